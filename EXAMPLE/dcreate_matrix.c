@@ -306,6 +306,165 @@ int dcreate_matrix_postfix(SuperMatrix *A, int nrhs, double **rhs,
     return 0;
 }
 
+/* \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * DGRID_ADVISE_POSTFIX chooses the shape of the process grid for the
+ * matrix in the file FP with superlu_grid_advise(), before the grid is
+ * created. Process 0 reads the matrix, computes the statistics of its
+ * symbolic factorization with OPTIONS, and rewinds FP; the shape is then
+ * broadcast over COMM.
+ *
+ * RANKSPERNODE (input) int
+ *       The number of MPI ranks per node.
+ *
+ * MAXDEP (input) int
+ *       The largest Z-dimension of the grid, 1 for a 2D grid.
+ *
+ * NRHS (input) int
+ *       The number of right-hand sides of the solves.
+ *
+ * SHAPE (output) superlu_gridshape_t*
+ *       The grid shape and its predicted times.
+ * </pre>
+ */
+int dgrid_advise_postfix(superlu_dist_options_t *options, FILE *fp,
+			 char *postfix, int ranksPerNode, int maxdep,
+			 int nrhs, MPI_Comm comm, superlu_gridshape_t *shape)
+{
+    superlu_symbstats_t stats;
+    int_t    *rowind, *colptr, m, n, nnz;
+    double   *nzval;
+    int      iam, nprocs;
+
+    MPI_Comm_rank(comm, &iam);
+    MPI_Comm_size(comm, &nprocs);
+
+    if ( !iam ) {
+	if ( !strcmp(postfix, "rua") )
+	    dreadhb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	else if ( !strcmp(postfix, "mtx") )
+	    dreadMM_dist(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	else if ( !strcmp(postfix, "rb") )
+	    dreadrb_dist(iam, fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	else if ( !strcmp(postfix, "dat") )
+	    dreadtriple_dist(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	else if ( !strcmp(postfix, "datnh") )
+	    dreadtriple_noheader(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	else if ( !strcmp(postfix, "bin") )
+	    dread_binary(fp, &m, &n, &nnz, &nzval, &rowind, &colptr);
+	else
+	    ABORT("File format not known");
+	rewind(fp);
+
+	if ( superlu_symbstats(options, m, n, nnz, colptr, rowind, &stats) )
+	    ABORT("superlu_symbstats() fails");
+	superlu_grid_advise(nprocs, ranksPerNode, maxdep, nrhs, &stats,
+			    NULL, shape);
+	superlu_symbstats_free(&stats);
+	SUPERLU_FREE(nzval);
+	SUPERLU_FREE(rowind);
+	SUPERLU_FREE(colptr);
+    }
+    MPI_Bcast(shape, sizeof(superlu_gridshape_t), MPI_BYTE, 0, comm);
+    return 0;
+}
+
+/* \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * DCREATE_MATRIX_MPIIO reads the matrix on all processes, so that the
+ * global matrix is never assembled on one process: Matrix Market files
+ * are read with MPI-IO (see pdreadMM_loc), and binary matrix files with
+ * suffix .sbin are mapped in memory (see pdread_binary_loc). It also
+ * generates the distributed true solution X and the right-hand side RHS.
+ *
+ * Arguments are as in DCREATE_MATRIX_POSTFIX, except:
+ *
+ * FILENAME (input) char*
+ *       The name of the matrix file.
+ * </pre>
+ */
+int dcreate_matrix_mpiio(SuperMatrix *A, int nrhs, double **rhs,
+			 int *ldb, double **x, int *ldx,
+			 char *filename, gridinfo_t *grid)
+{
+    NRformat_loc *Astore;
+    double   *xtrue_global, *nzval, sum;
+    int_t    *colind, *rowptr;
+    int_t    m_loc, fst_row, n, i, j, k;
+    int      iam, info;
+    size_t   len;
+    double   t;
+
+    iam = grid->iam;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Enter dcreate_matrix_mpiio()");
+#endif
+
+    t = SuperLU_timer_();
+    len = strlen(filename);
+    if ( len > 5 && !strcmp(filename + len - 5, ".sbin") )
+	info = pdread_binary_loc(filename, A, grid);
+    else
+	info = pdreadMM_loc(filename, A, grid);
+    if ( info ) ABORT("Cannot read the matrix file");
+    if ( !iam ) {
+	printf("Time to read and distribute matrix %.2f\n",
+	       SuperLU_timer_() - t);  fflush(stdout);
+    }
+
+    Astore = (NRformat_loc *) A->Store;
+    m_loc = Astore->m_loc;
+    fst_row = Astore->fst_row;
+    nzval = (double *) Astore->nzval;
+    colind = Astore->colind;
+    rowptr = Astore->rowptr;
+    n = A->ncol;
+
+    /* Generate the exact solution on PE 0 */
+    if ( !(xtrue_global = doubleMalloc_dist(n*nrhs)) )
+        ABORT("Malloc fails for xtrue[]");
+    if ( !iam ) dGenXtrue_dist(n, nrhs, xtrue_global, n);
+    MPI_Bcast( xtrue_global, n*nrhs, MPI_DOUBLE, 0, grid->comm );
+
+    /* Get the local B = A_loc * xtrue */
+    if ( !((*rhs) = doubleMalloc_dist(m_loc*nrhs)) )
+        ABORT("Malloc fails for rhs[]");
+    for (j = 0; j < nrhs; ++j) {
+	for (i = 0; i < m_loc; ++i) {
+	    sum = 0.0;
+	    for (k = rowptr[i]; k < rowptr[i+1]; ++k)
+		sum += nzval[k] * xtrue_global[colind[k] + j*n];
+	    (*rhs)[j*m_loc+i] = sum;
+	}
+    }
+    *ldb = m_loc;
+
+    /* Set the true X */
+    *ldx = m_loc;
+    if ( !((*x) = doubleMalloc_dist(*ldx * nrhs)) )
+        ABORT("Malloc fails for x_loc[]");
+    for (j = 0; j < nrhs; ++j) {
+      for (i = 0; i < m_loc; ++i)
+	(*x)[i + j*(*ldx)] = xtrue_global[i + fst_row + j*n];
+    }
+
+    SUPERLU_FREE(xtrue_global);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(iam, "Exit dcreate_matrix_mpiio()");
+#endif
+    return 0;
+}
+
 /* \brief
  *
  * <pre>
@@ -60,9 +60,11 @@ int main(int argc, char *argv[])
     double   *berr;
     double   *b, *xtrue;
     int    m, n;
-    int      nprow, npcol, lookahead, colperm, rowperm, ir, symbfact, batch;
+    int      nprow, npcol, lookahead, colperm, rowperm, ir, symbfact, batch, mpiio;
+    int      sympattern, ranksPerNode;
     int      iam, info, ldb, ldx, nrhs;
     char     **cpp, c, *postfix;;
+    char     *binfile;
     FILE *fp, *fopen();
     int cpp_defs();
     int ii, omp_mpi_level;
@@ -84,7 +86,11 @@ int main(int argc, char *argv[])
     rowperm = -1;
     ir = -1;
     symbfact = -1;
+    sympattern = -1;
     batch = 0;
+    mpiio = 0;
+    binfile = NULL;
+    ranksPerNode = 0;
 
     /* ------------------------------------------------------------
        INITIALIZE MPI ENVIRONMENT.
@@ -137,9 +143,13 @@ int main(int argc, char *argv[])
 		  printf("\t-p <int>: row permutation    (default %4d)\n", options.RowPerm);
 		  printf("\t-q <int>: col permutation    (default %4d)\n", options.ColPerm);
 		  printf("\t-s <int>: parallel symbolic? (default %4d)\n", options.ParSymbFact);
+		  printf("\t-y <int>: symmetric pattern? (default %4d)\n", options.SymPattern);
 		  printf("\t-l <int>: lookahead level    (default %4d)\n", options.num_lookaheads);
 		  printf("\t-i <int>: iter. refinement   (default %4d)\n", options.IterRefine);
 		  printf("\t-b <int>: use batch mode?    (default %4d)\n", batch);
+		  printf("\t-m <int>: MPI-IO .mtx read?  (default %4d)\n", mpiio);
+		  printf("\t-o <file>: write A to a binary matrix file (.sbin)\n");
+		  printf("\t-a <int>: choose the grid shape for this number of ranks per node\n");
 		  exit(0);
 		  break;
 	      case 'r': nprow = atoi(*cpp);
@@ -154,10 +164,18 @@ int main(int argc, char *argv[])
                         break;
 	      case 's': symbfact = atoi(*cpp);
 		        break;
+	      case 'y': sympattern = atoi(*cpp);
+		        break;
               case 'i': ir = atoi(*cpp);
                         break;
               case 'b': batch = atoi(*cpp);
                         break;
+              case 'm': mpiio = atoi(*cpp);
+                        break;
+              case 'o': binfile = *cpp;
+                        break;
+              case 'a': ranksPerNode = atoi(*cpp);
+                        break;
 	    }
 	} else { /* Last arg is considered a filename */
 	    if ( !(fp = fopen(*cpp, "r")) ) {
@@ -173,8 +191,31 @@ int main(int argc, char *argv[])
     if (lookahead != -1) options.num_lookaheads = lookahead;
     if (ir != -1) options.IterRefine = ir;
     if (symbfact != -1) options.ParSymbFact = symbfact;
+    if (sympattern != -1) options.SymPattern = sympattern;
 
     int superlu_acc_offload = sp_ienv_dist(10, &options); //get_acc_offload();
+
+    for(ii = 0;ii<strlen(*cpp);ii++){
+	if((*cpp)[ii]=='.'){
+		postfix = &((*cpp)[ii+1]);
+	}
+    }
+    // printf("%s\n", postfix);
+
+    /* Replace -r and -c by the 2D shape predicted to be the fastest. */
+    if ( ranksPerNode > 0 && !batch ) {
+	superlu_gridshape_t shape;
+	dgrid_advise_postfix(&options, fp, postfix, ranksPerNode, 1,
+			     nrhs, MPI_COMM_WORLD, &shape);
+	nprow = shape.nprow;
+	npcol = shape.npcol;
+	MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+	if ( !myrank ) {
+	    printf("Advised grid %d X %d: predicted factorization %.3e s,"
+		   " solve %.3e s\n", nprow, npcol, shape.tFactor, shape.tSolve);
+	    fflush(stdout);
+	}
+    }
     
     /* In the batch mode: create multiple SuperLU grids,
         each grid solving one linear system. */
@@ -297,17 +338,15 @@ int main(int argc, char *argv[])
     CHECK_MALLOC(iam, "Enter main()");
 #endif
 
-    for(ii = 0;ii<strlen(*cpp);ii++){
-	if((*cpp)[ii]=='.'){
-		postfix = &((*cpp)[ii+1]);
-	}
-    }
-    // printf("%s\n", postfix);
-
     /* ------------------------------------------------------------
        GET THE MATRIX FROM FILE AND SETUP THE RIGHT HAND SIDE.
        ------------------------------------------------------------*/
-    dcreate_matrix_postfix(&A, nrhs, &b, &ldb, &xtrue, &ldx, fp, postfix, &grid);
+    if ( (mpiio && !strcmp(postfix, "mtx")) || !strcmp(postfix, "sbin") )
+	dcreate_matrix_mpiio(&A, nrhs, &b, &ldb, &xtrue, &ldx, *cpp, &grid);
+    else
+	dcreate_matrix_postfix(&A, nrhs, &b, &ldb, &xtrue, &ldx, fp, postfix, &grid);
+    if ( binfile && pdwrite_binary_loc(binfile, &A, 0, &grid) )
+	ABORT("Cannot write the binary matrix file");
 
     if ( !(berr = doubleMalloc_dist(nrhs)) )
 	ABORT("Malloc fails for berr[].");
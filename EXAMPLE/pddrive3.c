@@ -46,6 +46,10 @@ at the top-level directory.
  * although the numerical values are different. So 'Llu' is set up once
  * in the first call to PDGSSVX, and reused in the subsequent call.
  *
+ * The last system differs from the previous one only in its last row;
+ * PDGSREFACT_MARK marks the supernodes depending on that row, and only
+ * these are refactored by the subsequent call to PDGSSVX.
+ *
  * With MPICH,  program may be run by typing:
  *    mpiexec -n <np> pddrive3 -r <proc rows> -c <proc columns> big.rua
  * </pre>
@@ -64,6 +68,13 @@ int main(int argc, char *argv[])
     double   *berr;
     double   *b, *b1, *xtrue, *nzval, *nzval1;
     int_t    *colind, *colind1, *rowptr, *rowptr1;
+    double   *b2, *nzval2, *b3, *nzval3, xdiff[2], xmax[2];
+    int_t    *colind2, *rowptr2, *colind3, *rowptr3, last_row, nrefact;
+    superlu_dist_options_t options3;
+    dScalePermstruct_t ScalePermstruct3;
+    dLUstruct_t LUstruct3;
+    dSOLVEstruct_t SOLVEstruct3;
+    int      agree = 1;
     int_t    i, j, m, n, nnz_loc, m_loc, fst_row;
     int      nprow, npcol;
     int      iam, info, ldb, ldx, nrhs;
@@ -240,6 +251,21 @@ int main(int argc, char *argv[])
     dZeroLblocks(iam, n, &grid, &LUstruct);
     dZeroUblocks(iam, n, &grid, &LUstruct);
 
+    /* Save a copy of the matrix A and of the right-hand side for
+       the third system. */
+    nzval2 = doubleMalloc_dist(nnz_loc);
+    colind2 = intMalloc_dist(nnz_loc);
+    rowptr2 = intMalloc_dist(m_loc+1);
+    for (i = 0; i < nnz_loc; ++i) {
+        nzval2[i] = nzval1[i];
+        colind2[i] = colind1[i];
+    }
+    for (i = 0; i < m_loc+1; ++i) rowptr2[i] = rowptr1[i];
+    if ( !(b2 = doubleMalloc_dist(ldb * nrhs)) )
+        ABORT("Malloc fails for b2[]");
+    for (j = 0; j < nrhs; ++j)
+        for (i = 0; i < ldb; ++i) b2[i+j*ldb] = b1[i+j*ldb];
+
     dCreate_CompRowLoc_Matrix_dist(&A, m, n, nnz_loc, m_loc, fst_row,
 				   nzval1, colind1, rowptr1,
 				   SLU_NR_loc, SLU_D, SLU_GE);
@@ -263,6 +289,106 @@ int main(int argc, char *argv[])
     /* Print the statistics. */
     PStatPrint(&options, &stat, &grid);
 
+    /* ------------------------------------------------------------
+       NOW WE SOLVE A THIRD SYSTEM, IN WHICH ONLY THE LAST ROW OF A
+       CHANGED. ONLY THE SUPERNODES DEPENDING ON THIS ROW ARE
+       REFACTORED; L AND U MUST NOT BE ZEROED IN THIS CASE.
+       THE ROW IS DOUBLED, AND THE SOLUTION IS NOT REFINED, SO THAT
+       IT IS WRONG IF A SUPERNODE IS MISSED; IT IS COMPARED WITH THAT
+       OF A FULL FACTORIZATION.
+       ------------------------------------------------------------*/
+    Destroy_CompRowLoc_Matrix_dist(&A);
+    PStatClear(&stat);
+
+    last_row = m - 1;
+    if ( m_loc > 0 && fst_row + m_loc == m ) { /* I own the last row. */
+        for (i = rowptr2[m_loc-1]; i < rowptr2[m_loc]; ++i)
+            nzval2[i] *= 2.0;
+    }
+
+    /* Save a copy of the matrix A and of the right-hand side for
+       the full factorization. */
+    nzval3 = doubleMalloc_dist(nnz_loc);
+    colind3 = intMalloc_dist(nnz_loc);
+    rowptr3 = intMalloc_dist(m_loc+1);
+    for (i = 0; i < nnz_loc; ++i) {
+        nzval3[i] = nzval2[i];
+        colind3[i] = colind2[i];
+    }
+    for (i = 0; i < m_loc+1; ++i) rowptr3[i] = rowptr2[i];
+    if ( !(b3 = doubleMalloc_dist(ldb * nrhs)) )
+        ABORT("Malloc fails for b3[]");
+    for (j = 0; j < nrhs; ++j)
+        for (i = 0; i < ldb; ++i) b3[i+j*ldb] = b2[i+j*ldb];
+
+    dCreate_CompRowLoc_Matrix_dist(&A, m, n, nnz_loc, m_loc, fst_row,
+				   nzval2, colind2, rowptr2,
+				   SLU_NR_loc, SLU_D, SLU_GE);
+
+    options.IterRefine = NOREFINE;
+    nrefact = pdgsrefact_mark(&options, 1, &last_row, 0, NULL, &A,
+                              &ScalePermstruct, &LUstruct, &grid);
+    pdgssvx(&options, &A, &ScalePermstruct, b2, ldb, nrhs, &grid,
+            &LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+    if ( info ) {  /* Something is wrong */
+        if ( iam==0 ) {
+	    printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+	    fflush(stdout);
+	}
+    } else {
+        /* Check the accuracy of the solution. */
+        if ( !iam )
+            printf("Solve a system with one changed row: %ld supernodes "
+                   "refactored.\n", (long) nrefact);
+    }
+
+    PStatPrint(&options, &stat, &grid);
+    Destroy_CompRowLoc_Matrix_dist(&A);
+
+    /* The same system, factored from scratch. */
+    options3 = options;
+    options3.Fact = DOFACT;
+    options3.SolveInitialized = NO;
+    options3.RefineInitialized = NO;
+    dCreate_CompRowLoc_Matrix_dist(&A, m, n, nnz_loc, m_loc, fst_row,
+				   nzval3, colind3, rowptr3,
+				   SLU_NR_loc, SLU_D, SLU_GE);
+    dScalePermstructInit(m, n, &ScalePermstruct3);
+    dLUstructInit(n, &LUstruct3);
+    PStatClear(&stat);
+    pdgssvx(&options3, &A, &ScalePermstruct3, b3, ldb, nrhs, &grid,
+            &LUstruct3, &SOLVEstruct3, berr, &stat, &info);
+    if ( info ) {  /* Something is wrong */
+        if ( iam==0 ) {
+	    printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+	    fflush(stdout);
+	}
+    }
+
+    /* || x_partial - x_full || / || x_full || */
+    xdiff[0] = xdiff[1] = 0.0;
+    for (j = 0; j < nrhs; ++j)
+        for (i = 0; i < m_loc; ++i) {
+	    xdiff[0] = SUPERLU_MAX(xdiff[0], fabs(b2[i+j*ldb] - b3[i+j*ldb]));
+	    xdiff[1] = SUPERLU_MAX(xdiff[1], fabs(b3[i+j*ldb]));
+	}
+    MPI_Allreduce(xdiff, xmax, 2, MPI_DOUBLE, MPI_MAX, grid.comm);
+    agree = xmax[0] <= 1e-8 * xmax[1];
+    if ( !iam ) {
+        printf("%s: ||x_partial - x_full|| / ||x_full|| = %e\n",
+	       agree ? "Partial and full refactorization agree" : "ERROR",
+	       xmax[0] / xmax[1]);
+	fflush(stdout);
+    }
+
+    dDestroy_LU(n, &grid, &LUstruct3);
+    dScalePermstructFree(&ScalePermstruct3);
+    dLUstructFree(&LUstruct3);
+    if ( options3.SolveInitialized ) {
+        dSolveFinalize(&options3, &SOLVEstruct3);
+    }
+
     /* ------------------------------------------------------------
        DEALLOCATE ALL STORAGE.
        ------------------------------------------------------------*/
@@ -276,6 +402,8 @@ int main(int argc, char *argv[])
         dSolveFinalize(&options, &SOLVEstruct);
     }
     SUPERLU_FREE(b1);	             /* Free storage of right-hand side.    */
+    SUPERLU_FREE(b2);
+    SUPERLU_FREE(b3);
     SUPERLU_FREE(xtrue);             /* Free storage of the exact solution. */
     SUPERLU_FREE(berr);
     fclose(fp);
@@ -295,6 +423,7 @@ out:
     CHECK_MALLOC(iam, "Exit main()");
 #endif
 
+    return ( agree ? 0 : 1 );
 }
 
 
@@ -42,7 +42,7 @@ at the top-level directory.
  *    mpiexec -np <p> pddrive3d -r <proc rows> -c <proc columns> \
  *                                   -d <proc Z-dimension> <input_file>
  * NOTE: total number of processes p = r * c * d
- *       d must be a power-of-two, e.g., 1, 2, 4, ...
+ *       d need not be a power-of-two, e.g., 1, 2, 3, 4, ...
  *
  * </pre>
  */
@@ -116,7 +116,7 @@ int main (int argc, char *argv[])
     char **cpp, c, *suffix;
     FILE *fp, *fopen ();
     extern int cpp_defs ();
-    int ii, omp_mpi_level, batchCount = 0;
+    int ii, omp_mpi_level, batchCount = 0, ranksPerNode = 0;
     int*    usermap;     /* The following variables are used for batch solves */
     float result_min[2];
     result_min[0]=1e10;
@@ -129,7 +129,7 @@ int main (int argc, char *argv[])
 
     nprow = 1;            /* Default process rows.      */
     npcol = 1;            /* Default process columns.   */
-    npdep = 1;            /* replication factor must be power of two */
+    npdep = 1;            /* replication factor */
     nrhs = 1;             /* Number of right-hand side. */
     equil = -1;
     colperm = -1;
@@ -171,6 +171,7 @@ int main (int argc, char *argv[])
                 printf ("\t-r <int>: process rows    (default %d)\n", nprow);
                 printf ("\t-c <int>: process columns (default %d)\n", npcol);
                 printf ("\t-d <int>: process Z-dimension (default %d)\n", npdep);
+                printf ("\t-a <int>: choose the grid shape for this number of ranks per node\n");
                 exit (0);
                 break;
             case 'r':
@@ -182,6 +183,8 @@ int main (int argc, char *argv[])
             case 'd':
                 npdep = atoi (*cpp);
                 break;
+            case 'a': ranksPerNode = atoi(*cpp);
+                      break;
             case 'b': batchCount = atoi(*cpp);
                       break;
             case 'e': equil = atoi(*cpp);
@@ -247,7 +250,32 @@ int main (int argc, char *argv[])
     if (ir != -1) options.IterRefine = ir;
     if (lookahead != -1) options.num_lookaheads = lookahead;
 
-    
+    for (ii = 0; ii<strlen(*cpp); ii++) {
+	if((*cpp)[ii]=='.'){
+	    suffix = &((*cpp)[ii+1]);
+	    // printf("%s\n", suffix);
+	}
+    }
+
+    /* Replace -r, -c and -d by the shape predicted to be the fastest. */
+    if ( ranksPerNode > 0 && batchCount == 0 ) {
+	superlu_gridshape_t shape;
+	int nprocs;
+	MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+	dgrid_advise_postfix(&options, fp, suffix, ranksPerNode, nprocs,
+			     nrhs, MPI_COMM_WORLD, &shape);
+	nprow = shape.nprow;
+	npcol = shape.npcol;
+	npdep = shape.npdep;
+	MPI_Comm_rank(MPI_COMM_WORLD, &ii);
+	if ( !ii ) {
+	    printf("Advised grid %d X %d X %d: predicted factorization %.3e s,"
+		   " solve %.3e s\n", nprow, npcol, npdep,
+		   shape.tFactor, shape.tSolve);
+	    fflush(stdout);
+	}
+    }
+
     /* ------------------------------------------------------------
        INITIALIZE THE SUPERLU PROCESS GRID.
        ------------------------------------------------------------ */
@@ -324,13 +352,6 @@ int main (int argc, char *argv[])
     /* ------------------------------------------------------------
        GET THE MATRIX FROM FILE AND SETUP THE RIGHT HAND SIDE.
        ------------------------------------------------------------ */
-    for (ii = 0; ii<strlen(*cpp); ii++) {
-	if((*cpp)[ii]=='.'){
-	    suffix = &((*cpp)[ii+1]);
-	    // printf("%s\n", suffix);
-	}
-    }
-
     if ( batchCount > 0 ) {
 	/* ------------------------------------------------------------
 	   SOLVE THE BATCH LINEAR SYSTEM.
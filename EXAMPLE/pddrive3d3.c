@@ -50,7 +50,7 @@ at the top-level directory.
  *    mpiexec -np <p> pddrive3d3 -r <proc rows> -c <proc columns> \
  *                                    -d <proc Z-dimension> <input_file>
  * NOTE: total number of processes p = r * c * d
- *       (d must be a power-of-two, e.g., 1, 2, 4, ...)
+ *       (d need not be a power-of-two, e.g., 1, 2, 3, 4, ...)
  *
  * </pre>
  */
@@ -128,7 +128,7 @@ main (int argc, char *argv[])
 
     nprow = 1;            /* Default process rows.      */
     npcol = 1;            /* Default process columns.   */
-    npdep = 1;            /* replication factor must be power of two */
+    npdep = 1;            /* replication factor */
     nrhs = 1;             /* Number of right-hand side. */
     lookahead = -1;
     colperm = -1;
@@ -0,0 +1,253 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Driver program for PDGSSVX example with a matrix assembled
+ * from element matrices
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* Add the bilinear element matrices of the cells owned by my process,
+   for a coefficient depending on the pass, to the assembly. If
+   unbalanced is set, process 0 owns all the cells. */
+static void
+add_elements(dAssemble_t *as, int_t nx, int pass, int iam, int nprocs,
+	     int unbalanced)
+{
+    /* Stiffness of the Laplacian on a square bilinear element,
+       vertices numbered counterclockwise */
+    static const double K[4][4] = {
+	{ 4., -1., -2., -1.}, {-1.,  4., -1., -2.},
+	{-2., -1.,  4., -1.}, {-1., -2., -1.,  4.} };
+    int_t rows[16], cols[16], v[4], cx, cy, e, r, c;
+    double vals[16], coef;
+
+    /* Cells are dealt cyclically, so that most of them have vertices
+       in the rows of other processes. */
+    if ( unbalanced ) {
+	if ( iam ) return;
+	nprocs = 1;
+    }
+    for (e = iam; e < (nx - 1) * (nx - 1); e += nprocs) {
+	cx = e % (nx - 1);
+	cy = e / (nx - 1);
+	v[0] = cy * nx + cx;
+	v[1] = v[0] + 1;
+	v[2] = v[1] + nx;
+	v[3] = v[0] + nx;
+	coef = 1.0 + 0.5 * pass * sin((double) e);
+	for (r = 0; r < 4; ++r)
+	    for (c = 0; c < 4; ++c) {
+		rows[4*r+c] = v[r];
+		cols[4*r+c] = v[c];
+		vals[4*r+c] = coef * K[r][c] / 6.0 + (r == c ? 0.01 : 0.0);
+	    }
+	if ( dAssembleAdd(as, 16, rows, cols, vals) )
+	    ABORT("Element vertex out of range.");
+    }
+}
+
+/* Set up xtrue and b = A * xtrue for the local rows of A. */
+static void
+set_rhs(SuperMatrix *A, double *xtrue_global, double **b, double **xtrue)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    double *a = (double *) Astore->nzval;
+    int_t i, k;
+
+    if ( !(*b = doubleMalloc_dist(Astore->m_loc)) ||
+	 !(*xtrue = doubleMalloc_dist(Astore->m_loc)) )
+	ABORT("Malloc fails for b[] or xtrue[].");
+    for (i = 0; i < Astore->m_loc; ++i) {
+	(*b)[i] = 0.0;
+	for (k = Astore->rowptr[i]; k < Astore->rowptr[i+1]; ++k)
+	    (*b)[i] += a[k] * xtrue_global[Astore->colind[k]];
+	(*xtrue)[i] = xtrue_global[Astore->fst_row + i];
+    }
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * The driver program PDDRIVE_ASSEMBLE.
+ *
+ * This example illustrates how to assemble a distributed matrix from
+ * element matrices with dAssembleAdd(), each process adding the elements
+ * it owns whatever the rows they touch, and how to assemble new values
+ * with the same sparsity pattern, reusing the routing of the entries, to
+ * solve again with options.Fact = SamePattern.
+ * The matrix is the Laplacian on an nx-by-nx grid of bilinear elements,
+ * plus a small shift.
+ *
+ * With -u 1, process 0 adds all the elements while the other processes
+ * finalize at once, which checks that no process waits on the others.
+ *
+ * With MPICH,  program may be run by typing:
+ *    mpiexec -n <np> pddrive_assemble -r <proc rows> -c <proc columns> -n <nx>
+ * </pre>
+ */
+int main(int argc, char *argv[])
+{
+    superlu_dist_options_t options;
+    SuperLUStat_t stat;
+    SuperMatrix A;
+    dAssemble_t as;
+    dScalePermstruct_t ScalePermstruct;
+    dLUstruct_t LUstruct;
+    dSOLVEstruct_t SOLVEstruct;
+    gridinfo_t grid;
+    double   *berr, *b = NULL, *xtrue = NULL, *xtrue_global;
+    int_t    nx, n, m_loc;
+    int      nprow, npcol, nprocs, pass, unbalanced;
+    int      iam, info, ldb, nrhs;
+    char     **cpp, c;
+
+    nprow = 1;  /* Default process rows.      */
+    npcol = 1;  /* Default process columns.   */
+    nx = 40;    /* Default grid size.         */
+    nrhs = 1;   /* Number of right-hand side. */
+    unbalanced = 0;
+
+    /* ------------------------------------------------------------
+       INITIALIZE MPI ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Init( &argc, &argv );
+
+    /* Parse command line argv[]. */
+    for (cpp = argv+1; *cpp; ++cpp) {
+	if ( **cpp == '-' ) {
+	    c = *(*cpp+1);
+	    ++cpp;
+	    switch (c) {
+	      case 'h':
+		  printf("Options:\n");
+		  printf("\t-r <int>: process rows    (default %4d)\n", nprow);
+		  printf("\t-c <int>: process columns (default %4d)\n", npcol);
+		  printf("\t-n <int>: grid size       (default %4d)\n", (int) nx);
+		  printf("\t-u <0|1>: process 0 adds all the elements (default %d)\n", unbalanced);
+		  exit(0);
+		  break;
+	      case 'r': nprow = atoi(*cpp);
+		        break;
+	      case 'c': npcol = atoi(*cpp);
+		        break;
+	      case 'n': nx = atoi(*cpp);
+		        break;
+	      case 'u': unbalanced = atoi(*cpp);
+		        break;
+	    }
+	}
+    }
+
+    /* ------------------------------------------------------------
+       INITIALIZE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+    superlu_gridinit(MPI_COMM_WORLD, nprow, npcol, &grid);
+
+    /* Bail out if I do not belong in the grid. */
+    iam = grid.iam;
+    if ( iam == -1 ) goto out;
+    nprocs = nprow * npcol;
+    n = nx * nx;
+    if ( !iam ) {
+	printf("Grid %d x %d, n " IFMT "\n", (int) nx, (int) nx, n);
+	printf("Process grid:\t\t%d X %d\n", (int)grid.nprow, (int)grid.npcol);
+	fflush(stdout);
+    }
+
+    /* The same exact solution on all processes */
+    if ( !(xtrue_global = doubleMalloc_dist(n)) )
+	ABORT("Malloc fails for xtrue_global[].");
+    if ( !iam ) dGenXtrue_dist(n, 1, xtrue_global, n);
+    MPI_Bcast( xtrue_global, n, MPI_DOUBLE, 0, grid.comm );
+    if ( !(berr = doubleMalloc_dist(nrhs)) )
+	ABORT("Malloc fails for berr[].");
+
+    set_default_options_dist(&options);
+    dScalePermstructInit(n, n, &ScalePermstruct);
+    dLUstructInit(n, &LUstruct);
+    PStatInit(&stat);
+
+    /* ------------------------------------------------------------
+       ASSEMBLE AND SOLVE; THEN ASSEMBLE NEW VALUES WITH THE SAME
+       PATTERN AND SOLVE AGAIN.
+       ------------------------------------------------------------*/
+    dAssembleInit(&as, n, n, 0, YES, &grid);
+    for (pass = 0; pass < 2; ++pass) {
+	if ( pass ) dAssembleRestart(&as);
+	add_elements(&as, nx, pass, iam, nprocs, unbalanced);
+	if ( dAssembleFinalize(&as, &A) )
+	    ABORT("The second assembly has a different pattern.");
+	set_rhs(&A, xtrue_global, &b, &xtrue);
+	m_loc = ((NRformat_loc *) A.Store)->m_loc;
+	ldb = m_loc;
+
+	if ( pass ) {
+	    options.Fact = SamePattern;
+	    PStatClear(&stat);
+	}
+	pdgssvx(&options, &A, &ScalePermstruct, b, ldb, nrhs, &grid,
+		&LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+	if ( info ) {  /* Something is wrong */
+	    if ( iam==0 ) {
+		printf("ERROR: INFO = %d returned from pdgssvx()\n", info);
+		fflush(stdout);
+	    }
+	} else {
+	    /* Check the accuracy of the solution. */
+	    if ( !iam && pass )
+		printf("Solve the system with the same sparsity pattern.\n");
+	    pdinf_norm_error(iam, m_loc, nrhs, b, ldb, xtrue, m_loc, grid.comm);
+	}
+	PStatPrint(&options, &stat, &grid);
+
+	Destroy_CompRowLoc_Matrix_dist(&A);
+	dDestroy_LU(n, &grid, &LUstruct);
+	SUPERLU_FREE(b);
+	SUPERLU_FREE(xtrue);
+    }
+    dAssembleFree(&as);
+
+    /* ------------------------------------------------------------
+       DEALLOCATE STORAGE.
+       ------------------------------------------------------------*/
+    PStatFree(&stat);
+    dScalePermstructFree(&ScalePermstruct);
+    dLUstructFree(&LUstruct);
+    if ( options.SolveInitialized ) {
+        dSolveFinalize(&options, &SOLVEstruct);
+    }
+    SUPERLU_FREE(berr);
+    SUPERLU_FREE(xtrue_global);
+
+    /* ------------------------------------------------------------
+       RELEASE THE SUPERLU PROCESS GRID.
+       ------------------------------------------------------------*/
+out:
+    superlu_gridexit(&grid);
+
+    /* ------------------------------------------------------------
+       TERMINATES THE MPI EXECUTION ENVIRONMENT.
+       ------------------------------------------------------------*/
+    MPI_Finalize();
+}
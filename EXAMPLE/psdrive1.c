@@ -41,6 +41,9 @@ at the top-level directory.
  * in the subsequent call to PSGSSVX:
  *        ScalePermstruct  : DiagScale, R, C, perm_r, perm_c
  *        LUstruct         : Glu_persist, Llu
+ * Finally, it solves a system with A + u*v^T by attaching the rank-1
+ * update to the factorization of A with PSGSUPDATE_LOWRANK, and
+ * solving with PSGSSVX_LOWRANK.
  *
  * With MPICH,  program may be run by typing:
  *    mpiexec -n <np> psdrive1 -r <proc rows> -c <proc columns> big.rua
@@ -56,10 +59,10 @@ int main(int argc, char *argv[])
     sSOLVEstruct_t SOLVEstruct;
     gridinfo_t grid;
     float   *berr;
-    float   *b, *xtrue, *b1, *b2;
+    float   *b, *xtrue, *b1, *b2, *b3, *u, *v, vx;
     int    i, j, m, n, m_loc;
     int    nprow, npcol;
-    int    iam, info, ldb, ldx, nrhs;
+    int    iam, info, lrinfo, ldb, ldx, nrhs;
     char     **cpp, c, *postfix;
     int ii, omp_mpi_level;
     FILE *fp, *fopen();
@@ -145,10 +148,13 @@ int main(int argc, char *argv[])
         ABORT("Malloc fails for b1[]");
     if ( !(b2 = floatMalloc_dist(ldb * nrhs)) )
         ABORT("Malloc fails for b1[]");
+    if ( !(b3 = floatMalloc_dist(ldb * nrhs)) )
+        ABORT("Malloc fails for b3[]");
     for (j = 0; j < nrhs; ++j) {
         for (i = 0; i < ldb; ++i) {
 	    b1[i+j*ldb] = b[i+j*ldb];
 	    b2[i+j*ldb] = b[i+j*ldb];
+	    b3[i+j*ldb] = b[i+j*ldb];
         }
     }
 
@@ -269,6 +275,48 @@ int main(int argc, char *argv[])
 
     PStatPrint(&options, &stat, &grid);        /* Print the statistics. */
 
+    /* ------------------------------------------------------------
+       4. SOLVE THE SYSTEM WITH A + u*v^T, WITH THE RANK-1 UPDATE
+       ATTACHED TO THE EXISTING FACTORIZATION OF A, WITHOUT
+       REFACTORIZATION.
+       ------------------------------------------------------------*/
+    PStatClear(&stat); /* clear the statistics variables. */
+
+    if ( !(u = floatMalloc_dist(2 * ldb)) )
+        ABORT("Malloc fails for u[]");
+    v = u + ldb;
+    for (i = 0; i < m_loc; ++i) {
+	u[i] = 1.0;
+	v[i] = 1.0 / n;
+    }
+    lrinfo = psgsupdate_lowrank(&options, 1, u, ldb, v, ldb, &A,
+				&ScalePermstruct, &LUstruct, &grid, &stat,
+				&info);
+
+    /* Set up the right-hand sides (A + u*v^T) * xtrue. */
+    for (j = 0; j < nrhs; ++j) {
+	for (i = 0, vx = 0.0; i < m_loc; ++i) vx += v[i] * xtrue[i+j*ldx];
+	MPI_Allreduce(MPI_IN_PLACE, &vx, 1, MPI_FLOAT, MPI_SUM, grid.comm);
+	for (i = 0; i < m_loc; ++i) b3[i+j*ldb] += u[i] * vx;
+    }
+
+    psgssvx_lowrank(&options, &A, &ScalePermstruct, b3, ldb, nrhs, &grid,
+		    &LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+    if ( info || lrinfo ) {  /* Something is wrong */
+        if ( iam==0 ) {
+	    printf("ERROR: INFO = %d, %d returned from psgssvx_lowrank()\n",
+		   info, lrinfo);
+	    fflush(stdout);
+	}
+    } else {
+        /* Check the accuracy of the solution. */
+        if ( !iam ) printf("\tSolve the system with a rank-1 update of A:\n");
+        psinf_norm_error(iam, m_loc, nrhs, b3, ldb, xtrue, ldx, grid.comm);
+    }
+
+    PStatPrint(&options, &stat, &grid);        /* Print the statistics. */
+
     /* ------------------------------------------------------------
        DEALLOCATE STORAGE.
        ------------------------------------------------------------*/
@@ -283,6 +331,8 @@ int main(int argc, char *argv[])
     SUPERLU_FREE(b);
     SUPERLU_FREE(b1);
     SUPERLU_FREE(b2);
+    SUPERLU_FREE(b3);
+    SUPERLU_FREE(u);
     SUPERLU_FREE(xtrue);
     SUPERLU_FREE(berr);
     fclose(fp);
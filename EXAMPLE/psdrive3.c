@@ -46,6 +46,10 @@ at the top-level directory.
  * although the numerical values are different. So 'Llu' is set up once
  * in the first call to PSGSSVX, and reused in the subsequent call.
  *
+ * The last system differs from the previous one only in its last row;
+ * PSGSREFACT_MARK marks the supernodes depending on that row, and only
+ * these are refactored by the subsequent call to PSGSSVX.
+ *
  * With MPICH,  program may be run by typing:
  *    mpiexec -n <np> psdrive3 -r <proc rows> -c <proc columns> big.rua
  * </pre>
@@ -64,6 +68,8 @@ int main(int argc, char *argv[])
     float   *berr;
     float   *b, *b1, *xtrue, *nzval, *nzval1;
     int_t    *colind, *colind1, *rowptr, *rowptr1;
+    float   *b2, *nzval2;
+    int_t    *colind2, *rowptr2, last_row, nrefact;
     int_t    i, j, m, n, nnz_loc, m_loc, fst_row;
     int      nprow, npcol;
     int      iam, info, ldb, ldx, nrhs;
@@ -240,6 +246,21 @@ int main(int argc, char *argv[])
     sZeroLblocks(iam, n, &grid, &LUstruct);
     sZeroUblocks(iam, n, &grid, &LUstruct);
 
+    /* Save a copy of the matrix A and of the right-hand side for
+       the third system. */
+    nzval2 = floatMalloc_dist(nnz_loc);
+    colind2 = intMalloc_dist(nnz_loc);
+    rowptr2 = intMalloc_dist(m_loc+1);
+    for (i = 0; i < nnz_loc; ++i) {
+        nzval2[i] = nzval1[i];
+        colind2[i] = colind1[i];
+    }
+    for (i = 0; i < m_loc+1; ++i) rowptr2[i] = rowptr1[i];
+    if ( !(b2 = floatMalloc_dist(ldb * nrhs)) )
+        ABORT("Malloc fails for b2[]");
+    for (j = 0; j < nrhs; ++j)
+        for (i = 0; i < ldb; ++i) b2[i+j*ldb] = b1[i+j*ldb];
+
     sCreate_CompRowLoc_Matrix_dist(&A, m, n, nnz_loc, m_loc, fst_row,
 				   nzval1, colind1, rowptr1,
 				   SLU_NR_loc, SLU_S, SLU_GE);
@@ -263,6 +284,43 @@ int main(int argc, char *argv[])
     /* Print the statistics. */
     PStatPrint(&options, &stat, &grid);
 
+    /* ------------------------------------------------------------
+       NOW WE SOLVE A THIRD SYSTEM, IN WHICH ONLY THE LAST ROW OF A
+       CHANGED. ONLY THE SUPERNODES DEPENDING ON THIS ROW ARE
+       REFACTORED; L AND U MUST NOT BE ZEROED IN THIS CASE.
+       ------------------------------------------------------------*/
+    Destroy_CompRowLoc_Matrix_dist(&A);
+    PStatClear(&stat);
+
+    last_row = m - 1;
+    if ( m_loc > 0 && fst_row + m_loc == m ) { /* I own the last row. */
+        for (i = rowptr2[m_loc-1]; i < rowptr2[m_loc]; ++i)
+            if ( colind2[i] == last_row ) nzval2[i] += 1.0e-6;
+    }
+    sCreate_CompRowLoc_Matrix_dist(&A, m, n, nnz_loc, m_loc, fst_row,
+				   nzval2, colind2, rowptr2,
+				   SLU_NR_loc, SLU_S, SLU_GE);
+
+    nrefact = psgsrefact_mark(&options, 1, &last_row, 0, NULL, &A,
+                              &ScalePermstruct, &LUstruct, &grid);
+    psgssvx(&options, &A, &ScalePermstruct, b2, ldb, nrhs, &grid,
+            &LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+    if ( info ) {  /* Something is wrong */
+        if ( iam==0 ) {
+	    printf("ERROR: INFO = %d returned from psgssvx()\n", info);
+	    fflush(stdout);
+	}
+    } else {
+        /* Check the accuracy of the solution. */
+        if ( !iam )
+            printf("Solve a system with one changed row: %ld supernodes "
+                   "refactored.\n", (long) nrefact);
+        psinf_norm_error(iam, m_loc, nrhs, b2, ldb, xtrue, ldx, grid.comm);
+    }
+
+    PStatPrint(&options, &stat, &grid);
+
     /* ------------------------------------------------------------
        DEALLOCATE ALL STORAGE.
        ------------------------------------------------------------*/
@@ -276,6 +334,7 @@ int main(int argc, char *argv[])
         sSolveFinalize(&options, &SOLVEstruct);
     }
     SUPERLU_FREE(b1);	             /* Free storage of right-hand side.    */
+    SUPERLU_FREE(b2);
     SUPERLU_FREE(xtrue);             /* Free storage of the exact solution. */
     SUPERLU_FREE(berr);
     fclose(fp);
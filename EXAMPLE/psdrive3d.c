@@ -42,7 +42,7 @@ at the top-level directory.
  *    mpiexec -np <p> psdrive3d -r <proc rows> -c <proc columns> \
  *                                   -d <proc Z-dimension> <input_file>
  * NOTE: total number of processes p = r * c * d
- *       d must be a power-of-two, e.g., 1, 2, 4, ...
+ *       d need not be a power-of-two, e.g., 1, 2, 3, 4, ...
  *
  * </pre>
  */
@@ -129,7 +129,7 @@ int main (int argc, char *argv[])
 
     nprow = 1;            /* Default process rows.      */
     npcol = 1;            /* Default process columns.   */
-    npdep = 1;            /* replication factor must be power of two */
+    npdep = 1;            /* replication factor */
     nrhs = 1;             /* Number of right-hand side. */
     equil = -1;
     colperm = -1;
@@ -40,6 +40,9 @@ at the top-level directory.
  * in the subsequent call to PZGSSVX:
  *        ScalePermstruct  : DiagScale, R, C, perm_r, perm_c
  *        LUstruct         : Glu_persist, Llu
+ * Finally, it solves a system with A + u*v^T by attaching the rank-1
+ * update to the factorization of A with PZGSUPDATE_LOWRANK, and
+ * solving with PZGSSVX_LOWRANK.
  * 
  * With MPICH,  program may be run by typing:
  *    mpiexec -n <np> pzdrive1 -r <proc rows> -c <proc columns> big.rua
@@ -55,10 +58,10 @@ int main(int argc, char *argv[])
     zSOLVEstruct_t SOLVEstruct;
     gridinfo_t grid;
     double   *berr;
-    doublecomplex   *b, *xtrue, *b1, *b2;
+    doublecomplex   *b, *xtrue, *b1, *b2, *b3, *u, *v, vx;
     int    i, j, m, n, m_loc;
     int    nprow, npcol;
-    int    iam, info, ldb, ldx, nrhs;
+    int    iam, info, lrinfo, ldb, ldx, nrhs;
     char     **cpp, c, *postfix;
     int ii, omp_mpi_level;
     FILE *fp, *fopen();
@@ -144,10 +147,13 @@ int main(int argc, char *argv[])
         ABORT("Malloc fails for b1[]");
     if ( !(b2 = doublecomplexMalloc_dist(ldb * nrhs)) )
         ABORT("Malloc fails for b1[]");
+    if ( !(b3 = doublecomplexMalloc_dist(ldb * nrhs)) )
+        ABORT("Malloc fails for b3[]");
     for (j = 0; j < nrhs; ++j) {
         for (i = 0; i < ldb; ++i) {
 	    b1[i+j*ldb] = b[i+j*ldb];
 	    b2[i+j*ldb] = b[i+j*ldb];
+	    b3[i+j*ldb] = b[i+j*ldb];
         }
     }	    
 
@@ -267,6 +273,55 @@ int main(int argc, char *argv[])
     
     PStatPrint(&options, &stat, &grid);        /* Print the statistics. */
 
+    /* ------------------------------------------------------------
+       4. SOLVE THE SYSTEM WITH A + u*v^T, WITH THE RANK-1 UPDATE
+       ATTACHED TO THE EXISTING FACTORIZATION OF A, WITHOUT
+       REFACTORIZATION.
+       ------------------------------------------------------------*/
+    PStatClear(&stat); /* clear the statistics variables. */
+
+    if ( !(u = doublecomplexMalloc_dist(2 * ldb)) )
+        ABORT("Malloc fails for u[]");
+    v = u + ldb;
+    for (i = 0; i < m_loc; ++i) {
+	u[i].r = 1.0; u[i].i = 0.0;
+	v[i].r = 1.0 / n; v[i].i = 0.0;
+    }
+    lrinfo = pzgsupdate_lowrank(&options, 1, u, ldb, v, ldb, &A,
+				&ScalePermstruct, &LUstruct, &grid, &stat,
+				&info);
+
+    /* Set up the right-hand sides (A + u*v^T) * xtrue. */
+    for (j = 0; j < nrhs; ++j) {
+	vx.r = vx.i = 0.0;
+	for (i = 0; i < m_loc; ++i) {
+	    vx.r += v[i].r * xtrue[i+j*ldx].r - v[i].i * xtrue[i+j*ldx].i;
+	    vx.i += v[i].r * xtrue[i+j*ldx].i + v[i].i * xtrue[i+j*ldx].r;
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &vx, 2, MPI_DOUBLE, MPI_SUM, grid.comm);
+	for (i = 0; i < m_loc; ++i) {
+	    b3[i+j*ldb].r += u[i].r * vx.r - u[i].i * vx.i;
+	    b3[i+j*ldb].i += u[i].r * vx.i + u[i].i * vx.r;
+	}
+    }
+
+    pzgssvx_lowrank(&options, &A, &ScalePermstruct, b3, ldb, nrhs, &grid,
+		    &LUstruct, &SOLVEstruct, berr, &stat, &info);
+
+    if ( info || lrinfo ) {  /* Something is wrong */
+        if ( iam==0 ) {
+	    printf("ERROR: INFO = %d, %d returned from pzgssvx_lowrank()\n",
+		   info, lrinfo);
+	    fflush(stdout);
+	}
+    } else {
+        /* Check the accuracy of the solution. */
+        if ( !iam ) printf("\tSolve the system with a rank-1 update of A:\n");
+        pzinf_norm_error(iam, m_loc, nrhs, b3, ldb, xtrue, ldx, grid.comm);
+    }
+
+    PStatPrint(&options, &stat, &grid);        /* Print the statistics. */
+
     /* ------------------------------------------------------------
        DEALLOCATE STORAGE.
        ------------------------------------------------------------*/
@@ -281,6 +336,8 @@ int main(int argc, char *argv[])
     SUPERLU_FREE(b);
     SUPERLU_FREE(b1);
     SUPERLU_FREE(b2);
+    SUPERLU_FREE(b3);
+    SUPERLU_FREE(u);
     SUPERLU_FREE(xtrue);
     SUPERLU_FREE(berr);
     fclose(fp);
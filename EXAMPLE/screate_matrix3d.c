@@ -359,6 +359,28 @@ int screate_batch_systems(handle_t *SparseMatrix_handles, int batchCount,
 
         printf("Time to read and distribute matrix %.2f\n",
                SuperLU_timer_() - t);  fflush(stdout);
+
+        /* Broadcast matrix A to the other PEs. */
+        MPI_Bcast( &m,     1,   mpi_int_t,  0, grid3d->comm );
+        MPI_Bcast( &n,     1,   mpi_int_t,  0, grid3d->comm );
+        MPI_Bcast( &nnz,   1,   mpi_int_t,  0, grid3d->comm );
+        MPI_Bcast( nzval,  nnz, MPI_FLOAT, 0, grid3d->comm );
+        MPI_Bcast( rowind, nnz, mpi_int_t,  0, grid3d->comm );
+        MPI_Bcast( colptr, n + 1, mpi_int_t,  0, grid3d->comm );
+    }
+    else
+    {
+        /* Receive matrix A from PE 0. */
+        MPI_Bcast( &m,   1,   mpi_int_t,  0, grid3d->comm );
+        MPI_Bcast( &n,   1,   mpi_int_t,  0, grid3d->comm );
+        MPI_Bcast( &nnz, 1,   mpi_int_t,  0, grid3d->comm );
+
+        /* Allocate storage for compressed column representation. */
+        sallocateA_dist(n, nnz, &nzval, &rowind, &colptr);
+
+        MPI_Bcast( nzval,   nnz, MPI_FLOAT, 0, grid3d->comm );
+        MPI_Bcast( rowind,  nnz, mpi_int_t,  0, grid3d->comm );
+        MPI_Bcast( colptr,  n + 1, mpi_int_t,  0, grid3d->comm );
     }
 	
     /* Allocate storage for CSC containing all the matrices */
@@ -43,14 +43,17 @@ integer, parameter, public :: &
                       LargeDiag_MC64          = 1, &
                       LargeDiag_HWPM          = 2, &
                       MY_PERMR                = 3, &
+                      LargeDiag_AUCTION       = 4, &
                       NATURAL                 = 0, & ! colperm_t
                       MMD_ATA                 = 1, &
                       MMD_AT_PLUS_A           = 2, &
                       COLAMD                  = 3, &
                       METIS_AT_PLUS_A         = 4, &
                       PARMETIS                = 5, &
-                      ZOLTAN                  = 6, &
-                      MY_PERMC                = 7, &
+                      METIS_ATA               = 6, &
+                      ZOLTAN                  = 7, &
+                      MY_PERMC                = 8, &
+                      ND_AT_PLUS_A            = 9, &
                       NOTRANS                 = 0, & ! trans_t
                       TRANS                   = 1, &
                       CONJ                    = 2, &
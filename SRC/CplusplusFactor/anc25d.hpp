@@ -28,9 +28,11 @@ struct anc25d_t
         commSizes = (int *)SUPERLU_MALLOC(sizeof(int) * (maxLvl - 1));
         for (int i = 0; i < maxLvl - 1; i++)
         {
-            commSizes[i] = 1 << (i + 1);
-            myranks[i] = myGrid % (commSizes[i]);
-           
+            /* the last group is smaller when Np is not a power of two */
+            int lvlCommSize = 1 << (i + 1);
+            int lvlCommBase = (myGrid / lvlCommSize) * lvlCommSize;
+            commSizes[i] = SUPERLU_MIN(lvlCommSize, grid3d->zscp.Np - lvlCommBase);
+            myranks[i] = myGrid - lvlCommBase;
         }
     }
 
@@ -126,6 +126,9 @@ int_t xLUstruct_t<Ftype>::dsparseTreeFactor(
             
         }
 
+        /* reduce the ancestor panels landed from the other grid meanwhile */
+        ancestorReductionProgress(0);
+
         k1 = k1+winSize;
         for (int_t k0_next = k1; k0_next < SUPERLU_MIN(nnodes, k1+winSize); ++k0_next)
         {
@@ -27,6 +27,11 @@ int_t LUstruct_v100::ancestorReduction3dGPU(int_t ilvl, int_t *myNodeCount,
         receiver = myGrid - (1 << ilvl);
     }
 
+    /* When Np is not a power of two, the last grids have no partner at
+       the upper levels; see log2i() */
+    if (sender >= grid3d->zscp.Np)
+        return 0;
+
     /*Reduce all the ancestors*/
     for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
     {
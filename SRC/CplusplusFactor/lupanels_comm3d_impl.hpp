@@ -5,6 +5,18 @@
 #include "luAuxStructTemplated.hpp"
 #include "superlu_blas.hpp"
 
+/* The ancestor reduction along Z is non-blocking.
+   The sender posts an MPI_Isend for every L and U panel of the ancestors.
+   The receiver queues the panels and keeps options->num_lookaheads of them
+   in flight in redRecvBufs[]; each panel is reduced as soon as it lands,
+   and its slot is refilled with the next one of the queue.
+   Only the panels of the next level, which are factored next, are waited
+   for. The higher ancestors keep landing while that level is factored,
+   see ancestorReductionProgress() in dsparseTreeFactor(), and are
+   completed before this grid sends them on or the factorization ends.
+   A panel may thus be reduced after some Schur updates of the next level
+   rather than before them; the sums are the same, so the factors agree
+   with those of the blocking reduction up to rounding. */
 template <typename Ftype>
 int_t xLUstruct_t<Ftype>::ancestorReduction3d(int_t ilvl, int_t *myNodeCount,
                                          int_t **treePerm)
@@ -24,17 +36,28 @@ int_t xLUstruct_t<Ftype>::ancestorReduction3d(int_t ilvl, int_t *myNodeCount,
         receiver = myGrid - (1 << ilvl);
     }
 
+    double treduce = SuperLU_timer_();
+
+    /* The ancestors received at the previous level must be complete */
+    ancestorReductionWait();
+
+    /* When Np is not a power of two, the last grids have no partner at
+       the upper levels; see log2i() */
+    if (sender >= grid3d->zscp.Np)
+    {
+        SCT->ancsReduce += SuperLU_timer_() - treduce;
+        return 0;
+    }
+
     /*Reduce all the ancestors*/
+    size_t nextLevelItems = 0;
     for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
     {
         /* code */
         // int_t atree = myTreeIdxs[alvl];
         int_t numNodes = myNodeCount[alvl];
         int_t *nodeList = treePerm[alvl];
-        double treduce = SuperLU_timer_();
-        
 
-        /*first setting the L blocks to zero*/
         for (int_t node = 0; node < numNodes; ++node) /* for each block column ... */
         {
             int_t k0 = nodeList[node];
@@ -52,9 +75,19 @@ int_t xLUstruct_t<Ftype>::ancestorReduction3d(int_t ilvl, int_t *myNodeCount,
                 zRecvUPanel(k0, sender, alpha, beta);
             }
         }
-        // return 0;
-        SCT->ancsReduce += SuperLU_timer_() - treduce;
+        if (alvl == ilvl + 1)
+            nextLevelItems = redQueue.size();
+    }
+
+    if (myGrid == sender)
+    {
+        MPI_Waitall(redSendReqs.size(), redSendReqs.data(), MPI_STATUSES_IGNORE);
+        redSendReqs.clear();
     }
+    else
+        ancestorReductionProgress(nextLevelItems);
+
+    SCT->ancsReduce += SuperLU_timer_() - treduce;
     return 0;
 }
 
@@ -67,14 +100,18 @@ int_t xLUstruct_t<Ftype>::zSendLPanel(int_t k0, int_t receiverGrid)
 		int_t lk = g2lCol(k0);
         if (!lPanelVec[lk].isEmpty())
 		{
-            MPI_Send(lPanelVec[lk].blkPtr(0), lPanelVec[lk].nzvalSize(), 
-                    get_mpi_type<Ftype>(), receiverGrid, k0, grid3d->zscp.comm);
+            MPI_Request req;
+            MPI_Isend(lPanelVec[lk].blkPtr(0), lPanelVec[lk].nzvalSize(),
+                    get_mpi_type<Ftype>(), receiverGrid, k0, grid3d->zscp.comm,
+                    &req);
+            redSendReqs.push_back(req);
 			SCT->commVolRed += lPanelVec[lk].nzvalSize() * sizeof(Ftype);
 		}
 	}
 	return 0;
 }
 
+/* Queue the L panel of k0 for reduction; see ancestorReductionProgress() */
 template <typename Ftype>
 int_t xLUstruct_t<Ftype>::zRecvLPanel(int_t k0, int_t senderGrid, Ftype alpha, Ftype beta)
 {
@@ -83,14 +120,11 @@ int_t xLUstruct_t<Ftype>::zRecvLPanel(int_t k0, int_t senderGrid, Ftype alpha, F
 		int_t lk = g2lCol(k0);
         if (!lPanelVec[lk].isEmpty())
 		{
-            
-            MPI_Status status;
-			MPI_Recv(LvalRecvBufs[0], lPanelVec[lk].nzvalSize(), get_mpi_type<Ftype>(), senderGrid, k0,
-					 grid3d->zscp.comm, &status);
-
-			/*reduce the updates*/
-			superlu_scal<Ftype>(lPanelVec[lk].nzvalSize(), alpha, lPanelVec[lk].blkPtr(0), 1);
-			superlu_axpy<Ftype>(lPanelVec[lk].nzvalSize(), beta, LvalRecvBufs[0], 1, lPanelVec[lk].blkPtr(0), 1);
+            redSender = senderGrid;
+            redAlpha = alpha;
+            redBeta = beta;
+            redQueue.push_back(2 * k0);
+            redItemDone.push_back(0);
 		}
 	}
 	return 0;
@@ -105,14 +139,18 @@ int_t xLUstruct_t<Ftype>::zSendUPanel(int_t k0, int_t receiverGrid)
 		int_t lk = g2lRow(k0);
         if (!uPanelVec[lk].isEmpty())
 		{
-            MPI_Send(uPanelVec[lk].blkPtr(0), uPanelVec[lk].nzvalSize(), 
-                    get_mpi_type<Ftype>(), receiverGrid, k0, grid3d->zscp.comm);
+            MPI_Request req;
+            MPI_Isend(uPanelVec[lk].blkPtr(0), uPanelVec[lk].nzvalSize(),
+                    get_mpi_type<Ftype>(), receiverGrid, k0, grid3d->zscp.comm,
+                    &req);
+            redSendReqs.push_back(req);
 			SCT->commVolRed += uPanelVec[lk].nzvalSize() * sizeof(Ftype);
 		}
 	}
 	return 0;
 }
 
+/* Queue the U panel of k0 for reduction; see ancestorReductionProgress() */
 template <typename Ftype>
 int_t xLUstruct_t<Ftype>::zRecvUPanel(int_t k0, int_t senderGrid, Ftype alpha, Ftype beta)
 {
@@ -121,17 +159,99 @@ int_t xLUstruct_t<Ftype>::zRecvUPanel(int_t k0, int_t senderGrid, Ftype alpha, F
 		int_t lk = g2lRow(k0);
         if (!uPanelVec[lk].isEmpty())
 		{
-
-            MPI_Status status;
-			MPI_Recv(UvalRecvBufs[0], uPanelVec[lk].nzvalSize(), get_mpi_type<Ftype>(), senderGrid, k0,
-					 grid3d->zscp.comm, &status);
-
-			/*reduce the updates*/
-			superlu_scal<Ftype>(uPanelVec[lk].nzvalSize(), alpha, uPanelVec[lk].blkPtr(0), 1);
-			superlu_axpy<Ftype>(uPanelVec[lk].nzvalSize(), beta, UvalRecvBufs[0], 1, uPanelVec[lk].blkPtr(0), 1);
+            redSender = senderGrid;
+            redAlpha = alpha;
+            redBeta = beta;
+            redQueue.push_back(2 * k0 + 1);
+            redItemDone.push_back(0);
 		}
 	}
 	return 0;
 }
 
+/* Reduce the queued panels that have landed and refill the receive window.
+   Blocks until the first upto panels of the queue are reduced; with
+   upto = 0, only the panels already landed are reduced.
+   The L and U panels of a supernode share the tag k0, and they are
+   received in the order they are sent, which MPI keeps between two
+   processes. */
+template <typename Ftype>
+int_t xLUstruct_t<Ftype>::ancestorReductionProgress(size_t upto)
+{
+    if (redQueue.empty())
+        return 0;
+
+    if (redRecvBufs.empty())
+    {
+        int nslots = SUPERLU_MAX(options->num_lookaheads, 1);
+        int_t maxValCount = SUPERLU_MAX(maxLvalCount, maxUvalCount);
+        redRecvBufs.resize(nslots);
+        redRecvReqs.assign(nslots, MPI_REQUEST_NULL);
+        redSlotItem.resize(nslots);
+        for (int s = 0; s < nslots; s++)
+            redRecvBufs[s] = (Ftype *)SUPERLU_MALLOC(sizeof(Ftype) * maxValCount);
+    }
+    int nslots = redRecvReqs.size();
+
+    while (1)
+    {
+        /* keep the window full */
+        for (int s = 0; s < nslots && redNextPost < redQueue.size(); s++)
+        {
+            if (redRecvReqs[s] != MPI_REQUEST_NULL)
+                continue;
+            int_t k0 = redQueue[redNextPost] / 2;
+            int_t count = (redQueue[redNextPost] % 2)
+                              ? uPanelVec[g2lRow(k0)].nzvalSize()
+                              : lPanelVec[g2lCol(k0)].nzvalSize();
+            MPI_Irecv(redRecvBufs[s], count, get_mpi_type<Ftype>(), redSender,
+                      k0, grid3d->zscp.comm, &redRecvReqs[s]);
+            redSlotItem[s] = redNextPost++;
+        }
+
+        while (redFirstNotDone < redQueue.size() && redItemDone[redFirstNotDone])
+            redFirstNotDone++;
+        if (redFirstNotDone == redQueue.size())
+        {
+            redQueue.clear();
+            redItemDone.clear();
+            redNextPost = redFirstNotDone = 0;
+            break;
+        }
+
+        int s, flag = 1;
+        if (redFirstNotDone < upto)
+            MPI_Waitany(nslots, redRecvReqs.data(), &s, MPI_STATUS_IGNORE);
+        else
+            MPI_Testany(nslots, redRecvReqs.data(), &s, &flag, MPI_STATUS_IGNORE);
+        if (!flag || s == MPI_UNDEFINED)
+            break;
 
+        /*reduce the updates*/
+        size_t item = redSlotItem[s];
+        int_t k0 = redQueue[item] / 2;
+        Ftype *val;
+        int_t count;
+        if (redQueue[item] % 2)
+        {
+            val = uPanelVec[g2lRow(k0)].blkPtr(0);
+            count = uPanelVec[g2lRow(k0)].nzvalSize();
+        }
+        else
+        {
+            val = lPanelVec[g2lCol(k0)].blkPtr(0);
+            count = lPanelVec[g2lCol(k0)].nzvalSize();
+        }
+        superlu_scal<Ftype>(count, redAlpha, val, 1);
+        superlu_axpy<Ftype>(count, redBeta, redRecvBufs[s], 1, val, 1);
+        redItemDone[item] = 1;
+    }
+    return 0;
+}
+
+/* Complete the reduction of all the queued panels */
+template <typename Ftype>
+int_t xLUstruct_t<Ftype>::ancestorReductionWait()
+{
+    return ancestorReductionProgress(redQueue.size());
+}
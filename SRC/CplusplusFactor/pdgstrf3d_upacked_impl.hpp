@@ -343,6 +343,7 @@ int_t xLUstruct_t<Ftype>::pdgstrf3d()
                                                  : SCT->NetSchurUpTimer - SCT->tSchCompUdt3d[ilvl - 1];
         } /*for (int_t ilvl = 0; ilvl < maxLvl; ++ilvl)*/
 
+        ancestorReductionWait();
         MPI_Barrier(grid3d->comm);
         SCT->pdgstrfTimer = SuperLU_timer_() - SCT->pdgstrfTimer;
 
@@ -382,6 +382,17 @@ struct xLUstruct_t
     std::vector<int_t *> LidxRecvBufs;
     std::vector<int_t *> UidxRecvBufs;
 
+    // non-blocking ancestor reduction along Z, see lupanels_comm3d_impl.hpp
+    std::vector<Ftype *> redRecvBufs;     /* window of receive buffers */
+    std::vector<MPI_Request> redRecvReqs; /* one per window slot */
+    std::vector<size_t> redSlotItem;      /* queue item received in a slot */
+    std::vector<int_t> redQueue;          /* panels to receive: 2*k0 (+1 for U) */
+    std::vector<char> redItemDone;
+    size_t redNextPost = 0, redFirstNotDone = 0;
+    std::vector<MPI_Request> redSendReqs;
+    int redSender = -1;
+    Ftype redAlpha, redBeta;
+
     // send and recv count for 2d comm
     std::vector<int_t> LvalSendCounts;
     std::vector<int_t> UvalSendCounts;
@@ -486,6 +497,9 @@ struct xLUstruct_t
         for (i = 0; i < numDiagBufs; i++)
             SUPERLU_FREE(diagFactBufs[i]);
 
+        for (i = 0; i < (int) redRecvBufs.size(); i++)
+            SUPERLU_FREE(redRecvBufs[i]);
+
         /* Sherry added the following, which comes from batch setup */
         superlu_acc_offload = sp_ienv_dist(10, options); //get_acc_offload();
         if (superlu_acc_offload)
@@ -571,6 +585,8 @@ struct xLUstruct_t
     int_t zRecvLPanel(int_t k0, int_t senderGrid, Ftype alpha, Ftype beta);
     int_t zSendUPanel(int_t k0, int_t receiverGrid);
     int_t zRecvUPanel(int_t k0, int_t senderGrid, Ftype alpha, Ftype beta);
+    int_t ancestorReductionProgress(size_t upto);
+    int_t ancestorReductionWait();
 
     int_t dAncestorFactorBaseline(
         int_t alvl,
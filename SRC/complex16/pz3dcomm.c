@@ -330,6 +330,282 @@ int_t zzRecvUPanel(int_t k, int_t sender, doublecomplex alpha, doublecomplex bet
 }
 
 
+/* Sparse-aware reduction of the ancestor panels.
+   The ancestors of a grid that is not their owner are zeroed by
+   zzeroSetLU() before its subtrees are factored, so a block of such a
+   panel that is still zero was not touched by the Schur complement
+   updates. The sender sends the positions of the touched blocks in the
+   panel, blk_buf[0] = count and blk_buf[1:count], followed by their values
+   back to back; when all the blocks are touched, the panel is sent as is.
+   The receiver adds them to its own panel. */
+int_t zzSendLPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+                          doublecomplex* val_buf, zLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    zLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t mycol = MYCOL (iam, grid);
+
+    if (mycol == PCOL( k, grid ))
+	{
+	    int_t lk = LBj( k, grid ); /* Local block number */
+	    int_t* lsub = Llu->Lrowind_bc_ptr[lk];
+	    doublecomplex* lnzval = Llu->Lnzval_bc_ptr[lk];
+
+	    if (lsub != NULL)
+		{
+		    int_t nlb = lsub[0];
+		    int_t nsupr = lsub[1];   /* LDA of the nzval[] */
+		    int_t nsupc = SuperSize(k);
+		    int_t lptr = BC_HEADER, luptr = 0, nblk = 0, nval = 0;
+
+		    for (int_t lb = 0; lb < nlb; ++lb)
+			{
+			    int_t nbrow = lsub[lptr + 1];
+			    int_t touched = 0;
+			    for (int_t j = 0; j < nsupc && !touched; ++j)
+				for (int_t i = 0; i < nbrow; ++i)
+				    if (lnzval[luptr + j * nsupr + i].r != 0.0
+					|| lnzval[luptr + j * nsupr + i].i != 0.0)
+					{
+					    touched = 1;
+					    break;
+					}
+			    if (touched) blk_buf[++nblk] = lb;
+			    lptr += LB_DESCRIPTOR + nbrow;
+			    luptr += nbrow;
+			}
+		    blk_buf[0] = nblk;
+		    MPI_Send(blk_buf, nblk + 1, mpi_int_t, receiver, k,
+			     grid3d->zscp.comm);
+
+		    if (nblk == nlb)
+			{
+			    nval = nsupc * nsupr;
+			    MPI_Send(lnzval, nval, SuperLU_MPI_DOUBLE_COMPLEX, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    else if (nblk)
+			{
+			    lptr = BC_HEADER;
+			    luptr = 0;
+			    for (int_t lb = 0, ib = 1; ib <= nblk; ++lb)
+				{
+				    int_t nbrow = lsub[lptr + 1];
+				    if (lb == blk_buf[ib])
+					{
+					    for (int_t j = 0; j < nsupc; ++j)
+						for (int_t i = 0; i < nbrow; ++i)
+						    val_buf[nval++] = lnzval[luptr + j * nsupr + i];
+					    ++ib;
+					}
+				    lptr += LB_DESCRIPTOR + nbrow;
+				    luptr += nbrow;
+				}
+			    MPI_Send(val_buf, nval, SuperLU_MPI_DOUBLE_COMPLEX, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    SCT->commVolRed += (nblk + 1) * sizeof(int_t)
+			+ nval * sizeof(doublecomplex);
+		}
+	}
+    return 0;
+}
+
+
+int_t zzRecvLPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+                          doublecomplex* Lval_buf, zLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    doublecomplex one = {1.0, 0.0};
+    zLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t mycol = MYCOL (iam, grid);
+
+    if (mycol == PCOL( k, grid ))
+	{
+	    int_t lk = LBj( k, grid ); /* Local block number */
+	    int_t* lsub = Llu->Lrowind_bc_ptr[lk];
+	    doublecomplex* lnzval = Llu->Lnzval_bc_ptr[lk];
+
+	    if (lsub != NULL)
+		{
+		    int_t nlb = lsub[0];
+		    int_t nsupr = lsub[1];   /* LDA of the nzval[] */
+		    int_t nsupc = SuperSize(k);
+		    int_t len2 = nsupc * nsupr;
+		    MPI_Status status;
+
+		    MPI_Recv(blk_buf, nlb + 1, mpi_int_t, sender, k,
+			     grid3d->zscp.comm, &status);
+		    int_t nblk = blk_buf[0];
+		    if (nblk == 0) return 0;
+
+		    MPI_Recv(Lval_buf, len2, SuperLU_MPI_DOUBLE_COMPLEX, sender, k,
+			     grid3d->zscp.comm, &status);
+
+		    /*reduce the updates*/
+		    if (nblk == nlb)
+			{
+			    superlu_zaxpy(len2, one, Lval_buf, 1, lnzval, 1);
+			    return 0;
+			}
+		    int_t lptr = BC_HEADER, luptr = 0, nval = 0;
+		    for (int_t lb = 0, ib = 1; ib <= nblk; ++lb)
+			{
+			    int_t nbrow = lsub[lptr + 1];
+			    if (lb == blk_buf[ib])
+				{
+				    for (int_t j = 0; j < nsupc; ++j)
+					for (int_t i = 0; i < nbrow; ++i, ++nval)
+					    z_add(&lnzval[luptr + j * nsupr + i],
+						  &lnzval[luptr + j * nsupr + i], &Lval_buf[nval]);
+				    ++ib;
+				}
+			    lptr += LB_DESCRIPTOR + nbrow;
+			    luptr += nbrow;
+			}
+		}
+	}
+    return 0;
+}
+
+
+int_t zzSendUPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+                          doublecomplex* val_buf, zLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    zLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t myrow = MYROW (iam, grid);
+
+    if (myrow == PROW( k, grid ))
+	{
+	    int_t lk = LBi( k, grid ); /* Local block number */
+	    int_t* usub = Llu->Ufstnz_br_ptr[lk];
+	    doublecomplex* unzval = Llu->Unzval_br_ptr[lk];
+
+	    if (usub != NULL)
+		{
+		    int_t nub = usub[0];
+		    int_t iukp = BR_HEADER, rukp = 0, nblk = 0, nval = 0;
+
+		    for (int_t ub = 0; ub < nub; ++ub)
+			{
+			    int_t gb = usub[iukp];
+			    int_t len = usub[iukp + 1]; /* nonzeros of the block */
+			    for (int_t i = 0; i < len; ++i)
+				if (unzval[rukp + i].r != 0.0 || unzval[rukp + i].i != 0.0)
+				    {
+					blk_buf[++nblk] = ub;
+					break;
+				    }
+			    iukp += UB_DESCRIPTOR + SuperSize(gb);
+			    rukp += len;
+			}
+		    blk_buf[0] = nblk;
+		    MPI_Send(blk_buf, nblk + 1, mpi_int_t, receiver, k,
+			     grid3d->zscp.comm);
+
+		    if (nblk == nub)
+			{
+			    nval = usub[1];
+			    MPI_Send(unzval, nval, SuperLU_MPI_DOUBLE_COMPLEX, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    else if (nblk)
+			{
+			    iukp = BR_HEADER;
+			    rukp = 0;
+			    for (int_t ub = 0, ib = 1; ib <= nblk; ++ub)
+				{
+				    int_t gb = usub[iukp];
+				    int_t len = usub[iukp + 1];
+				    if (ub == blk_buf[ib])
+					{
+					    memcpy(&val_buf[nval], &unzval[rukp],
+						   len * sizeof(doublecomplex));
+					    nval += len;
+					    ++ib;
+					}
+				    iukp += UB_DESCRIPTOR + SuperSize(gb);
+				    rukp += len;
+				}
+			    MPI_Send(val_buf, nval, SuperLU_MPI_DOUBLE_COMPLEX, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    SCT->commVolRed += (nblk + 1) * sizeof(int_t)
+			+ nval * sizeof(doublecomplex);
+		}
+	}
+    return 0;
+}
+
+
+int_t zzRecvUPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+                          doublecomplex* Uval_buf, zLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    doublecomplex one = {1.0, 0.0};
+    zLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t myrow = MYROW (iam, grid);
+
+    if (myrow == PROW( k, grid ))
+	{
+	    int_t lk = LBi( k, grid ); /* Local block number */
+	    int_t* usub = Llu->Ufstnz_br_ptr[lk];
+	    doublecomplex* unzval = Llu->Unzval_br_ptr[lk];
+
+	    if (usub != NULL)
+		{
+		    int_t nub = usub[0];
+		    int_t lenv = usub[1];
+		    MPI_Status status;
+
+		    MPI_Recv(blk_buf, nub + 1, mpi_int_t, sender, k,
+			     grid3d->zscp.comm, &status);
+		    int_t nblk = blk_buf[0];
+		    if (nblk == 0) return 0;
+
+		    MPI_Recv(Uval_buf, lenv, SuperLU_MPI_DOUBLE_COMPLEX, sender, k,
+			     grid3d->zscp.comm, &status);
+
+		    /*reduce the updates*/
+		    if (nblk == nub)
+			{
+			    superlu_zaxpy(lenv, one, Uval_buf, 1, unzval, 1);
+			    return 0;
+			}
+		    int_t iukp = BR_HEADER, rukp = 0, nval = 0;
+		    for (int_t ub = 0, ib = 1; ib <= nblk; ++ub)
+			{
+			    int_t gb = usub[iukp];
+			    int_t len = usub[iukp + 1];
+			    if (ub == blk_buf[ib])
+				{
+				    superlu_zaxpy(len, one, &Uval_buf[nval], 1,
+						  &unzval[rukp], 1);
+				    nval += len;
+				    ++ib;
+				}
+			    iukp += UB_DESCRIPTOR + SuperSize(gb);
+			    rukp += len;
+			}
+		}
+	}
+    return 0;
+}
+
+
 int_t zp3dScatter(int_t n, zLUstruct_t * LUstruct, gridinfo3d_t* grid3d, int *supernodeMask)
 /* Copies LU structure from layer 0 to all the layers */
 {
@@ -962,27 +1238,29 @@ int_t zzeroSetLU(int_t nnodes, int_t* nodeList, zLUstruct_t *LUstruct,
 
 int_t zreduceAncestors3d(int_t sender, int_t receiver,
                         int_t nnodes, int_t* nodeList,
-                        doublecomplex* Lval_buf, doublecomplex* Uval_buf,
+                        zLUValSubBuf_t* LUvsb,
                         zLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT)
 {
-    doublecomplex alpha = {1.0, 0.0}, beta = {1.0, 0.0};
     int_t myGrid = grid3d->zscp.Iam;
 
-    /*first setting the L blocks to zero*/
+    /* Only the blocks touched by the sender's subtrees are sent, see
+       zzSendLPanelTouched(); the buffers of LUvsb are free on both sides. */
     for (int_t node = 0; node < nnodes; ++node)   /* for each block column ... */
 	{
 	    int_t jb = nodeList[node];
 
 	    if (myGrid == sender)
 		{
-		    zzSendLPanel(jb, receiver, LUstruct,  grid3d, SCT);
-		    zzSendUPanel(jb, receiver, LUstruct,  grid3d, SCT);
+		    zzSendLPanelTouched(jb, receiver, LUvsb->Lsub_buf,
+					LUvsb->Lval_buf, LUstruct, grid3d, SCT);
+		    zzSendUPanelTouched(jb, receiver, LUvsb->Usub_buf,
+					LUvsb->Uval_buf, LUstruct, grid3d, SCT);
 		}
 	    else {
-	        zzRecvLPanel(jb, sender, alpha, beta, Lval_buf,
-                                LUstruct, grid3d, SCT);
-		zzRecvUPanel(jb, sender, alpha, beta, Uval_buf,
-                                LUstruct,  grid3d, SCT);
+	        zzRecvLPanelTouched(jb, sender, LUvsb->Lsub_buf,
+				    LUvsb->Lval_buf, LUstruct, grid3d, SCT);
+		zzRecvUPanelTouched(jb, sender, LUvsb->Usub_buf,
+				    LUvsb->Uval_buf, LUstruct, grid3d, SCT);
 	    }
 
 	}
@@ -1046,8 +1324,6 @@ int zreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
                              zLUValSubBuf_t* LUvsb, zLUstruct_t* LUstruct,
                              gridinfo3d_t* grid3d, SCT_t* SCT )
 {
-    doublecomplex * Lval_buf  = LUvsb->Lval_buf;
-    doublecomplex * Uval_buf  = LUvsb->Uval_buf;
     int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
 
@@ -1063,6 +1339,10 @@ int zreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 	    receiver = myGrid - (1 << ilvl);
 	}
 
+    /* When Np is not a power of two, the last grids have no partner at
+       the upper levels; see log2i() */
+    if (sender >= grid3d->zscp.Np) return 0;
+
     /*Reduce all the ancestors*/
     for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
@@ -1072,7 +1352,7 @@ int zreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 	    int_t* cAncestorList = treePerm[alvl];
 	    double treduce = SuperLU_timer_();
 	    zreduceAncestors3d(sender, receiver, nsAncestor, cAncestorList,
-			        Lval_buf, Uval_buf, LUstruct, grid3d, SCT);
+			        LUvsb, LUstruct, grid3d, SCT);
 	    SCT->ancsReduce += SuperLU_timer_() - treduce;
 
 	}
@@ -1110,6 +1390,7 @@ int_t zgatherAllFactoredLU( ztrf3Dpartition_t*  trf3Dpartition,
 			    sender = myGrid;
 			    receiver = myGrid - (1 << ilvl);
 			}
+		    if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
 
 		    for (int_t alvl = 0; alvl <= ilvl; alvl++)
 			{
@@ -1171,6 +1452,7 @@ int_t zbroadcastAncestor3d( ztrf3Dpartition_t*  trf3Dpartition,
 				sender = myGrid - (1 << (ilvl-1));
 				receiver = myGrid ;
 			}
+			if (receiver >= grid3d->zscp.Np) continue; /* no partner grid */
 			int_t tr =  tree;
 			for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
 			{
@@ -1214,6 +1496,7 @@ int_t zgatherAllFactoredLU3d( ztrf3Dpartition_t*  trf3Dpartition,
 		{
 			int sender = (1 << (ilvl )) * ( tr - start );
 			int receiver =0;
+			if (sender >= grid3d->zscp.Np) continue; /* no such grid */
 			//printf("tr = %d, sender %d, receiver %d\n", tr, sender, receiver);
 			if(myGrid == sender || myGrid == receiver)
 			zgatherFactoredLU(sender, receiver,
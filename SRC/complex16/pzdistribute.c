@@ -498,6 +498,7 @@ pzdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
     int_t  ik, il, lk, rel, knsupc, idx_r;
     int_t  lptr1_tmp, idx_i, idx_v,m, uu;
     int_t nub;
+    int   *refact_mask; /* supernodes to reload, NULL: all */
     int tag;
 
 #if ( PRNTlevel>=1 )
@@ -544,6 +545,9 @@ pzdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 #endif
 	/* We can propagate the new values of A into the existing
 	   L and U data structures.            */
+	/* With a refactorization mask, only the blocks of the marked
+	   supernodes are reloaded; L(:,jb) and U(gb,:) are kept otherwise. */
+	refact_mask = Llu->refact_mask;
 	ilsum = Llu->ilsum;
 	ldaspa = Llu->ldalsum;
 	if ( !(dense = doublecomplexCalloc_dist(ldaspa * sp_ienv_dist(3, options))) )
@@ -570,7 +574,7 @@ pzdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 	for (lb = 0; lb < nrbu; ++lb) {
 	    Urb_indptr[lb] = BR_HEADER; /* Skip header in U index[]. */
 	    index = Ufstnz_br_ptr[lb];
-	    if ( index ) {
+	    if ( index && (!refact_mask || refact_mask[lb*grid->nprow+myrow]) ) {
 		uval = Unzval_br_ptr[lb];
 		len = index[1];
 		for (i = 0; i < len; ++i) uval[i] = zero;
@@ -579,6 +583,7 @@ pzdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 
 	for (jb = 0; jb < nsupers; ++jb) { /* Loop through each block column */
 	    pc = PCOL( jb, grid );
+	    if ( refact_mask && !refact_mask[jb] ) continue;
 	    if ( mycol == pc ) { /* Block column jb in my process column */
 		fsupc = FstBlockC( jb );
 		nsupc = SuperSize( jb );
@@ -591,6 +596,7 @@ pzdistribute(superlu_dist_options_t *options, int_t n, SuperMatrix *A,
 			if ( myrow == PROW( gb, grid ) ) {
 			    lb = LBi( gb, grid );
  			    if ( gb < jb ) { /* in U */
+				if ( refact_mask && !refact_mask[gb] ) continue;
  				index = Ufstnz_br_ptr[lb];
  				uval = Unzval_br_ptr[lb];
  				while (  (k = index[Urb_indptr[lb]]) < jb ) {
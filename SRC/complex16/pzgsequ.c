@@ -242,3 +242,164 @@ pzgsequ(SuperMatrix *A, double *r, double *c, double *rowcnd,
     return;
 
 } /* pzgsequ */
+
+/*! \brief
+
+ <pre>
+    Purpose
+    =======
+
+    PZGSEQU_RUIZ computes row and column scalings of a square matrix A by
+    the iterative method of Ruiz: at each step the rows and the columns
+    of B(i,j) = R(i)*A(i,j)*C(j) are divided by the square roots of their
+    largest values of |Re| + |Im|, until these are all within TOL of 1 or
+    MAXIT steps are done. Unlike PZGSEQU, no array of the size of A is
+    reduced over all the processes: the column maxima are exchanged only
+    between the processes sharing columns (see pxgsequ_colmax), and R and
+    C are gathered once at the end.
+
+    Arguments
+    =========
+
+    A       (input) SuperMatrix*
+            The matrix of dimension (A->nrow, A->ncol), A->nrow = A->ncol.
+            Stype = SLU_NR_loc; Dtype = SLU_Z; Mtype = SLU_GE.
+
+    R       (input/output) double*, size A->nrow
+    C       (input/output) double*, size A->ncol
+            On entry, if WARM = YES, the scale factors to start from,
+            e.g. those of a previous matrix with the same pattern.
+            On exit, the row and column scale factors if INFO = 0,
+            ones if INFO > 0.
+
+    WARM    (input) yes_no_t
+            Whether to start from R and C rather than from the identity.
+
+    MAXIT   (input) int
+            The maximum number of scaling steps.
+
+    TOL     (input) double
+            The tolerance on the largest absolute values of the rows and
+            columns of B.
+
+    INFO    (output) int*
+            = 0:  successful exit
+            < 0:  if INFO = -i, the i-th argument had an illegal value
+            > 0:  if INFO = i,  and i is
+                  <= M:  the i-th row of A is exactly zero
+                  >  M:  the (i-M)-th column of A is exactly zero
+
+    GRID    (input) gridinfo_t*
+            The 2D process mesh.
+
+    Returns the number of scaling steps done; 0 means that the starting
+    scale factors already equilibrate A within TOL and were kept.
+ </pre>
+*/
+int
+pzgsequ_ruiz(SuperMatrix *A, double *r, double *c, yes_no_t warm, int maxit,
+	     double tol, int *info, gridinfo_t *grid)
+{
+    NRformat_loc *Astore;
+    pxgsequ_colmax_t cm;
+    doublecomplex *Aval;
+    double *dr, *dc, *dco, *rmax, *smax, err, v;
+    int_t  i, j, k, m_loc, fst_row, *rowptr, zero;
+    int    *sizes, *displs, procs, p, it;
+
+    /* Test the input parameters. */
+    *info = 0;
+    if ( A->nrow != A->ncol || A->Stype != SLU_NR_loc || A->Dtype != SLU_Z
+	 || A->Mtype != SLU_GE )
+	*info = -1;
+    if (*info != 0) {
+	pxerr_dist("pzgsequ_ruiz", grid, -*info);
+	return 0;
+    }
+    if ( A->nrow == 0 ) return 0;
+
+    Astore = A->Store;
+    Aval = Astore->nzval;
+    m_loc = Astore->m_loc;
+    fst_row = Astore->fst_row;
+    rowptr = Astore->rowptr;
+    pxgsequ_colmax_init(m_loc, fst_row, rowptr, Astore->colind, grid, &cm);
+
+    /* dr: my rows; dc: the columns of my slots; dco: my columns */
+    if ( !(dr = doubleMalloc_dist(3 * SUPERLU_MAX(m_loc, 1) + 2 * cm.nslot)) )
+	ABORT("Malloc fails for dr[].");
+    dco = dr + SUPERLU_MAX(m_loc, 1);
+    rmax = dco + SUPERLU_MAX(m_loc, 1);
+    dc = rmax + m_loc;
+    smax = dc + cm.nslot;
+    for (i = 0; i < m_loc; ++i) {
+	dr[i] = warm ? r[fst_row + i] : 1.;
+	dco[i] = warm ? c[fst_row + i] : 1.;
+    }
+    for (k = 0; k < cm.nslot; ++k) dc[k] = warm ? c[cm.col[k]] : 1.;
+
+    for (it = 0; ; ++it) {
+	/* Largest entries of the rows and columns of diag(dr)*A*diag(dc) */
+	for (k = 0; k < cm.nslot; ++k) smax[k] = 0.;
+	for (i = 0; i < m_loc; ++i) {
+	    rmax[i] = 0.;
+	    for (j = rowptr[i]; j < rowptr[i+1]; ++j) {
+		k = cm.slot[j];
+		v = slud_z_abs1(&Aval[j]) * dr[i] * dc[k];
+		rmax[i] = SUPERLU_MAX(rmax[i], v);
+		smax[k] = SUPERLU_MAX(smax[k], v);
+	    }
+	}
+	pxgsequ_colmax(&cm, smax);
+
+	if ( it == 0 ) { /* Look for an empty row, then an empty column. */
+	    zero = 2 * A->nrow + 1;
+	    for (i = m_loc - 1; i >= 0; --i) {
+		if ( rmax[i] == 0. ) zero = fst_row + i + 1;
+		else if ( cm.cmax[i] == 0. && zero > A->nrow )
+		    zero = A->nrow + fst_row + i + 1;
+	    }
+	    MPI_Allreduce(MPI_IN_PLACE, &zero, 1, mpi_int_t, MPI_MIN, grid->comm);
+	    if ( zero <= 2 * A->nrow ) {
+		*info = zero;
+		break;
+	    }
+	}
+
+	err = 0.;
+	for (i = 0; i < m_loc; ++i)
+	    err = SUPERLU_MAX(err, SUPERLU_MAX(fabs(1. - rmax[i]),
+					       fabs(1. - cm.cmax[i])));
+	MPI_Allreduce(MPI_IN_PLACE, &err, 1, MPI_DOUBLE, MPI_MAX, grid->comm);
+	if ( err <= tol || it == maxit ) break;
+
+	for (i = 0; i < m_loc; ++i) {
+	    dr[i] /= sqrt(rmax[i]);
+	    dco[i] /= sqrt(cm.cmax[i]);
+	}
+	for (k = 0; k < cm.nslot; ++k) dc[k] /= sqrt(smax[k]);
+    }
+    pxgsequ_colmax_free(&cm);
+    if ( *info > 0 )
+	for (i = 0; i < A->nrow; ++i) r[i] = c[i] = 1.;
+
+    /* Gather R and C on all the processes. */
+    if ( *info == 0 && (it > 0 || !warm) ) {
+	procs = grid->nprow * grid->npcol;
+	if ( !(sizes = SUPERLU_MALLOC(2 * procs * sizeof(int))) )
+	    ABORT("Malloc fails for sizes[].");
+	displs = sizes + procs;
+	p = (int) m_loc;
+	MPI_Allgather(&p, 1, MPI_INT, sizes, 1, MPI_INT, grid->comm);
+	displs[0] = 0;
+	for (p = 1; p < procs; ++p) displs[p] = displs[p-1] + sizes[p-1];
+	MPI_Allgatherv(dr, m_loc, MPI_DOUBLE, r, sizes, displs, MPI_DOUBLE,
+		       grid->comm);
+	MPI_Allgatherv(dco, m_loc, MPI_DOUBLE, c, sizes, displs, MPI_DOUBLE,
+		       grid->comm);
+	SUPERLU_FREE(sizes);
+    }
+    SUPERLU_FREE(dr);
+    return *info ? 0 : it;
+
+} /* pzgsequ_ruiz */
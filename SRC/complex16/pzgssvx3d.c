@@ -340,6 +340,9 @@ at the top-level directory.
  *                        off-diagonal.
  *           = MY_PERMR:  use the ordering given in ScalePermstruct->perm_r
  *                        input by the user.
+ *           = LargeDiag_AUCTION: like LargeDiag_MC64, but the matching is
+ *                        computed by a distributed auction on the local
+ *                        rows of A, without gathering A to one process.
  *
  *         o ColPerm (colperm_t)
  *           Specifies what type of column permutation to use to reduce fill.
@@ -558,6 +561,8 @@ void pzgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
     float GA_mem_use;	/* memory usage by global A */
     float dist_mem_use; /* memory usage during distribution */
     superlu_dist_mem_usage_t num_mem_usage, symb_mem_usage;
+    symbfact_cache_key_t symb_key = {0};  /* fingerprint for the symbolic cache */
+    int      symb_cached = 0;
     float flinfo; /* track memory usage of parallel symbolic factorization */
     bool Solve3D = true;
     int_t nsupers;
@@ -794,7 +799,14 @@ void pzgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
 		}
 	    } /* end ... use parmetis */
 
-	    if (permc_spec != MY_PERMC && Fact == DOFACT) {
+	    /* Look up the ordering and the serial symbolic factorization
+	       of this pattern in the cache given by SUPERLU_SYMB_CACHE. */
+	    if (parSymbFact == NO && Fact == DOFACT && permc_spec != PARMETIS)
+		symb_cached = symbfact_cache_load(options, &GA, perm_c, etree,
+		                      Glu_persist, &Glu_freeable, &symb_mem_usage,
+		                      grid, &symb_key);
+
+	    if (!symb_cached && permc_spec != MY_PERMC && Fact == DOFACT) {
 		if (permc_spec == PARMETIS) {
 		/* Get column permutation vector in perm_c.                   *
 		 * This routine takes as input the distributed input matrix A *
@@ -806,8 +818,10 @@ void pzgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
 						 grid, &symb_comm);
 		    if (flinfo > 0)
 			ABORT("ERROR in get perm_c parmetis.");
-		} else {
-		    get_perm_c_dist(iam, permc_spec, &GA, perm_c);
+		} else if (parSymbFact == NO || permc_spec != NATURAL) {
+		    /* perm_c is already the identity for ParSymbFact, where GA
+		       may not have been formed */
+		    get_perm_c_stat(iam, permc_spec, &GA, perm_c, stat);
 		}
 	    }
 
@@ -818,7 +832,11 @@ void pzgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
 	       Adjust perm_c[] to be consistent with a postorder of etree.
 	       Permute columns of A to form A*Pc'. */
 	    if (Fact != SamePattern_SameRowPerm) {
-		if (parSymbFact == NO)
+		if (parSymbFact == NO && symb_cached)
+		{
+		    stat->utime[SYMBFAC] = 0.0;
+		}
+		else if (parSymbFact == NO)
 		{
 		    /* Allocating Glu_freeable used by symbfact */
 		    if (!(Glu_freeable = (Glu_freeable_t *)
@@ -828,6 +846,8 @@ void pzgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
 					   Glu_persist, Glu_freeable, stat,
 					   &symb_mem_usage,
 					   grid3d);
+		    symbfact_cache_store(&symb_key, n, perm_c, etree, Glu_persist,
+					 Glu_freeable, grid);
 
 		} /* end serial symbolic factorization */
 		else { /* parallel symbolic factorization */
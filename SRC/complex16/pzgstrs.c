@@ -167,8 +167,8 @@ pzReDistribute_B_to_X(doublecomplex *B, int_t m_loc, int nrhs, int_t ldb,
 		      Glu_persist_t *Glu_persist,
 		      gridinfo_t *grid, zSOLVEstruct_t *SOLVEstruct)
 {
-    int  *SendCnt, *SendCnt_nrhs, *RecvCnt, *RecvCnt_nrhs;
-    int  *sdispls, *sdispls_nrhs, *rdispls, *rdispls_nrhs;
+    int  *SendCnt, *RecvCnt;
+    int  *sdispls, *rdispls, *rdispls_nrhs;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
     int_t  *perm_r, *perm_c; /* row and column permutation vectors */
     int_t  *send_ibuf, *recv_ibuf;
@@ -177,9 +177,7 @@ pzReDistribute_B_to_X(doublecomplex *B, int_t m_loc, int nrhs, int_t ldb,
     int_t  i, ii, irow, gbi, j, jj, k, knsupc, l, lk, nbrow;
     int    p, procs;
     pxgstrs_comm_t *gstrs_comm = SOLVEstruct->gstrs_comm;
-	MPI_Request req_i, req_d, *req_send, *req_recv;
-	MPI_Status status, *status_send, *status_recv;
-	int Nreq_recv, Nreq_send, pp, pps, ppr;
+	pxgstrs_nbr_t *nbr;
 	double t;
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter pzReDistribute_B_to_X()");
@@ -194,11 +192,8 @@ pzReDistribute_B_to_X(doublecomplex *B, int_t m_loc, int nrhs, int_t ldb,
     xsup = Glu_persist->xsup;
     supno = Glu_persist->supno;
     SendCnt      = gstrs_comm->B_to_X_SendCnt;
-    SendCnt_nrhs = gstrs_comm->B_to_X_SendCnt +   procs;
     RecvCnt      = gstrs_comm->B_to_X_SendCnt + 2*procs;
-    RecvCnt_nrhs = gstrs_comm->B_to_X_SendCnt + 3*procs;
     sdispls      = gstrs_comm->B_to_X_SendCnt + 4*procs;
-    sdispls_nrhs = gstrs_comm->B_to_X_SendCnt + 5*procs;
     rdispls      = gstrs_comm->B_to_X_SendCnt + 6*procs;
     rdispls_nrhs = gstrs_comm->B_to_X_SendCnt + 7*procs;
     ptr_to_ibuf  = gstrs_comm->ptr_to_ibuf;
@@ -250,14 +245,6 @@ pzReDistribute_B_to_X(doublecomplex *B, int_t m_loc, int nrhs, int_t ldb,
 		if ( !(send_dbuf = doublecomplexMalloc_dist((k + l)* (size_t)nrhs)) )
 			ABORT("Malloc fails for send_dbuf[].");
 		recv_dbuf = send_dbuf + k * nrhs;
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -284,80 +271,15 @@ pzReDistribute_B_to_X(doublecomplex *B, int_t m_loc, int nrhs, int_t ldb,
 		// t = SuperLU_timer_() - t;
 		// printf(".. copy to send buffer time\t%8.4f\n", t);
 
-#if 0
-	#if 1
-		/* Communicate the (permuted) row indices. */
-		MPI_Alltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-			  recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm);
- 		/* Communicate the numerical values. */
-		MPI_Alltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
-			  recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
-			  grid->comm);
-	#else
- 		/* Communicate the (permuted) row indices. */
-		MPI_Ialltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-				recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm, &req_i);
- 		/* Communicate the numerical values. */
-		MPI_Ialltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
-				recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
-				grid->comm, &req_d);
-		MPI_Wait(&req_i,&status);
-		MPI_Wait(&req_d,&status);
- 	#endif
-#endif
-	MPI_Barrier( grid->comm );
-
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-
-		if(SendCnt[pps]>0){
-			MPI_Isend(&send_ibuf[sdispls[pps]], SendCnt[pps], mpi_int_t, pps, 0, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt[ppr]>0){
-			MPI_Irecv(&recv_ibuf[rdispls[ppr]], RecvCnt[ppr], mpi_int_t, ppr, 0, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt_nrhs[pps]>0){
-			MPI_Isend(&send_dbuf[sdispls_nrhs[pps]], SendCnt_nrhs[pps], SuperLU_MPI_DOUBLE_COMPLEX, pps, 1, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt_nrhs[ppr]>0){
-			MPI_Irecv(&recv_dbuf[rdispls_nrhs[ppr]], RecvCnt_nrhs[ppr], SuperLU_MPI_DOUBLE_COMPLEX, ppr, 1, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
+	/* Exchange with the graph neighbors only; the distributed-graph
+	   communicator was built once in pzgstrs_init(). */
+	nbr = &gstrs_comm->B_to_X_nbr;
+	MPI_Neighbor_alltoallv(send_ibuf, nbr->SendCnt, nbr->sdispls, mpi_int_t,
+			       recv_ibuf, nbr->RecvCnt, nbr->rdispls, mpi_int_t,
+			       nbr->comm);
+	MPI_Neighbor_alltoallv(send_dbuf, nbr->SendCnt_nrhs, nbr->sdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
+			       recv_dbuf, nbr->RecvCnt_nrhs, nbr->rdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
+			       nbr->comm);
 
 
 		/* ------------------------------------------------------------
@@ -392,10 +314,6 @@ pzReDistribute_B_to_X(doublecomplex *B, int_t m_loc, int nrhs, int_t ldb,
 
 		SUPERLU_FREE(send_ibuf);
 		SUPERLU_FREE(send_dbuf);
-		SUPERLU_FREE(req_send);
-		SUPERLU_FREE(req_recv);
-		SUPERLU_FREE(status_send);
-		SUPERLU_FREE(status_recv);
 	}
 
 
@@ -429,8 +347,8 @@ pzReDistribute_X_to_B(int_t n, doublecomplex *B, int_t m_loc, int_t ldb, int_t f
 {
     int_t  i, ii, irow, j, jj, k, knsupc, nsupers, l, lk;
     int_t  *xsup, *supno;
-    int  *SendCnt, *SendCnt_nrhs, *RecvCnt, *RecvCnt_nrhs;
-    int  *sdispls, *rdispls, *sdispls_nrhs, *rdispls_nrhs;
+    int  *SendCnt, *RecvCnt;
+    int  *sdispls, *rdispls, *sdispls_nrhs;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
     int_t  *send_ibuf, *recv_ibuf;
     doublecomplex *send_dbuf, *recv_dbuf;
@@ -438,9 +356,7 @@ pzReDistribute_X_to_B(int_t n, doublecomplex *B, int_t m_loc, int_t ldb, int_t f
     pxgstrs_comm_t *gstrs_comm = SOLVEstruct->gstrs_comm;
     int  iam, p, q, pkk, procs;
     int_t  num_diag_procs, *diag_procs;
-	MPI_Request req_i, req_d, *req_send, *req_recv;
-	MPI_Status status, *status_send, *status_recv;
-	int Nreq_recv, Nreq_send, pp,pps,ppr;
+	pxgstrs_nbr_t *nbr;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter pzReDistribute_X_to_B()");
@@ -456,13 +372,10 @@ pzReDistribute_X_to_B(int_t n, doublecomplex *B, int_t m_loc, int_t ldb, int_t f
     procs = grid->nprow * grid->npcol;
 
     SendCnt      = gstrs_comm->X_to_B_SendCnt;
-    SendCnt_nrhs = gstrs_comm->X_to_B_SendCnt +   procs;
     RecvCnt      = gstrs_comm->X_to_B_SendCnt + 2*procs;
-    RecvCnt_nrhs = gstrs_comm->X_to_B_SendCnt + 3*procs;
     sdispls      = gstrs_comm->X_to_B_SendCnt + 4*procs;
     sdispls_nrhs = gstrs_comm->X_to_B_SendCnt + 5*procs;
     rdispls      = gstrs_comm->X_to_B_SendCnt + 6*procs;
-    rdispls_nrhs = gstrs_comm->X_to_B_SendCnt + 7*procs;
     ptr_to_ibuf  = gstrs_comm->ptr_to_ibuf;
     ptr_to_dbuf  = gstrs_comm->ptr_to_dbuf;
 
@@ -504,14 +417,6 @@ pzReDistribute_X_to_B(int_t n, doublecomplex *B, int_t m_loc, int_t ldb, int_t f
 		recv_ibuf = send_ibuf + k;
 		if ( !(send_dbuf = doublecomplexMalloc_dist((k + l)*nrhs)) )
 			ABORT("Malloc fails for send_dbuf[].");
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 		recv_dbuf = send_dbuf + k * nrhs;
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -551,76 +456,16 @@ pzReDistribute_X_to_B(int_t n, doublecomplex *B, int_t m_loc, int_t ldb, int_t f
 		/* ------------------------------------------------------------
 			COMMUNICATE THE (PERMUTED) ROW INDICES AND NUMERICAL VALUES.
 		   ------------------------------------------------------------*/
-#if 0
-	#if 1
-		MPI_Alltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-			  recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm);
-		MPI_Alltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs,SuperLU_MPI_DOUBLE_COMPLEX,
-			  recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
-			  grid->comm);
-	#else
-		MPI_Ialltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-				recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm,&req_i);
-		MPI_Ialltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
-				recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
-				grid->comm,&req_d);
- 		MPI_Wait(&req_i,&status);
-		MPI_Wait(&req_d,&status);
-	#endif
-#endif
-
-	MPI_Barrier( grid->comm );
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt[pps]>0){
-			MPI_Isend(&send_ibuf[sdispls[pps]], SendCnt[pps], mpi_int_t, pps, 0, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt[ppr]>0){
-			MPI_Irecv(&recv_ibuf[rdispls[ppr]], RecvCnt[ppr], mpi_int_t, ppr, 0, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-	// MPI_Barrier( grid->comm );
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt_nrhs[pps]>0){
-			MPI_Isend(&send_dbuf[sdispls_nrhs[pps]], SendCnt_nrhs[pps], SuperLU_MPI_DOUBLE_COMPLEX, pps, 1, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt_nrhs[ppr]>0){
-			MPI_Irecv(&recv_dbuf[rdispls_nrhs[ppr]], RecvCnt_nrhs[ppr], SuperLU_MPI_DOUBLE_COMPLEX, ppr, 1, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
 
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-	// MPI_Barrier( grid->comm );
+	/* Exchange with the graph neighbors only; the distributed-graph
+	   communicator was built once in pzgstrs_init(). */
+	nbr = &gstrs_comm->X_to_B_nbr;
+	MPI_Neighbor_alltoallv(send_ibuf, nbr->SendCnt, nbr->sdispls, mpi_int_t,
+			       recv_ibuf, nbr->RecvCnt, nbr->rdispls, mpi_int_t,
+			       nbr->comm);
+	MPI_Neighbor_alltoallv(send_dbuf, nbr->SendCnt_nrhs, nbr->sdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
+			       recv_dbuf, nbr->RecvCnt_nrhs, nbr->rdispls_nrhs, SuperLU_MPI_DOUBLE_COMPLEX,
+			       nbr->comm);
 
 
 		/* ------------------------------------------------------------
@@ -636,10 +481,6 @@ pzReDistribute_X_to_B(int_t n, doublecomplex *B, int_t m_loc, int_t ldb, int_t f
 
     SUPERLU_FREE(send_ibuf);
     SUPERLU_FREE(send_dbuf);
-	SUPERLU_FREE(req_send);
-	SUPERLU_FREE(req_recv);
-	SUPERLU_FREE(status_send);
-	SUPERLU_FREE(status_recv);
 }
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Exit pzReDistribute_X_to_B()");
@@ -226,6 +226,9 @@ int ztrs_compute_communication_structure(superlu_dist_options_t *options, int_t
     int *h_recv_cnt;
     int *h_recv_cnt_u;
 
+    /* Node map used to shape the broadcast and reduction trees below */
+    C_Tree_SetTopology(grid->comm);
+
     /* Reconstruct the global L structure and compute the communication metadata */
 
     if ( !(tmpglo = intCalloc_dist(nsupers)) )
@@ -1428,6 +1431,7 @@ int_t ztrs_x_reduction_newsolve(int_t nsupers, doublecomplex* x, int nrhs, zLUst
                 sender = myGrid;
                 receiver = myGrid - (1 << (ilvl-1));
             }
+            if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
             int_t tr =  tree;
             for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
             {
@@ -1469,6 +1473,7 @@ int_t ztrs_x_broadcast_newsolve(int_t nsupers, doublecomplex* x, int nrhs, zLUst
                 sender = myGrid - (1 << (ilvl-1));
                 receiver = myGrid ;
             }
+            if (receiver >= grid3d->zscp.Np) continue; /* no partner grid */
             int_t tr =  tree;
             for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
             {
@@ -1572,6 +1577,7 @@ int_t ztrs_X_gather3d(doublecomplex* x, int nrhs, ztrf3Dpartition_t*  trf3Dparti
 				sender = myGrid;
 				receiver = myGrid - (1 << ilvl);
 			}
+			if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
 			for (int_t alvl = 0; alvl <= ilvl; alvl++)
 			{
 				int_t diffLvl  = ilvl - alvl;
@@ -1750,6 +1756,7 @@ int_t zbsolve_Xt_bcast(int_t ilvl, zxT_struct *xT_s, int nrhs, ztrf3Dpartition_t
 		receiver = myGrid;
 		sender = myGrid - (1 << ilvl);
 	}
+	if (receiver >= grid3d->zscp.Np) return 0; /* no partner grid */
 
 	for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
@@ -7445,6 +7452,7 @@ int_t pzgsTrForwardSolve3d(superlu_dist_options_t *options, int_t n, zLUstruct_t
                     receiver = myGrid - (1 << ilvl);
                 }
                 double tx = SuperLU_timer_();
+                if (sender < grid3d->zscp.Np) /* else no partner grid */
                 for (int_t alvl = ilvl + 1; alvl <  maxLvl; ++alvl)
                 {
                     /* code */
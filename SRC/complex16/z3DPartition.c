@@ -31,13 +31,13 @@ void znewTrfPartitionInit(int_t nsupers,  zLUstruct_t *LUstruct, gridinfo3d_t *g
         grid3d);
 #endif
     // Calculation of tree weight
-    calcTreeWeight(nsupers, setree, treeList, LUstruct->Glu_persist->xsup);
+    calcTreeWeight(nsupers, setree, treeList, LUstruct->Glu_persist->xsup, grid3d);
 
     // Calculation of maximum level
     int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
 
     // Generation of forests
-    sForest_t **sForests = getForests(maxLvl, nsupers, setree, treeList);
+    sForest_t **sForests = getForests(maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
 
     ztrf3Dpartition_t *trf3Dpart = LUstruct->trf3Dpart;
     trf3Dpart->sForests = sForests;
@@ -0,0 +1,500 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+/*! @file
+ * \brief Streaming assembly of a distributed matrix from triplets
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The processes insert batches of (i, j, v) triplets in any row with
+ * zAssembleAdd(). Triplets in the rows of another process are packed in
+ * a buffer per destination and sent with MPI_Isend when it is full; the
+ * incoming buffers are received whenever a process inserts or flushes.
+ * zAssembleFinalize() sends the remaining buffers, receives the messages
+ * still expected while the message counts are exchanged, sums the duplicates and returns the matrix in the
+ * SLU_NR_loc block-row format, each process owning m / nprocs consecutive
+ * rows (the last one also owns the remainder).
+ *
+ * If the routing is kept, the structure of the local rows and the
+ * position in nzval[] of every entry, per source process in arrival
+ * order, are recorded. Since the messages between two processes are not
+ * overtaken, inserting the same sequence of triplets again after
+ * zAssembleRestart() sends the values only, and each value is added
+ * directly at its position in the new matrix.
+ * </pre>
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "superlu_zdefs.h"
+
+/* Size of a packed entry */
+#define ASM_ENTRY(as) ( (as)->SamePattern ? sizeof(doublecomplex) \
+			: 2 * sizeof(int_t) + sizeof(doublecomplex) )
+
+static int
+asm_owner(zAssemble_t *as, int_t i)
+{
+    int_t m_loc_fst = as->m / as->nprocs;
+    return m_loc_fst ? SUPERLU_MIN(i / m_loc_fst, as->nprocs - 1)
+		     : as->nprocs - 1;
+}
+
+/* Copy the n first elements of the array old of element size esz in a
+   new array of newmax elements, and free old. */
+static void *
+asm_grow(void *old, int_t n, int_t newmax, size_t esz)
+{
+    void *buf = SUPERLU_MALLOC(newmax * esz);
+
+    if ( !buf ) ABORT("Malloc fails for the assembled entries.");
+    if ( old ) {
+	memcpy(buf, old, n * esz);
+	SUPERLU_FREE(old);
+    }
+    return buf;
+}
+
+/* Store an entry of one of my rows, coming from process src. */
+static void
+asm_store(zAssemble_t *as, int src, int_t i, int_t j, doublecomplex v)
+{
+    if ( as->SamePattern ) {
+	int_t k = as->slotptr[src] + as->cnt[src]++;
+	if ( k < as->slotptr[src+1] ) {
+	    z_add(&as->nzval[as->slot[k]], &as->nzval[as->slot[k]], &v);
+	} else as->error = 1;
+	return;
+    }
+    if ( as->nloc == as->maxloc ) {
+	/* The arrays are grown one at a time and by half, which bounds the
+	   memory above the received entries. */
+	int_t n = as->nloc, newmax = SUPERLU_MAX(n + n / 2, 1024);
+	as->lrow = asm_grow(as->lrow, n, newmax, sizeof(int_t));
+	as->lcol = asm_grow(as->lcol, n, newmax, sizeof(int_t));
+	as->lval = asm_grow(as->lval, n, newmax, sizeof(doublecomplex));
+	if ( as->KeepRouting )
+	    as->lsrc = asm_grow(as->lsrc, n, newmax, sizeof(int));
+	as->maxloc = newmax;
+    }
+    as->lrow[as->nloc] = i - as->fst_row;
+    as->lcol[as->nloc] = j;
+    as->lval[as->nloc] = v;
+    if ( as->lsrc ) as->lsrc[as->nloc] = src;
+    ++as->nloc;
+}
+
+/* Receive one message from process from (or MPI_ANY_SOURCE), waiting
+   for it if block is set. Returns 0 if there was none. */
+static int
+asm_recv(zAssemble_t *as, int from, int block)
+{
+    MPI_Status status;
+    size_t esz = ASM_ENTRY(as);
+    int flag = 1, bytes, k, nent, src;
+    int_t i = 0, j = 0;
+    doublecomplex v;
+    char *p;
+
+    if ( block ) MPI_Probe(from, as->tag, as->comm, &status);
+    else MPI_Iprobe(from, as->tag, as->comm, &flag, &status);
+    if ( !flag ) return 0;
+
+    MPI_Get_count(&status, MPI_BYTE, &bytes);
+    src = status.MPI_SOURCE;
+    if ( bytes > as->recvcap ) {
+	if ( as->recvbuf ) SUPERLU_FREE(as->recvbuf);
+	as->recvcap = bytes;
+	if ( !(as->recvbuf = (char *) SUPERLU_MALLOC(bytes)) )
+	    ABORT("Malloc fails for recvbuf[].");
+    }
+    MPI_Recv(as->recvbuf, bytes, MPI_BYTE, src, as->tag, as->comm, &status);
+    ++as->nrecv[src];
+
+    nent = bytes / esz;
+    for (k = 0, p = as->recvbuf; k < nent; ++k) {
+	if ( !as->SamePattern ) {
+	    memcpy(&i, p, sizeof(int_t)); p += sizeof(int_t);
+	    memcpy(&j, p, sizeof(int_t)); p += sizeof(int_t);
+	}
+	memcpy(&v, p, sizeof(doublecomplex)); p += sizeof(doublecomplex);
+	asm_store(as, src, i, j, v);
+    }
+    return 1;
+}
+
+/* Send the buffer of process p, after the previous one to p is sent. */
+static void
+asm_post(zAssemble_t *as, int p)
+{
+    char *buf;
+    int done;
+
+    if ( as->req[p] != MPI_REQUEST_NULL ) {
+	for (;;) {
+	    MPI_Test(&as->req[p], &done, MPI_STATUS_IGNORE);
+	    if ( done ) break;
+	    asm_recv(as, MPI_ANY_SOURCE, 0);
+	}
+    }
+    buf = as->sendbuf[p];
+    as->sendbuf[p] = as->inflight[p];
+    as->inflight[p] = buf;
+    MPI_Isend(buf, (int) (as->nsend[p] * ASM_ENTRY(as)), MPI_BYTE, p,
+	      as->tag, as->comm, &as->req[p]);
+    ++as->nmsg[p];
+    as->nsend[p] = 0;
+}
+
+/*! \brief Initialize the assembly of an m-by-n matrix on the processes
+ * of grid.
+ *
+ * <pre>
+ * bufsize is the number of triplets buffered for each destination
+ * process before they are sent (4096 if bufsize <= 0). If KeepRouting is
+ * YES, the routing of the entries is kept by zAssembleFinalize() so that
+ * the values can be assembled again with zAssembleRestart().
+ * </pre>
+ */
+void
+zAssembleInit(zAssemble_t *as, int_t m, int_t n, int_t bufsize,
+	      yes_no_t KeepRouting, gridinfo_t *grid)
+{
+    int p;
+
+    memset(as, 0, sizeof(zAssemble_t));
+    as->m = m;
+    as->n = n;
+    as->bufsize = bufsize > 0 ? bufsize : 4096;
+    as->KeepRouting = KeepRouting;
+    as->SamePattern = NO;
+    MPI_Comm_dup(grid->comm, &as->comm);
+    MPI_Comm_rank(as->comm, &as->iam);
+    MPI_Comm_size(as->comm, &as->nprocs);
+    superlu_mm_block_rows(m, as->iam, as->nprocs, &as->m_loc, &as->fst_row);
+
+    p = as->nprocs;
+    if ( !(as->sendbuf = (char **) SUPERLU_MALLOC(2 * p * sizeof(char *))) )
+	ABORT("Malloc fails for sendbuf[].");
+    as->inflight = as->sendbuf + p;
+    if ( !(as->req = (MPI_Request *) SUPERLU_MALLOC(p * sizeof(MPI_Request))) )
+	ABORT("Malloc fails for req[].");
+    if ( !(as->nsend = intCalloc_dist(2 * p)) )
+	ABORT("Malloc fails for nsend[].");
+    as->cnt = as->nsend + p;
+    if ( !(as->nmsg = int32Calloc_dist(2 * p)) )
+	ABORT("Malloc fails for nmsg[].");
+    as->nrecv = as->nmsg + p;
+    for (p = 0; p < as->nprocs; ++p) {
+	as->sendbuf[p] = as->inflight[p] = NULL;
+	as->req[p] = MPI_REQUEST_NULL;
+    }
+}
+
+/*! \brief Insert nt triplets (rows[k], cols[k], vals[k]), with 0-based
+ * global indices, in any row of the matrix.
+ *
+ * <pre>
+ * Duplicates are summed. After zAssembleRestart(), the triplets must be
+ * inserted in the same order as in the first assembly, and cols may be
+ * NULL. Returns 0, or k+1 if the indices of triplet k are out of range.
+ * Not collective.
+ * </pre>
+ */
+int
+zAssembleAdd(zAssemble_t *as, int_t nt, int_t *rows, int_t *cols,
+	     doublecomplex *vals)
+{
+    size_t esz = ASM_ENTRY(as);
+    int_t k, i, j = 0;
+    char *p;
+    int q;
+
+    for (k = 0; k < nt; ++k) {
+	i = rows[k];
+	if ( !as->SamePattern ) j = cols[k];
+	if ( i < 0 || i >= as->m || j < 0 || j >= as->n ) return k + 1;
+	q = asm_owner(as, i);
+	if ( q == as->iam ) {
+	    asm_store(as, q, i, j, vals[k]);
+	    continue;
+	}
+	if ( !as->sendbuf[q] ) {
+	    size_t sz = as->bufsize * (2 * sizeof(int_t) + sizeof(doublecomplex));
+	    if ( !(as->sendbuf[q] = (char *) SUPERLU_MALLOC(sz)) ||
+		 !(as->inflight[q] = (char *) SUPERLU_MALLOC(sz)) )
+		ABORT("Malloc fails for sendbuf[].");
+	}
+	p = as->sendbuf[q] + as->nsend[q] * esz;
+	if ( !as->SamePattern ) {
+	    memcpy(p, &i, sizeof(int_t)); p += sizeof(int_t);
+	    memcpy(p, &j, sizeof(int_t)); p += sizeof(int_t);
+	}
+	memcpy(p, &vals[k], sizeof(doublecomplex));
+	if ( ++as->nsend[q] == as->bufsize ) asm_post(as, q);
+    }
+    while ( asm_recv(as, MPI_ANY_SOURCE, 0) ) ;
+    return 0;
+}
+
+typedef struct { int_t col, pos; } asm_pair_t;
+
+static int
+asm_pair_cmp(const void *a, const void *b)
+{
+    const asm_pair_t *x = (const asm_pair_t *) a, *y = (const asm_pair_t *) b;
+    if ( x->col != y->col ) return x->col < y->col ? -1 : 1;
+    return x->pos < y->pos ? -1 : (x->pos > y->pos);
+}
+
+/* Build my rows in compressed row format from the received triplets,
+   with sorted columns and summed duplicates. The triplets are sorted by
+   row in place, so that lcol[] and lval[] become colind[] and nzval[]
+   without a second copy of the entries. */
+static void
+asm_build(zAssemble_t *as, int_t *nnz_loc, int_t **rowptr_out,
+	  int_t **colind_out, doublecomplex **nzval_out)
+{
+    int_t m_loc = as->m_loc, nloc = as->nloc;
+    int_t *rowptr, *next, *colind, *lrow = as->lrow, *sidx = NULL;
+    int_t r, rr, t, a, b, q, k, maxrow, itmp;
+    doublecomplex *nzval, *tv, vtmp;
+    asm_pair_t *tp;
+    int p;
+
+    if ( !as->maxloc ) { /* no entry in my rows */
+	lrow = as->lrow = intMalloc_dist(1);
+	as->lcol = intMalloc_dist(1);
+	as->lval = doublecomplexMalloc_dist(1);
+	if ( !lrow || !as->lcol || !as->lval )
+	    ABORT("Malloc fails for colind[] or nzval[].");
+    }
+    colind = as->lcol;
+    nzval = as->lval;
+
+    if ( !(rowptr = intCalloc_dist(m_loc + 1)) || !(next = intMalloc_dist(m_loc + 1)) )
+	ABORT("Malloc fails for rowptr[].");
+    for (t = 0; t < nloc; ++t) ++rowptr[lrow[t] + 1];
+    for (r = 0, maxrow = 0; r < m_loc; ++r) {
+	maxrow = SUPERLU_MAX(maxrow, rowptr[r+1]);
+	rowptr[r+1] += rowptr[r];
+	next[r] = rowptr[r];
+    }
+
+    /* sidx[t]: index in slot[] of the t-th entry, i.e. the source
+       process and the arrival order from it */
+    if ( as->KeepRouting ) {
+	if ( !(as->slotptr = intCalloc_dist(as->nprocs + 1)) ||
+	     !(as->slot = intMalloc_dist(SUPERLU_MAX(nloc, 1))) ||
+	     !(sidx = intMalloc_dist(SUPERLU_MAX(nloc, 1))) )
+	    ABORT("Malloc fails for the routing.");
+	for (t = 0; t < nloc; ++t) ++as->slotptr[as->lsrc[t] + 1];
+	for (p = 0; p < as->nprocs; ++p) {
+	    as->slotptr[p+1] += as->slotptr[p];
+	    as->cnt[p] = 0;
+	}
+	for (t = 0; t < nloc; ++t) {
+	    p = as->lsrc[t];
+	    sidx[t] = as->slotptr[p] + as->cnt[p]++;
+	}
+	if ( as->lsrc ) SUPERLU_FREE(as->lsrc);
+	as->lsrc = NULL;
+    }
+
+    /* Move every entry to its row, by swaps */
+    for (r = 0; r < m_loc; ++r) {
+	while ( next[r] < rowptr[r+1] ) {
+	    t = next[r];
+	    rr = lrow[t];
+	    if ( rr == r ) {
+		++next[r];
+		continue;
+	    }
+	    q = next[rr]++;
+	    lrow[t] = lrow[q]; lrow[q] = rr;
+	    itmp = colind[t]; colind[t] = colind[q]; colind[q] = itmp;
+	    vtmp = nzval[t]; nzval[t] = nzval[q]; nzval[q] = vtmp;
+	    if ( sidx ) {
+		itmp = sidx[t]; sidx[t] = sidx[q]; sidx[q] = itmp;
+	    }
+	}
+    }
+    SUPERLU_FREE(next);
+    SUPERLU_FREE(as->lrow);
+    as->lrow = as->lcol = NULL;
+    as->lval = NULL;
+
+    /* Sort each row by column and sum the duplicates in place */
+    tp = (asm_pair_t *) SUPERLU_MALLOC(SUPERLU_MAX(maxrow, 1) * sizeof(asm_pair_t));
+    tv = doublecomplexMalloc_dist(SUPERLU_MAX(maxrow, 1));
+    if ( !tp || !tv ) ABORT("Malloc fails for the row work arrays.");
+    for (r = 0, k = 0, b = 0; r < m_loc; ++r) {
+	a = b;
+	b = rowptr[r+1];
+	for (q = a; q < b; ++q) {
+	    tp[q-a].col = colind[q];
+	    tp[q-a].pos = q;
+	    tv[q-a] = nzval[q];
+	}
+	qsort(tp, b - a, sizeof(asm_pair_t), asm_pair_cmp);
+	rowptr[r] = k;
+	for (q = 0; q < b - a; ++q) {
+	    if ( q > 0 && tp[q].col == tp[q-1].col ) {
+		z_add(&nzval[k-1], &nzval[k-1], &tv[tp[q].pos - a]);
+	    } else {
+		colind[k] = tp[q].col;
+		nzval[k] = tv[tp[q].pos - a];
+		++k;
+	    }
+	    if ( sidx ) as->slot[sidx[tp[q].pos]] = k - 1;
+	}
+    }
+    rowptr[m_loc] = k;
+    SUPERLU_FREE(tp);
+    SUPERLU_FREE(tv);
+
+    /* Structure kept for zAssembleRestart() */
+    if ( sidx ) {
+	SUPERLU_FREE(sidx);
+	if ( !(as->rowptr = intMalloc_dist(m_loc + 1)) ||
+	     !(as->colind = intMalloc_dist(SUPERLU_MAX(k, 1))) )
+	    ABORT("Malloc fails for the kept structure.");
+	memcpy(as->rowptr, rowptr, (m_loc + 1) * sizeof(int_t));
+	memcpy(as->colind, colind, k * sizeof(int_t));
+	as->nnz_loc = k;
+    }
+    as->nloc = as->maxloc = 0;
+
+    *nnz_loc = k;
+    *rowptr_out = rowptr;
+    *colind_out = colind;
+    *nzval_out = nzval;
+}
+
+/*! \brief Complete the assembly and create A in SLU_NR_loc format;
+ * collective.
+ *
+ * <pre>
+ * After zAssembleRestart(), A has the structure of the first assembly.
+ * Returns 0 on success, and on all the processes 1 if an assembly after
+ * zAssembleRestart() did not insert the same entries as the first one;
+ * A is not created in that case.
+ * </pre>
+ */
+int
+zAssembleFinalize(zAssemble_t *as, SuperMatrix *A)
+{
+    int_t nnz_loc, *rowptr, *colind;
+    doublecomplex *nzval;
+    int *expect, p, info, done;
+    MPI_Request xreq;
+
+    /* Send the remaining buffers and receive all the messages. The
+       message counts are exchanged with a nonblocking all-to-all, and
+       the messages are received until it completes: a large message
+       is only sent once it is received, and a process may still be
+       sending to one that has reached the exchange. A process that
+       already finalized may have started sending the next assembly,
+       which uses the other tag. */
+    for (p = 0; p < as->nprocs; ++p)
+	if ( as->nsend[p] ) asm_post(as, p);
+    if ( !(expect = int32Malloc_dist(as->nprocs)) )
+	ABORT("Malloc fails for expect[].");
+    MPI_Ialltoall(as->nmsg, 1, MPI_INT, expect, 1, MPI_INT, as->comm, &xreq);
+    for (;;) {
+	MPI_Test(&xreq, &done, MPI_STATUS_IGNORE);
+	if ( done ) break;
+	asm_recv(as, MPI_ANY_SOURCE, 0);
+    }
+    for (p = 0; p < as->nprocs; ++p)
+	while ( as->nrecv[p] < expect[p] ) asm_recv(as, p, 1);
+    MPI_Waitall(as->nprocs, as->req, MPI_STATUSES_IGNORE);
+    for (p = 0; p < as->nprocs; ++p) as->nmsg[p] = as->nrecv[p] = 0;
+    as->tag = !as->tag;
+    SUPERLU_FREE(expect);
+
+    if ( as->SamePattern ) {
+	for (p = 0; p < as->nprocs; ++p)
+	    if ( as->cnt[p] != as->slotptr[p+1] - as->slotptr[p] )
+		as->error = 1;
+	info = as->error;
+	MPI_Allreduce(MPI_IN_PLACE, &info, 1, MPI_INT, MPI_MAX, as->comm);
+	nzval = as->nzval;
+	as->nzval = NULL;
+	if ( info ) {
+	    SUPERLU_FREE(nzval);
+	    return info;
+	}
+	nnz_loc = as->nnz_loc;
+	rowptr = intMalloc_dist(as->m_loc + 1);
+	colind = intMalloc_dist(SUPERLU_MAX(nnz_loc, 1));
+	if ( !rowptr || !colind ) ABORT("Malloc fails for rowptr[] or colind[].");
+	memcpy(rowptr, as->rowptr, (as->m_loc + 1) * sizeof(int_t));
+	memcpy(colind, as->colind, nnz_loc * sizeof(int_t));
+    } else {
+	asm_build(as, &nnz_loc, &rowptr, &colind, &nzval);
+    }
+    zCreate_CompRowLoc_Matrix_dist(A, as->m, as->n, nnz_loc, as->m_loc,
+				   as->fst_row, nzval, colind, rowptr,
+				   SLU_NR_loc, SLU_Z, SLU_GE);
+    return 0;
+}
+
+/*! \brief Start assembling new values with the pattern of the first
+ * assembly, finalized with KeepRouting = YES.
+ *
+ * The triplets must then be inserted in the same order as in the first
+ * assembly. The matrix of the previous assembly is not used, as the
+ * solvers may have changed its structure.
+ */
+void
+zAssembleRestart(zAssemble_t *as)
+{
+    int p;
+
+    if ( !as->slot ) ABORT("zAssembleRestart: the routing was not kept.");
+    as->SamePattern = YES;
+    if ( as->nzval ) SUPERLU_FREE(as->nzval);
+    if ( !(as->nzval = doublecomplexCalloc_dist(SUPERLU_MAX(as->nnz_loc, 1))) )
+	ABORT("Malloc fails for nzval[].");
+    for (p = 0; p < as->nprocs; ++p) as->cnt[p] = 0;
+    as->error = 0;
+}
+
+/*! \brief Free the storage of the assembly; the matrices created are
+ * not freed.
+ */
+void
+zAssembleFree(zAssemble_t *as)
+{
+    int p;
+
+    for (p = 0; p < as->nprocs; ++p) {
+	if ( as->sendbuf[p] ) SUPERLU_FREE(as->sendbuf[p]);
+	if ( as->inflight[p] ) SUPERLU_FREE(as->inflight[p]);
+    }
+    SUPERLU_FREE(as->sendbuf);
+    SUPERLU_FREE(as->req);
+    SUPERLU_FREE(as->nsend);
+    SUPERLU_FREE(as->nmsg);
+    if ( as->recvbuf ) SUPERLU_FREE(as->recvbuf);
+    if ( as->lrow ) SUPERLU_FREE(as->lrow);
+    if ( as->lcol ) SUPERLU_FREE(as->lcol);
+    if ( as->lval ) SUPERLU_FREE(as->lval);
+    if ( as->lsrc ) SUPERLU_FREE(as->lsrc);
+    if ( as->slot ) SUPERLU_FREE(as->slot);
+    if ( as->slotptr ) SUPERLU_FREE(as->slotptr);
+    if ( as->rowptr ) SUPERLU_FREE(as->rowptr);
+    if ( as->colind ) SUPERLU_FREE(as->colind);
+    if ( as->nzval ) SUPERLU_FREE(as->nzval);
+    MPI_Comm_free(&as->comm);
+}
@@ -159,6 +159,14 @@ while (j < nub && perm_u[2 * j] <= k0 + num_look_aheads)
 
 	/*if (thread_id == 0) tt_start = SuperLU_timer_();*/
 
+        /* A kept column k only updates the refactored blocks. */
+        if ( keep_k && !(refact_mask[ib] && refact_mask[jb]) ) {
+            ++current_b;
+            lptr += temp_nbrow;
+            luptr += temp_nbrow;
+            continue;
+        }
+
         /* calling gemm */
 	stat->ops[FACT] += 8.0 * (flops_t)temp_nbrow * ldu * ncols;
 #if defined (USE_VENDOR_BLAS)
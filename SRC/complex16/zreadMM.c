@@ -17,6 +17,7 @@ at the top-level directory.
  */
 #include <ctype.h>
 #include <stdio.h>
+#include <string.h>
 #include "superlu_zdefs.h"
 
 #undef EXPAND_SYM
@@ -226,6 +227,121 @@ zreadMM_dist(FILE *fp, int_t *m, int_t *n, int_t *nonz,
 }
 
 
+/*! \brief Read a Matrix Market file in parallel into a distributed matrix
+ *
+ * <pre>
+ * All processes of grid read the entries of the file with MPI-IO (see
+ * mmio_mpi.c), and A is returned in the block-row distributed format
+ * SLU_NR_loc, each process owning m / nprocs consecutive rows (the last
+ * one also owns the remainder). Symmetric, skew-symmetric and Hermitian
+ * matrices are expanded; pattern matrices get unit values;
+ * real and integer matrices get zero imaginary parts.
+ * The indices are taken as 0-based if any of them is 0.
+ *
+ * Returns 0 on success, a positive value on all processes otherwise.
+ * </pre>
+ */
+int
+pzreadMM_loc(char *filename, SuperMatrix *A, gridinfo_t *grid)
+{
+    superlu_mm_header_t hdr;
+    MPI_Comm comm = grid->comm;
+    int_t m_loc, fst_row, nnz_loc, *rowptr, *colind, *ij;
+    int_t i, j, k, nz, nlines, imin, gmin;
+    doublecomplex *val;
+    void *nzval;
+    const char *p, *eol, *end;
+    char *buf;
+    size_t len;
+    int iam, info, expand;
+
+    MPI_Comm_rank(comm, &iam);
+    if ( (info = superlu_mm_read_header(filename, &hdr, comm)) ) return info;
+    info = 0;
+    if ( hdr.symmetry != SLU_MM_GENERAL && hdr.m != hdr.n ) info = 5;
+    if ( info ) {
+	if ( !iam ) fprintf(stderr, "%s: %s\n", filename,
+			    "rectangular matrix cannot be symmetric");
+	return info;
+    }
+    expand = (hdr.symmetry != SLU_MM_GENERAL);
+
+    buf = superlu_mm_read_lines(filename, &hdr, comm, &len);
+    end = buf + len;
+    for (p = buf, nlines = 0; p < end; ++p) nlines += (*p == '\n');
+    ++nlines;
+    if ( expand ) nlines *= 2;
+    ij = intMalloc_dist(2 * nlines);
+    val = doublecomplexMalloc_dist(nlines);
+    if ( !ij || !val ) ABORT("Malloc fails for the entries.");
+
+    /* Parse the triplets */
+    imin = hdr.m + hdr.n;
+    for (p = buf, nz = 0; p < end; p = eol + 1) {
+	if ( !(eol = memchr(p, '\n', end - p)) ) eol = end;
+	if ( *p == '%' || !(p = superlu_parse_int(p, eol, &i)) ) continue;
+	val[nz].r = 1.0;
+	val[nz].i = 0.0;
+	if ( !(p = superlu_parse_int(p, eol, &j)) ||
+	     (hdr.field != SLU_MM_PATTERN &&
+	      (!(p = superlu_parse_double(p, eol, &val[nz].r)) ||
+	       (hdr.field == SLU_MM_COMPLEX &&
+		!superlu_parse_double(p, eol, &val[nz].i)))) ) {
+	    info = 6;
+	    break;
+	}
+	ij[2*nz] = i;
+	ij[2*nz+1] = j;
+	imin = SUPERLU_MIN(imin, SUPERLU_MIN(i, j));
+	++nz;
+	if ( expand && i != j ) {
+	    ij[2*nz] = j;
+	    ij[2*nz+1] = i;
+	    val[nz] = val[nz-1];
+	    if ( hdr.symmetry == SLU_MM_SKEW ) {
+		val[nz].r = -val[nz].r;
+		val[nz].i = -val[nz].i;
+	    } else if ( hdr.symmetry == SLU_MM_HERMITIAN )
+		val[nz].i = -val[nz].i;
+	    ++nz;
+	}
+    }
+    SUPERLU_FREE(buf);
+
+    /* Change to 0-based indexing, and check the bounds */
+    MPI_Allreduce(&imin, &gmin, 1, mpi_int_t, MPI_MIN, comm);
+    if ( gmin > 0 ) for (k = 0; k < 2 * nz; ++k) --ij[k];
+    for (k = 0; k < nz && !info; ++k)
+	if ( ij[2*k] < 0 || ij[2*k] >= hdr.m
+	     || ij[2*k+1] < 0 || ij[2*k+1] >= hdr.n ) info = 7;
+    MPI_Allreduce(MPI_IN_PLACE, &info, 1, MPI_INT, MPI_MAX, comm);
+    if ( info ) {
+	if ( !iam ) fprintf(stderr, "%s: %s\n", filename, info == 6 ?
+			    "invalid entry" : "index out of bound");
+	SUPERLU_FREE(ij);
+	SUPERLU_FREE(val);
+	return info;
+    }
+
+    superlu_mm_distribute(hdr.m, nz, ij, val, sizeof(doublecomplex),
+			  SuperLU_MPI_DOUBLE_COMPLEX, comm,
+			  &m_loc, &fst_row, &nnz_loc, &rowptr, &colind,
+			  &nzval);
+    SUPERLU_FREE(ij);
+    SUPERLU_FREE(val);
+
+    zCreate_CompRowLoc_Matrix_dist(A, hdr.m, hdr.n, nnz_loc, m_loc, fst_row,
+				   (doublecomplex *) nzval, colind, rowptr,
+				   SLU_NR_loc, SLU_Z, SLU_GE);
+    if ( !iam ) {
+	printf("m %lld, n %lld, nonz %lld\n", (long long) hdr.m,
+	       (long long) hdr.n, (long long) hdr.nnz);
+	fflush(stdout);
+    }
+    return 0;
+}
+
+
 static void zreadrhs(int m, doublecomplex *b)
 {
     FILE *fp, *fopen();
@@ -34,10 +34,13 @@ void
 zreadtriple_dist(FILE *fp, int_t *m, int_t *n, int_t *nonz,
 	    doublecomplex **nzval, int_t **rowind, int_t **colptr)
 {
-    int_t    j, k, jsize, nnz, nz, new_nonz;
+    int_t    nnz, nz, new_nonz, bad;
     doublecomplex *a, *val;
     int_t    *asub, *xa, *row, *col;
     int_t    zero_base = 0;
+    char     *buf;
+    void     *base;
+    size_t   len, size;
 
     /* 	File format:
      *    First line:  #rows    #non-zero
@@ -70,49 +73,73 @@ zreadtriple_dist(FILE *fp, int_t *m, int_t *n, int_t *nonz,
     if ( !(col = (int_t *) SUPERLU_MALLOC(new_nonz * sizeof(int_t))) )
         ABORT("Malloc fails for col[]");
 
-    for (j = 0; j < *n; ++j) xa[j] = 0;
-
-    /* Read into the triplet array from a file */
-    for (nnz = 0, nz = 0; nnz < *nonz; ++nnz) {
-
-#ifdef _LONGINT
-        fscanf(fp, "%lld%lld%lf%lf\n", &row[nz], &col[nz], &val[nz].r, &val[nz].i);
-#else // int
-        fscanf(fp, "%d%d%lf%lf\n", &row[nz], &col[nz], &val[nz].r, &val[nz].i);
+    /* Parse the triplets with all the threads from the file mapped in
+       memory; fall back on fscanf() if it cannot be mapped or parsed. */
+    nz = -1;
+#ifndef EXPAND_SYM
+    if ( (buf = superlu_map_stream(fp, &len, &base, &size)) ) {
+	nz = superlu_parse_triples(buf, len, SLU_Z, *nonz, row, col, val);
+	superlu_unmap_stream(base, size);
+    }
 #endif
 
-	if ( nnz == 0 ) { /* first nonzero */
+    if ( nz == *nonz ) {
+	if ( nz > 0 ) {
 	    if ( row[0] == 0 || col[0] == 0 ) {
 		zero_base = 1;
 		printf("triplet file: row/col indices are zero-based.\n");
 	    } else {
 		printf("triplet file: row/col indices are one-based.\n");
-     	    }
-        }
-
-	if ( !zero_base ) {
-	    /* Change to 0-based indexing. */
-	    --row[nz];
-	    --col[nz];
+	    }
 	}
-
-	if (row[nz] < 0 || row[nz] >= *m || col[nz] < 0 || col[nz] >= *n
-	    /*|| val[nz] == 0.*/) {
+	bad = superlu_check_triples(*m, *n, nz, zero_base, row, col);
+	if ( bad >= 0 ) {
 	    fprintf(stderr, "nz " IFMT ", (" IFMT ", " IFMT ") = {%e\t%e} out of bound, removed\n",
-		    nz, row[nz], col[nz], val[nz].r, val[nz].i);
+		    bad, row[bad], col[bad], val[bad].r, val[bad].i);
 	    exit(-1);
-	} else {
-	    ++xa[col[nz]];
-#ifdef EXPAND_SYM
-	    if ( row[nz] != col[nz] ) { /* Excluding diagonal */
-	      ++nz;
-	      row[nz] = col[nz-1];
-	      col[nz] = row[nz-1];
-	      val[nz] = val[nz-1];
-	      ++xa[col[nz]];
+	}
+    } else {
+
+	/* Read into the triplet array from a file */
+	for (nnz = 0, nz = 0; nnz < *nonz; ++nnz) {
+
+#ifdef _LONGINT
+	    fscanf(fp, "%lld%lld%lf%lf\n", &row[nz], &col[nz], &val[nz].r, &val[nz].i);
+#else // int
+	    fscanf(fp, "%d%d%lf%lf\n", &row[nz], &col[nz], &val[nz].r, &val[nz].i);
+#endif
+
+	    if ( nnz == 0 ) { /* first nonzero */
+		if ( row[0] == 0 || col[0] == 0 ) {
+		    zero_base = 1;
+		    printf("triplet file: row/col indices are zero-based.\n");
+		} else {
+		    printf("triplet file: row/col indices are one-based.\n");
+		}
+	    }
+
+	    if ( !zero_base ) {
+		/* Change to 0-based indexing. */
+		--row[nz];
+		--col[nz];
 	    }
+
+	    if (row[nz] < 0 || row[nz] >= *m || col[nz] < 0 || col[nz] >= *n
+		/*|| val[nz] == 0.*/) {
+		fprintf(stderr, "nz " IFMT ", (" IFMT ", " IFMT ") = {%e\t%e} out of bound, removed\n",
+			nz, row[nz], col[nz], val[nz].r, val[nz].i);
+		exit(-1);
+	    } else {
+#ifdef EXPAND_SYM
+		if ( row[nz] != col[nz] ) { /* Excluding diagonal */
+		  ++nz;
+		  row[nz] = col[nz-1];
+		  col[nz] = row[nz-1];
+		  val[nz] = val[nz-1];
+		}
 #endif
-	    ++nz;
+		++nz;
+	    }
 	}
     }
 
@@ -121,37 +148,16 @@ zreadtriple_dist(FILE *fp, int_t *m, int_t *n, int_t *nonz,
     printf("new_nonz after symmetric expansion:\t%d\n", *nonz);
 #endif
 
-
-    /* Initialize the array of column pointers */
-    k = 0;
-    jsize = xa[0];
-    xa[0] = 0;
-    for (j = 1; j < *n; ++j) {
-	k += jsize;
-	jsize = xa[j];
-	xa[j] = k;
-    }
-
-    /* Copy the triplets into the column oriented storage */
-    for (nz = 0; nz < *nonz; ++nz) {
-	j = col[nz];
-	k = xa[j];
-	asub[k] = row[nz];
-	a[k] = val[nz];
-	++xa[j];
-    }
-
-    /* Reset the column pointers to the beginning of each column */
-    for (j = *n; j > 0; --j)
-	xa[j] = xa[j-1];
-    xa[0] = 0;
+    /* Sort the triplets by columns with a stable counting sort */
+    superlu_triples_to_csc(*n, *nonz, row, col, val, sizeof(doublecomplex),
+			   xa, asub, a);
 
     SUPERLU_FREE(val);
     SUPERLU_FREE(row);
     SUPERLU_FREE(col);
 
 #ifdef CHK_INPUT
-    int i;
+    int i, k;
     for (i = 0; i < *n; i++) {
 	printf("Col %d, xa %d\n", i, xa[i]);
 	for (k = xa[i]; k < xa[i+1]; k++)
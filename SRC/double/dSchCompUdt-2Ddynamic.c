@@ -69,6 +69,13 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	 ib = lsub[lptr];            /* Block number of L(i,k). */
 	 temp_nbrow = lsub[lptr+1];  /* Number of full rows. */
 
+	 if ( keep_k && !refact_mask[ib] ) { /* L(i,k) updates kept blocks */
+	     cum_nrow += temp_nbrow;
+	     lptr += LB_DESCRIPTOR + temp_nbrow;
+	     luptr += temp_nbrow;
+	     continue;
+	 }
+
 	 int look_up_flag = 1; /* assume ib is outside look-up window */
 	 for (int j = k0+1; j < SUPERLU_MIN (k0 + num_look_aheads+2, nsupers );
 	      ++j) {
@@ -157,6 +164,7 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
           * of each block in the data arrays, store them in Ublock_info[j]
           * for block U(k,j).
   	  */
+	 int nub_k = jj0; /* end of the U blocks set up in Ublock_info[] */
 	 for (j = jj0; j < nub; ++j) { /* jj0 starts after look-ahead window. */
 	     temp_ncols = 0;
 #if 1
@@ -171,9 +179,11 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	     nsupc = SuperSize(jb);
 	     iukp += UB_DESCRIPTOR; /* Start fstnz of block U(k,j). */
 #endif
-	     Ublock_info[j].iukp = iukp;
-	     Ublock_info[j].rukp = rukp;
-	     Ublock_info[j].jb = jb;
+	     /* A kept column k only updates the refactored blocks. */
+	     if ( keep_k && !refact_mask[jb] ) continue;
+	     Ublock_info[nub_k].iukp = iukp;
+	     Ublock_info[nub_k].rukp = rukp;
+	     Ublock_info[nub_k].jb = jb;
 
 	     /* if ( iam==0 )
 		 printf("j %d: Ublock_info[j].iukp %d, Ublock_info[j].rukp %d,"
@@ -191,7 +201,7 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 		 }
 	     }
 
-	     Ublock_info[j].full_u_cols = temp_ncols;
+	     Ublock_info[nub_k++].full_u_cols = temp_ncols;
 	     ncols += temp_ncols;
 #if 0 // Sherry comment out 5/31/2018 */
 	     /* Jump number of nonzeros in block U(k,jj);
@@ -200,6 +210,7 @@ if ( msg0 && msg2 ) { /* L(:,k) and U(k,:) are not empty. */
 	     iukp += nsupc;
 #endif
          } /* end for j ... compute ldu & ncols */
+	 nub = nub_k;
 
 	 /* Now doing prefix sum on full_u_cols.
 	  * After this, full_u_cols is the number of nonzero columns
@@ -35,37 +35,78 @@ void
 dreadtriple_noheader(FILE *fp, int_t *m, int_t *n, int_t *nonz,
 	    double **nzval, int_t **rowind, int_t **colptr)
 {
-    int_t    i, j, k, jsize, lasta, nnz, nz, new_nonz, minn = 100;
-    double *a, *val, vali;
-    int_t    *asub, *xa, *row, *col;
+    int_t    i, j, k, nnz, nz, new_nonz, minn = 100, bad;
+    double *a, *val = NULL, vali;
+    int_t    *asub, *xa, *row = NULL, *col = NULL;
     int      zero_base = 0, ret_val = 0;
+    char     *buf;
+    void     *base;
+    size_t   len, size;
 
     /* 	File format: Triplet in a line for each nonzero entry:
      *                 row    col    value
      *         or      row    col    real_part	imaginary_part
      */
 
-    /* First pass: determine N and NNZ */
+    /* Parse the triplets with all the threads from the file mapped in
+       memory; fall back on fscanf() if it cannot be mapped or parsed. */
     nz = *n = 0;
+#ifndef EXPAND_SYM
+    if ( (buf = superlu_map_stream(fp, &len, &base, &size)) ) {
+	nz = superlu_parse_triples(buf, len, SLU_D, -1, NULL, NULL, NULL);
+	if ( nz > 0 ) {
+	    if ( !(val = (double *) SUPERLU_MALLOC(nz * sizeof(double))) )
+		ABORT("Malloc fails for val[]");
+	    if ( !(row = (int_t *) SUPERLU_MALLOC(nz * sizeof(int_t))) )
+		ABORT("Malloc fails for row[]");
+	    if ( !(col = (int_t *) SUPERLU_MALLOC(nz * sizeof(int_t))) )
+		ABORT("Malloc fails for col[]");
+	    if ( superlu_parse_triples(buf, len, SLU_D, nz, row, col, val) != nz ) {
+		SUPERLU_FREE(val);
+		SUPERLU_FREE(row);
+		SUPERLU_FREE(col);
+		row = NULL;
+	    }
+	}
+	superlu_unmap_stream(base, size);
+    }
+#endif
+
+    if ( row ) {
+	/* N and the index base from the largest and smallest indices */
+	i = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(max: i) reduction(min: minn)
+#endif
+	for (k = 0; k < nz; ++k) {
+	    i = SUPERLU_MAX(i, SUPERLU_MAX(row[k], col[k]));
+	    minn = SUPERLU_MIN(minn, SUPERLU_MIN(row[k], col[k]));
+	}
+	*n = i;
+    } else {
+	/* First pass: determine N and NNZ */
+	nz = 0;
 
 #ifdef _LONGINT
-    ret_val = fscanf(fp, "%lld%lld%lf\n", &i, &j, &vali);
+	ret_val = fscanf(fp, "%lld%lld%lf\n", &i, &j, &vali);
 #else  // int
-    ret_val = fscanf(fp, "%d%d%lf\n", &i, &j, &vali);
+	ret_val = fscanf(fp, "%d%d%lf\n", &i, &j, &vali);
 #endif
 
-    while (ret_val != EOF) {
-	*n = SUPERLU_MAX(*n, i);
-	*n = SUPERLU_MAX(*n, j);
-	minn = SUPERLU_MIN(minn, i);
-	minn = SUPERLU_MIN(minn, j);
-	++nz;
+	while (ret_val != EOF) {
+	    *n = SUPERLU_MAX(*n, i);
+	    *n = SUPERLU_MAX(*n, j);
+	    minn = SUPERLU_MIN(minn, i);
+	    minn = SUPERLU_MIN(minn, j);
+	    ++nz;
 
 #ifdef _LONGINT
-        ret_val = fscanf(fp, "%lld%lld%lf\n", &i, &j, &vali);
+	    ret_val = fscanf(fp, "%lld%lld%lf\n", &i, &j, &vali);
 #else  // int
-        ret_val = fscanf(fp, "%d%d%lf\n", &i, &j, &vali);
+	    ret_val = fscanf(fp, "%d%d%lf\n", &i, &j, &vali);
 #endif
+	}
+	rewind(fp);
     }
 
     if ( minn == 0 ) { /* zero-based indexing */
@@ -78,7 +119,6 @@ dreadtriple_noheader(FILE *fp, int_t *m, int_t *n, int_t *nonz,
 
     *m = *n;
     *nonz = nz;
-    rewind(fp);
 
 #ifdef EXPAND_SYM
     new_nonz = 2 * *nonz - *n;
@@ -93,46 +133,51 @@ dreadtriple_noheader(FILE *fp, int_t *m, int_t *n, int_t *nonz,
     asub = *rowind;
     xa   = *colptr;
 
-    if ( !(val = (double *) SUPERLU_MALLOC(new_nonz * sizeof(double))) )
-        ABORT("Malloc fails for val[]");
-    if ( !(row = (int_t *) SUPERLU_MALLOC(new_nonz * sizeof(int_t))) )
-        ABORT("Malloc fails for row[]");
-    if ( !(col = (int_t *) SUPERLU_MALLOC(new_nonz * sizeof(int_t))) )
-        ABORT("Malloc fails for col[]");
-
-    for (j = 0; j < *n; ++j) xa[j] = 0;
-
-    /* Read into the triplet array from a file */
-    for (nnz = 0, nz = 0; nnz < *nonz; ++nnz) {
+    if ( row ) {
+	bad = superlu_check_triples(*m, *n, nz, zero_base, row, col);
+	if ( bad >= 0 ) {
+	    fprintf(stderr, "nz" IFMT ", (" IFMT ", " IFMT ") = %e out of bound, removed\n",
+		    bad, row[bad], col[bad], val[bad]);
+	    exit(-1);
+	}
+    } else {
+	if ( !(val = (double *) SUPERLU_MALLOC(new_nonz * sizeof(double))) )
+	    ABORT("Malloc fails for val[]");
+	if ( !(row = (int_t *) SUPERLU_MALLOC(new_nonz * sizeof(int_t))) )
+	    ABORT("Malloc fails for row[]");
+	if ( !(col = (int_t *) SUPERLU_MALLOC(new_nonz * sizeof(int_t))) )
+	    ABORT("Malloc fails for col[]");
+
+	/* Read into the triplet array from a file */
+	for (nnz = 0, nz = 0; nnz < *nonz; ++nnz) {
 #ifdef _LONGINT
-	fscanf(fp, "%lld%lld%lf\n", &row[nz], &col[nz], &val[nz]);
+	    fscanf(fp, "%lld%lld%lf\n", &row[nz], &col[nz], &val[nz]);
 #else // int32
-	fscanf(fp, "%d%d%lf\n", &row[nz], &col[nz], &val[nz]);
+	    fscanf(fp, "%d%d%lf\n", &row[nz], &col[nz], &val[nz]);
 #endif
 
-	if ( !zero_base ) {
-	    /* Change to 0-based indexing. */
-	    --row[nz];
-	    --col[nz];
-	}
+	    if ( !zero_base ) {
+		/* Change to 0-based indexing. */
+		--row[nz];
+		--col[nz];
+	    }
 
-	if (row[nz] < 0 || row[nz] >= *m || col[nz] < 0 || col[nz] >= *n
-	    /*|| val[nz] == 0.*/) {
-	    fprintf(stderr, "nz" IFMT ", (" IFMT ", " IFMT ") = %e out of bound, removed\n",
-		    nz, row[nz], col[nz], val[nz]);
-	    exit(-1);
-	} else {
-	    ++xa[col[nz]];
+	    if (row[nz] < 0 || row[nz] >= *m || col[nz] < 0 || col[nz] >= *n
+		/*|| val[nz] == 0.*/) {
+		fprintf(stderr, "nz" IFMT ", (" IFMT ", " IFMT ") = %e out of bound, removed\n",
+			nz, row[nz], col[nz], val[nz]);
+		exit(-1);
+	    } else {
 #ifdef EXPAND_SYM
-	    if ( row[nz] != col[nz] ) { /* Excluding diagonal */
-	      ++nz;
-	      row[nz] = col[nz-1];
-	      col[nz] = row[nz-1];
-	      val[nz] = val[nz-1];
-	      ++xa[col[nz]];
-	    }
+		if ( row[nz] != col[nz] ) { /* Excluding diagonal */
+		  ++nz;
+		  row[nz] = col[nz-1];
+		  col[nz] = row[nz-1];
+		  val[nz] = val[nz-1];
+		}
 #endif
-	    ++nz;
+		++nz;
+	    }
 	}
     }
 
@@ -141,30 +186,9 @@ dreadtriple_noheader(FILE *fp, int_t *m, int_t *n, int_t *nonz,
     printf("new_nonz after symmetric expansion:\t%d\n", *nonz);
 #endif
 
-
-    /* Initialize the array of column pointers */
-    k = 0;
-    jsize = xa[0];
-    xa[0] = 0;
-    for (j = 1; j < *n; ++j) {
-	k += jsize;
-	jsize = xa[j];
-	xa[j] = k;
-    }
-
-    /* Copy the triplets into the column oriented storage */
-    for (nz = 0; nz < *nonz; ++nz) {
-	j = col[nz];
-	k = xa[j];
-	asub[k] = row[nz];
-	a[k] = val[nz];
-	++xa[j];
-    }
-
-    /* Reset the column pointers to the beginning of each column */
-    for (j = *n; j > 0; --j)
-	xa[j] = xa[j-1];
-    xa[0] = 0;
+    /* Sort the triplets by columns with a stable counting sort */
+    superlu_triples_to_csc(*n, *nonz, row, col, val, sizeof(double),
+			   xa, asub, a);
 
     SUPERLU_FREE(val);
     SUPERLU_FREE(row);
@@ -177,7 +201,6 @@ dreadtriple_noheader(FILE *fp, int_t *m, int_t *n, int_t *nonz,
 	    printf("%d\t%16.10f\n", asub[k], a[k]);
     }
 #endif
-
 }
 
 #if 0
@@ -603,7 +603,7 @@ dtrf3Dpartition_t* dinitTrf3DpartitionLUstructgrid0(int_t n, superlu_dist_option
         }
         SUPERLU_FREE(scuWeight);
     }
-    calcTreeWeight(nsupers, setree, treeList, xsup);
+    calcTreeWeight(nsupers, setree, treeList, xsup, grid3d);
 
     if (grid3d->zscp.Iam){
         SUPERLU_FREE(xsup);
@@ -619,7 +619,7 @@ dtrf3Dpartition_t* dinitTrf3DpartitionLUstructgrid0(int_t n, superlu_dist_option
     }
 
     int maxLvl = log2i(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
-    sForest_t**  sForests = getForests( maxLvl, nsupers, setree, treeList);
+    sForest_t**  sForests = getForests(maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
     /*indexes of trees for my process grid in gNodeList size(maxLvl)*/
     int_t* myTreeIdxs = getGridTrees(grid3d);
     int_t* myZeroTrIdxs = getReplicatedTrees(grid3d);
@@ -791,7 +791,7 @@ dtrf3Dpartition_t* dinitTrf3Dpartition_allgrid(int_t n, superlu_dist_options_t *
         LUstruct->Llu->Lrowind_bc_ptr, LUstruct->Llu->Ufstnz_br_ptr,
         grid3d);
 
-    calcTreeWeight(nsupers, setree, treeList, xsup);
+    calcTreeWeight(nsupers, setree, treeList, xsup, grid3d);
 
     gEtreeInfo_t gEtreeInfo;
     gEtreeInfo.setree = setree;
@@ -803,7 +803,7 @@ dtrf3Dpartition_t* dinitTrf3Dpartition_allgrid(int_t n, superlu_dist_options_t *
     }
 
     int maxLvl = log2i(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
-    sForest_t**  sForests = getForests( maxLvl, nsupers, setree, treeList);
+    sForest_t**  sForests = getForests(maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
     /*indexes of trees for my process grid in gNodeList size(maxLvl)*/
     int_t* myTreeIdxs = getGridTrees(grid3d);
     int_t* myZeroTrIdxs = getReplicatedTrees(grid3d);
@@ -970,7 +970,7 @@ dtrf3Dpartition_t* dinitTrf3Dpartition(int_t nsupers,
 		  LUstruct->Llu->Lrowind_bc_ptr, LUstruct->Llu->Ufstnz_br_ptr,
 		  grid3d);
 
-    calcTreeWeight(nsupers, setree, treeList, xsup);
+    calcTreeWeight(nsupers, setree, treeList, xsup, grid3d);
 
     gEtreeInfo_t gEtreeInfo;
     gEtreeInfo.setree = setree;
@@ -982,7 +982,7 @@ dtrf3Dpartition_t* dinitTrf3Dpartition(int_t nsupers,
     }
 
     int maxLvl = log2i(grid3d->zscp.Np) + 1; /* Levels for Pz process layer */
-    sForest_t**  sForests = getForests( maxLvl, nsupers, setree, treeList);
+    sForest_t**  sForests = getForests(maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
     /*indexes of trees for my process grid in gNodeList size(maxLvl)*/
     int_t* myTreeIdxs = getGridTrees(grid3d);
     int_t* myZeroTrIdxs = getReplicatedTrees(grid3d);
@@ -331,6 +331,278 @@ int_t dzRecvUPanel(int_t k, int_t sender, double alpha, double beta,
 }
 
 
+/* Sparse-aware reduction of the ancestor panels.
+   The ancestors of a grid that is not their owner are zeroed by
+   dzeroSetLU() before its subtrees are factored, so a block of such a
+   panel that is still zero was not touched by the Schur complement
+   updates. The sender sends the positions of the touched blocks in the
+   panel, blk_buf[0] = count and blk_buf[1:count], followed by their values
+   back to back; when all the blocks are touched, the panel is sent as is.
+   The receiver adds them to its own panel. */
+int_t dzSendLPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+                          double* val_buf, dLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    dLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t mycol = MYCOL (iam, grid);
+
+    if (mycol == PCOL( k, grid ))
+	{
+	    int_t lk = LBj( k, grid ); /* Local block number */
+	    int_t* lsub = Llu->Lrowind_bc_ptr[lk];
+	    double* lnzval = Llu->Lnzval_bc_ptr[lk];
+
+	    if (lsub != NULL)
+		{
+		    int_t nlb = lsub[0];
+		    int_t nsupr = lsub[1];   /* LDA of the nzval[] */
+		    int_t nsupc = SuperSize(k);
+		    int_t lptr = BC_HEADER, luptr = 0, nblk = 0, nval = 0;
+
+		    for (int_t lb = 0; lb < nlb; ++lb)
+			{
+			    int_t nbrow = lsub[lptr + 1];
+			    int_t touched = 0;
+			    for (int_t j = 0; j < nsupc && !touched; ++j)
+				for (int_t i = 0; i < nbrow; ++i)
+				    if (lnzval[luptr + j * nsupr + i] != 0.0)
+					{
+					    touched = 1;
+					    break;
+					}
+			    if (touched) blk_buf[++nblk] = lb;
+			    lptr += LB_DESCRIPTOR + nbrow;
+			    luptr += nbrow;
+			}
+		    blk_buf[0] = nblk;
+		    MPI_Send(blk_buf, nblk + 1, mpi_int_t, receiver, k,
+			     grid3d->zscp.comm);
+
+		    if (nblk == nlb)
+			{
+			    nval = nsupc * nsupr;
+			    MPI_Send(lnzval, nval, MPI_DOUBLE, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    else if (nblk)
+			{
+			    lptr = BC_HEADER;
+			    luptr = 0;
+			    for (int_t lb = 0, ib = 1; ib <= nblk; ++lb)
+				{
+				    int_t nbrow = lsub[lptr + 1];
+				    if (lb == blk_buf[ib])
+					{
+					    for (int_t j = 0; j < nsupc; ++j)
+						for (int_t i = 0; i < nbrow; ++i)
+						    val_buf[nval++] = lnzval[luptr + j * nsupr + i];
+					    ++ib;
+					}
+				    lptr += LB_DESCRIPTOR + nbrow;
+				    luptr += nbrow;
+				}
+			    MPI_Send(val_buf, nval, MPI_DOUBLE, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    SCT->commVolRed += (nblk + 1) * sizeof(int_t)
+			+ nval * sizeof(double);
+		}
+	}
+    return 0;
+}
+
+
+int_t dzRecvLPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+                          double* Lval_buf, dLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    dLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t mycol = MYCOL (iam, grid);
+
+    if (mycol == PCOL( k, grid ))
+	{
+	    int_t lk = LBj( k, grid ); /* Local block number */
+	    int_t* lsub = Llu->Lrowind_bc_ptr[lk];
+	    double* lnzval = Llu->Lnzval_bc_ptr[lk];
+
+	    if (lsub != NULL)
+		{
+		    int_t nlb = lsub[0];
+		    int_t nsupr = lsub[1];   /* LDA of the nzval[] */
+		    int_t nsupc = SuperSize(k);
+		    int_t len2 = nsupc * nsupr;
+		    MPI_Status status;
+
+		    MPI_Recv(blk_buf, nlb + 1, mpi_int_t, sender, k,
+			     grid3d->zscp.comm, &status);
+		    int_t nblk = blk_buf[0];
+		    if (nblk == 0) return 0;
+
+		    MPI_Recv(Lval_buf, len2, MPI_DOUBLE, sender, k,
+			     grid3d->zscp.comm, &status);
+
+		    /*reduce the updates*/
+		    if (nblk == nlb)
+			{
+			    superlu_daxpy(len2, 1.0, Lval_buf, 1, lnzval, 1);
+			    return 0;
+			}
+		    int_t lptr = BC_HEADER, luptr = 0, nval = 0;
+		    for (int_t lb = 0, ib = 1; ib <= nblk; ++lb)
+			{
+			    int_t nbrow = lsub[lptr + 1];
+			    if (lb == blk_buf[ib])
+				{
+				    for (int_t j = 0; j < nsupc; ++j)
+					for (int_t i = 0; i < nbrow; ++i)
+					    lnzval[luptr + j * nsupr + i] += Lval_buf[nval++];
+				    ++ib;
+				}
+			    lptr += LB_DESCRIPTOR + nbrow;
+			    luptr += nbrow;
+			}
+		}
+	}
+    return 0;
+}
+
+
+int_t dzSendUPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+                          double* val_buf, dLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    dLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t myrow = MYROW (iam, grid);
+
+    if (myrow == PROW( k, grid ))
+	{
+	    int_t lk = LBi( k, grid ); /* Local block number */
+	    int_t* usub = Llu->Ufstnz_br_ptr[lk];
+	    double* unzval = Llu->Unzval_br_ptr[lk];
+
+	    if (usub != NULL)
+		{
+		    int_t nub = usub[0];
+		    int_t iukp = BR_HEADER, rukp = 0, nblk = 0, nval = 0;
+
+		    for (int_t ub = 0; ub < nub; ++ub)
+			{
+			    int_t gb = usub[iukp];
+			    int_t len = usub[iukp + 1]; /* nonzeros of the block */
+			    for (int_t i = 0; i < len; ++i)
+				if (unzval[rukp + i] != 0.0)
+				    {
+					blk_buf[++nblk] = ub;
+					break;
+				    }
+			    iukp += UB_DESCRIPTOR + SuperSize(gb);
+			    rukp += len;
+			}
+		    blk_buf[0] = nblk;
+		    MPI_Send(blk_buf, nblk + 1, mpi_int_t, receiver, k,
+			     grid3d->zscp.comm);
+
+		    if (nblk == nub)
+			{
+			    nval = usub[1];
+			    MPI_Send(unzval, nval, MPI_DOUBLE, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    else if (nblk)
+			{
+			    iukp = BR_HEADER;
+			    rukp = 0;
+			    for (int_t ub = 0, ib = 1; ib <= nblk; ++ub)
+				{
+				    int_t gb = usub[iukp];
+				    int_t len = usub[iukp + 1];
+				    if (ub == blk_buf[ib])
+					{
+					    memcpy(&val_buf[nval], &unzval[rukp],
+						   len * sizeof(double));
+					    nval += len;
+					    ++ib;
+					}
+				    iukp += UB_DESCRIPTOR + SuperSize(gb);
+				    rukp += len;
+				}
+			    MPI_Send(val_buf, nval, MPI_DOUBLE, receiver, k,
+				     grid3d->zscp.comm);
+			}
+		    SCT->commVolRed += (nblk + 1) * sizeof(int_t)
+			+ nval * sizeof(double);
+		}
+	}
+    return 0;
+}
+
+
+int_t dzRecvUPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+                          double* Uval_buf, dLUstruct_t* LUstruct,
+                          gridinfo3d_t* grid3d, SCT_t* SCT)
+{
+    dLocalLU_t *Llu = LUstruct->Llu;
+    int_t* xsup = LUstruct->Glu_persist->xsup;
+    gridinfo_t* grid = &(grid3d->grid2d);
+    int_t iam = grid->iam;
+    int_t myrow = MYROW (iam, grid);
+
+    if (myrow == PROW( k, grid ))
+	{
+	    int_t lk = LBi( k, grid ); /* Local block number */
+	    int_t* usub = Llu->Ufstnz_br_ptr[lk];
+	    double* unzval = Llu->Unzval_br_ptr[lk];
+
+	    if (usub != NULL)
+		{
+		    int_t nub = usub[0];
+		    int_t lenv = usub[1];
+		    MPI_Status status;
+
+		    MPI_Recv(blk_buf, nub + 1, mpi_int_t, sender, k,
+			     grid3d->zscp.comm, &status);
+		    int_t nblk = blk_buf[0];
+		    if (nblk == 0) return 0;
+
+		    MPI_Recv(Uval_buf, lenv, MPI_DOUBLE, sender, k,
+			     grid3d->zscp.comm, &status);
+
+		    /*reduce the updates*/
+		    if (nblk == nub)
+			{
+			    superlu_daxpy(lenv, 1.0, Uval_buf, 1, unzval, 1);
+			    return 0;
+			}
+		    int_t iukp = BR_HEADER, rukp = 0, nval = 0;
+		    for (int_t ub = 0, ib = 1; ib <= nblk; ++ub)
+			{
+			    int_t gb = usub[iukp];
+			    int_t len = usub[iukp + 1];
+			    if (ub == blk_buf[ib])
+				{
+				    superlu_daxpy(len, 1.0, &Uval_buf[nval], 1,
+						  &unzval[rukp], 1);
+				    nval += len;
+				    ++ib;
+				}
+			    iukp += UB_DESCRIPTOR + SuperSize(gb);
+			    rukp += len;
+			}
+		}
+	}
+    return 0;
+}
+
+
 int_t dp3dScatter(int_t n, dLUstruct_t * LUstruct, gridinfo3d_t* grid3d, int *supernodeMask)
 /* Copies LU structure from layer 0 to all the layers */
 {
@@ -963,27 +1235,29 @@ int_t dzeroSetLU(int_t nnodes, int_t* nodeList, dLUstruct_t *LUstruct,
 
 int_t dreduceAncestors3d(int_t sender, int_t receiver,
                         int_t nnodes, int_t* nodeList,
-                        double* Lval_buf, double* Uval_buf,
+                        dLUValSubBuf_t* LUvsb,
                         dLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT)
 {
-    double alpha = 1.0, beta = 1.0;
     int_t myGrid = grid3d->zscp.Iam;
 
-    /*first setting the L blocks to zero*/
+    /* Only the blocks touched by the sender's subtrees are sent, see
+       dzSendLPanelTouched(); the buffers of LUvsb are free on both sides. */
     for (int_t node = 0; node < nnodes; ++node)   /* for each block column ... */
 	{
 	    int_t jb = nodeList[node];
 
 	    if (myGrid == sender)
 		{
-		    dzSendLPanel(jb, receiver, LUstruct,  grid3d, SCT);
-		    dzSendUPanel(jb, receiver, LUstruct,  grid3d, SCT);
+		    dzSendLPanelTouched(jb, receiver, LUvsb->Lsub_buf,
+					LUvsb->Lval_buf, LUstruct, grid3d, SCT);
+		    dzSendUPanelTouched(jb, receiver, LUvsb->Usub_buf,
+					LUvsb->Uval_buf, LUstruct, grid3d, SCT);
 		}
 	    else {
-	        dzRecvLPanel(jb, sender, alpha, beta, Lval_buf,
-                                LUstruct, grid3d, SCT);
-		dzRecvUPanel(jb, sender, alpha, beta, Uval_buf,
-                                LUstruct,  grid3d, SCT);
+	        dzRecvLPanelTouched(jb, sender, LUvsb->Lsub_buf,
+				    LUvsb->Lval_buf, LUstruct, grid3d, SCT);
+		dzRecvUPanelTouched(jb, sender, LUvsb->Usub_buf,
+				    LUvsb->Uval_buf, LUstruct, grid3d, SCT);
 	    }
 
 	}
@@ -1047,8 +1321,6 @@ int dreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
                              dLUValSubBuf_t* LUvsb, dLUstruct_t* LUstruct,
                              gridinfo3d_t* grid3d, SCT_t* SCT )
 {
-    double * Lval_buf  = LUvsb->Lval_buf;
-    double * Uval_buf  = LUvsb->Uval_buf;
     int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
     int_t myGrid = grid3d->zscp.Iam;
 
@@ -1064,6 +1336,10 @@ int dreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 	    receiver = myGrid - (1 << ilvl);
 	}
 
+    /* When Np is not a power of two, the last grids have no partner at
+       the upper levels; see log2i() */
+    if (sender >= grid3d->zscp.Np) return 0;
+
     /*Reduce all the ancestors*/
     for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
@@ -1073,7 +1349,7 @@ int dreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount, int_t** treePerm,
 	    int_t* cAncestorList = treePerm[alvl];
 	    double treduce = SuperLU_timer_();
 	    dreduceAncestors3d(sender, receiver, nsAncestor, cAncestorList,
-			        Lval_buf, Uval_buf, LUstruct, grid3d, SCT);
+			        LUvsb, LUstruct, grid3d, SCT);
 	    SCT->ancsReduce += SuperLU_timer_() - treduce;
 
 	}
@@ -1111,6 +1387,7 @@ int_t dgatherAllFactoredLU( dtrf3Dpartition_t*  trf3Dpartition,
 			    sender = myGrid;
 			    receiver = myGrid - (1 << ilvl);
 			}
+		    if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
 
 		    for (int_t alvl = 0; alvl <= ilvl; alvl++)
 			{
@@ -1172,6 +1449,7 @@ int_t dbroadcastAncestor3d( dtrf3Dpartition_t*  trf3Dpartition,
 				sender = myGrid - (1 << (ilvl-1));
 				receiver = myGrid ;
 			}
+			if (receiver >= grid3d->zscp.Np) continue; /* no partner grid */
 			int_t tr =  tree;
 			for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
 			{
@@ -1215,6 +1493,7 @@ int_t dgatherAllFactoredLU3d( dtrf3Dpartition_t*  trf3Dpartition,
 		{
 			int sender = (1 << (ilvl )) * ( tr - start );
 			int receiver =0;
+			if (sender >= grid3d->zscp.Np) continue; /* no such grid */
 			//printf("tr = %d, sender %d, receiver %d\n", tr, sender, receiver);
 			if(myGrid == sender || myGrid == receiver)
 			dgatherFactoredLU(sender, receiver,
@@ -304,9 +304,15 @@ at the top-level directory.
  *                             (possibly row and/or column scaled and/or
  *                              permuted)
  *                          modified LUstruct->Llu
+ *             If only some rows or columns of A changed, pdgsrefact_mark()
+ *             can be called before, so that only the supernodes depending
+ *             on them are reloaded and refactored.
  *           = FACTORED: the matrix A is already factored.
  *                 Inputs:  all of ScalePermstruct
  *                          all of LUstruct
+ *             The low-rank updates attached by pdgsupdate_lowrank()
+ *             are applied by pdgssvx_lowrank(), not here. Any other
+ *             value of Fact discards them.
  *
  *         o Equil (yes_no_t)
  *           Specifies whether to equilibrate the system.
@@ -330,6 +336,9 @@ at the top-level directory.
  *                        off-diagonal.
  *           = MY_PERMR:  use the ordering given in ScalePermstruct->perm_r
  *                        input by the user.
+ *           = LargeDiag_AUCTION: like LargeDiag_MC64, but the matching is
+ *                        computed by a distributed auction on the local
+ *                        rows of A, without gathering A to one process.
  *
  *         o ColPerm (colperm_t)
  *           Specifies what type of column permutation to use to reduce fill.
@@ -536,7 +545,7 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
     int_t   *etree;  /* elimination tree */
     int_t   *rowptr, *colind;  /* Local A in NR*/
     int_t   nnz_loc, nnz;
-    int     m_loc, fst_row, icol, iinfo;
+    int     m_loc, fst_row, icol, iinfo, ruiz;
     int     colequ, Equil, factored, job, notran, rowequ, need_value;
     int_t   i, j, irow, m, n;
     int     permc_spec;
@@ -549,6 +558,8 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
     float    GA_mem_use = 0.0;    /* memory usage by global A */
     float    dist_mem_use = 0.0;  /* memory usage during distribution */
     superlu_dist_mem_usage_t num_mem_usage, symb_mem_usage;
+    symbfact_cache_key_t symb_key = {0};  /* fingerprint for the symbolic cache */
+    int      symb_cached = 0;
     int64_t  nnzLU;
     int_t    nnz_tot;
     double *nzval_a;
@@ -592,9 +603,10 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
     Fact = options->Fact;
     if ( Fact < DOFACT || Fact > FACTORED )
 	*info = -1;
-    else if ( options->RowPerm < NOROWPERM || options->RowPerm > MY_PERMR )
+    else if ( options->RowPerm < NOROWPERM ||
+              options->RowPerm > LargeDiag_AUCTION )
 	*info = -1;
-    else if ( options->ColPerm < NATURAL || options->ColPerm > MY_PERMC )
+    else if ( options->ColPerm < NATURAL || options->ColPerm > ND_AT_PLUS_A )
 	*info = -1;
     else if ( options->IterRefine < NOREFINE || options->IterRefine > SLU_EXTRA )
 	*info = -1;
@@ -621,6 +633,9 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 
     factored = (Fact == FACTORED);
     Equil = (!factored && options->Equil == YES);
+
+    /* A new factorization drops the updates of pdgsupdate_lowrank(). */
+    if ( !factored ) dLowRankFree(LUstruct);
     notran = (options->Trans == NOTRANS);
     parSymbFact = options->ParSymbFact;
 
@@ -714,6 +729,41 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 		}
 	        break;
 	    }
+	} else if ( (ruiz = get_equil_ruiz()) > 0 ) {
+	    /* Iterative scaling with neighbor communication only. With
+	       SamePattern, start from the previous R and C; they are kept
+	       if they still equilibrate A within the tolerance. */
+	    ruiz = pdgsequ_ruiz(A, R, C, (yes_no_t) (Fact == SamePattern &&
+				 ScalePermstruct->DiagScale == BOTH),
+				 ruiz, get_equil_tol(), &iinfo, grid);
+	    if ( iinfo > 0 ) {
+		if ( iinfo <= m ) {
+		    fprintf(stderr, "The %d-th row of A is exactly zero\n", (int)iinfo);
+		} else {
+                    fprintf(stderr, "The %d-th column of A is exactly zero\n", (int)(iinfo-n));
+                }
+ 	    } else if ( iinfo < 0 ) return;
+
+	    /* A <-- diag(R)*A*diag(C); R = C = 1 if A has an empty row
+	       or column. */
+	    irow = fst_row;
+	    for (j = 0; j < m_loc; ++j) {
+		for (i = rowptr[j]; i < rowptr[j+1]; ++i) {
+		    icol = colind[i];
+		    a[i] *= R[irow] * C[icol]; /* Scale rows and cols. */
+		}
+		++irow;
+	    }
+	    ScalePermstruct->DiagScale = BOTH;
+	    rowequ = ROW;
+	    colequ = COL;
+
+#if ( PRNTlevel>=1 )
+	    if ( !iam ) {
+		printf(".. Ruiz equilibration steps %d\n", ruiz);
+		fflush(stdout);
+	    }
+#endif
 	} else { /* Compute R & C from scratch */
             /* Compute the row and column scalings. */
 	    pdgsequ(A, R, C, &rowcnd, &colcnd, &amax, &iinfo, grid);
@@ -798,8 +848,9 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	            	irow = rowind[i];
 		    	rowind[i] = perm_r[irow];
 	            }
-	        } else if ( options->RowPerm == LargeDiag_MC64 ) {
-	            /* Get a new perm_r[] from MC64 */
+	        } else if ( options->RowPerm == LargeDiag_MC64 ||
+	                    options->RowPerm == LargeDiag_AUCTION ) {
+	            /* Get a new perm_r[] from MC64 or the auction */
 	            if ( job == 5 ) {
 		        /* Allocate storage for scaling factors. */
 		        if ( !(R1 = doubleMalloc_dist(m)) )
@@ -808,7 +859,10 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 		            ABORT("SUPERLU_MALLOC fails for C1[]");
 	            }
 
-	            if ( !iam ) { /* Process 0 finds a row permutation */
+	            if ( options->RowPerm == LargeDiag_AUCTION ) {
+		        /* All processes match their own rows of A. */
+		        iinfo = pdldperm_dist(job, A, grid, perm_r, R1, C1);
+	            } else if ( !iam ) { /* Process 0 finds a row permutation */
 		        iinfo = dldperm_dist(job, m, nnz, colptr, rowind, a_GA,
 		                perm_r, R1, C1);
 
@@ -998,7 +1052,14 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	    }
         } /* end preparing for parallel symbolic */
 
-	if ( permc_spec != MY_PERMC && Fact == DOFACT ) {
+	/* Look up the ordering and the serial symbolic factorization of
+	   this pattern in the cache directory given by SUPERLU_SYMB_CACHE. */
+	if ( parSymbFact == NO && Fact == DOFACT && permc_spec != PARMETIS )
+	    symb_cached = symbfact_cache_load(options, &GA, perm_c, etree,
+	                          Glu_persist, &Glu_freeable, &symb_mem_usage,
+	                          grid, &symb_key);
+
+	if ( !symb_cached && permc_spec != MY_PERMC && Fact == DOFACT ) {
           /* Reuse perm_c if Fact == SamePattern, or SamePattern_SameRowPerm */
 	  if ( permc_spec == PARMETIS ) {
 	// #pragma omp parallel
@@ -1020,8 +1081,10 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 		  *info = flinfo;
 		  return;
      	      }
-	  } else {
-	      get_perm_c_dist(iam, permc_spec, &GA, perm_c);
+	  } else if ( parSymbFact == NO || permc_spec != NATURAL ) {
+	      /* perm_c is already the identity for ParSymbFact, where GA
+	         may not have been formed */
+	      get_perm_c_stat(iam, permc_spec, &GA, perm_c, stat);
           }
         }
 
@@ -1029,7 +1092,10 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 
 	/* Symbolic factorization. */
 	if ( Fact != SamePattern_SameRowPerm ) {
-	    if ( parSymbFact == NO ) { /* Perform serial symbolic factorization */
+	    if ( parSymbFact == NO && symb_cached ) {
+		nnzLU = Glu_freeable->nnzLU;
+		stat->utime[SYMBFAC] = 0.0;
+	    } else if ( parSymbFact == NO ) { /* Perform serial symbolic factorization */
 		/* GA = Pr*A, perm_r[] is already applied. */
 	        int_t *GACcolbeg, *GACcolend, *GACrowind;
 
@@ -1075,6 +1141,8 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	    	stat->utime[SYMBFAC] = SuperLU_timer_() - t;
 	    	if ( linfo <= 0 ) { /* Successful return */
 		    QuerySpace_dist(n, -linfo, Glu_freeable, &symb_mem_usage);
+		    symbfact_cache_store(&symb_key, n, perm_c, etree, Glu_persist,
+		                         Glu_freeable, grid);
 #if ( PRNTlevel>=1 )
 		    if ( !iam ) {
 		    	printf("\tNo of supers " IFMT "\n", Glu_persist->supno[n-1]+1);
@@ -1116,7 +1184,7 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
             /* Destroy global GA */
             if ( parSymbFact == NO || options->RowPerm != NO )
                 Destroy_CompCol_Matrix_dist(&GA);
-            if ( parSymbFact == NO )
+            if ( parSymbFact == NO && !symb_cached )
  	        Destroy_CompCol_Permuted_dist(&GAC);
 
 	} /* end if Fact != SamePattern_SameRowPerm ... */
@@ -1125,6 +1193,14 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
         if (fstVtxSep) SUPERLU_FREE (fstVtxSep);
 	if (symb_comm != MPI_COMM_NULL) MPI_Comm_free (&symb_comm);
 
+	/* The refactorization mask set by pdgsrefact_mark() only applies
+	   to SamePattern_SameRowPerm with the serial symbolic factorization. */
+	if ( LUstruct->Llu->refact_mask &&
+	     (Fact != SamePattern_SameRowPerm || parSymbFact == YES) ) {
+	    SUPERLU_FREE(LUstruct->Llu->refact_mask);
+	    LUstruct->Llu->refact_mask = NULL;
+	}
+
 	/* Distribute entries of A into L & U data structures. */
 	//if (parSymbFact == NO || ???? Fact == SamePattern_SameRowPerm) {
 	if ( parSymbFact == NO ) {
@@ -1180,6 +1256,10 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 	stat->utime[FACT] = SuperLU_timer_() - t;
 	// }
 	// }
+	if ( LUstruct->Llu->refact_mask ) { /* consumed */
+	    SUPERLU_FREE(LUstruct->Llu->refact_mask);
+	    LUstruct->Llu->refact_mask = NULL;
+	}
 
 
 #if ( PRNTlevel>=2 )
@@ -1454,7 +1534,11 @@ pdgssvx(superlu_dist_options_t *options, SuperMatrix *A,
 
 
 	if ( options->DiagInv==YES && (Fact != FACTORED) ) {
-	    pdCompute_Diag_Inv(n, LUstruct, grid, stat, info);
+	    if ( get_diaginv_single() && !get_acc_solve() ) {
+		pdCompute_Diag_Inv_s(n, LUstruct, grid, stat, info);
+	    } else {
+		pdCompute_Diag_Inv(n, LUstruct, grid, stat, info);
+	    }
 		int_t nsupers = getNsupers(n, LUstruct->Glu_persist);
 #ifdef GPU_ACC
 		pdconvertU(options, grid, LUstruct, stat, n);
@@ -0,0 +1,280 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Solves (A + U*V^T) X = B with the factorization of A
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * The low-rank updates U*V^T attached to a factored dLUstruct_t by
+ * pdgsupdate_lowrank() are applied at solve time with the
+ * Sherman-Morrison-Woodbury formula
+ *
+ *     inv(A + U*V^T) = inv(A) - Z * inv(I + V^T*Z) * V^T * inv(A),
+ *
+ * where Z = inv(A)*U is computed once per update with the triangular
+ * solves of pdgssvx(). The k-by-k capacitance matrix I + V^T*Z is
+ * replicated on all the processes and factored with partial pivoting.
+ * </pre>
+ */
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/* LU factorization with partial pivoting of the n-by-n matrix a[]. */
+static int
+dlowrank_getrf(int n, double *a, int lda, int *ipiv)
+{
+    int i, j, k, p;
+    double t;
+
+    for (k = 0; k < n; ++k) {
+	for (p = k, i = k + 1; i < n; ++i)
+	    if ( fabs(a[i + k*lda]) > fabs(a[p + k*lda]) ) p = i;
+	ipiv[k] = p;
+	if ( a[p + k*lda] == 0.0 ) return k + 1;
+	if ( p != k )
+	    for (j = 0; j < n; ++j) {
+		t = a[k + j*lda]; a[k + j*lda] = a[p + j*lda]; a[p + j*lda] = t;
+	    }
+	for (i = k + 1; i < n; ++i) a[i + k*lda] /= a[k + k*lda];
+	for (j = k + 1; j < n; ++j)
+	    for (i = k + 1; i < n; ++i)
+		a[i + j*lda] -= a[i + k*lda] * a[k + j*lda];
+    }
+    return 0;
+}
+
+/* Solve with the factors of dlowrank_getrf(); b[] is n-by-nrhs. */
+static void
+dlowrank_getrs(int n, double *a, int lda, int *ipiv, int nrhs,
+	       double *b, int ldb)
+{
+    int i, j, k;
+    double t, *x;
+
+    for (j = 0; j < nrhs; ++j) {
+	x = &b[j*ldb];
+	for (k = 0; k < n; ++k) {
+	    t = x[ipiv[k]]; x[ipiv[k]] = x[k]; x[k] = t;
+	    for (i = k + 1; i < n; ++i) x[i] -= a[i + k*lda] * x[k];
+	}
+	for (k = n - 1; k >= 0; --k) {
+	    x[k] /= a[k + k*lda];
+	    for (i = 0; i < k; ++i) x[i] -= a[i + k*lda] * x[k];
+	}
+    }
+}
+
+/*! \brief Free the low-rank updates attached to LUstruct. */
+void
+dLowRankFree(dLUstruct_t *LUstruct)
+{
+    dLowRank_t *lr = LUstruct->lowrank;
+
+    if ( !lr ) return;
+    SUPERLU_FREE(lr->V);
+    SUPERLU_FREE(lr->Z);
+    SUPERLU_FREE(lr->CapLU);
+    SUPERLU_FREE(lr->ipiv);
+    SUPERLU_FREE(lr);
+    LUstruct->lowrank = NULL;
+}
+
+/*! \brief Attach the rank-k update U*V^T to the factorization of A.
+
+ <pre>
+    Purpose
+    =======
+
+    PDGSUPDATE_LOWRANK records U*V^T so that the subsequent calls to
+    pdgssvx_lowrank() solve with A + U*V^T plus all the updates attached
+    before, while the L and U factors of A are left untouched.
+
+    A, ScalePermstruct and LUstruct must hold a factorization computed by
+    pdgssvx(). U and V are distributed by rows as B in pdgssvx(): the
+    local m_loc-by-k blocks of U and V are stored with the leading
+    dimensions ldu and ldv >= m_loc.
+
+    The updates are kept until pdgssvx() refactors, or until the total
+    rank would exceed the limit set by the environment variable
+    SUPERLU_LOWRANK_MAX (default 32). In the latter case nothing is
+    attached, 1 is returned and the caller is expected to refactor
+    A + U*V^T with the updates folded in.
+
+    Collective over grid->comm. Return value:
+      = 0: the update is attached;
+      = 1: the rank limit is reached; nothing is attached;
+      = 2: I + V^T*inv(A)*U is exactly singular; nothing is attached.
+    info is set by the solves with pdgssvx().
+ </pre>
+*/
+int
+pdgsupdate_lowrank(superlu_dist_options_t *options, int k, double *U,
+		   int ldu, double *V, int ldv, SuperMatrix *A,
+		   dScalePermstruct_t *ScalePermstruct,
+		   dLUstruct_t *LUstruct, gridinfo_t *grid,
+		   SuperLUStat_t *stat, int *info)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    dLowRank_t *lr = LUstruct->lowrank;
+    superlu_dist_options_t opts;
+    dSOLVEstruct_t SOLVEstruct;
+    int m_loc = Astore->m_loc, ld = SUPERLU_MAX(m_loc, 1);
+    int i, j, kn, kmax;
+    double *berr, *Vk, *Zk;
+
+    *info = 0;
+    if ( k <= 0 ) return 0;
+
+    if ( !lr ) {
+	kmax = get_lowrank_max();
+	if ( k > kmax ) return 1;
+	if ( !(lr = (dLowRank_t *) SUPERLU_MALLOC(sizeof(dLowRank_t))) )
+	    ABORT("Malloc fails for lowrank.");
+	lr->m_loc = m_loc;
+	lr->k = 0;
+	lr->kmax = kmax;
+	if ( !(lr->V = doubleMalloc_dist(ld * kmax)) )
+	    ABORT("Malloc fails for V[].");
+	if ( !(lr->Z = doubleMalloc_dist(ld * kmax)) )
+	    ABORT("Malloc fails for Z[].");
+	if ( !(lr->CapLU = doubleMalloc_dist(kmax * kmax)) )
+	    ABORT("Malloc fails for CapLU[].");
+	if ( !(lr->ipiv = SUPERLU_MALLOC(kmax * sizeof(int))) )
+	    ABORT("Malloc fails for ipiv[].");
+	LUstruct->lowrank = lr;
+    }
+    kn = lr->k + k;
+    if ( kn > lr->kmax ) return 1;
+
+    /* Z(:,k0:kn-1) = inv(A) * U, with a solve structure of its own, as
+       the one of pdgssvx_lowrank() is set up for the number of
+       right-hand sides of the caller. The refinement is skipped, as it
+       would set up pdgsmv_init() on A a second time. */
+    Vk = &lr->V[lr->k * ld];
+    Zk = &lr->Z[lr->k * ld];
+    for (j = 0; j < k; ++j)
+	for (i = 0; i < m_loc; ++i) {
+	    Vk[i + j*ld] = V[i + j*ldv];
+	    Zk[i + j*ld] = U[i + j*ldu];
+	}
+    if ( !(berr = doubleMalloc_dist(k)) )
+	ABORT("Malloc fails for berr[].");
+    opts = *options;
+    opts.Fact = FACTORED;
+    opts.Trans = NOTRANS;
+    opts.SolveInitialized = NO;
+    opts.RefineInitialized = NO;
+    opts.IterRefine = NOREFINE;
+    opts.PrintStat = NO;
+    pdgssvx(&opts, A, ScalePermstruct, Zk, ld, k, grid, LUstruct,
+	    &SOLVEstruct, berr, stat, info);
+    if ( opts.SolveInitialized ) {
+	dSolveFinalize(&opts, &SOLVEstruct);
+	if ( get_acc_solve() ) pdgstrs_delete_device_lsum_x(&SOLVEstruct);
+    }
+    SUPERLU_FREE(berr);
+    if ( *info ) return 0;
+
+    /* CapLU = I + V^T * Z, summed over the rows of all the processes. */
+    for (j = 0; j < kn; ++j)
+	for (i = 0; i < kn; ++i) lr->CapLU[i + j*kn] = 0.0;
+    if ( m_loc )
+	superlu_dgemm("T", "N", kn, kn, m_loc, 1.0, lr->V, ld,
+		      lr->Z, ld, 0.0, lr->CapLU, kn);
+    MPI_Allreduce(MPI_IN_PLACE, lr->CapLU, kn * kn, MPI_DOUBLE, MPI_SUM,
+		  grid->comm);
+    for (i = 0; i < kn; ++i) lr->CapLU[i + i*kn] += 1.0;
+
+    if ( dlowrank_getrf(kn, lr->CapLU, kn, lr->ipiv) ) {
+	/* Drop the new update and restore the factors of the old one. */
+	if ( lr->k == 0 ) {
+	    dLowRankFree(LUstruct);
+	    return 2;
+	}
+	kn = lr->k;
+	for (j = 0; j < kn; ++j)
+	    for (i = 0; i < kn; ++i) lr->CapLU[i + j*kn] = 0.0;
+	if ( m_loc )
+	    superlu_dgemm("T", "N", kn, kn, m_loc, 1.0, lr->V, ld,
+			  lr->Z, ld, 0.0, lr->CapLU, kn);
+	MPI_Allreduce(MPI_IN_PLACE, lr->CapLU, kn * kn, MPI_DOUBLE, MPI_SUM,
+		      grid->comm);
+	for (i = 0; i < kn; ++i) lr->CapLU[i + i*kn] += 1.0;
+	dlowrank_getrf(kn, lr->CapLU, kn, lr->ipiv);
+	return 2;
+    }
+    lr->k = kn;
+    return 0;
+}
+
+/*! \brief Solve (A + U*V^T) X = B with the factorization of A.
+
+ <pre>
+    Purpose
+    =======
+
+    PDGSSVX_LOWRANK solves the system with A plus the low-rank updates
+    attached by pdgsupdate_lowrank(), using the factorization of A computed
+    by pdgssvx(). The arguments are those of pdgssvx() with
+    options->Fact = FACTORED, which is set for the duration of the call.
+    Without an attached update it is the solve of pdgssvx(); with one,
+    only options->Trans = NOTRANS is supported and info = -1 is returned
+    otherwise.
+
+    On exit, berr[] is the componentwise backward error of the solve with
+    A, before the low-rank correction.
+ </pre>
+*/
+void
+pdgssvx_lowrank(superlu_dist_options_t *options, SuperMatrix *A,
+		dScalePermstruct_t *ScalePermstruct, double B[], int ldb,
+		int nrhs, gridinfo_t *grid, dLUstruct_t *LUstruct,
+		dSOLVEstruct_t *SOLVEstruct, double *berr,
+		SuperLUStat_t *stat, int *info)
+{
+    dLowRank_t *lr = LUstruct->lowrank;
+    fact_t Fact = options->Fact;
+    int ld, kn;
+    double *W;
+
+    if ( lr && lr->k > 0 && options->Trans != NOTRANS ) {
+	*info = -1;
+	pxerr_dist("pdgssvx_lowrank", grid, -*info);
+	return;
+    }
+
+    /* Y = inv(A) * B */
+    options->Fact = FACTORED;
+    pdgssvx(options, A, ScalePermstruct, B, ldb, nrhs, grid, LUstruct,
+	    SOLVEstruct, berr, stat, info);
+    options->Fact = Fact;
+    if ( *info || !lr || lr->k == 0 ) return;
+
+    /* X = Y - Z * inv(I + V^T*Z) * (V^T * Y) */
+    kn = lr->k;
+    ld = SUPERLU_MAX(lr->m_loc, 1);
+    if ( !(W = doubleCalloc_dist(kn * nrhs)) )
+	ABORT("Calloc fails for W[].");
+    if ( lr->m_loc )
+	superlu_dgemm("T", "N", kn, nrhs, lr->m_loc, 1.0, lr->V, ld,
+		      B, ldb, 0.0, W, kn);
+    MPI_Allreduce(MPI_IN_PLACE, W, kn * nrhs, MPI_DOUBLE, MPI_SUM,
+		  grid->comm);
+    dlowrank_getrs(kn, lr->CapLU, kn, lr->ipiv, nrhs, W, kn);
+    if ( lr->m_loc )
+	superlu_dgemm("N", "N", lr->m_loc, nrhs, kn, -1.0, lr->Z, ld,
+		      W, kn, 1.0, B, ldb);
+    SUPERLU_FREE(W);
+}
@@ -317,6 +317,12 @@ int_t pdgstrf3d(superlu_dist_options_t *options, int m, int n, double anorm,
 
 #endif  // end GPU_ACC
 
+#ifndef GPU_ACC
+    /* record the cost of every supernode for the next partitioning */
+    if ( get_lbs_profile() && !SCT->tSupernode )
+        SCT->tSupernode = doubleCalloc_dist(nsupers);
+#endif
+
     /*====  starting main factorization loop =====*/
     MPI_Barrier( grid3d->comm);
     SCT->tStartup = SuperLU_timer_() - SCT->tStartup;
@@ -393,6 +399,11 @@ int_t pdgstrf3d(superlu_dist_options_t *options, int m, int n, double anorm,
     //printf("After factorization: INFO = %d\n", *info); fflush(stdout);
 
     SCT->pdgstrfTimer = SuperLU_timer_() - SCT->pdgstrfTimer;
+
+    if ( SCT->tSupernode ) {
+        saveSupernodeCost(nsupers, xsup, SCT->tSupernode, grid3d);
+        forestImbalance3D(sForests, SCT, grid3d);
+    }
     if(!grid3d->zscp.Iam)
     {
         // SCT_printSummary(grid, SCT);
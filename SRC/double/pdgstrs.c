@@ -347,8 +347,8 @@ pdReDistribute_B_to_X(double *B, int_t m_loc, int nrhs, int_t ldb,
 		      Glu_persist_t *Glu_persist,
 		      gridinfo_t *grid, dSOLVEstruct_t *SOLVEstruct)
 {
-    int  *SendCnt, *SendCnt_nrhs, *RecvCnt, *RecvCnt_nrhs;
-    int  *sdispls, *sdispls_nrhs, *rdispls, *rdispls_nrhs;
+    int  *SendCnt, *RecvCnt;
+    int  *sdispls, *rdispls, *rdispls_nrhs;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
     int_t  *perm_r, *perm_c; /* row and column permutation vectors */
     int_t  *send_ibuf, *recv_ibuf;
@@ -357,9 +357,7 @@ pdReDistribute_B_to_X(double *B, int_t m_loc, int nrhs, int_t ldb,
     int_t  i, ii, irow, gbi, j, jj, k, knsupc, l, lk, nbrow;
     int    p, procs;
     pxgstrs_comm_t *gstrs_comm = SOLVEstruct->gstrs_comm;
-	MPI_Request req_i, req_d, *req_send, *req_recv;
-	MPI_Status status, *status_send, *status_recv;
-	int Nreq_recv, Nreq_send, pp, pps, ppr;
+	pxgstrs_nbr_t *nbr;
 	double t;
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter pdReDistribute_B_to_X()");
@@ -374,11 +372,8 @@ pdReDistribute_B_to_X(double *B, int_t m_loc, int nrhs, int_t ldb,
     xsup = Glu_persist->xsup;
     supno = Glu_persist->supno;
     SendCnt      = gstrs_comm->B_to_X_SendCnt;
-    SendCnt_nrhs = gstrs_comm->B_to_X_SendCnt +   procs;
     RecvCnt      = gstrs_comm->B_to_X_SendCnt + 2*procs;
-    RecvCnt_nrhs = gstrs_comm->B_to_X_SendCnt + 3*procs;
     sdispls      = gstrs_comm->B_to_X_SendCnt + 4*procs;
-    sdispls_nrhs = gstrs_comm->B_to_X_SendCnt + 5*procs;
     rdispls      = gstrs_comm->B_to_X_SendCnt + 6*procs;
     rdispls_nrhs = gstrs_comm->B_to_X_SendCnt + 7*procs;
     ptr_to_ibuf  = gstrs_comm->ptr_to_ibuf;
@@ -429,14 +424,6 @@ pdReDistribute_B_to_X(double *B, int_t m_loc, int nrhs, int_t ldb,
 		if ( !(send_dbuf = doubleMalloc_dist((k + l)* (size_t)nrhs)) )
 			ABORT("Malloc fails for send_dbuf[].");
 		recv_dbuf = send_dbuf + k * nrhs;
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -463,80 +450,15 @@ pdReDistribute_B_to_X(double *B, int_t m_loc, int nrhs, int_t ldb,
 		// t = SuperLU_timer_() - t;
 		// printf(".. copy to send buffer time\t%8.4f\n", t);
 
-#if 0
-	#if 1
-		/* Communicate the (permuted) row indices. */
-		MPI_Alltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-			  recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm);
- 		/* Communicate the numerical values. */
-		MPI_Alltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, MPI_DOUBLE,
-			  recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_DOUBLE,
-			  grid->comm);
-	#else
- 		/* Communicate the (permuted) row indices. */
-		MPI_Ialltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-				recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm, &req_i);
- 		/* Communicate the numerical values. */
-		MPI_Ialltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, MPI_DOUBLE,
-				recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_DOUBLE,
-				grid->comm, &req_d);
-		MPI_Wait(&req_i,&status);
-		MPI_Wait(&req_d,&status);
- 	#endif
-#endif
-	MPI_Barrier( grid->comm );
-
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-
-		if(SendCnt[pps]>0){
-			MPI_Isend(&send_ibuf[sdispls[pps]], SendCnt[pps], mpi_int_t, pps, 0, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt[ppr]>0){
-			MPI_Irecv(&recv_ibuf[rdispls[ppr]], RecvCnt[ppr], mpi_int_t, ppr, 0, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt_nrhs[pps]>0){
-			MPI_Isend(&send_dbuf[sdispls_nrhs[pps]], SendCnt_nrhs[pps], MPI_DOUBLE, pps, 1, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt_nrhs[ppr]>0){
-			MPI_Irecv(&recv_dbuf[rdispls_nrhs[ppr]], RecvCnt_nrhs[ppr], MPI_DOUBLE, ppr, 1, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
+	/* Exchange with the graph neighbors only; the distributed-graph
+	   communicator was built once in pdgstrs_init(). */
+	nbr = &gstrs_comm->B_to_X_nbr;
+	MPI_Neighbor_alltoallv(send_ibuf, nbr->SendCnt, nbr->sdispls, mpi_int_t,
+			       recv_ibuf, nbr->RecvCnt, nbr->rdispls, mpi_int_t,
+			       nbr->comm);
+	MPI_Neighbor_alltoallv(send_dbuf, nbr->SendCnt_nrhs, nbr->sdispls_nrhs, MPI_DOUBLE,
+			       recv_dbuf, nbr->RecvCnt_nrhs, nbr->rdispls_nrhs, MPI_DOUBLE,
+			       nbr->comm);
 
 
 		/* ------------------------------------------------------------
@@ -570,10 +492,6 @@ pdReDistribute_B_to_X(double *B, int_t m_loc, int nrhs, int_t ldb,
 
 		SUPERLU_FREE(send_ibuf);
 		SUPERLU_FREE(send_dbuf);
-		SUPERLU_FREE(req_send);
-		SUPERLU_FREE(req_recv);
-		SUPERLU_FREE(status_send);
-		SUPERLU_FREE(status_recv);
 	}
 
 
@@ -607,8 +525,8 @@ pdReDistribute_X_to_B(int_t n, double *B, int_t m_loc, int_t ldb, int_t fst_row,
 {
     int_t  i, ii, irow, j, jj, k, knsupc, nsupers, l, lk;
     int_t  *xsup, *supno;
-    int  *SendCnt, *SendCnt_nrhs, *RecvCnt, *RecvCnt_nrhs;
-    int  *sdispls, *rdispls, *sdispls_nrhs, *rdispls_nrhs;
+    int  *SendCnt, *RecvCnt;
+    int  *sdispls, *rdispls, *sdispls_nrhs;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
     int_t  *send_ibuf, *recv_ibuf;
     double *send_dbuf, *recv_dbuf;
@@ -616,9 +534,7 @@ pdReDistribute_X_to_B(int_t n, double *B, int_t m_loc, int_t ldb, int_t fst_row,
     pxgstrs_comm_t *gstrs_comm = SOLVEstruct->gstrs_comm;
     int  iam, p, q, pkk, procs;
     int_t  num_diag_procs, *diag_procs;
-	MPI_Request req_i, req_d, *req_send, *req_recv;
-	MPI_Status status, *status_send, *status_recv;
-	int Nreq_recv, Nreq_send, pp,pps,ppr;
+	pxgstrs_nbr_t *nbr;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter pdReDistribute_X_to_B()");
@@ -634,13 +550,10 @@ pdReDistribute_X_to_B(int_t n, double *B, int_t m_loc, int_t ldb, int_t fst_row,
     procs = grid->nprow * grid->npcol;
 
     SendCnt      = gstrs_comm->X_to_B_SendCnt;
-    SendCnt_nrhs = gstrs_comm->X_to_B_SendCnt +   procs;
     RecvCnt      = gstrs_comm->X_to_B_SendCnt + 2*procs;
-    RecvCnt_nrhs = gstrs_comm->X_to_B_SendCnt + 3*procs;
     sdispls      = gstrs_comm->X_to_B_SendCnt + 4*procs;
     sdispls_nrhs = gstrs_comm->X_to_B_SendCnt + 5*procs;
     rdispls      = gstrs_comm->X_to_B_SendCnt + 6*procs;
-    rdispls_nrhs = gstrs_comm->X_to_B_SendCnt + 7*procs;
     ptr_to_ibuf  = gstrs_comm->ptr_to_ibuf;
     ptr_to_dbuf  = gstrs_comm->ptr_to_dbuf;
 
@@ -682,14 +595,6 @@ pdReDistribute_X_to_B(int_t n, double *B, int_t m_loc, int_t ldb, int_t fst_row,
 		recv_ibuf = send_ibuf + k;
 		if ( !(send_dbuf = doubleMalloc_dist((k + l)*nrhs)) )
 			ABORT("Malloc fails for send_dbuf[].");
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 		recv_dbuf = send_dbuf + k * nrhs;
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -729,76 +634,16 @@ pdReDistribute_X_to_B(int_t n, double *B, int_t m_loc, int_t ldb, int_t fst_row,
 		/* ------------------------------------------------------------
 			COMMUNICATE THE (PERMUTED) ROW INDICES AND NUMERICAL VALUES.
 		   ------------------------------------------------------------*/
-#if 0
-	#if 1
-		MPI_Alltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-			  recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm);
-		MPI_Alltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs,MPI_DOUBLE,
-			  recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_DOUBLE,
-			  grid->comm);
-	#else
-		MPI_Ialltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-				recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm,&req_i);
-		MPI_Ialltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, MPI_DOUBLE,
-				recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_DOUBLE,
-				grid->comm,&req_d);
- 		MPI_Wait(&req_i,&status);
-		MPI_Wait(&req_d,&status);
-	#endif
-#endif
 
-	MPI_Barrier( grid->comm );
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt[pps]>0){
-			MPI_Isend(&send_ibuf[sdispls[pps]], SendCnt[pps], mpi_int_t, pps, 0, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt[ppr]>0){
-			MPI_Irecv(&recv_ibuf[rdispls[ppr]], RecvCnt[ppr], mpi_int_t, ppr, 0, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-	// MPI_Barrier( grid->comm );
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt_nrhs[pps]>0){
-			MPI_Isend(&send_dbuf[sdispls_nrhs[pps]], SendCnt_nrhs[pps], MPI_DOUBLE, pps, 1, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt_nrhs[ppr]>0){
-			MPI_Irecv(&recv_dbuf[rdispls_nrhs[ppr]], RecvCnt_nrhs[ppr], MPI_DOUBLE, ppr, 1, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-	// MPI_Barrier( grid->comm );
+	/* Exchange with the graph neighbors only; the distributed-graph
+	   communicator was built once in pdgstrs_init(). */
+	nbr = &gstrs_comm->X_to_B_nbr;
+	MPI_Neighbor_alltoallv(send_ibuf, nbr->SendCnt, nbr->sdispls, mpi_int_t,
+			       recv_ibuf, nbr->RecvCnt, nbr->rdispls, mpi_int_t,
+			       nbr->comm);
+	MPI_Neighbor_alltoallv(send_dbuf, nbr->SendCnt_nrhs, nbr->sdispls_nrhs, MPI_DOUBLE,
+			       recv_dbuf, nbr->RecvCnt_nrhs, nbr->rdispls_nrhs, MPI_DOUBLE,
+			       nbr->comm);
 
 
 		/* ------------------------------------------------------------
@@ -814,10 +659,6 @@ pdReDistribute_X_to_B(int_t n, double *B, int_t m_loc, int_t ldb, int_t fst_row,
 
     SUPERLU_FREE(send_ibuf);
     SUPERLU_FREE(send_dbuf);
-	SUPERLU_FREE(req_send);
-	SUPERLU_FREE(req_recv);
-	SUPERLU_FREE(status_send);
-	SUPERLU_FREE(status_recv);
 }
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Exit pdReDistribute_X_to_B()");
@@ -960,6 +801,147 @@ pdCompute_Diag_Inv(int_t n, dLUstruct_t *LUstruct,gridinfo_t *grid,
 }
 
 
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   Same as pdCompute_Diag_Inv, but the inverses are rounded to single
+ *   precision and kept in packed triangular storage in
+ *   Llu->sLinv_bc_ptr[] / Llu->sUinv_bc_ptr[]: column j of inv(L(k,k))
+ *   holds rows j:knsupc-1, column j of inv(U(k,k)) holds rows 0:j.
+ *   This takes 1/4 of the memory of the full double precision blocks and
+ *   the solve reads 1/4 of the bytes. The error introduced is corrected
+ *   by iterative refinement.
+ *
+ *   The double precision Linv_bc_dat/Uinv_bc_dat are released once the
+ *   single precision copies exist (CPU builds only; the GPU solve keeps
+ *   using the double copies).
+ * </pre>
+ */
+void
+pdCompute_Diag_Inv_s(int_t n, dLUstruct_t *LUstruct,gridinfo_t *grid,
+                     SuperLUStat_t *stat, int *info)
+{
+#ifdef SLU_HAVE_LAPACK
+    Glu_persist_t *Glu_persist = LUstruct->Glu_persist;
+    dLocalLU_t *Llu = LUstruct->Llu;
+    double *lusup, *Linv, *Uinv;
+    float  *sLinv, *sUinv;
+    int_t  i, j, k, lk, nsupers, ncb, maxsupc, cnt;
+    int_t  *xsup, *lsub;
+    int    knsupc, nsupr, mycol, myrow, INFO;
+    double one = 1.0, zero = 0.0;
+#if ( PROFlevel>=1 )
+    double t = SuperLU_timer_();
+#endif
+
+    xsup = Glu_persist->xsup;
+    nsupers = Glu_persist->supno[n-1] + 1;
+    ncb = CEILING( nsupers, grid->npcol ); /* Number of local block columns. */
+    myrow = MYROW( grid->iam, grid );
+    mycol = MYCOL( grid->iam, grid );
+
+    Llu->inv = 1;
+
+    /* Allocate the packed storage once; the pattern does not change
+       when refactoring with SamePattern_SameRowPerm. */
+    if ( !Llu->sLinv_bc_ptr ) {
+	if ( !(Llu->sLinv_bc_ptr = (float **) SUPERLU_MALLOC(ncb * sizeof(float *)))
+	     || !(Llu->sUinv_bc_ptr = (float **) SUPERLU_MALLOC(ncb * sizeof(float *))) )
+	    ABORT("Malloc fails for sLinv_bc_ptr[]/sUinv_bc_ptr[].");
+	cnt = 0;
+	for (k = 0; k < nsupers; ++k) {
+	    if ( myrow == PROW( k, grid ) && mycol == PCOL( k, grid ) ) {
+		knsupc = SuperSize( k );
+		cnt += knsupc * (knsupc + 1) / 2;
+	    }
+	}
+	cnt = SUPERLU_MAX(cnt, 1);
+	if ( !(Llu->sLinv_bc_dat = (float *) SUPERLU_MALLOC(cnt * sizeof(float)))
+	     || !(Llu->sUinv_bc_dat = (float *) SUPERLU_MALLOC(cnt * sizeof(float))) )
+	    ABORT("Malloc fails for sLinv_bc_dat[]/sUinv_bc_dat[].");
+	cnt = 0;
+	for (lk = 0; lk < ncb; ++lk) {
+	    Llu->sLinv_bc_ptr[lk] = NULL;
+	    Llu->sUinv_bc_ptr[lk] = NULL;
+	}
+	for (k = 0; k < nsupers; ++k) {
+	    if ( myrow == PROW( k, grid ) && mycol == PCOL( k, grid ) ) {
+		lk = LBj( k, grid );
+		knsupc = SuperSize( k );
+		Llu->sLinv_bc_ptr[lk] = &Llu->sLinv_bc_dat[cnt];
+		Llu->sUinv_bc_ptr[lk] = &Llu->sUinv_bc_dat[cnt];
+		cnt += knsupc * (knsupc + 1) / 2;
+	    }
+	}
+    }
+
+    maxsupc = 1;
+    for (k = 0; k < nsupers; ++k) maxsupc = SUPERLU_MAX(maxsupc, SuperSize( k ));
+    if ( !(Linv = doubleMalloc_dist(2 * maxsupc * maxsupc)) )
+	ABORT("Malloc fails for Linv[].");
+    Uinv = &Linv[maxsupc * maxsupc];
+
+    for (k = 0; k < nsupers; ++k) {
+	if ( myrow != PROW( k, grid ) || mycol != PCOL( k, grid ) ) continue;
+	lk = LBj( k, grid ); /* Local block number, column-wise. */
+	lsub = Llu->Lrowind_bc_ptr[lk];
+	if ( !lsub ) continue;
+	lusup = Llu->Lnzval_bc_ptr[lk];
+	nsupr = lsub[1];
+	knsupc = SuperSize( k );
+
+	for (j = 0; j < knsupc; j++) {
+	    for (i = 0; i < knsupc; i++) {
+		Linv[j*knsupc+i] = zero;
+		Uinv[j*knsupc+i] = zero;
+	    }
+	}
+	for (j = 0; j < knsupc; j++) {
+	    Linv[j*knsupc+j] = one;
+	    for (i = j+1; i < knsupc; i++) Linv[j*knsupc+i] = lusup[j*nsupr+i];
+	    for (i = 0; i < j+1; i++) Uinv[j*knsupc+i] = lusup[j*nsupr+i];
+	}
+
+	/* Triangular inversion */
+	dtrtri_("L","U",&knsupc,Linv,&knsupc,&INFO);
+	dtrtri_("U","N",&knsupc,Uinv,&knsupc,&INFO);
+
+	sLinv = Llu->sLinv_bc_ptr[lk];
+	sUinv = Llu->sUinv_bc_ptr[lk];
+	for (j = 0; j < knsupc; j++) {
+	    for (i = j; i < knsupc; i++) *sLinv++ = (float) Linv[j*knsupc+i];
+	    for (i = 0; i <= j; i++) *sUinv++ = (float) Uinv[j*knsupc+i];
+	}
+    } /* end for k ... */
+
+    SUPERLU_FREE(Linv);
+
+#ifndef GPU_ACC
+    if ( Llu->Linv_bc_dat ) {
+	SUPERLU_FREE(Llu->Linv_bc_dat);
+	SUPERLU_FREE(Llu->Uinv_bc_dat);
+	Llu->Linv_bc_dat = NULL;
+	Llu->Uinv_bc_dat = NULL;
+	for (lk = 0; lk < ncb; ++lk) {
+	    Llu->Linv_bc_ptr[lk] = NULL;
+	    Llu->Uinv_bc_ptr[lk] = NULL;
+	}
+    }
+#endif
+
+#if ( PROFlevel>=1 )
+    if( grid->iam==0 ) {
+	t = SuperLU_timer_() - t;
+	printf(".. L-diag_inv (single) time\t%10.5f\n", t);
+	fflush(stdout);
+    }
+#endif
+#endif /* SLU_HAVE_LAPACK */
+} /* pdCompute_Diag_Inv_s */
+
+
 /*! \brief
  *
  * <pre>
@@ -1155,6 +1137,10 @@ pdgstrs(superlu_dist_options_t *options, int_t n,
     int_t procs = grid->nprow * grid->npcol;
     yes_no_t done;
     yes_no_t startforward;
+    int msgtag;       /* tag of the message being processed */
+    int rma_solve;    /* use MPI-3 one-sided mailboxes instead of Isend/Recv */
+    int lvl_solve;    /* single process: follow the level-set schedule */
+    C_RmaBox rmabox;
     int nbrow;
     int_t  ik, rel, idx_r, jb, nrbl, irow, pc,iknsupc;
     int_t  lptr1_tmp, idx_i, idx_v,m;
@@ -1518,6 +1504,16 @@ if(procs==1){
 
 	for (i = 0; i < nlb; ++i) fmod[i*aln_i] += frecv[i];
 
+	lvl_solve = get_lvl_solve() && !get_acc_solve() && procs==1;
+	if ( lvl_solve && !Llu->Lsched ) dLvlSchedInit(nsupers, xsup, grid, Llu);
+
+	rma_solve = get_rma_solve() && !get_acc_solve() && procs>1;
+	if ( rma_solve ) {
+	    C_RmaBox_Create(&rmabox, grid->comm, grid->comm, nfrecvx+nfrecvmod, maxrecvsz, MPI_DOUBLE);
+	    C_Tree_AttachRma(LBtree_ptr, nsupers_j, &rmabox);
+	    C_Tree_AttachRma(LRtree_ptr, nsupers_i, &rmabox);
+	}
+
 	if ( !(recvbuf_BC_fwd = (double*)SUPERLU_MALLOC(maxrecvsz*(nfrecvx+1) * sizeof(double))) )  // this needs to be optimized for 1D row mapping
 		ABORT("Malloc fails for recvbuf_BC_fwd[].");
 	nfrecvx_buf=0;
@@ -1950,6 +1946,8 @@ t1 = SuperLU_timer_();
 
 #endif
 #endif
+}else if ( lvl_solve ){  /* level-set trisolve on a single process */
+	dlsolve_lvl(x, rtemp, sizertemp, nrhs, xsup, grid, Llu, stat_loc, num_thread);
 }else{  /* CPU trisolve*/
 
 #ifdef _OPENMP
@@ -1989,6 +1987,9 @@ t1 = SuperLU_timer_();
 			lusup = Lnzval_bc_ptr[lk];
 
 			nsupr = lsub[1];
+			if ( Llu->sLinv_bc_ptr ) { /* inverse kept in single precision */
+			    dDiagInvMult_s("L", knsupc, nrhs, Llu->sLinv_bc_ptr[lk], &x[ii], rtemp_loc);
+			} else {
 			Linv = Linv_bc_ptr[lk];
 #ifdef _CRAY
 			SGEMM( ftcs2, ftcs2, &knsupc, &nrhs, &knsupc,
@@ -2003,6 +2004,7 @@ t1 = SuperLU_timer_();
 					&alpha, Linv, &knsupc, &x[ii],
 					&knsupc, &beta, rtemp_loc, &knsupc );
 #endif
+			}
 
 			for (i=0 ; i<knsupc*nrhs ; i++){
 				x[ii+i] = rtemp_loc[i];
@@ -2201,11 +2203,15 @@ t1 = SuperLU_timer_();
 			// msgcnt[1] = maxrecvsz;
 #endif
 
-			recvbuf0 = &recvbuf_BC_fwd[nfrecvx_buf*maxrecvsz];
-
 			/* Receive a message. */
-			MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
+			if ( rma_solve ) {
+			    recvbuf0 = (double*) C_RmaBox_Recv(&rmabox, &msgtag);
+			} else {
+			    recvbuf0 = &recvbuf_BC_fwd[nfrecvx_buf*maxrecvsz];
+			    MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
 				MPI_ANY_SOURCE, MPI_ANY_TAG, grid->comm, &status );
+			    msgtag = status.MPI_TAG;
+			}
 			// MPI_Irecv(recvbuf0,maxrecvsz,MPI_DOUBLE,MPI_ANY_SOURCE,MPI_ANY_TAG,grid->comm,&req);
 			// ready=0;
 			// while(ready==0){
@@ -2226,10 +2232,10 @@ t1 = SuperLU_timer_();
 			k = *recvbuf0;
 
 #if ( DEBUGlevel>=2 )
-			printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, status.MPI_TAG);
+			printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, msgtag);
 #endif
 
-			if(status.MPI_TAG==BC_L){
+			if(msgtag==BC_L){
 				// --nfrecvx;
 				nfrecvx_buf++;
 				{
@@ -2267,7 +2273,7 @@ t1 = SuperLU_timer_();
 
 				} /* if lsub */
 			    }
-			}else if(status.MPI_TAG==RD_L){
+			}else if(msgtag==RD_L){
 				// --nfrecvmod;
 				lk = LBi( k, grid ); /* Local block number, row-wise. */
 
@@ -2308,6 +2314,9 @@ t1 = SuperLU_timer_();
 					TIC(t1);
 #endif
 					if(Llu->inv == 1){
+						if ( Llu->sLinv_bc_ptr ) { /* inverse kept in single precision */
+						    dDiagInvMult_s("L", knsupc, nrhs, Llu->sLinv_bc_ptr[lk], &x[ii], rtemp_loc);
+						} else {
 						Linv = Linv_bc_ptr[lk];
 #ifdef _CRAY
 						SGEMM( ftcs2, ftcs2, &knsupc, &nrhs, &knsupc,
@@ -2322,6 +2331,7 @@ t1 = SuperLU_timer_();
 							&alpha, Linv, &knsupc, &x[ii],
 							&knsupc, &beta, rtemp_loc, &knsupc );
 #endif
+						}
 						for (i=0 ; i<knsupc*nrhs ; i++){
 							x[ii+i] = rtemp_loc[i];
 						}
@@ -2411,6 +2421,11 @@ t1 = SuperLU_timer_();
 		}
 		MPI_Barrier( grid->comm );
 
+		if ( rma_solve ) {
+		    C_Tree_AttachRma(LBtree_ptr, nsupers_j, NULL);
+		    C_Tree_AttachRma(LRtree_ptr, nsupers_i, NULL);
+		    C_RmaBox_Free(&rmabox);
+		}
 	}  /* end CPU trisolve */
 #if ( PROFlevel>=1 )
 	t3 = SuperLU_timer_() - t3;
@@ -2599,6 +2614,12 @@ t1 = SuperLU_timer_();
 	}
 
 	for (i = 0; i < nlb; ++i) bmod[i*aln_i] += brecv[i];
+
+	if ( rma_solve ) {
+	    C_RmaBox_Create(&rmabox, grid->comm, grid->comm, nbrecvx+nbrecvmod, maxrecvsz, MPI_DOUBLE);
+	    C_Tree_AttachRma(UBtree_ptr, nsupers_j, &rmabox);
+	    C_Tree_AttachRma(URtree_ptr, nsupers_i, &rmabox);
+	}
 	// for (i = 0; i < nlb; ++i)printf("bmod[i]: %5d\n",bmod[i]);
 
 	if ( !(recvbuf_BC_fwd = (double*)SUPERLU_MALLOC(maxrecvsz*(nbrecvx+1) * sizeof(double))) )  // this needs to be optimized for 1D row mapping
@@ -2711,6 +2732,8 @@ if (get_acc_solve()){  /* GPU trisolve*/
 	stat_loc[0]->ops[SOLVE]+=Llu->Unzval_br_cnt*nrhs*2; // YL: this is a rough estimate
 
 #endif
+}else if ( lvl_solve ){  /* level-set trisolve on a single process */
+	dusolve_lvl(x, rtemp, sizertemp, nrhs, xsup, grid, Llu, stat_loc, num_thread);
 }else{  /* CPU trisolve*/
 
 
@@ -2754,6 +2777,9 @@ if (get_acc_solve()){  /* GPU trisolve*/
 
 			if(Llu->inv == 1){
 
+				if ( Llu->sUinv_bc_ptr ) { /* inverse kept in single precision */
+				    dDiagInvMult_s("U", knsupc, nrhs, Llu->sUinv_bc_ptr[lk], &x[ii], rtemp_loc);
+				} else {
 				Uinv = Uinv_bc_ptr[lk];
 #ifdef _CRAY
 				SGEMM( ftcs2, ftcs2, &knsupc, &nrhs, &knsupc,
@@ -2768,6 +2794,7 @@ if (get_acc_solve()){  /* GPU trisolve*/
 						&alpha, Uinv, &knsupc, &x[ii],
 						&knsupc, &beta, rtemp_loc, &knsupc );
 #endif
+				}
 				for (i=0 ; i<knsupc*nrhs ; i++){
 					x[ii+i] = rtemp_loc[i];
 				}
@@ -2887,11 +2914,15 @@ for (i=0;i<nroot_send;i++){
 			TIC(t1);
 #endif
 
-		recvbuf0 = &recvbuf_BC_fwd[nbrecvx_buf*maxrecvsz];
-
 		/* Receive a message. */
-		MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
+		if ( rma_solve ) {
+		    recvbuf0 = (double*) C_RmaBox_Recv(&rmabox, &msgtag);
+		} else {
+		    recvbuf0 = &recvbuf_BC_fwd[nbrecvx_buf*maxrecvsz];
+		    MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
 			MPI_ANY_SOURCE, MPI_ANY_TAG, grid->comm, &status );
+		    msgtag = status.MPI_TAG;
+		}
 
 #if ( PROFlevel>=1 )
 			TOC(t2, t1);
@@ -2902,10 +2933,10 @@ for (i=0;i<nroot_send;i++){
 
 		k = *recvbuf0;
 #if ( DEBUGlevel>=2 )
-		printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, status.MPI_TAG);
+		printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, msgtag);
 		fflush(stdout);
 #endif
-		if(status.MPI_TAG==BC_U){
+		if(msgtag==BC_U){
 		    // --nfrecvx;
 		    nbrecvx_buf++;
 		    lk = LBj( k, grid );    /* local block number */
@@ -2924,7 +2955,7 @@ for (i=0;i<nroot_send;i++){
 		    dlsum_bmod_inv_master(lsum, x, &recvbuf0[XK_H], rtemp, nrhs, k, bmod, Urbs,
 				Ucb_indptr, Ucb_valptr, xsup, grid, Llu,
 				stat_loc, sizelsum,sizertemp,thread_id,num_thread);
-		}else if(status.MPI_TAG==RD_U){
+		}else if(msgtag==RD_U){
 
 		    lk = LBi( k, grid ); /* Local block number, row-wise. */
 
@@ -2962,6 +2993,9 @@ for (i=0;i<nroot_send;i++){
 
 			    if(Llu->inv == 1){
 
+				if ( Llu->sUinv_bc_ptr ) { /* inverse kept in single precision */
+				    dDiagInvMult_s("U", knsupc, nrhs, Llu->sUinv_bc_ptr[lk], &x[ii], rtemp_loc);
+				} else {
 				Uinv = Uinv_bc_ptr[lk];
 
 #ifdef _CRAY
@@ -2977,6 +3011,7 @@ for (i=0;i<nroot_send;i++){
 						&alpha, Uinv, &knsupc, &x[ii],
 						&knsupc, &beta, rtemp_loc, &knsupc );
 #endif
+				}
 
 			#ifdef _OPENMP
 			#pragma omp simd
@@ -3054,6 +3089,12 @@ for (lk=0;lk<nsupers_j;++lk){
 		}
 	}
 	MPI_Barrier( grid->comm );
+
+	if ( rma_solve ) {
+	    C_Tree_AttachRma(UBtree_ptr, nsupers_j, NULL);
+	    C_Tree_AttachRma(URtree_ptr, nsupers_i, NULL);
+	    C_RmaBox_Free(&rmabox);
+	}
 }
 
 #if ( PROFlevel>=1 )
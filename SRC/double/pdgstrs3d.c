@@ -227,6 +227,9 @@ int dtrs_compute_communication_structure(superlu_dist_options_t *options, int_t
     int *h_recv_cnt;
     int *h_recv_cnt_u;
 
+    /* Node map used to shape the broadcast and reduction trees below */
+    C_Tree_SetTopology(grid->comm);
+
     /* Reconstruct the global L structure and compute the communication metadata */
 
     if ( !(tmpglo = intCalloc_dist(nsupers)) )
@@ -1429,6 +1432,7 @@ int_t dtrs_x_reduction_newsolve(int_t nsupers, double* x, int nrhs, dLUstruct_t
                 sender = myGrid;
                 receiver = myGrid - (1 << (ilvl-1));
             }
+            if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
             int_t tr =  tree;
             for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
             {
@@ -1470,6 +1474,7 @@ int_t dtrs_x_broadcast_newsolve(int_t nsupers, double* x, int nrhs, dLUstruct_t
                 sender = myGrid - (1 << (ilvl-1));
                 receiver = myGrid ;
             }
+            if (receiver >= grid3d->zscp.Np) continue; /* no partner grid */
             int_t tr =  tree;
             for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
             {
@@ -1573,6 +1578,7 @@ int_t dtrs_X_gather3d(double* x, int nrhs, dtrf3Dpartition_t*  trf3Dpartition,
 				sender = myGrid;
 				receiver = myGrid - (1 << ilvl);
 			}
+			if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
 			for (int_t alvl = 0; alvl <= ilvl; alvl++)
 			{
 				int_t diffLvl  = ilvl - alvl;
@@ -1751,6 +1757,7 @@ int_t dbsolve_Xt_bcast(int_t ilvl, dxT_struct *xT_s, int nrhs, dtrf3Dpartition_t
 		receiver = myGrid;
 		sender = myGrid - (1 << ilvl);
 	}
+	if (receiver >= grid3d->zscp.Np) return 0; /* no partner grid */
 
 	for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
@@ -2672,6 +2679,9 @@ void dForwardSolve3d_newsolve_reusepdgstrs(superlu_dist_options_t *options, int_
     int_t procs = grid->nprow * grid->npcol;
     yes_no_t done;
     yes_no_t startforward;
+    int msgtag;       /* tag of the message being processed */
+    int rma_solve;    /* use MPI-3 one-sided mailboxes instead of Isend/Recv */
+    C_RmaBox rmabox;
     int nbrow;
     int_t  ik, rel, idx_r, jb, nrbl, irow, pc,iknsupc;
     int_t  lptr1_tmp, idx_i, idx_v,m;
@@ -2928,6 +2938,13 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 	for (i = 0; i < nlb; ++i) fmod[i*aln_i] += frecv[i];
 }
+
+	rma_solve = get_rma_solve() && !get_acc_solve() && procs>1;
+	if ( rma_solve ) {
+	    C_RmaBox_Create(&rmabox, grid->comm, grid3d->comm, nfrecvx+nfrecvmod, maxrecvsz, MPI_DOUBLE);
+	    C_Tree_AttachRma(LBtree_ptr, nsupers_j, &rmabox);
+	    C_Tree_AttachRma(LRtree_ptr, nsupers_i, &rmabox);
+	}
 	if ( !(recvbuf_BC_fwd = (double*)SUPERLU_MALLOC(maxrecvsz*(nfrecvx+1) * sizeof(double))) )  // this needs to be optimized for 1D row mapping
 		ABORT("Malloc fails for recvbuf_BC_fwd[].");
 	nfrecvx_buf=0;
@@ -3313,11 +3330,16 @@ thread_id=0;
 						// msgcnt[1] = maxrecvsz;
 #endif
 
-						recvbuf0 = &recvbuf_BC_fwd[nfrecvx_buf*maxrecvsz];
                         double tx = SuperLU_timer_();
 						/* Receive a message. */
-						MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
+						if ( rma_solve ) {
+							recvbuf0 = (double*) C_RmaBox_Recv(&rmabox, &msgtag);
+						} else {
+							recvbuf0 = &recvbuf_BC_fwd[nfrecvx_buf*maxrecvsz];
+							MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
 								MPI_ANY_SOURCE, MPI_ANY_TAG, grid->comm, &status );
+							msgtag = status.MPI_TAG;
+						}
                         xtrsTimer->tfs_comm += SuperLU_timer_() - tx;
 
 						// MPI_Irecv(recvbuf0,maxrecvsz,MPI_DOUBLE,MPI_ANY_SOURCE,MPI_ANY_TAG,grid->comm,&req);
@@ -3340,10 +3362,10 @@ thread_id=0;
 			                k = *recvbuf0;
 
 #if ( DEBUGlevel>=2 )
-							printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, status.MPI_TAG);
+							printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, msgtag);
 #endif
 
-							if(status.MPI_TAG==BC_L){
+							if(msgtag==BC_L){
                                 xtrsTimer->trsDataRecvXY  += SuperSize (k)*nrhs + XK_H;
 								// --nfrecvx;
 								nfrecvx_buf++;
@@ -3384,7 +3406,7 @@ thread_id=0;
 									} /* if lsub */
 								}
 
-							}else if(status.MPI_TAG==RD_L){
+							}else if(msgtag==RD_L){
                                 xtrsTimer->trsDataRecvXY  += SuperSize (k)*nrhs + LSUM_H;
 								// --nfrecvmod;
 								lk = LBi( k, grid ); /* Local block number, row-wise. */
@@ -3595,6 +3617,12 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 		}
 		// MPI_Barrier( grid->comm );
 
+		if ( rma_solve ) {
+		    C_Tree_AttachRma(LBtree_ptr, nsupers_j, NULL);
+		    C_Tree_AttachRma(LRtree_ptr, nsupers_i, NULL);
+		    C_RmaBox_Free(&rmabox);
+		}
+
 #if ( VAMPIR>=1 )
 		VT_traceoff();
 		VT_finalize();
@@ -4769,6 +4797,9 @@ void dBackSolve3d_newsolve_reusepdgstrs(superlu_dist_options_t *options, int_t n
     int_t procs = grid->nprow * grid->npcol;
     yes_no_t done;
     yes_no_t startforward;
+    int msgtag;       /* tag of the message being processed */
+    int rma_solve;    /* use MPI-3 one-sided mailboxes instead of Isend/Recv */
+    C_RmaBox rmabox;
     int nbrow;
     int_t  ik, rel, idx_r, jb, nrbl, irow, pc,iknsupc;
     int_t  lptr1_tmp, idx_i, idx_v,m;
@@ -5069,6 +5100,13 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 	// for (i = 0; i < nlb; ++i)printf("bmod[i]: %5d\n",bmod[i]);
 }
 
+	rma_solve = get_rma_solve() && !get_acc_solve() && procs>1;
+	if ( rma_solve ) {
+	    C_RmaBox_Create(&rmabox, grid->comm, grid3d->comm, nbrecvx+nbrecvmod, maxrecvsz, MPI_DOUBLE);
+	    C_Tree_AttachRma(UBtree_ptr, nsupers_j, &rmabox);
+	    C_Tree_AttachRma(URtree_ptr, nsupers_i, &rmabox);
+	}
+
 	if ( !(recvbuf_BC_fwd = (double*)SUPERLU_MALLOC(maxrecvsz*(nbrecvx+1) * sizeof(double))) )  // this needs to be optimized for 1D row mapping
 		ABORT("Malloc fails for recvbuf_BC_fwd[].");
 	nbrecvx_buf=0;
@@ -5353,11 +5391,16 @@ xtrsTimer->tbs_compute += SuperLU_timer_() - tx;
 			TIC(t1);
 #endif
 
-			recvbuf0 = &recvbuf_BC_fwd[nbrecvx_buf*maxrecvsz];
             double tx = SuperLU_timer_();
 			/* Receive a message. */
-			MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
+			if ( rma_solve ) {
+				recvbuf0 = (double*) C_RmaBox_Recv(&rmabox, &msgtag);
+			} else {
+				recvbuf0 = &recvbuf_BC_fwd[nbrecvx_buf*maxrecvsz];
+				MPI_Recv( recvbuf0, maxrecvsz, MPI_DOUBLE,
 					MPI_ANY_SOURCE, MPI_ANY_TAG, grid->comm, &status );
+				msgtag = status.MPI_TAG;
+			}
             xtrsTimer->tbs_comm += SuperLU_timer_() - tx;
 
 #if ( PROFlevel>=1 )
@@ -5370,11 +5413,11 @@ xtrsTimer->tbs_compute += SuperLU_timer_() - tx;
 
 			k = *recvbuf0;
 #if ( DEBUGlevel>=2 )
-			printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, status.MPI_TAG);
+			printf("(%2d) Recv'd block %d, tag %2d\n", iam, k, msgtag);
 			fflush(stdout);
 #endif
             tx = SuperLU_timer_();
-			if(status.MPI_TAG==BC_U){
+			if(msgtag==BC_U){
                 xtrsTimer->trsDataRecvXY  += SuperSize (k)*nrhs + XK_H;
 				// --nfrecvx;
 				nbrecvx_buf++;
@@ -5396,7 +5439,7 @@ xtrsTimer->tbs_compute += SuperLU_timer_() - tx;
 				dlsum_bmod_inv_master(lsum, x, &recvbuf0[XK_H], rtemp, nrhs, k, bmod, Urbs,
 						Ucb_indptr, Ucb_valptr, xsup, grid, Llu,
 						stat_loc, sizelsum,sizertemp,thread_id,num_thread);
-			}else if(status.MPI_TAG==RD_U){
+			}else if(msgtag==RD_U){
                 xtrsTimer->trsDataRecvXY  += SuperSize (k)*nrhs + LSUM_H;
 				lk = LBi( k, grid ); /* Local block number, row-wise. */
 
@@ -5623,6 +5666,12 @@ if ( !(get_new3dsolvetreecomm() && get_acc_solve())){
 		}
 		// MPI_Barrier( grid->comm );
 
+		if ( rma_solve ) {
+		    C_Tree_AttachRma(UBtree_ptr, nsupers_j, NULL);
+		    C_Tree_AttachRma(URtree_ptr, nsupers_i, NULL);
+		    C_RmaBox_Free(&rmabox);
+		}
+
 
 #if ( PROFlevel>=2 )
 		{
@@ -7426,6 +7475,7 @@ int_t pdgsTrForwardSolve3d(superlu_dist_options_t *options, int_t n, dLUstruct_t
                     receiver = myGrid - (1 << ilvl);
                 }
                 double tx = SuperLU_timer_();
+                if (sender < grid3d->zscp.Np) /* else no partner grid */
                 for (int_t alvl = ilvl + 1; alvl <  maxLvl; ++alvl)
                 {
                     /* code */
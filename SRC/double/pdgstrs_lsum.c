@@ -28,6 +28,9 @@ at the top-level directory.
 
 #include "superlu_ddefs.h"
 #include "superlu_defs.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#endif
 
 #ifndef CACHELINE
 #define CACHELINE 64  /* bytes, Xeon Phi KNL, Cori haswell, Edision */
@@ -666,6 +669,9 @@ void dlsum_fmod_inv
 							nsupr1 = lsub1[1];
 
 							if(Llu->inv == 1){
+								if ( Llu->sLinv_bc_ptr ) { /* inverse kept in single precision */
+								    dDiagInvMult_s("L", iknsupc, nrhs, Llu->sLinv_bc_ptr[lk], &x[ii], rtemp_loc);
+								} else {
 								Linv = Llu->Linv_bc_ptr[lk];
 
 
@@ -682,6 +688,7 @@ void dlsum_fmod_inv
 										&alpha, Linv, &iknsupc, &x[ii],
 										&iknsupc, &beta, rtemp_loc, &iknsupc );
 #endif
+								}
 							#ifdef _OPENMP
 							#pragma omp simd
 							#endif
@@ -865,6 +872,9 @@ void dlsum_fmod_inv
 					nsupr1 = lsub1[1];
 
 					if(Llu->inv == 1){
+					    if ( Llu->sLinv_bc_ptr ) { /* inverse kept in single precision */
+					        dDiagInvMult_s("L", iknsupc, nrhs, Llu->sLinv_bc_ptr[lk], &x[ii], rtemp_loc);
+					    } else {
 					    Linv = Llu->Linv_bc_ptr[lk];
 #ifdef _CRAY
 					    SGEMM( ftcs2, ftcs2, &iknsupc, &nrhs, &iknsupc,
@@ -879,6 +889,7 @@ void dlsum_fmod_inv
 							&alpha, Linv, &iknsupc, &x[ii],
 							&iknsupc, &beta, rtemp_loc, &iknsupc );
 #endif
+					    }
 					#ifdef _OPENMP
 					#pragma omp simd
 					#endif
@@ -1279,6 +1290,9 @@ void dlsum_fmod_inv_master
 					nsupr1 = lsub1[1];
 
 					if(Llu->inv == 1){
+						if ( Llu->sLinv_bc_ptr ) { /* inverse kept in single precision */
+						    dDiagInvMult_s("L", iknsupc, nrhs, Llu->sLinv_bc_ptr[lk], &x[ii], rtemp_loc);
+						} else {
 						Linv = Llu->Linv_bc_ptr[lk];
 #ifdef _CRAY
 						SGEMM( ftcs2, ftcs2, &iknsupc, &nrhs, &iknsupc,
@@ -1293,6 +1307,7 @@ void dlsum_fmod_inv_master
 								&alpha, Linv, &iknsupc, &x[ii],
 								&iknsupc, &beta, rtemp_loc, &iknsupc );
 #endif
+						}
 				#ifdef _OPENMP
 				#pragma omp simd
 				#endif
@@ -1560,6 +1575,9 @@ void dlsum_bmod_inv
 							nsupr = lsub[1];
 
 							if(Llu->inv == 1){
+								if ( Llu->sUinv_bc_ptr ) { /* inverse kept in single precision */
+								    dDiagInvMult_s("U", iknsupc, nrhs, Llu->sUinv_bc_ptr[lk1], &x[ii], rtemp_loc);
+								} else {
 								Uinv = Llu->Uinv_bc_ptr[lk1];
 		#ifdef _CRAY
 								SGEMM( ftcs2, ftcs2, &iknsupc, &nrhs, &iknsupc,
@@ -1574,6 +1592,7 @@ void dlsum_bmod_inv
 										&alpha, Uinv, &iknsupc, &x[ii],
 										&iknsupc, &beta, rtemp_loc, &iknsupc );
 		#endif
+								}
 								#ifdef _OPENMP
 								#pragma omp simd
 								#endif
@@ -1741,6 +1760,9 @@ void dlsum_bmod_inv
 						nsupr = lsub[1];
 
 						if(Llu->inv == 1){
+							if ( Llu->sUinv_bc_ptr ) { /* inverse kept in single precision */
+							    dDiagInvMult_s("U", iknsupc, nrhs, Llu->sUinv_bc_ptr[lk1], &x[ii], rtemp_loc);
+							} else {
 							Uinv = Llu->Uinv_bc_ptr[lk1];
 	#ifdef _CRAY
 							SGEMM( ftcs2, ftcs2, &iknsupc, &nrhs, &iknsupc,
@@ -1755,6 +1777,7 @@ void dlsum_bmod_inv
 									&alpha, Uinv, &iknsupc, &x[ii],
 									&iknsupc, &beta, rtemp_loc, &iknsupc );
 	#endif
+							}
 				#ifdef _OPENMP
 				#pragma omp simd
 				#endif
@@ -2071,6 +2094,9 @@ void dlsum_bmod_inv_master
 					nsupr = lsub[1];
 
 					if(Llu->inv == 1){
+						if ( Llu->sUinv_bc_ptr ) { /* inverse kept in single precision */
+						    dDiagInvMult_s("U", iknsupc, nrhs, Llu->sUinv_bc_ptr[lk1], &x[ii], rtemp_loc);
+						} else {
 						Uinv = Llu->Uinv_bc_ptr[lk1];
 #ifdef _CRAY
 						SGEMM( ftcs2, ftcs2, &iknsupc, &nrhs, &iknsupc,
@@ -2085,6 +2111,7 @@ void dlsum_bmod_inv_master
 								&alpha, Uinv, &iknsupc, &x[ii],
 								&iknsupc, &beta, rtemp_loc, &iknsupc );
 #endif
+						}
 			#ifdef _OPENMP
 			#pragma omp simd
 			#endif
@@ -2145,3 +2172,502 @@ void dlsum_bmod_inv_master
 	}
 
 } /* dlsum_bmod_inv_master */
+
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   Build the level-set schedules of the L- and U-solves on a single
+ *   process (Pr = Pc = 1). For every supernode k the schedule keeps the
+ *   list of blocks L(k,j), j < k, resp. U(k,j), j > k, that update X[k],
+ *   stored contiguously in block-row order so that the solve pulls its
+ *   updates instead of pushing them with atomic counters. Supernodes are
+ *   sorted by level, i.e., the length of the longest dependency chain.
+ *
+ *   Only positions into Lrowind_bc_ptr[]/Lnzval_bc_ptr[] and
+ *   Ufstnz_br_ptr[]/Unzval_br_ptr[] are recorded, hence the schedule
+ *   remains valid for refactorizations with the same pattern.
+ * </pre>
+ */
+static LvlSched_t *dLvlSchedAlloc(int_t nsupers, int_t ndeps)
+{
+    LvlSched_t *sched;
+
+    if ( !(sched = (LvlSched_t *) SUPERLU_MALLOC(sizeof(LvlSched_t))) )
+	ABORT("Malloc fails for LvlSched_t.");
+    sched->nsupers = nsupers;
+    sched->nlevels = 0;
+    sched->order = intMalloc_dist(nsupers);
+    sched->lvlptr = intCalloc_dist(nsupers + 1);
+    sched->depptr = intCalloc_dist(nsupers + 1);
+    sched->depsup = intMalloc_dist(SUPERLU_MAX(ndeps, 1));
+    sched->depidx = intMalloc_dist(SUPERLU_MAX(ndeps, 1));
+    sched->depval = intMalloc_dist(SUPERLU_MAX(ndeps, 1));
+    if ( !sched->order || !sched->lvlptr || !sched->depptr
+	 || !sched->depsup || !sched->depidx || !sched->depval )
+	ABORT("Malloc fails for LvlSched_t arrays.");
+    return sched;
+}
+
+/* Sort the supernodes by level; level[] is overwritten. */
+static void dLvlSchedOrder(LvlSched_t *sched, int_t *level)
+{
+    int_t k, l, nsupers = sched->nsupers, nlevels = 0;
+    int_t *lvlptr = sched->lvlptr;
+
+    for (k = 0; k < nsupers; ++k) {
+	nlevels = SUPERLU_MAX(nlevels, level[k] + 1);
+	++lvlptr[level[k] + 1];
+    }
+    for (l = 0; l < nlevels; ++l) lvlptr[l + 1] += lvlptr[l];
+    for (k = 0; k < nsupers; ++k)
+	sched->order[lvlptr[level[k]]++] = k;
+    for (l = nlevels; l > 0; --l) lvlptr[l] = lvlptr[l - 1];
+    lvlptr[0] = 0;
+    sched->nlevels = nlevels;
+}
+
+void dLvlSchedInit(int_t nsupers, int_t *xsup, gridinfo_t *grid,
+                   dLocalLU_t *Llu)
+{
+    int_t  b, gb, i, j, k, lptr, luptr, nb, nbrow, ndeps, uptr;
+    int_t  *lsub, *usub, *depptr, *level;
+    LvlSched_t *sched;
+
+    if ( grid->nprow * grid->npcol != 1 )
+	ABORT("dLvlSchedInit requires a single process.");
+    dLvlSchedFree(Llu);
+
+    if ( !(level = intMalloc_dist(nsupers + 1)) )
+	ABORT("Malloc fails for level[].");
+
+    /* L-solve: X[k] depends on X[j] for every block L(k,j), j < k. */
+    ndeps = 0;
+    for (j = 0; j < nsupers; ++j) {
+	if ( (lsub = Llu->Lrowind_bc_ptr[j]) ) ndeps += lsub[0];
+    }
+    sched = dLvlSchedAlloc(nsupers, ndeps);
+    depptr = sched->depptr;
+    for (j = 0; j < nsupers; ++j) {
+	if ( !(lsub = Llu->Lrowind_bc_ptr[j]) ) continue;
+	nb = lsub[0];
+	lptr = BC_HEADER;
+	for (b = 0; b < nb; ++b) {
+	    gb = lsub[lptr];
+	    if ( gb != j ) ++depptr[gb + 1];
+	    lptr += LB_DESCRIPTOR + lsub[lptr + 1];
+	}
+    }
+    for (k = 0; k < nsupers; ++k) depptr[k + 1] += depptr[k];
+    for (j = 0; j < nsupers; ++j) { /* Dependencies come in order of j. */
+	if ( !(lsub = Llu->Lrowind_bc_ptr[j]) ) continue;
+	nb = lsub[0];
+	lptr = BC_HEADER;
+	luptr = 0;
+	for (b = 0; b < nb; ++b) {
+	    gb = lsub[lptr];
+	    nbrow = lsub[lptr + 1];
+	    if ( gb != j ) {
+		i = depptr[gb]++;
+		sched->depsup[i] = j;
+		sched->depidx[i] = lptr;
+		sched->depval[i] = luptr;
+	    }
+	    lptr += LB_DESCRIPTOR + nbrow;
+	    luptr += nbrow;
+	}
+    }
+    for (k = nsupers; k > 0; --k) depptr[k] = depptr[k - 1];
+    depptr[0] = 0;
+    for (k = 0; k < nsupers; ++k) {
+	level[k] = 0;
+	for (i = depptr[k]; i < depptr[k + 1]; ++i)
+	    level[k] = SUPERLU_MAX(level[k], level[sched->depsup[i]] + 1);
+    }
+    dLvlSchedOrder(sched, level);
+    Llu->Lsched = sched;
+
+    /* U-solve: X[k] depends on X[j] for every block U(k,j), j > k.
+       The blocks of a block row are already contiguous in Unzval_br_ptr[k]. */
+    ndeps = 0;
+    for (k = 0; k < nsupers; ++k) {
+	if ( (usub = Llu->Ufstnz_br_ptr[k]) ) ndeps += usub[0];
+    }
+    sched = dLvlSchedAlloc(nsupers, ndeps);
+    depptr = sched->depptr;
+    for (k = 0; k < nsupers; ++k) {
+	depptr[k + 1] = depptr[k];
+	if ( !(usub = Llu->Ufstnz_br_ptr[k]) ) continue;
+	nb = usub[0];
+	i = BR_HEADER;
+	uptr = 0;
+	for (b = 0; b < nb; ++b) {
+	    gb = usub[i];
+	    sched->depsup[depptr[k + 1]] = gb;
+	    sched->depidx[depptr[k + 1]] = i + UB_DESCRIPTOR;
+	    sched->depval[depptr[k + 1]] = uptr;
+	    ++depptr[k + 1];
+	    uptr += usub[i + 1];
+	    i += UB_DESCRIPTOR + SuperSize( gb );
+	}
+    }
+    for (k = nsupers - 1; k >= 0; --k) {
+	level[k] = 0;
+	for (i = depptr[k]; i < depptr[k + 1]; ++i)
+	    level[k] = SUPERLU_MAX(level[k], level[sched->depsup[i]] + 1);
+    }
+    dLvlSchedOrder(sched, level);
+    Llu->Usched = sched;
+
+    SUPERLU_FREE(level);
+}
+
+void dLvlSchedFree(dLocalLU_t *Llu)
+{
+    LvlSched_t *sched[2];
+    int i;
+
+    sched[0] = Llu->Lsched;
+    sched[1] = Llu->Usched;
+    for (i = 0; i < 2; ++i) {
+	if ( !sched[i] ) continue;
+	SUPERLU_FREE(sched[i]->order);
+	SUPERLU_FREE(sched[i]->lvlptr);
+	SUPERLU_FREE(sched[i]->depptr);
+	SUPERLU_FREE(sched[i]->depsup);
+	SUPERLU_FREE(sched[i]->depidx);
+	SUPERLU_FREE(sched[i]->depval);
+	SUPERLU_FREE(sched[i]);
+    }
+    Llu->Lsched = NULL;
+    Llu->Usched = NULL;
+}
+
+/* Spin until supernode j has been solved by another thread; back off
+   to the OS scheduler when the wait is long (oversubscribed cores). */
+static inline void dLvlSchedWait(volatile int *done, int_t j)
+{
+    int ready, spins = 0;
+    do {
+#ifdef _OPENMP
+#pragma omp atomic read seq_cst
+#endif
+	ready = done[j];
+#if defined(__unix__) || defined(__APPLE__)
+	if ( !ready && ++spins > 1000 ) sched_yield();
+#endif
+    } while ( !ready );
+}
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   Solve L*Y = B on a single process following Llu->Lsched. On entry
+ *   x[] holds B in the X_BLK layout, on exit it holds Y.
+ *
+ *   The supernodes are dealt out to the threads round-robin in level
+ *   order. Instead of a barrier after each level, a thread only waits
+ *   for the flags of the supernodes its next block row depends on, so
+ *   threads run ahead as soon as their own inputs are ready. Each X[k]
+ *   is written by one thread only, hence no atomic updates and no
+ *   per-thread lsum[] copies are needed.
+ * </pre>
+ */
+void dlsolve_lvl(double *x, double *rtemp, int_t sizertemp, int nrhs,
+                 int_t *xsup, gridinfo_t *grid, dLocalLU_t *Llu,
+                 SuperLUStat_t **stat, int num_thread)
+{
+    LvlSched_t *sched = Llu->Lsched;
+    int_t nsupers = sched->nsupers;
+    int_t *ilsum = Llu->ilsum;
+    int *done;
+
+    if ( !(done = int32Calloc_dist(nsupers)) )
+	ABORT("Calloc fails for done[].");
+
+#ifdef _OPENMP
+#pragma omp parallel default(shared) num_threads(num_thread)
+#endif
+    {
+	double alpha = 1.0, beta = 0.0;
+	double *rtemp_loc, *xk, *lusup, *Linv;
+	int_t  *lsub;
+	int_t  d, i, ii, irow, j, jj, k, lptr, p, rel;
+	int    knsupc, jnsupc, nbrow, nsupr, thread_id = 0, nthr = 1;
+#if ( PROFlevel>=1 )
+	double t1, t2;
+#endif
+
+#ifdef _OPENMP
+	thread_id = omp_get_thread_num();
+	nthr = omp_get_num_threads();
+#endif
+	rtemp_loc = &rtemp[sizertemp * thread_id];
+
+	for (p = thread_id; p < nsupers; p += nthr) {
+	    k = sched->order[p];
+	    knsupc = SuperSize( k );
+	    xk = &x[X_BLK( k )];
+	    rel = xsup[k];
+
+#if ( PROFlevel>=1 )
+	    TIC(t1);
+#endif
+	    /* X[k] -= L(k,j) * X[j] for all blocks in block row k. */
+	    for (d = sched->depptr[k]; d < sched->depptr[k+1]; ++d) {
+		j = sched->depsup[d];
+		dLvlSchedWait(done, j);
+
+		jnsupc = SuperSize( j );
+		lsub = Llu->Lrowind_bc_ptr[j];
+		lusup = Llu->Lnzval_bc_ptr[j];
+		nsupr = lsub[1];
+		lptr = sched->depidx[d];
+		nbrow = lsub[lptr + 1];
+		lptr += LB_DESCRIPTOR;
+#if defined (USE_VENDOR_BLAS)
+		dgemm_( "N", "N", &nbrow, &nrhs, &jnsupc,
+			&alpha, &lusup[sched->depval[d]], &nsupr, &x[X_BLK( j )],
+			&jnsupc, &beta, rtemp_loc, &nbrow, 1, 1 );
+#else
+		dgemm_( "N", "N", &nbrow, &nrhs, &jnsupc,
+			&alpha, &lusup[sched->depval[d]], &nsupr, &x[X_BLK( j )],
+			&jnsupc, &beta, rtemp_loc, &nbrow );
+#endif
+		RHS_ITERATE(jj)
+		    for (i = 0; i < nbrow; ++i) {
+			irow = lsub[lptr + i] - rel; /* Relative row. */
+			xk[irow + jj*knsupc] -= rtemp_loc[i + jj*nbrow];
+		    }
+		stat[thread_id]->ops[SOLVE] += 2 * nbrow * nrhs * jnsupc;
+	    }
+#if ( PROFlevel>=1 )
+	    TOC(t2, t1);
+	    stat[thread_id]->utime[SOL_GEMM] += t2;
+	    TIC(t1);
+#endif
+
+	    /* Diagonal block. */
+	    lsub = Llu->Lrowind_bc_ptr[k];
+	    lusup = Llu->Lnzval_bc_ptr[k];
+	    nsupr = lsub[1];
+	    if ( Llu->inv == 1 ) {
+		if ( Llu->sLinv_bc_ptr ) { /* inverse kept in single precision */
+		    dDiagInvMult_s("L", knsupc, nrhs, Llu->sLinv_bc_ptr[k], xk, rtemp_loc);
+		} else {
+		Linv = Llu->Linv_bc_ptr[k];
+#if defined (USE_VENDOR_BLAS)
+		dgemm_( "N", "N", &knsupc, &nrhs, &knsupc,
+			&alpha, Linv, &knsupc, xk,
+			&knsupc, &beta, rtemp_loc, &knsupc, 1, 1 );
+#else
+		dgemm_( "N", "N", &knsupc, &nrhs, &knsupc,
+			&alpha, Linv, &knsupc, xk,
+			&knsupc, &beta, rtemp_loc, &knsupc );
+#endif
+		}
+		for (ii = 0; ii < knsupc*nrhs; ++ii) xk[ii] = rtemp_loc[ii];
+	    } else {
+#if defined (USE_VENDOR_BLAS)
+		dtrsm_("L", "L", "N", "U", &knsupc, &nrhs, &alpha,
+		       lusup, &nsupr, xk, &knsupc, 1, 1, 1, 1);
+#else
+		dtrsm_("L", "L", "N", "U", &knsupc, &nrhs, &alpha,
+		       lusup, &nsupr, xk, &knsupc);
+#endif
+	    }
+	    stat[thread_id]->ops[SOLVE] += knsupc * (knsupc - 1) * nrhs;
+#if ( PROFlevel>=1 )
+	    TOC(t2, t1);
+	    stat[thread_id]->utime[SOL_TRSM] += t2;
+#endif
+
+#ifdef _OPENMP
+#pragma omp atomic write seq_cst
+#endif
+	    done[k] = 1;
+	} /* end for p ... */
+    } /* end parallel region */
+
+    SUPERLU_FREE(done);
+} /* dlsolve_lvl */
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   Solve U*X = Y on a single process following Llu->Usched. On entry
+ *   x[] holds Y in the X_BLK layout, on exit it holds X. The updates of
+ *   X[k] are read straight from block row k of U (Ufstnz_br_ptr[k],
+ *   Unzval_br_ptr[k]), which is stored contiguously.
+ * </pre>
+ */
+void dusolve_lvl(double *x, double *rtemp, int_t sizertemp, int nrhs,
+                 int_t *xsup, gridinfo_t *grid, dLocalLU_t *Llu,
+                 SuperLUStat_t **stat, int num_thread)
+{
+    LvlSched_t *sched = Llu->Usched;
+    int_t nsupers = sched->nsupers;
+    int_t *ilsum = Llu->ilsum;
+    int *done;
+
+    if ( !(done = int32Calloc_dist(nsupers)) )
+	ABORT("Calloc fails for done[].");
+
+#ifdef _OPENMP
+#pragma omp parallel default(shared) num_threads(num_thread)
+#endif
+    {
+	double alpha = 1.0, beta = 0.0;
+	double *rtemp_loc, *xk, *y, *dest, *uval, *lusup, *Uinv;
+	int_t  *usub, *lsub;
+	int_t  d, fnz, i, ii, ikfrow, iklrow, irow, j, jj, k, p, uptr;
+	int    knsupc, jnsupc, nsupr, thread_id = 0, nthr = 1;
+#if ( PROFlevel>=1 )
+	double t1, t2;
+#endif
+
+#ifdef _OPENMP
+	thread_id = omp_get_thread_num();
+	nthr = omp_get_num_threads();
+#endif
+	rtemp_loc = &rtemp[sizertemp * thread_id];
+
+	for (p = thread_id; p < nsupers; p += nthr) {
+	    k = sched->order[p];
+	    knsupc = SuperSize( k );
+	    xk = &x[X_BLK( k )];
+	    ikfrow = FstBlockC( k );
+	    iklrow = FstBlockC( k+1 );
+	    usub = Llu->Ufstnz_br_ptr[k];
+	    uval = Llu->Unzval_br_ptr[k];
+
+#if ( PROFlevel>=1 )
+	    TIC(t1);
+#endif
+	    /* X[k] -= U(k,j) * X[j] for all blocks in block row k. */
+	    for (d = sched->depptr[k]; d < sched->depptr[k+1]; ++d) {
+		j = sched->depsup[d];
+		dLvlSchedWait(done, j);
+
+		jnsupc = SuperSize( j );
+		i = sched->depidx[d];
+		RHS_ITERATE(ii) {
+		    dest = &xk[ii*knsupc];
+		    y = &x[X_BLK( j ) + ii*jnsupc];
+		    uptr = sched->depval[d];
+		    for (jj = 0; jj < jnsupc; ++jj) {
+			fnz = usub[i + jj];
+			if ( fnz < iklrow ) { /* Nonzero segment. */
+			    for (irow = fnz; irow < iklrow; ++irow)
+				dest[irow - ikfrow] -= uval[uptr++] * y[jj];
+			    stat[thread_id]->ops[SOLVE] += 2 * (iklrow - fnz);
+			}
+		    }
+		}
+	    }
+#if ( PROFlevel>=1 )
+	    TOC(t2, t1);
+	    stat[thread_id]->utime[SOL_GEMM] += t2;
+	    TIC(t1);
+#endif
+
+	    /* Diagonal block. */
+	    lsub = Llu->Lrowind_bc_ptr[k];
+	    lusup = Llu->Lnzval_bc_ptr[k];
+	    nsupr = lsub[1];
+	    if ( Llu->inv == 1 ) {
+		if ( Llu->sUinv_bc_ptr ) { /* inverse kept in single precision */
+		    dDiagInvMult_s("U", knsupc, nrhs, Llu->sUinv_bc_ptr[k], xk, rtemp_loc);
+		} else {
+		Uinv = Llu->Uinv_bc_ptr[k];
+#if defined (USE_VENDOR_BLAS)
+		dgemm_( "N", "N", &knsupc, &nrhs, &knsupc,
+			&alpha, Uinv, &knsupc, xk,
+			&knsupc, &beta, rtemp_loc, &knsupc, 1, 1 );
+#else
+		dgemm_( "N", "N", &knsupc, &nrhs, &knsupc,
+			&alpha, Uinv, &knsupc, xk,
+			&knsupc, &beta, rtemp_loc, &knsupc );
+#endif
+		}
+		for (ii = 0; ii < knsupc*nrhs; ++ii) xk[ii] = rtemp_loc[ii];
+	    } else {
+#if defined (USE_VENDOR_BLAS)
+		dtrsm_("L", "U", "N", "N", &knsupc, &nrhs, &alpha,
+		       lusup, &nsupr, xk, &knsupc, 1, 1, 1, 1);
+#else
+		dtrsm_("L", "U", "N", "N", &knsupc, &nrhs, &alpha,
+		       lusup, &nsupr, xk, &knsupc);
+#endif
+	    }
+	    stat[thread_id]->ops[SOLVE] += knsupc * (knsupc + 1) * nrhs;
+#if ( PROFlevel>=1 )
+	    TOC(t2, t1);
+	    stat[thread_id]->utime[SOL_TRSM] += t2;
+#endif
+
+#ifdef _OPENMP
+#pragma omp atomic write seq_cst
+#endif
+	    done[k] = 1;
+	} /* end for p ... */
+    } /* end parallel region */
+
+    SUPERLU_FREE(done);
+} /* dusolve_lvl */
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   Y = inv(T) * X, where inv(T) is an n-by-n inverted diagonal block kept
+ *   in single precision packed storage by pdCompute_Diag_Inv_s:
+ *   uplo = "L": column j holds rows j:n-1;  uplo = "U": rows 0:j.
+ *   X and Y are n-by-nrhs with leading dimension n; the products are
+ *   accumulated in double precision.
+ * </pre>
+ */
+void dDiagInvMult_s(char *uplo, int n, int nrhs, float *Tinv,
+                    double *x, double *y)
+{
+    int    i, j, jj;
+    float  *col;
+    double xj, *yj, *xjj;
+
+    for (jj = 0; jj < nrhs; ++jj) {
+	yj = &y[jj*n];
+	xjj = &x[jj*n];
+	for (i = 0; i < n; ++i) yj[i] = 0.0;
+	col = Tinv;
+	if ( *uplo == 'L' ) {
+	    for (j = 0; j < n; ++j) {
+		xj = xjj[j];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+		for (i = j; i < n; ++i) yj[i] += (double) col[i-j] * xj;
+		col += n - j;
+	    }
+	} else {
+	    for (j = 0; j < n; ++j) {
+		xj = xjj[j];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+		for (i = 0; i <= j; ++i) yj[i] += (double) col[i] * xj;
+		col += j + 1;
+	    }
+	}
+    }
+} /* dDiagInvMult_s */
@@ -0,0 +1,341 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+
+
+/*! @file
+ * \brief Distributed approximate-weight perfect matching for large diagonal
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ * </pre>
+ */
+#include <math.h>
+#include "superlu_ddefs.h"
+
+#define AWPM_EPS_MIN    1.0e-3  /* final epsilon of the auction */
+#define AWPM_EPS_RATIO  5.0     /* epsilon reduction between phases */
+#define AWPM_MAXROUNDS  100000  /* give up (structurally singular?) */
+
+/*! \brief Gather the (column, holder, price) reports of all processes.
+ * Returns the total number of reports; they are in allrep[3*k..3*k+2].
+ */
+static int_t
+awpm_exchange(int_t nrep, double *rep, double *allrep, int *counts,
+              int *displs, gridinfo_t *grid)
+{
+    int nprocs = grid->nprow * grid->npcol, p, cnt = 3 * (int) nrep;
+
+    MPI_Allgather(&cnt, 1, MPI_INT, counts, 1, MPI_INT, grid->comm);
+    for (displs[0] = 0, p = 1; p < nprocs; ++p)
+        displs[p] = displs[p-1] + counts[p-1];
+    cnt = displs[nprocs-1] + counts[nprocs-1];
+    if ( cnt )
+        MPI_Allgatherv(rep, 3 * (int) nrep, MPI_DOUBLE, allrep, counts,
+                       displs, MPI_DOUBLE, grid->comm);
+    return cnt / 3;
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ *   PDLDPERM_DIST finds a row permutation so that the matrix has large
+ *   entries on the diagonal, like dldperm_dist() with job = 5, but works
+ *   on the distributed matrix directly: no process needs more than its
+ *   own rows of A and a few vectors of length n.
+ *
+ *   The matching is computed by an auction with epsilon scaling on the
+ *   weights log|a_ij| - log max_k |a_kj|. Rows are the bidders and are
+ *   owned by the processes holding them; the column prices and owners are
+ *   replicated. In every round each process runs the auction for its
+ *   unmatched rows against its copy of the prices (block Gauss-Seidel),
+ *   then the columns that changed hands are exchanged and every process
+ *   merges them the same way: the highest price for a column wins, ties
+ *   going to the lower row. The rows that lost a column bid again in the
+ *   next round. On one process this is the sequential auction.
+ *
+ *   On exit the product of the diagonal of the permuted matrix is within
+ *   a factor exp(n*eps) of the optimum found by MC64, with
+ *   eps = AWPM_EPS_MIN. With the returned scaling all diagonal entries of
+ *   the permuted matrix are one in absolute value and the off-diagonal
+ *   entries are at most exp(eps) in absolute value.
+ *
+ * Arguments
+ * =========
+ *
+ * job    (input) int
+ *        = 5: also compute the scaling vectors u and v.
+ *        Otherwise only the permutation is computed.
+ *
+ * A      (input) SuperMatrix*
+ *        The distributed input matrix A of dimension (A->nrow, A->ncol).
+ *        The type of A can be: Stype = SLU_NR_loc; Dtype = SLU_D; Mtype = SLU_GE.
+ *
+ * grid   (input) gridinfo_t*
+ *        The 2D process mesh. All processes in grid->comm call this routine.
+ *
+ * perm   (output) int_t*, of size n, on all processes
+ *        The permutation vector. perm[i] = j means row i in the
+ *        original matrix is in row j of the permuted matrix.
+ *
+ * u      (output) double*, of size n, on all processes
+ *        If job = 5, the natural logarithms of the row scaling factors.
+ *
+ * v      (output) double*, of size n, on all processes
+ *        If job = 5, the natural logarithms of the column scaling factors.
+ *        The scaled matrix B has entries b_ij = a_ij * exp(u_i + v_j).
+ *
+ * Return value
+ * ============
+ *
+ *   = 0: successful exit.
+ *   > 0: the matrix is structurally singular, or the auction did not
+ *        finish within AWPM_MAXROUNDS rounds; the value is the number of
+ *        unmatched rows, which are given the unmatched columns in order.
+ * </pre>
+ */
+int
+pdldperm_dist(int job, SuperMatrix *A, gridinfo_t *grid, int_t *perm,
+              double u[], double v[])
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    int_t n = A->ncol, m_loc = Astore->m_loc, fst_row = Astore->fst_row;
+    int_t nnz_loc = Astore->nnz_loc;
+    int_t *rowptr = Astore->rowptr, *colind = Astore->colind;
+    double *a = (double *) Astore->nzval;
+    int nprocs = grid->nprow * grid->npcol, p, info = 0;
+    int_t i, j, k, i1, j1, head, nq, nrep, nall, ndead, nfree, rounds = 0;
+    int_t *owner, *changed, *match, *queue, *repcol;
+    int *counts, *displs;
+    double *price, *logcmax, *w, *rep, *allrep;
+    double delta, eps, pbound, v1, v2, val;
+#if ( PRNTlevel>=1 )
+    double t = SuperLU_timer_();
+#endif
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Enter pdldperm_dist()");
+#endif
+
+    if ( !(owner = intMalloc_dist(2 * n)) ) ABORT("Malloc fails for owner[]");
+    changed = owner + n;
+    if ( !(match = intMalloc_dist(3 * m_loc + 1)) ) ABORT("Malloc fails for match[]");
+    queue = match + m_loc;
+    repcol = queue + m_loc;
+    if ( !(price = doubleMalloc_dist(n)) ) ABORT("Malloc fails for price[]");
+    if ( !(logcmax = doubleMalloc_dist(n)) ) ABORT("Malloc fails for logcmax[]");
+    if ( !(w = doubleMalloc_dist(nnz_loc + 1)) ) ABORT("Malloc fails for w[]");
+    if ( !(rep = doubleMalloc_dist(3 * m_loc + 1)) ) ABORT("Malloc fails for rep[]");
+    if ( !(allrep = doubleMalloc_dist(3 * n + 1)) ) ABORT("Malloc fails for allrep[]");
+    counts = SUPERLU_MALLOC(2 * nprocs * sizeof(int));
+    if ( !counts ) ABORT("Malloc fails for counts[]");
+    displs = counts + nprocs;
+
+    /* Weights w_ij = log|a_ij| - log max_k |a_kj| <= 0; zeros are not
+       edges of the bipartite graph and get w = -HUGE_VAL. */
+    for (j = 0; j < n; ++j) logcmax[j] = 0.0;
+    for (k = 0; k < nnz_loc; ++k)
+        logcmax[colind[k]] = SUPERLU_MAX(logcmax[colind[k]], fabs(a[k]));
+    MPI_Allreduce(MPI_IN_PLACE, logcmax, n, MPI_DOUBLE, MPI_MAX, grid->comm);
+    for (j = 0; j < n; ++j)
+        logcmax[j] = logcmax[j] > 0.0 ? log(logcmax[j]) : 0.0;
+    delta = 0.0;
+    ndead = 0;
+    for (i = 0; i < m_loc; ++i) {
+        nq = 0;
+        for (k = rowptr[i]; k < rowptr[i+1]; ++k) {
+            if ( a[k] != 0.0 ) {
+                w[k] = log(fabs(a[k])) - logcmax[colind[k]];
+                delta = SUPERLU_MAX(delta, -w[k]);
+                ++nq;
+            } else w[k] = -HUGE_VAL;
+        }
+        if ( nq == 0 ) ++ndead;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &delta, 1, MPI_DOUBLE, MPI_MAX, grid->comm);
+    MPI_Allreduce(MPI_IN_PLACE, &ndead, 1, mpi_int_t, MPI_SUM, grid->comm);
+    delta = SUPERLU_MAX(delta, 1.0);
+    /* A row with a single edge bids as if its second choice were worth
+       delta + 1 less. Prices cannot exceed pbound in a feasible problem. */
+    pbound = (double) (n + 1) * (2.0 * delta + 1.0);
+
+    for (j = 0; j < n; ++j) {
+        owner[j] = SLU_EMPTY;
+        changed[j] = 0;
+        price[j] = 0.0;
+    }
+    /* queue[] is a circular list of the nq unmatched local rows. */
+    for (i = 0; i < m_loc; ++i) {
+        match[i] = SLU_EMPTY;
+        queue[i] = i;
+    }
+    head = 0;
+    nq = m_loc;
+
+    eps = delta / AWPM_EPS_RATIO;
+    while ( ndead == 0 && !info ) {
+        eps = SUPERLU_MAX(eps / AWPM_EPS_RATIO, AWPM_EPS_MIN);
+
+        /* Release the rows that are no longer eps-happy. */
+        nrep = 0;
+        for (i = 0; i < m_loc; ++i) {
+            if ( (j = match[i]) == SLU_EMPTY ) continue;
+            v1 = -HUGE_VAL;
+            for (k = rowptr[i]; k < rowptr[i+1]; ++k)
+                v1 = SUPERLU_MAX(v1, w[k] - price[colind[k]]);
+            for (k = rowptr[i]; k < rowptr[i+1]; ++k)
+                if ( colind[k] == j ) break;
+            if ( w[k] - price[j] < v1 - eps ) {
+                match[i] = SLU_EMPTY;
+                queue[(head + nq++) % m_loc] = i;
+                rep[3 * nrep] = (double) j;
+                rep[3 * nrep + 1] = (double) SLU_EMPTY;
+                rep[3 * nrep + 2] = price[j];
+                ++nrep;
+            }
+        }
+        nall = awpm_exchange(nrep, rep, allrep, counts, displs, grid);
+        for (k = 0; k < nall; ++k) owner[(int_t) allrep[3 * k]] = SLU_EMPTY;
+
+        /* Auction rounds. */
+        for (;;) {
+            /* Local auction: a row that is outbid by another local row
+               bids again at once; columns held by other processes are
+               taken tentatively. */
+            nrep = 0;
+            while ( nq && !info ) {
+                i = queue[head];
+                head = (head + 1) % m_loc;
+                --nq;
+                v1 = v2 = -HUGE_VAL;
+                j1 = SLU_EMPTY;
+                for (k = rowptr[i]; k < rowptr[i+1]; ++k) {
+                    if ( w[k] == -HUGE_VAL ) continue;
+                    j = colind[k];
+                    val = w[k] - price[j];
+                    if ( val > v1 ) {
+                        v2 = v1;
+                        v1 = val;
+                        j1 = j;
+                    } else if ( val > v2 ) v2 = val;
+                }
+                if ( v2 == -HUGE_VAL ) v2 = v1 - delta - 1.0;
+
+                i1 = owner[j1] - fst_row;
+                if ( i1 >= 0 && i1 < m_loc && match[i1] == j1 ) {
+                    match[i1] = SLU_EMPTY;
+                    queue[(head + nq++) % m_loc] = i1;
+                }
+                owner[j1] = i + fst_row;
+                price[j1] += (v1 - v2) + eps;
+                match[i] = j1;
+                if ( !changed[j1] ) {
+                    changed[j1] = 1;
+                    repcol[nrep++] = j1;
+                }
+                if ( price[j1] > pbound ) info = 1;
+            }
+
+            /* Every changed column is held by a local row, so there are at
+               most m_loc reports. */
+            for (k = 0; k < nrep; ++k) {
+                j = repcol[k];
+                changed[j] = 0;
+                rep[3 * k] = (double) j;
+                rep[3 * k + 1] = (double) owner[j];
+                rep[3 * k + 2] = price[j];
+            }
+            nall = awpm_exchange(nrep, rep, allrep, counts, displs, grid);
+            if ( nall == 0 ) break;
+            if ( ++rounds > AWPM_MAXROUNDS ) {
+                info = 1;
+                break;
+            }
+
+            /* Merge: a report replaces the current holder if its price is
+               higher, or equal with a lower row. Local rows that lose
+               their column go back to the queue. */
+            for (k = 0; k < nall; ++k) {
+                j = (int_t) allrep[3 * k];
+                i = (int_t) allrep[3 * k + 1];
+                val = allrep[3 * k + 2];
+                if ( val < price[j] || (val == price[j] && i >= owner[j]) )
+                    continue;
+                i1 = owner[j] - fst_row;
+                if ( i1 >= 0 && i1 < m_loc && match[i1] == j ) {
+                    match[i1] = SLU_EMPTY;
+                    queue[(head + nq++) % m_loc] = i1;
+                }
+                owner[j] = i;
+                price[j] = val;
+                if ( val > pbound ) info = 1;
+            }
+            if ( info ) break;
+        }
+
+        if ( eps <= AWPM_EPS_MIN ) break;
+    }
+
+    /* Assemble perm[] from the replicated owners; unmatched rows, if any,
+       take the unmatched columns in order. */
+    for (i = 0; i < n; ++i) perm[i] = SLU_EMPTY;
+    for (j = 0; j < n; ++j)
+        if ( owner[j] != SLU_EMPTY ) perm[owner[j]] = j;
+    nfree = 0;
+    for (i = 0, j = 0; i < n; ++i) {
+        if ( perm[i] != SLU_EMPTY ) continue;
+        while ( owner[j] != SLU_EMPTY ) ++j;
+        perm[i] = j++;
+        ++nfree;
+    }
+    if ( ndead || nfree ) info = (int) SUPERLU_MAX(nfree, ndead);
+
+    if ( job == 5 && !info ) {
+        /* u_i makes the matched entry one: u_i = -(w_ij - p_j), j = perm[i];
+           v_j = -p_j - log max_k |a_kj|. */
+        for (i = 0; i < m_loc; ++i) {
+            j = perm[i + fst_row];
+            for (k = rowptr[i]; k < rowptr[i+1]; ++k)
+                if ( colind[k] == j ) break;
+            rep[i] = price[j] - w[k];
+        }
+        p = (int) m_loc;
+        MPI_Allgather(&p, 1, MPI_INT, counts, 1, MPI_INT, grid->comm);
+        p = (int) fst_row;
+        MPI_Allgather(&p, 1, MPI_INT, displs, 1, MPI_INT, grid->comm);
+        MPI_Allgatherv(rep, (int) m_loc, MPI_DOUBLE, u, counts, displs,
+                       MPI_DOUBLE, grid->comm);
+        for (j = 0; j < n; ++j) v[j] = -price[j] - logcmax[j];
+    }
+
+#if ( PRNTlevel>=1 )
+    if ( !grid->iam )
+        printf(".. AWPM: %lld rounds, eps %.1e, info %d, time %.2f\n",
+               (long long) rounds, eps, info, SuperLU_timer_() - t);
+#endif
+
+    SUPERLU_FREE(owner);
+    SUPERLU_FREE(match);
+    SUPERLU_FREE(price);
+    SUPERLU_FREE(logcmax);
+    SUPERLU_FREE(w);
+    SUPERLU_FREE(rep);
+    SUPERLU_FREE(allrep);
+    SUPERLU_FREE(counts);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(grid->iam, "Exit pdldperm_dist()");
+#endif
+    return info;
+}
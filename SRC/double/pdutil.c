@@ -416,6 +416,13 @@ void dLUstructInit(const int_t n, dLUstruct_t *LUstruct)
 	   SUPERLU_MALLOC(sizeof(dLocalLU_t))) )
 	ABORT("Malloc fails for LocalLU_t.");
 	LUstruct->Llu->inv = 0;
+	LUstruct->Llu->sLinv_bc_ptr = NULL;
+	LUstruct->Llu->sUinv_bc_ptr = NULL;
+	LUstruct->Llu->Lsched = NULL;
+	LUstruct->Llu->Usched = NULL;
+	LUstruct->Llu->refact_mask = NULL;
+	LUstruct->trf3Dpart = NULL;
+	LUstruct->lowrank = NULL;
 }
 
 /*! \brief Deallocate LUstruct */
@@ -452,6 +459,7 @@ dDestroy_LU(int_t n, gridinfo_t *grid, dLUstruct_t *LUstruct)
 #endif
 
     dDestroy_Tree(n, grid, LUstruct);
+    dLvlSchedFree(Llu);
 
     nsupers = Glu_persist->supno[n-1] + 1;
 
@@ -503,6 +511,11 @@ dDestroy_LU(int_t n, gridinfo_t *grid, dLUstruct_t *LUstruct)
     SUPERLU_FREE((Llu->bsendx_plist)[0]);
     SUPERLU_FREE(Llu->bsendx_plist);
     SUPERLU_FREE(Llu->mod_bit);
+    if ( Llu->refact_mask ) {
+	SUPERLU_FREE(Llu->refact_mask);
+	Llu->refact_mask = NULL;
+    }
+    dLowRankFree(LUstruct);
 
     /* Following are free'd in distribution routines */
     // nb = CEILING(nsupers, grid->npcol);
@@ -525,11 +538,19 @@ dDestroy_LU(int_t n, gridinfo_t *grid, dLUstruct_t *LUstruct)
     //	}
     // }
     SUPERLU_FREE(Llu->Linv_bc_ptr);
-    SUPERLU_FREE(Llu->Linv_bc_dat);
+    if ( Llu->Linv_bc_dat ) SUPERLU_FREE(Llu->Linv_bc_dat); /* NULL if released by pdCompute_Diag_Inv_s */
     SUPERLU_FREE(Llu->Linv_bc_offset);
     SUPERLU_FREE(Llu->Uinv_bc_ptr);
-    SUPERLU_FREE(Llu->Uinv_bc_dat);
+    if ( Llu->Uinv_bc_dat ) SUPERLU_FREE(Llu->Uinv_bc_dat);
     SUPERLU_FREE(Llu->Uinv_bc_offset);
+    if ( Llu->sLinv_bc_ptr ) {
+	SUPERLU_FREE(Llu->sLinv_bc_ptr);
+	SUPERLU_FREE(Llu->sLinv_bc_dat);
+	SUPERLU_FREE(Llu->sUinv_bc_ptr);
+	SUPERLU_FREE(Llu->sUinv_bc_dat);
+	Llu->sLinv_bc_ptr = NULL;
+	Llu->sUinv_bc_ptr = NULL;
+    }
     SUPERLU_FREE(Llu->Unnz);
 
     /* Following are free'd in distribution routines */
@@ -613,6 +634,62 @@ if (get_acc_solve()){
 #endif
 }
 
+/*! \brief Restrict the next refactorization to the part of L and U that
+ * depends on changed rows or columns of A.
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   After A has been factored by pdgssvx(), a subsequent call with
+ *   options->Fact = SamePattern_SameRowPerm normally redistributes all of
+ *   A into L and U and refactors them. When only the rows rows[0:nrow-1]
+ *   and the columns cols[0:ncol-1] of A (original indices) changed, this
+ *   routine marks the supernodes on the elimination tree paths from the
+ *   changed entries to the root. The next SamePattern_SameRowPerm call
+ *   of pdgssvx() then reloads and refactors only the panels of these
+ *   supernodes; the other panels of L and U are kept from the previous
+ *   factorization, and only the updates into the marked panels are
+ *   recomputed. The marks are consumed by that call.
+ *
+ *   Call it with A as it will be passed to pdgssvx(), i.e. before
+ *   the column permutation is applied to A->Store->colind, and do not
+ *   zero L and U between the two factorizations. The scaling R and C is
+ *   reused by SamePattern_SameRowPerm, so the unchanged rows keep their
+ *   scaled values.
+ *
+ *   Nothing is marked, and the whole matrix is refactored, with the
+ *   parallel symbolic factorization, or when the Schur complement
+ *   updates are offloaded to the GPU.
+ *
+ * Return value
+ * ============
+ *   The number of supernodes that will be refactored.
+ * </pre>
+ */
+int_t
+pdgsrefact_mark(superlu_dist_options_t *options, int_t nrow, int_t *rows,
+		int_t ncol, int_t *cols, SuperMatrix *A,
+		dScalePermstruct_t *ScalePermstruct, dLUstruct_t *LUstruct,
+		gridinfo_t *grid)
+{
+    dLocalLU_t *Llu = LUstruct->Llu;
+    int_t n = A->ncol, nsupers = LUstruct->Glu_persist->supno[n-1] + 1;
+
+    if ( Llu->refact_mask ) {
+	SUPERLU_FREE(Llu->refact_mask);
+	Llu->refact_mask = NULL;
+    }
+    if ( options->ParSymbFact == YES ) return nsupers;
+#ifdef GPU_ACC
+    if ( sp_ienv_dist(10, options) ) return nsupers;
+#endif
+
+    return pxgsrefact_mask(n, A, ScalePermstruct->perm_r,
+			   ScalePermstruct->perm_c, LUstruct->etree,
+			   LUstruct->Glu_persist, nrow, rows, ncol, cols,
+			   grid, &Llu->refact_mask);
+}
+
 /*! \brief
  *
  * <pre>
@@ -770,6 +847,10 @@ pdgstrs_init(int_t n, int_t m_loc, int_t nrhs, int_t fst_row,
     gstrs_comm->ptr_to_ibuf = ptr_to_ibuf;
     gstrs_comm->ptr_to_dbuf = ptr_to_ibuf + procs;
 
+    /* Only the ranks with nonzero counts take part in the exchanges. */
+    pxgstrs_nbr_init(gstrs_comm->B_to_X_SendCnt, grid, &gstrs_comm->B_to_X_nbr);
+    pxgstrs_nbr_init(gstrs_comm->X_to_B_SendCnt, grid, &gstrs_comm->X_to_B_nbr);
+
     return 0;
 } /* PDGSTRS_INIT */
 
@@ -160,6 +160,10 @@ typedef struct {
   int_t  xusub_nextLvl;   /* Pointer to usub of the next level */
   int_t  xlsub_nextLvl;   /* Pointer to lsub of the next level */
   int_t  fstVtx_nextLvl;  /* First vertex of the next level */
+  int    *fstPSep;        /* First processor affected to each node of the
+			     separator tree */
+  int    *lstPSep;        /* Last processor (+1) affected to each node of the
+			     separator tree */
 } vtcsInfo_symbfact_t;
 
 /*! \brief Structure used for redistributing A for the symbolic factorization algorithm */
@@ -255,6 +255,14 @@ typedef struct {
     int_t nfrecvmod;
     int_t inv; /* whether the diagonal block is inverted*/
     int nbcol_masked; /*number of local block columns in my 2D grid*/
+    float  **sLinv_bc_ptr; /* single precision packed inverses, size ceil(NSUPERS/Pc) */
+    float  *sLinv_bc_dat;
+    float  **sUinv_bc_ptr; /* single precision packed inverses, size ceil(NSUPERS/Pc) */
+    float  *sUinv_bc_dat;
+    LvlSched_t *Lsched; /* level-set schedule of the L-solve (1 rank) */
+    LvlSched_t *Usched; /* level-set schedule of the U-solve (1 rank) */
+    int   *refact_mask;  /* supernodes refactored by the next SamePattern_
+			    SameRowPerm factorization, NULL: all of them */
 
 #ifdef GPU_ACC
     /* The following variables are used in GPU trisolve */
@@ -337,12 +345,26 @@ typedef struct
 } dtrf3Dpartition_t;
 
 
+/*! \brief Low-rank updates U*V^T attached to a factorization by
+ * pdgsupdate_lowrank(), see pdgssvx_lowrank.c.
+ */
+typedef struct {
+    int   m_loc;    /* number of local rows of U and V */
+    int   k;        /* total rank of the attached updates */
+    int   kmax;     /* rank limit, from SUPERLU_LOWRANK_MAX */
+    double *V;      /* local rows of V, leading dimension max(m_loc,1) */
+    double *Z;      /* local rows of inv(A)*U */
+    double *CapLU;  /* LU factors of I + V^T*Z, k-by-k, replicated */
+    int   *ipiv;    /* pivots of CapLU */
+} dLowRank_t;
+
 typedef struct {
     int_t *etree;
     Glu_persist_t *Glu_persist;
     dLocalLU_t *Llu;
     dtrf3Dpartition_t *trf3Dpart;
     char dt;
+    dLowRank_t *lowrank; /* NULL if no low-rank update is attached */
 } dLUstruct_t;
 
 
@@ -484,6 +506,36 @@ typedef struct dlsumBmod_buff_t
     int_t *indCols; //
 }dlsumBmod_buff_t;
 
+/*-- Streaming assembly of a distributed matrix, see dassemble.c */
+typedef struct {
+    int_t    m, n;            /* global dimensions */
+    int_t    m_loc, fst_row;  /* my rows, as in NRformat_loc */
+    MPI_Comm comm;            /* duplicate of grid->comm */
+    int      iam, nprocs;
+    int_t    bufsize;         /* triplets buffered per destination */
+    yes_no_t KeepRouting;     /* keep slot[] for dAssembleRestart() */
+    yes_no_t SamePattern;     /* assembling values only */
+    char     **sendbuf;       /* [nprocs] buffer being filled */
+    char     **inflight;      /* [nprocs] buffer being sent */
+    MPI_Request *req;         /* [nprocs] send of inflight[] */
+    int_t    *nsend;          /* [nprocs] triplets in sendbuf[] */
+    int      *nmsg, *nrecv;   /* [nprocs] messages sent to / received from */
+    int      tag;             /* 0 and 1 in turn for the assemblies */
+    char     *recvbuf;
+    int      recvcap;
+    int_t    nloc, maxloc;    /* triplets received in my rows */
+    int_t    *lrow, *lcol;
+    double   *lval;
+    int      *lsrc;           /* source process of each triplet */
+    int_t    *slotptr, *slot; /* slot[slotptr[p]+k]: position in nzval[] of
+				 the k-th entry received from process p */
+    int_t    *cnt;            /* [nprocs] entries received in this pass */
+    int_t    nnz_loc, *rowptr, *colind; /* structure kept for the same
+					   pattern */
+    double   *nzval;          /* values being assembled */
+    int      error;
+} dAssemble_t;
+
 /*=====================*/
 
 /***********************************************************************
@@ -538,6 +590,10 @@ extern int     dcreate_matrix_dat(SuperMatrix *, int, double **, int *,
 			      double **, int *, FILE *, gridinfo_t *);
 extern int dcreate_matrix_postfix(SuperMatrix *, int, double **, int *,
 				  double **, int *, FILE *, char *, gridinfo_t *);
+extern int dgrid_advise_postfix(superlu_dist_options_t *, FILE *, char *,
+				int, int, int, MPI_Comm, superlu_gridshape_t *);
+extern int dcreate_matrix_mpiio(SuperMatrix *, int, double **, int *,
+				double **, int *, char *, gridinfo_t *);
 
 extern void   dScalePermstructInit(const int_t, const int_t,
                                       dScalePermstruct_t *);
@@ -551,6 +607,8 @@ extern void    dlaqgs_dist (SuperMatrix *, double *, double *, double,
 			    double, double, char *);
 extern void    pdgsequ (SuperMatrix *, double *, double *, double *,
 			double *, double *, int *, gridinfo_t *);
+extern int     pdgsequ_ruiz (SuperMatrix *, double *, double *, yes_no_t, int,
+			     double, int *, gridinfo_t *);
 extern double  pdlangs (char *, SuperMatrix *, gridinfo_t *);
 extern void    pdlaqgs (SuperMatrix *, double *, double *, double,
 			double, double, char *);
@@ -589,6 +647,7 @@ extern void  pdgssvx(superlu_dist_options_t *, SuperMatrix *,
 		     int, int, gridinfo_t *, dLUstruct_t *,
 		     dSOLVEstruct_t *, double *, SuperLUStat_t *, int *);
 extern void  pdCompute_Diag_Inv(int_t, dLUstruct_t *,gridinfo_t *, SuperLUStat_t *, int *);
+extern void  pdCompute_Diag_Inv_s(int_t, dLUstruct_t *,gridinfo_t *, SuperLUStat_t *, int *);
 extern int  dSolveInit(superlu_dist_options_t *, SuperMatrix *, int_t [], int_t [],
 		       int_t, dLUstruct_t *, gridinfo_t *, dSOLVEstruct_t *);
 extern void dSolveFinalize(superlu_dist_options_t *, dSOLVEstruct_t *);
@@ -602,12 +661,26 @@ extern int_t pdgstrs_delete_device_lsum_x(dSOLVEstruct_t *);
 extern void pxgstrs_finalize(pxgstrs_comm_t *);
 extern int  dldperm_dist(int, int, int_t, int_t [], int_t [],
 		    double [], int_t *, double [], double []);
+extern int  pdldperm_dist(int, SuperMatrix *, gridinfo_t *, int_t *,
+                           double [], double []);
 extern int  dstatic_schedule(superlu_dist_options_t *, int, int,
 		            dLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
 			    int_t *, int_t *, int *);
 extern void dLUstructInit(const int_t, dLUstruct_t *);
 extern void dLUstructFree(dLUstruct_t *);
 extern void dDestroy_LU(int_t, gridinfo_t *, dLUstruct_t *);
+extern int_t pdgsrefact_mark(superlu_dist_options_t *, int_t, int_t *, int_t,
+			    int_t *, SuperMatrix *, dScalePermstruct_t *,
+			    dLUstruct_t *, gridinfo_t *);
+extern int  pdgsupdate_lowrank(superlu_dist_options_t *, int, double *, int,
+				double *, int, SuperMatrix *, dScalePermstruct_t *,
+				dLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
+				int *);
+extern void pdgssvx_lowrank(superlu_dist_options_t *, SuperMatrix *,
+			    dScalePermstruct_t *, double *, int, int,
+			    gridinfo_t *, dLUstruct_t *, dSOLVEstruct_t *,
+			    double *, SuperLUStat_t *, int *);
+extern void dLowRankFree(dLUstruct_t *);
 extern void dDestroy_Tree(int_t, gridinfo_t *, dLUstruct_t *);
 extern void dscatter_l (int ib, int ljb, int nsupc, int_t iukp, int_t* xsup,
 			int klst, int nbrow, int_t lptr, int temp_nbrow,
@@ -672,6 +745,13 @@ extern void dlsum_bmod_inv_master(double *, double *, double *, double *,
 
 extern void dComputeLevelsets(int , int_t , gridinfo_t *,
 		  Glu_persist_t *, dLocalLU_t *, int_t *);
+extern void dLvlSchedInit(int_t, int_t *, gridinfo_t *, dLocalLU_t *);
+extern void dLvlSchedFree(dLocalLU_t *);
+extern void dDiagInvMult_s(char *, int, int, float *, double *, double *);
+extern void dlsolve_lvl(double *, double *, int_t, int, int_t *,
+                       gridinfo_t *, dLocalLU_t *, SuperLUStat_t **, int);
+extern void dusolve_lvl(double *, double *, int_t, int, int_t *,
+                       gridinfo_t *, dLocalLU_t *, SuperLUStat_t **, int);
 
 #ifdef GPU_ACC
 extern void pdconvertU(superlu_dist_options_t *, gridinfo_t *, dLUstruct_t *, SuperLUStat_t *, int);
@@ -956,6 +1036,12 @@ extern void dCopy_CompRowLoc_Matrix_dist(SuperMatrix *, SuperMatrix *);
 extern void dZero_CompRowLoc_Matrix_dist(SuperMatrix *);
 extern void dScaleAddId_CompRowLoc_Matrix_dist(SuperMatrix *, double);
 extern void dScaleAdd_CompRowLoc_Matrix_dist(SuperMatrix *, SuperMatrix *, double);
+extern void dAssembleInit(dAssemble_t *, int_t, int_t, int_t, yes_no_t,
+			  gridinfo_t *);
+extern int  dAssembleAdd(dAssemble_t *, int_t, int_t *, int_t *, double *);
+extern int  dAssembleFinalize(dAssemble_t *, SuperMatrix *);
+extern void dAssembleRestart(dAssemble_t *);
+extern void dAssembleFree(dAssemble_t *);
 extern void dZeroLblocks(int, int, gridinfo_t *, dLUstruct_t *);
 extern void dZeroUblocks(int iam, int n, gridinfo_t *, dLUstruct_t *);
 extern double dMaxAbsLij(int iam, int n, Glu_persist_t *,
@@ -977,8 +1063,11 @@ extern void  dreadrb_dist(int, FILE *, int_t *, int_t *, int_t *,
 		     double **, int_t **, int_t **);
 extern void  dreadMM_dist(FILE *, int_t *, int_t *, int_t *,
 	                  double **, int_t **, int_t **);
+extern int   pdreadMM_loc(char *, SuperMatrix *, gridinfo_t *);
 extern int  dread_binary(FILE *, int_t *, int_t *, int_t *,
 	                  double **, int_t **, int_t **);
+extern int   pdread_binary_loc(char *, SuperMatrix *, gridinfo_t *);
+extern int   pdwrite_binary_loc(char *, SuperMatrix *, int, gridinfo_t *);
 
 extern void validateInput_pdgssvx3d(superlu_dist_options_t *, SuperMatrix *A,
        int ldb, int nrhs, gridinfo3d_t *, int *info);
@@ -1312,7 +1401,7 @@ receiver[U(nodelist)] =sender[U(nodelist)] +receiver[U(nodelist)]
 */
 int_t dreduceAncestors3d(int_t sender, int_t receiver,
                         int_t nnodes, int_t* nodeList,
-                        double* Lval_buf, double* Uval_buf,
+                        dLUValSubBuf_t* LUvsb,
                         dLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT);
 /*reduces all nodelists required in a level*/
 extern int dreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount,
@@ -1351,6 +1440,19 @@ int_t dzSendUPanel(int_t k, int_t receiver,
 int_t dzRecvUPanel(int_t k, int_t sender, double alpha,
                    double beta, double* Uval_buf,
 		   dLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT);
+/* Send and add only the blocks of the panels touched by the sender */
+int_t dzSendLPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+			  double* val_buf, dLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t dzRecvLPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+			  double* Lval_buf, dLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t dzSendUPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+			  double* val_buf, dLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t dzRecvUPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+			  double* Uval_buf, dLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
 
     /* from communication_aux.h */
 extern int_t dIBcast_LPanel (int_t k, int_t k0, int_t* lsub, double* lusup,
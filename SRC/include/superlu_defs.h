@@ -434,6 +434,43 @@ typedef struct {
 			   */
 } gridinfo3d_t;
 
+/*-- Symbolic statistics for the process grid advisor, superlu_grid_advise().
+ *   The lvl arrays are indexed by the depth in the supernodal etree, with
+ *   the roots at depth 0; the others by supernode. */
+typedef struct {
+    int_t n;              /* order of the matrix */
+    int_t nsupers;        /* number of supernodes */
+    int   nlvl;           /* number of depths */
+    int_t *lvlNsupers;    /* supernodes */
+    int_t *lvlCols;       /* columns of these supernodes */
+    int_t *lvlRows;       /* rows of their L panels, diagonal block included */
+    double *lvlFlops;     /* factorization flops */
+    double *lvlFill;      /* nonzeros of L+U */
+    int_t *setree;        /* supernodal etree, see supernodal_etree() */
+    int_t *xsup;          /* first column of each supernode, size nsupers+1 */
+    int_t *depth;         /* depth of each supernode */
+    int_t *rows;          /* rows of its L panel */
+    double *flops;        /* its factorization flops */
+    double *fill;         /* its nonzeros of L+U */
+} superlu_symbstats_t;
+
+/*-- Machine parameters of the process grid advisor */
+typedef struct {
+    double flopRate;      /* flop/s of one process in the factorization */
+    double latency;       /* seconds per message */
+    double bwIntra;       /* bytes/s between two processes of a node */
+    double bwInter;       /* bytes/s out of a node, shared by its processes */
+} superlu_machine_t;
+
+/*-- Process grid shape returned by superlu_grid_advise() */
+typedef struct {
+    int nprow;            /* number of process rows */
+    int npcol;            /* number of process columns */
+    int npdep;            /* number of layers in Z-dimension */
+    double tFactor;       /* predicted factorization time in seconds */
+    double tSolve;        /* predicted time of one solve */
+} superlu_gridshape_t;
+
 
 /*
  *-- The structures are determined by SYMBFACT and used thereafter.
@@ -563,11 +600,34 @@ typedef struct {
 } ScalePermstruct_t;
 #endif
 
+/*-- Separator tree of a nested-dissection ordering (get_perm_c_nd).
+ *   Nodes are numbered in postorder. Node k owns the new positions
+ *   fstVtx[k] .. fstVtx[k+1]-1 (none for an empty separator), and its
+ *   subtree owns a contiguous range that ends with them. The domains are
+ *   the leaves; parent[] is SLU_EMPTY at the root.
+ */
+typedef struct {
+    int_t nnodes;
+    int_t *fstVtx;   /* size nnodes+1 */
+    int_t *parent;   /* size nnodes */
+} ndSepTree_t;
+
+/*-- Neighborhood of one B <-> X redistribution pattern --*/
+typedef struct {
+    MPI_Comm comm;      /* distributed graph over the ranks exchanged with,
+			   MPI_COMM_NULL if the grid has only one process */
+    int  outdeg, indeg;
+    int  *SendCnt, *SendCnt_nrhs, *sdispls, *sdispls_nrhs; /* length outdeg */
+    int  *RecvCnt, *RecvCnt_nrhs, *rdispls, *rdispls_nrhs; /* length indeg */
+} pxgstrs_nbr_t;
+
 /*-- Data structure for redistribution of B and X --*/
 typedef struct {
     int  *B_to_X_SendCnt;
     int  *X_to_B_SendCnt;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
+    pxgstrs_nbr_t B_to_X_nbr; /* built from B_to_X_SendCnt in pxgstrs_init */
+    pxgstrs_nbr_t X_to_B_nbr; /* built from X_to_B_SendCnt in pxgstrs_init */
 
     /* the following are needed in the hybrid solver PDSLin */
     int *X_to_B_iSendCnt;
@@ -583,6 +643,26 @@ typedef struct {
     void   *recv_dbuf2;
 } pxgstrs_comm_t;
 
+/*-- Exchange of column maxima for the distributed equilibration
+ *   p[sdz]gsequ_ruiz(). The columns are owned like the rows of the same
+ *   index. A process sends the partial maxima of the columns met in its
+ *   rows to their owners, which send back the maxima of whole columns;
+ *   only the processes sharing columns are neighbors.
+ */
+typedef struct {
+    int_t  nslot;        /* distinct columns in my rows */
+    int_t  *col;         /* their global indices, increasing; size nslot */
+    int_t  *slot;        /* slot of each local nonzero; size nnz_loc */
+    int_t  fst_col, ncol; /* my columns fst_col .. fst_col+ncol-1 */
+    double *cmax;        /* maxima of my columns; size ncol */
+    int_t  *ridx;        /* my columns sent by the in-neighbors */
+    double *rbuf;        /* their partial maxima */
+    MPI_Comm fwd, bwd;   /* graphs to the owners and back */
+    int  outdeg, indeg;
+    int  *SendCnt, *sdispls; /* length outdeg, outdeg+1 */
+    int  *RecvCnt, *rdispls; /* length indeg, indeg+1 */
+} pxgsequ_colmax_t;
+
 /*
  *-- This contains the options used to control the solution process.
  *
@@ -624,6 +704,7 @@ typedef struct {
  *        = MMD_AT_PLUS_A: use minimum degree ordering on structure of A'+A
  *        = COLAMD: use approximate minimum degree column ordering
  *        = MY_PERMC: use the ordering specified by the user
+ *        = ND_AT_PLUS_A: use the built-in nested dissection on A'+A
  *
  * Trans  (trans_t)
  *        Specifies the form of the system of equations:
@@ -777,12 +858,74 @@ typedef struct {
     int64_t nnzL, nnzU;
 } superlu_dist_mem_usage_t;
 
+/*-- Matrix Market header, read by superlu_mm_read_header(). */
+typedef enum {SLU_MM_REAL, SLU_MM_COMPLEX, SLU_MM_INTEGER, SLU_MM_PATTERN}
+    superlu_mm_field_t;
+typedef enum {SLU_MM_GENERAL, SLU_MM_SYMMETRIC, SLU_MM_SKEW, SLU_MM_HERMITIAN}
+    superlu_mm_symmetry_t;
+
+typedef struct {
+    int_t m, n, nnz;       /* size line of the file */
+    int   field;           /* superlu_mm_field_t */
+    int   symmetry;        /* superlu_mm_symmetry_t */
+    long long data_offset; /* offset of the first entry in the file */
+} superlu_mm_header_t;
+
+/*-- Binary matrix files, see binary_io.c. */
+#define SLU_BIN_VERSION     1
+#define SLU_BIN_SYM_PATTERN 0x1  /* flags: the pattern is symmetric */
+#define SLU_BIN_SYM_VALUES  0x2  /*        the values are symmetric */
+
+typedef struct {
+    char    magic[8];      /* "SLUDBIN" */
+    int32_t version;       /* SLU_BIN_VERSION of the writer */
+    int32_t byteorder;     /* 0x01020304 in the byte order of the writer */
+    int32_t dtype;         /* Dtype_t of the values */
+    int32_t index_size;    /* bytes per column index, 4 or 8 */
+    int32_t flags;         /* SLU_BIN_SYM_PATTERN | SLU_BIN_SYM_VALUES */
+    int32_t reserved0;
+    int64_t m, n, nnz;
+    int64_t nblocks;       /* number of row blocks in blkptr */
+    int64_t blk_off, rowptr_off, colind_off, nzval_off; /* section offsets */
+    int64_t reserved[4];
+} superlu_bin_header_t;
+
+typedef struct {
+    superlu_bin_header_t *hdr;
+    int64_t *blkptr;       /* first row, first nonzero of each row block */
+    int64_t *rowptr;       /* global row pointers, m+1 */
+    void    *colind;       /* column indices of index_size bytes */
+    void    *nzval;        /* values */
+    void    *base;         /* the mapped file */
+    size_t  size;
+} superlu_bin_t;
+
+/*-- Fingerprint of an entry of the symbolic factorization cache, see
+ *   symbfact_cache.c. */
+typedef struct {
+    uint64_t hash;         /* names the file; 0 if the cache is disabled */
+    uint64_t hash2;        /* independent hash of the same pattern and options */
+    int64_t  m, nnz;       /* of A */
+} symbfact_cache_key_t;
+
 /*-- Auxiliary data type used in PxGSTRS/PxGSTRS1. */
 typedef struct {
     int_t lbnum;  /* Row block number (local).      */
     int_t indpos; /* Starting position in Uindex[]. */
 } Ucb_indptr_t;
 
+/*-- Level-set schedule for the single-rank triangular solves. */
+typedef struct {
+    int_t nsupers;
+    int_t nlevels;
+    int_t *order;  /* Supernodes sorted by level.                       */
+    int_t *lvlptr; /* order[lvlptr[l]:lvlptr[l+1]-1] are in level l.    */
+    int_t *depptr; /* Blocks updating supernode k: depptr[k]:depptr[k+1]-1 */
+    int_t *depsup; /* Supernode (block column) the update comes from.   */
+    int_t *depidx; /* Start of the block in the index array.            */
+    int_t *depval; /* Start of the block in the nzval array.            */
+} LvlSched_t;
+
 /*
  *-- The new structures added in the hybrid GPU + OpenMP + MPI code.
  */
@@ -1084,6 +1227,13 @@ extern void   superlu_gridinit3d(MPI_Comm Bcomm,  int nprow, int npcol, int npde
 				 gridinfo3d_t *grid) ;
 extern void   superlu_gridmap3d(MPI_Comm, int, int, int, int [], gridinfo3d_t *);
 extern void   superlu_gridexit3d(gridinfo3d_t *grid);
+extern int_t  superlu_symbstats(superlu_dist_options_t *, int_t m, int_t n,
+				int_t nnz, int_t *colptr, int_t *rowind,
+				superlu_symbstats_t *);
+extern void   superlu_symbstats_free(superlu_symbstats_t *);
+extern void   superlu_grid_advise(int nprocs, int ranksPerNode, int maxdep,
+				  int nrhs, superlu_symbstats_t *,
+				  superlu_machine_t *, superlu_gridshape_t *);
 
 extern void   set_default_options_dist(superlu_dist_options_t *);
 extern void   print_options_dist(superlu_dist_options_t *);
@@ -1099,6 +1249,8 @@ extern void   sp_colorder (superlu_dist_options_t*, SuperMatrix*, int_t*, int_t*
 extern int    sp_symetree_dist(int_t *, int_t *, int_t *, int_t, int_t *);
 extern int    sp_coletree_dist (int_t *, int_t *, int_t *, int_t, int_t, int_t *);
 extern void   get_perm_c_dist(int_t, int_t, SuperMatrix *, int_t *);
+extern void   get_perm_c_stat(int_t, int_t, SuperMatrix *, int_t *,
+			      SuperLUStat_t *);
 extern void   get_perm_c_batch(superlu_dist_options_t *options,	int batchCount,
 			       handle_t  *SparseMatrix_handles, int **CpivPtr);
 extern void   at_plus_a_dist(const int_t, const int_t, int_t *, int_t *,
@@ -1106,6 +1258,9 @@ extern void   at_plus_a_dist(const int_t, const int_t, int_t *, int_t *,
 extern void   getata_dist(const int_t m, const int_t n, const int_t nz, int_t *colptr, int_t *rowind,
 			  int_t *atanz, int_t **ata_colptr, int_t **ata_rowind);
 extern void   get_metis_dist(int_t n, int_t bnz, int_t *b_colptr, int_t *b_rowind, int_t *perm_c);
+extern void   get_perm_c_nd(int_t n, int_t bnz, int_t *b_colptr, int_t *b_rowind,
+			    int_t *perm_c, ndSepTree_t *septree);
+extern void   Destroy_ndSepTree(ndSepTree_t *septree);
 extern void   get_colamd_dist(const int m, const int n, const int nnz,
 			      int_t *colptr, int_t *rowind, int_t *perm_c);
 extern int    genmmd_dist_(int_t *, int_t *, int_t *a,
@@ -1121,6 +1276,13 @@ extern int_t symbfact_SubInit(superlu_dist_options_t *options,
 extern int_t symbfact_SubXpand(int_t, int_t, int_t, MemType, int_t *,
 			       Glu_freeable_t *);
 extern int symbfact_SubFree(Glu_freeable_t *);
+extern int symbfact_cache_load(superlu_dist_options_t *, SuperMatrix *,
+			       int_t *, int_t *, Glu_persist_t *,
+			       Glu_freeable_t **, superlu_dist_mem_usage_t *,
+			       gridinfo_t *, symbfact_cache_key_t *);
+extern void symbfact_cache_store(symbfact_cache_key_t *, int_t, int_t *, int_t *,
+				 Glu_persist_t *, Glu_freeable_t *,
+				 gridinfo_t *);
 extern int ilu_level_symbfact(superlu_dist_options_t *, SuperMatrix *, int_t *,
 			      int_t *, Glu_persist_t *, Glu_freeable_t *);
 extern void    countnz_dist (const int_t, int_t *, int_t *, int_t *,
@@ -1237,6 +1399,57 @@ extern int get_acc_offload(superlu_dist_options_t *);
 extern int get_acc_solve(void);
 extern int get_new3dsolve(void);
 extern int get_new3dsolvetreecomm(void);
+extern int get_rma_solve(void);
+extern int get_lvl_solve(void);
+extern int get_diaginv_single(void);
+extern int get_tree_topo(void);
+extern char *get_symb_cache_dir(void);
+extern int get_equil_ruiz(void);
+extern double get_equil_tol(void);
+extern int get_lowrank_max(void);
+extern char *get_lbs_profile(void);
+extern void  pxgstrs_nbr_init(int *, gridinfo_t *, pxgstrs_nbr_t *);
+extern void  pxgstrs_nbr_free(pxgstrs_nbr_t *);
+
+/* Parallel Matrix Market reading with MPI-IO */
+extern const char *superlu_parse_int(const char *, const char *, int_t *);
+extern const char *superlu_parse_double(const char *, const char *, double *);
+extern const char *superlu_parse_float(const char *, const char *, float *);
+extern int   superlu_mm_read_header(char *, superlu_mm_header_t *, MPI_Comm);
+extern char *superlu_mm_read_lines(char *, superlu_mm_header_t *, MPI_Comm,
+				   size_t *);
+extern void  superlu_mm_block_rows(int_t, int, int, int_t *, int_t *);
+extern void  superlu_mm_distribute(int_t, int_t, int_t *, void *, size_t,
+				   MPI_Datatype, MPI_Comm, int_t *, int_t *,
+				   int_t *, int_t **, int_t **, void **);
+
+/* Binary matrix files */
+extern int   superlu_bin_open(char *, superlu_bin_t *);
+extern void  superlu_bin_close(superlu_bin_t *);
+extern int   superlu_bin_get_rows(superlu_bin_t *, int_t, int_t, int_t *,
+				  int_t **, int_t **, void **);
+extern int   superlu_bin_write_loc(char *, int, int, int_t, int_t, int_t,
+				   int_t, int_t *, int_t *, void *, MPI_Comm);
+
+/* Distributed equilibration */
+extern void  pxgsequ_colmax_init(int_t, int_t, int_t *, int_t *, gridinfo_t *,
+				 pxgsequ_colmax_t *);
+extern void  pxgsequ_colmax(pxgsequ_colmax_t *, double *);
+extern void  pxgsequ_colmax_free(pxgsequ_colmax_t *);
+
+/* Partial refactorization */
+extern int_t pxgsrefact_mask(int_t, SuperMatrix *, int_t *, int_t *, int_t *,
+			     Glu_persist_t *, int_t, int_t *, int_t, int_t *,
+			     gridinfo_t *, int **);
+
+/* Multithreaded reading of triplet files */
+extern char *superlu_map_stream(FILE *, size_t *, void **, size_t *);
+extern void  superlu_unmap_stream(void *, size_t);
+extern int_t superlu_parse_triples(const char *, size_t, int, int_t, int_t *,
+				   int_t *, void *);
+extern int_t superlu_check_triples(int_t, int_t, int_t, int, int_t *, int_t *);
+extern void  superlu_triples_to_csc(int_t, int_t, int_t *, int_t *, void *,
+				    size_t, int_t *, int_t *, void *);
 
 /* Routines for debugging */
 extern void  print_panel_seg_dist(int_t, int_t, int_t, int_t, int_t *, int_t *);
@@ -1254,19 +1467,46 @@ extern int   file_PrintLong10(FILE *, char *, int_t, int_t *);
 
 #ifndef __SUPERLU_ASYNC_TREE /* allow multiple inclusions */
 #define __SUPERLU_ASYNC_TREE
+
+/*-- Mailbox for the one-sided (MPI-3 RMA) triangular solve.
+ *   Each process exposes nslots_ slots in a passive-target window, one per
+ *   message it expects in the current solve phase. A sender reserves a slot
+ *   with MPI_Fetch_and_op on the target's counter, puts the payload, and
+ *   then sets the slot's flag to the message tag (BC_L, RD_L, ...).
+ */
+typedef struct
+{
+    MPI_Win win_;
+    char *base_;           /* local window memory */
+    MPI_Datatype type_;
+    int typeSize_;
+    int slotSize_;         /* payload capacity of one slot, in type_ */
+    int nslots_;           /* number of messages to be received */
+    int next_;             /* next slot to be consumed */
+    int myRank_;           /* my rank in the window communicator */
+    int *ranks_;           /* tree rank -> window rank; NULL if identical */
+} C_RmaBox;
+
+/* Largest fan-out of a C_Tree node, counting both its inter-node and
+   intra-node children (see C_Tree_SetTopology). */
+#ifndef DEG_TREE_MAX
+#define DEG_TREE_MAX 8
+#endif
+
 typedef struct
 {
-    MPI_Request sendRequests_[2];
+    MPI_Request sendRequests_[DEG_TREE_MAX];
     MPI_Comm comm_;
     int myRoot_;
     int destCnt_;
-    int myDests_[2];
+    int myDests_[DEG_TREE_MAX];
     int myRank_;
     int msgSize_;
     int tag_;
     yes_no_t empty_;
     MPI_Datatype type_;
     int myIdx;
+    C_RmaBox *rma_;        /* if not NULL, forward messages with MPI_Put */
 } C_Tree;
 
 #ifndef DEG_TREE
@@ -1289,6 +1529,13 @@ extern yes_no_t C_BcTree_IsRoot(C_Tree* tree);
 extern void C_BcTree_forwardMessageSimple(C_Tree* tree, void* localBuffer, int msgSize);
 extern void C_BcTree_waitSendRequest(C_Tree* tree);
 
+extern void C_RmaBox_Create(C_RmaBox* box, MPI_Comm comm, MPI_Comm wincomm, int nslots, int slotSize, MPI_Datatype type);
+extern void C_RmaBox_Free(C_RmaBox* box);
+extern void C_RmaBox_Put(C_RmaBox* box, int target, int tag, void* localBuffer, int msgSize);
+extern void* C_RmaBox_Recv(C_RmaBox* box, int* tag);
+extern void C_Tree_AttachRma(C_Tree* trees, int ntrees, C_RmaBox* box);
+extern void C_Tree_SetTopology(MPI_Comm comm);
+
 /*==== For 3D code ====*/
 typedef enum {
     NOT_IN_GRID, // doesn't belong to my grid
@@ -1361,7 +1608,8 @@ extern treeList_t* setree2list(int_t nsuper, int_t* setree );
 extern int  free_treelist(int_t nsuper, treeList_t* treeList);
 
 // int_t calcTreeWeight(int_t nsupers, treeList_t* treeList, int_t* xsup);
-extern int_t calcTreeWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* xsup);
+extern int_t calcTreeWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* xsup,
+                            gridinfo3d_t* grid3d);
 extern int_t getDescendList(int_t k, int_t*dlist,  treeList_t* treeList);
 extern int_t getCommonAncestorList(int_t k, int_t* alist,  int_t* seTree, treeList_t* treeList);
 extern int_t getCommonAncsCount(int_t k, treeList_t* treeList);
@@ -1438,8 +1686,13 @@ extern int_t*  getNodeCountsFr(int_t maxLvl, sForest_t**  sForests);
 // int_t* getNodeToForstMap(int_t nsupers, sForest_t**  sForests, gridinfo3d_t* grid3d);
 extern int* getIsNodeInMyGrid(int_t nsupers, int_t maxLvl, int_t* myNodeCount, int_t** treePerm);
 extern void printForestWeightCost(sForest_t**  sForests, SCT_t* SCT, gridinfo3d_t* grid3d);
-extern sForest_t**  getGreedyLoadBalForests( int_t maxLvl, int_t nsupers, int_t* setree, treeList_t* treeList);
-extern sForest_t**  getForests( int_t maxLvl, int_t nsupers, int_t*setree, treeList_t* treeList);
+extern sForest_t**  getGreedyLoadBalForests( int_t maxLvl, int_t Np, int_t nsupers, int_t* setree, treeList_t* treeList);
+extern sForest_t**  getForests( int_t maxLvl, int_t Np, int_t nsupers, int_t*setree, treeList_t* treeList);
+extern int_t  forestNumLayers(int_t tr, int_t lvl, int_t maxLvl, int_t Np);
+extern unsigned long long supernodeCostKey(int_t nsupers, int_t* xsup);
+extern void saveSupernodeCost(int_t nsupers, int_t* xsup, double* tSupernode,
+			      gridinfo3d_t* grid3d);
+extern void forestImbalance3D(sForest_t**  sForests, SCT_t* SCT, gridinfo3d_t* grid3d);
 
     /* from trfAux.h */
 extern int_t getBigUSize(superlu_dist_options_t *, int_t nsupers,
@@ -28,9 +28,11 @@ at the top-level directory.
  ***********************************************************************/
 typedef enum {NO, YES}                                          yes_no_t;
 typedef enum {DOFACT, SamePattern, SamePattern_SameRowPerm, FACTORED} fact_t;
-typedef enum {NOROWPERM, LargeDiag_MC64, LargeDiag_HWPM, MY_PERMR} rowperm_t;
+typedef enum {NOROWPERM, LargeDiag_MC64, LargeDiag_HWPM, MY_PERMR,
+              LargeDiag_AUCTION} rowperm_t;
 typedef enum {NATURAL, MMD_ATA, MMD_AT_PLUS_A, COLAMD,
-	      METIS_AT_PLUS_A, PARMETIS, METIS_ATA, ZOLTAN, MY_PERMC} colperm_t;
+	      METIS_AT_PLUS_A, PARMETIS, METIS_ATA, ZOLTAN, MY_PERMC,
+	      ND_AT_PLUS_A} colperm_t;
 typedef enum {NOTRANS, TRANS, CONJ}                             trans_t;
 typedef enum {NOEQUIL, ROW, COL, BOTH}                          DiagScale_t;
 typedef enum {NOREFINE, SLU_SINGLE=1, SLU_DOUBLE, SLU_EXTRA}    IterRefine_t;
@@ -86,6 +88,7 @@ typedef enum {
     TRSV,    /* fraction of FACT spent in xTRSV */
     GEMV,    /* fraction of FACT spent in xGEMV */
     FERR,    /* estimate error bounds after iterative refinement */
+    GRAPH,   /* form A'+A or A'*A for the column ordering (part of COLPERM) */
     NPHASES  /* total number of phases */
 } PhaseType;
 
@@ -255,6 +255,8 @@ typedef struct {
     int_t nfrecvmod;
     int_t inv; /* whether the diagonal block is inverted*/
     int nbcol_masked; /*number of local block columns in my 2D grid*/
+    int   *refact_mask;  /* supernodes refactored by the next SamePattern_
+			    SameRowPerm factorization, NULL: all of them */
 
 #ifdef GPU_ACC
     /* The following variables are used in GPU trisolve */
@@ -337,12 +339,26 @@ typedef struct
 } strf3Dpartition_t;
 
 
+/*! \brief Low-rank updates U*V^T attached to a factorization by
+ * psgsupdate_lowrank(), see psgssvx_lowrank.c.
+ */
+typedef struct {
+    int   m_loc;    /* number of local rows of U and V */
+    int   k;        /* total rank of the attached updates */
+    int   kmax;     /* rank limit, from SUPERLU_LOWRANK_MAX */
+    float *V;       /* local rows of V, leading dimension max(m_loc,1) */
+    float *Z;       /* local rows of inv(A)*U */
+    float *CapLU;   /* LU factors of I + V^T*Z, k-by-k, replicated */
+    int   *ipiv;    /* pivots of CapLU */
+} sLowRank_t;
+
 typedef struct {
     int_t *etree;
     Glu_persist_t *Glu_persist;
     sLocalLU_t *Llu;
     strf3Dpartition_t *trf3Dpart;
     char dt;
+    sLowRank_t *lowrank; /* NULL if no low-rank update is attached */
 } sLUstruct_t;
 
 
@@ -484,6 +500,36 @@ typedef struct slsumBmod_buff_t
     int_t *indCols; //
 }slsumBmod_buff_t;
 
+/*-- Streaming assembly of a distributed matrix, see sassemble.c */
+typedef struct {
+    int_t    m, n;            /* global dimensions */
+    int_t    m_loc, fst_row;  /* my rows, as in NRformat_loc */
+    MPI_Comm comm;            /* duplicate of grid->comm */
+    int      iam, nprocs;
+    int_t    bufsize;         /* triplets buffered per destination */
+    yes_no_t KeepRouting;     /* keep slot[] for sAssembleRestart() */
+    yes_no_t SamePattern;     /* assembling values only */
+    char     **sendbuf;       /* [nprocs] buffer being filled */
+    char     **inflight;      /* [nprocs] buffer being sent */
+    MPI_Request *req;         /* [nprocs] send of inflight[] */
+    int_t    *nsend;          /* [nprocs] triplets in sendbuf[] */
+    int      *nmsg, *nrecv;   /* [nprocs] messages sent to / received from */
+    int      tag;             /* 0 and 1 in turn for the assemblies */
+    char     *recvbuf;
+    int      recvcap;
+    int_t    nloc, maxloc;    /* triplets received in my rows */
+    int_t    *lrow, *lcol;
+    float    *lval;
+    int      *lsrc;           /* source process of each triplet */
+    int_t    *slotptr, *slot; /* slot[slotptr[p]+k]: position in nzval[] of
+				 the k-th entry received from process p */
+    int_t    *cnt;            /* [nprocs] entries received in this pass */
+    int_t    nnz_loc, *rowptr, *colind; /* structure kept for the same
+					   pattern */
+    float    *nzval;          /* values being assembled */
+    int      error;
+} sAssemble_t;
+
 /*=====================*/
 
 /***********************************************************************
@@ -551,6 +597,8 @@ extern void    slaqgs_dist (SuperMatrix *, float *, float *, float,
 			    float, float, char *);
 extern void    psgsequ (SuperMatrix *, float *, float *, float *,
 			float *, float *, int *, gridinfo_t *);
+extern int     psgsequ_ruiz (SuperMatrix *, float *, float *, yes_no_t, int,
+			     double, int *, gridinfo_t *);
 extern float  pslangs (char *, SuperMatrix *, gridinfo_t *);
 extern void    pslaqgs (SuperMatrix *, float *, float *, float,
 			float, float, char *);
@@ -602,12 +650,26 @@ extern int_t psgstrs_delete_device_lsum_x(sSOLVEstruct_t *);
 extern void pxgstrs_finalize(pxgstrs_comm_t *);
 extern int  sldperm_dist(int, int, int_t, int_t [], int_t [],
 		    float [], int_t *, float [], float []);
+extern int  psldperm_dist(int, SuperMatrix *, gridinfo_t *, int_t *,
+                           float [], float []);
 extern int  sstatic_schedule(superlu_dist_options_t *, int, int,
 		            sLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
 			    int_t *, int_t *, int *);
 extern void sLUstructInit(const int_t, sLUstruct_t *);
 extern void sLUstructFree(sLUstruct_t *);
 extern void sDestroy_LU(int_t, gridinfo_t *, sLUstruct_t *);
+extern int_t psgsrefact_mark(superlu_dist_options_t *, int_t, int_t *, int_t,
+			    int_t *, SuperMatrix *, sScalePermstruct_t *,
+			    sLUstruct_t *, gridinfo_t *);
+extern int  psgsupdate_lowrank(superlu_dist_options_t *, int, float *, int,
+				float *, int, SuperMatrix *, sScalePermstruct_t *,
+				sLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
+				int *);
+extern void psgssvx_lowrank(superlu_dist_options_t *, SuperMatrix *,
+			    sScalePermstruct_t *, float *, int, int,
+			    gridinfo_t *, sLUstruct_t *, sSOLVEstruct_t *,
+			    float *, SuperLUStat_t *, int *);
+extern void sLowRankFree(sLUstruct_t *);
 extern void sDestroy_Tree(int_t, gridinfo_t *, sLUstruct_t *);
 extern void sscatter_l (int ib, int ljb, int nsupc, int_t iukp, int_t* xsup,
 			int klst, int nbrow, int_t lptr, int temp_nbrow,
@@ -956,6 +1018,12 @@ extern void sCopy_CompRowLoc_Matrix_dist(SuperMatrix *, SuperMatrix *);
 extern void sZero_CompRowLoc_Matrix_dist(SuperMatrix *);
 extern void sScaleAddId_CompRowLoc_Matrix_dist(SuperMatrix *, float);
 extern void sScaleAdd_CompRowLoc_Matrix_dist(SuperMatrix *, SuperMatrix *, float);
+extern void sAssembleInit(sAssemble_t *, int_t, int_t, int_t, yes_no_t,
+			  gridinfo_t *);
+extern int  sAssembleAdd(sAssemble_t *, int_t, int_t *, int_t *, float *);
+extern int  sAssembleFinalize(sAssemble_t *, SuperMatrix *);
+extern void sAssembleRestart(sAssemble_t *);
+extern void sAssembleFree(sAssemble_t *);
 extern void sZeroLblocks(int, int, gridinfo_t *, sLUstruct_t *);
 extern void sZeroUblocks(int iam, int n, gridinfo_t *, sLUstruct_t *);
 extern float sMaxAbsLij(int iam, int n, Glu_persist_t *,
@@ -977,8 +1045,11 @@ extern void  sreadrb_dist(int, FILE *, int_t *, int_t *, int_t *,
 		     float **, int_t **, int_t **);
 extern void  sreadMM_dist(FILE *, int_t *, int_t *, int_t *,
 	                  float **, int_t **, int_t **);
+extern int   psreadMM_loc(char *, SuperMatrix *, gridinfo_t *);
 extern int  sread_binary(FILE *, int_t *, int_t *, int_t *,
 	                  float **, int_t **, int_t **);
+extern int   psread_binary_loc(char *, SuperMatrix *, gridinfo_t *);
+extern int   pswrite_binary_loc(char *, SuperMatrix *, int, gridinfo_t *);
 
 extern void validateInput_psgssvx3d(superlu_dist_options_t *, SuperMatrix *A,
        int ldb, int nrhs, gridinfo3d_t *, int *info);
@@ -1312,7 +1383,7 @@ receiver[U(nodelist)] =sender[U(nodelist)] +receiver[U(nodelist)]
 */
 int_t sreduceAncestors3d(int_t sender, int_t receiver,
                         int_t nnodes, int_t* nodeList,
-                        float* Lval_buf, float* Uval_buf,
+                        sLUValSubBuf_t* LUvsb,
                         sLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT);
 /*reduces all nodelists required in a level*/
 extern int sreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount,
@@ -1352,6 +1423,20 @@ int_t szRecvUPanel(int_t k, int_t sender, float alpha,
                    float beta, float* Uval_buf,
 		   sLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT);
 
+/* Send and add only the blocks of the panels touched by the sender */
+int_t szSendLPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+			  float* val_buf, sLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t szRecvLPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+			  float* Lval_buf, sLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t szSendUPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+			  float* val_buf, sLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t szRecvUPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+			  float* Uval_buf, sLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+
     /* from communication_aux.h */
 extern int_t sIBcast_LPanel (int_t k, int_t k0, int_t* lsub, float* lusup,
 			     gridinfo_t *, int* msgcnt, MPI_Request *,
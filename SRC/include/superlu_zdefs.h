@@ -255,6 +255,8 @@ typedef struct {
     int_t nfrecvmod;
     int_t inv; /* whether the diagonal block is inverted*/
     int nbcol_masked; /*number of local block columns in my 2D grid*/
+    int   *refact_mask;  /* supernodes refactored by the next SamePattern_
+			    SameRowPerm factorization, NULL: all of them */
 
 #ifdef GPU_ACC
     /* The following variables are used in GPU trisolve */
@@ -337,12 +339,26 @@ typedef struct
 } ztrf3Dpartition_t;
 
 
+/*! \brief Low-rank updates U*V^T attached to a factorization by
+ * pzgsupdate_lowrank(), see pzgssvx_lowrank.c.
+ */
+typedef struct {
+    int   m_loc;    /* number of local rows of U and V */
+    int   k;        /* total rank of the attached updates */
+    int   kmax;     /* rank limit, from SUPERLU_LOWRANK_MAX */
+    doublecomplex *V;     /* local rows of V, leading dimension max(m_loc,1) */
+    doublecomplex *Z;     /* local rows of inv(A)*U */
+    doublecomplex *CapLU; /* LU factors of I + V^T*Z, k-by-k, replicated */
+    int   *ipiv;    /* pivots of CapLU */
+} zLowRank_t;
+
 typedef struct {
     int_t *etree;
     Glu_persist_t *Glu_persist;
     zLocalLU_t *Llu;
     ztrf3Dpartition_t *trf3Dpart;
     char dt;
+    zLowRank_t *lowrank; /* NULL if no low-rank update is attached */
 } zLUstruct_t;
 
 
@@ -484,6 +500,36 @@ typedef struct zlsumBmod_buff_t
     int_t *indCols; //
 }zlsumBmod_buff_t;
 
+/*-- Streaming assembly of a distributed matrix, see zassemble.c */
+typedef struct {
+    int_t    m, n;            /* global dimensions */
+    int_t    m_loc, fst_row;  /* my rows, as in NRformat_loc */
+    MPI_Comm comm;            /* duplicate of grid->comm */
+    int      iam, nprocs;
+    int_t    bufsize;         /* triplets buffered per destination */
+    yes_no_t KeepRouting;     /* keep slot[] for zAssembleRestart() */
+    yes_no_t SamePattern;     /* assembling values only */
+    char     **sendbuf;       /* [nprocs] buffer being filled */
+    char     **inflight;      /* [nprocs] buffer being sent */
+    MPI_Request *req;         /* [nprocs] send of inflight[] */
+    int_t    *nsend;          /* [nprocs] triplets in sendbuf[] */
+    int      *nmsg, *nrecv;   /* [nprocs] messages sent to / received from */
+    int      tag;             /* 0 and 1 in turn for the assemblies */
+    char     *recvbuf;
+    int      recvcap;
+    int_t    nloc, maxloc;    /* triplets received in my rows */
+    int_t    *lrow, *lcol;
+    doublecomplex *lval;
+    int      *lsrc;           /* source process of each triplet */
+    int_t    *slotptr, *slot; /* slot[slotptr[p]+k]: position in nzval[] of
+				 the k-th entry received from process p */
+    int_t    *cnt;            /* [nprocs] entries received in this pass */
+    int_t    nnz_loc, *rowptr, *colind; /* structure kept for the same
+					   pattern */
+    doublecomplex *nzval;     /* values being assembled */
+    int      error;
+} zAssemble_t;
+
 /*=====================*/
 
 /***********************************************************************
@@ -551,6 +597,8 @@ extern void    zlaqgs_dist (SuperMatrix *, double *, double *, double,
 			    double, double, char *);
 extern void    pzgsequ (SuperMatrix *, double *, double *, double *,
 			double *, double *, int *, gridinfo_t *);
+extern int     pzgsequ_ruiz (SuperMatrix *, double *, double *, yes_no_t, int,
+			     double, int *, gridinfo_t *);
 extern double  pzlangs (char *, SuperMatrix *, gridinfo_t *);
 extern void    pzlaqgs (SuperMatrix *, double *, double *, double,
 			double, double, char *);
@@ -602,12 +650,26 @@ extern int_t pzgstrs_delete_device_lsum_x(zSOLVEstruct_t *);
 extern void pxgstrs_finalize(pxgstrs_comm_t *);
 extern int  zldperm_dist(int, int, int_t, int_t [], int_t [],
 		    doublecomplex [], int_t *, double [], double []);
+extern int  pzldperm_dist(int, SuperMatrix *, gridinfo_t *, int_t *,
+                           double [], double []);
 extern int  zstatic_schedule(superlu_dist_options_t *, int, int,
 		            zLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
 			    int_t *, int_t *, int *);
 extern void zLUstructInit(const int_t, zLUstruct_t *);
 extern void zLUstructFree(zLUstruct_t *);
 extern void zDestroy_LU(int_t, gridinfo_t *, zLUstruct_t *);
+extern int_t pzgsrefact_mark(superlu_dist_options_t *, int_t, int_t *, int_t,
+			    int_t *, SuperMatrix *, zScalePermstruct_t *,
+			    zLUstruct_t *, gridinfo_t *);
+extern int  pzgsupdate_lowrank(superlu_dist_options_t *, int, doublecomplex *, int,
+				doublecomplex *, int, SuperMatrix *, zScalePermstruct_t *,
+				zLUstruct_t *, gridinfo_t *, SuperLUStat_t *,
+				int *);
+extern void pzgssvx_lowrank(superlu_dist_options_t *, SuperMatrix *,
+			    zScalePermstruct_t *, doublecomplex *, int, int,
+			    gridinfo_t *, zLUstruct_t *, zSOLVEstruct_t *,
+			    double *, SuperLUStat_t *, int *);
+extern void zLowRankFree(zLUstruct_t *);
 extern void zDestroy_Tree(int_t, gridinfo_t *, zLUstruct_t *);
 extern void zscatter_l (int ib, int ljb, int nsupc, int_t iukp, int_t* xsup,
 			int klst, int nbrow, int_t lptr, int temp_nbrow,
@@ -958,6 +1020,12 @@ extern void zCopy_CompRowLoc_Matrix_dist(SuperMatrix *, SuperMatrix *);
 extern void zZero_CompRowLoc_Matrix_dist(SuperMatrix *);
 extern void zScaleAddId_CompRowLoc_Matrix_dist(SuperMatrix *, doublecomplex);
 extern void zScaleAdd_CompRowLoc_Matrix_dist(SuperMatrix *, SuperMatrix *, doublecomplex);
+extern void zAssembleInit(zAssemble_t *, int_t, int_t, int_t, yes_no_t,
+			  gridinfo_t *);
+extern int  zAssembleAdd(zAssemble_t *, int_t, int_t *, int_t *, doublecomplex *);
+extern int  zAssembleFinalize(zAssemble_t *, SuperMatrix *);
+extern void zAssembleRestart(zAssemble_t *);
+extern void zAssembleFree(zAssemble_t *);
 extern void zZeroLblocks(int, int, gridinfo_t *, zLUstruct_t *);
 extern void zZeroUblocks(int iam, int n, gridinfo_t *, zLUstruct_t *);
 extern double zMaxAbsLij(int iam, int n, Glu_persist_t *,
@@ -979,8 +1047,11 @@ extern void  zreadrb_dist(int, FILE *, int_t *, int_t *, int_t *,
 		     doublecomplex **, int_t **, int_t **);
 extern void  zreadMM_dist(FILE *, int_t *, int_t *, int_t *,
 	                  doublecomplex **, int_t **, int_t **);
+extern int   pzreadMM_loc(char *, SuperMatrix *, gridinfo_t *);
 extern int  zread_binary(FILE *, int_t *, int_t *, int_t *,
 	                  doublecomplex **, int_t **, int_t **);
+extern int   pzread_binary_loc(char *, SuperMatrix *, gridinfo_t *);
+extern int   pzwrite_binary_loc(char *, SuperMatrix *, int, gridinfo_t *);
 
 extern void validateInput_pzgssvx3d(superlu_dist_options_t *, SuperMatrix *A,
        int ldb, int nrhs, gridinfo3d_t *, int *info);
@@ -1314,7 +1385,7 @@ receiver[U(nodelist)] =sender[U(nodelist)] +receiver[U(nodelist)]
 */
 int_t zreduceAncestors3d(int_t sender, int_t receiver,
                         int_t nnodes, int_t* nodeList,
-                        doublecomplex* Lval_buf, doublecomplex* Uval_buf,
+                        zLUValSubBuf_t* LUvsb,
                         zLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT);
 /*reduces all nodelists required in a level*/
 extern int zreduceAllAncestors3d(int_t ilvl, int_t* myNodeCount,
@@ -1354,6 +1425,20 @@ int_t zzRecvUPanel(int_t k, int_t sender, doublecomplex alpha,
                    doublecomplex beta, doublecomplex* Uval_buf,
 		   zLUstruct_t* LUstruct,  gridinfo3d_t* grid3d, SCT_t* SCT);
 
+/* Send and add only the blocks of the panels touched by the sender */
+int_t zzSendLPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+			  doublecomplex* val_buf, zLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t zzRecvLPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+			  doublecomplex* Lval_buf, zLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t zzSendUPanelTouched(int_t k, int_t receiver, int_t* blk_buf,
+			  doublecomplex* val_buf, zLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+int_t zzRecvUPanelTouched(int_t k, int_t sender, int_t* blk_buf,
+			  doublecomplex* Uval_buf, zLUstruct_t* LUstruct,
+			  gridinfo3d_t* grid3d, SCT_t* SCT);
+
     /* from communication_aux.h */
 extern int_t zIBcast_LPanel (int_t k, int_t k0, int_t* lsub, doublecomplex* lusup,
 			     gridinfo_t *, int* msgcnt, MPI_Request *,
@@ -317,6 +317,9 @@ typedef struct
     double commVolFactor;
     double commVolRed;
 
+    /*measured time of each supernode, if SUPERLU_LBS_PROFILE is set*/
+    double *tSupernode;
+
     /*timer for new code */
     double tDiagFactorPanelSolve;
     double tPanelBcast;
@@ -0,0 +1,306 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief Versioned binary matrix files
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Precision-independent part of p[sdz]read_binary_loc() and
+ * p[sdz]write_binary_loc(). A file holds one matrix in compressed row
+ * format, so that the rows of a process are contiguous:
+ *
+ *   header      superlu_bin_header_t, 128 bytes
+ *   blkptr      int64_t[2*(nblocks+1)], first row and first nonzero of
+ *               each row block, as written by the processes of the writer
+ *   rowptr      int64_t[m+1]
+ *   colind      nnz column indices of index_size bytes
+ *   nzval       nnz values of the type given by dtype
+ *
+ * All sections start on 8-byte boundaries and are stored in the byte
+ * order of the writer. The file is mapped in memory by the readers, so
+ * that each process only touches the pages of its own rows, and the
+ * mapped arrays can be used in place when the index width matches int_t.
+ * </pre>
+ */
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "superlu_defs.h"
+
+#define SLU_BIN_MAGIC     "SLUDBIN"
+#define SLU_BIN_BYTEORDER 0x01020304
+
+static size_t
+bin_valsize(int dtype)
+{
+    switch (dtype) {
+      case SLU_S: return sizeof(float);
+      case SLU_D: return sizeof(double);
+      case SLU_C: return 2 * sizeof(float);
+      case SLU_Z: return 2 * sizeof(double);
+    }
+    return 0;
+}
+
+#define BIN_ALIGN(x)  ( ((x) + 7) & ~(int64_t) 7 )
+
+/* v is representable as an int_t */
+#define BIN_FITS_INT_T(v)  ( (int64_t) (int_t) (v) == (v) )
+
+/*! \brief Map a binary matrix file in memory and check its header.
+ *
+ * Returns 0 on success, otherwise
+ *   1 if the file cannot be opened or mapped,
+ *   2 if it is not a binary matrix file of a known version,
+ *   3 if it was written with another byte order,
+ *   4 if it is shorter than its header says, or its sections overlap,
+ *   6 if rowptr does not start at 0 or does not end at nnz,
+ *   7 if m or n does not fit in int_t.
+ */
+int
+superlu_bin_open(char *filename, superlu_bin_t *bin)
+{
+    superlu_bin_header_t *hdr;
+    struct stat st;
+    int64_t end, size;
+    int fd;
+
+    memset(bin, 0, sizeof(superlu_bin_t));
+    if ( (fd = open(filename, O_RDONLY)) < 0 ) return 1;
+    if ( fstat(fd, &st) ) {
+	close(fd);
+	return 1;
+    }
+    if ( st.st_size < (off_t) sizeof(superlu_bin_header_t) ) {
+	close(fd);
+	return 2;
+    }
+    bin->size = (size_t) st.st_size;
+    bin->base = mmap(NULL, bin->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if ( bin->base == MAP_FAILED ) {
+	bin->base = NULL;
+	return 1;
+    }
+
+    hdr = bin->hdr = (superlu_bin_header_t *) bin->base;
+    if ( memcmp(hdr->magic, SLU_BIN_MAGIC, 8) || hdr->version < 1
+	 || hdr->version > SLU_BIN_VERSION || !bin_valsize(hdr->dtype)
+	 || (hdr->index_size != 4 && hdr->index_size != 8) ) {
+	superlu_bin_close(bin);
+	return 2;
+    }
+    if ( hdr->byteorder != SLU_BIN_BYTEORDER ) {
+	superlu_bin_close(bin);
+	return 3;
+    }
+    /* Each count and offset is at most the file size, so that the sums
+       below cannot overflow. */
+    size = (int64_t) bin->size;
+    if ( hdr->m < 0 || hdr->m >= size || hdr->n < 0 || hdr->nnz < 0
+	 || hdr->nnz > size || hdr->nblocks < 0 || hdr->nblocks >= size
+	 || hdr->blk_off < (int64_t) sizeof(superlu_bin_header_t)
+	 || hdr->blk_off > size || hdr->rowptr_off > size
+	 || hdr->colind_off > size || hdr->nzval_off > size ) {
+	superlu_bin_close(bin);
+	return 4;
+    }
+    end = hdr->nzval_off + hdr->nnz * (int64_t) bin_valsize(hdr->dtype);
+    if ( end > size
+	 || hdr->blk_off + 16 * (hdr->nblocks + 1) > hdr->rowptr_off
+	 || hdr->rowptr_off + 8 * (hdr->m + 1) > hdr->colind_off
+	 || hdr->colind_off + hdr->index_size * hdr->nnz > hdr->nzval_off ) {
+	superlu_bin_close(bin);
+	return 4;
+    }
+
+    bin->blkptr = (int64_t *) ((char *) bin->base + hdr->blk_off);
+    bin->rowptr = (int64_t *) ((char *) bin->base + hdr->rowptr_off);
+    bin->colind = (char *) bin->base + hdr->colind_off;
+    bin->nzval = (char *) bin->base + hdr->nzval_off;
+
+    /* The rows in between are checked by superlu_bin_get_rows(). */
+    if ( bin->rowptr[0] != 0 || bin->rowptr[hdr->m] != hdr->nnz ) {
+	superlu_bin_close(bin);
+	return 6;
+    }
+    if ( !BIN_FITS_INT_T(hdr->m) || !BIN_FITS_INT_T(hdr->n) ) {
+	superlu_bin_close(bin);
+	return 7;
+    }
+    return 0;
+}
+
+void
+superlu_bin_close(superlu_bin_t *bin)
+{
+    if ( bin->base ) munmap(bin->base, bin->size);
+    memset(bin, 0, sizeof(superlu_bin_t));
+}
+
+/*! \brief Copy rows fst_row to fst_row+m_loc-1 of a mapped file into
+ * newly allocated compressed row arrays, converting the column indices
+ * to int_t.
+ *
+ * Returns 0 on success, otherwise, with the arrays set to NULL,
+ *   6 if rowptr decreases in these rows or a column index is not in
+ *     [0, n),
+ *   7 if their number of nonzeros or a column index does not fit in
+ *     int_t.
+ */
+int
+superlu_bin_get_rows(superlu_bin_t *bin, int_t fst_row, int_t m_loc,
+		     int_t *nnz_loc, int_t **rowptr, int_t **colind,
+		     void **nzval)
+{
+    size_t valsz = bin_valsize(bin->hdr->dtype);
+    int64_t *xrow = bin->rowptr + fst_row;
+    int64_t k0 = xrow[0], nnz = xrow[m_loc] - k0, n = bin->hdr->n, k;
+    int_t i;
+    int info = 0;
+
+    *rowptr = *colind = NULL;
+    *nzval = NULL;
+    for (i = 0; i < m_loc; ++i)
+	if ( xrow[i+1] < xrow[i] ) return 6;
+    if ( !BIN_FITS_INT_T(nnz) ) return 7;
+
+    *nnz_loc = (int_t) nnz;
+    if ( !(*rowptr = intMalloc_dist(m_loc + 1)) )
+	ABORT("Malloc fails for rowptr[].");
+    if ( !(*colind = intMalloc_dist(SUPERLU_MAX(nnz, 1))) )
+	ABORT("Malloc fails for colind[].");
+
+    for (i = 0; i <= m_loc; ++i) (*rowptr)[i] = (int_t) (xrow[i] - k0);
+    if ( bin->hdr->index_size == sizeof(int_t) ) {
+	memcpy(*colind, (char *) bin->colind + k0 * sizeof(int_t),
+	       nnz * sizeof(int_t));
+    } else if ( bin->hdr->index_size == 4 ) {
+	int32_t *c = (int32_t *) bin->colind + k0;
+	for (k = 0; k < nnz; ++k) (*colind)[k] = (int_t) c[k];
+    } else { /* 64-bit indices, narrower int_t */
+	int64_t *c = (int64_t *) bin->colind + k0;
+	for (k = 0; k < nnz; ++k) {
+	    if ( !BIN_FITS_INT_T(c[k]) ) {
+		info = 7;
+		break;
+	    }
+	    (*colind)[k] = (int_t) c[k];
+	}
+    }
+    for (k = 0; k < nnz && !info; ++k)
+	if ( (*colind)[k] < 0 || (*colind)[k] >= n ) info = 6;
+    if ( info ) {
+	SUPERLU_FREE(*rowptr);
+	SUPERLU_FREE(*colind);
+	*rowptr = *colind = NULL;
+	return info;
+    }
+
+    if ( !(*nzval = SUPERLU_MALLOC(SUPERLU_MAX(nnz, 1) * valsz)) )
+	ABORT("Malloc fails for nzval[].");
+    memcpy(*nzval, (char *) bin->nzval + k0 * valsz, nnz * valsz);
+    return 0;
+}
+
+/*! \brief Write a matrix distributed by block rows to a binary file.
+ *
+ * Collective on comm; each process gives rows fst_row to fst_row+m_loc-1
+ * in compressed row format, and the blocks must cover the m rows in the
+ * order of the ranks. Returns 0 on success, 1 if the file cannot be
+ * written.
+ */
+int
+superlu_bin_write_loc(char *filename, int dtype, int flags, int_t m,
+		      int_t n, int_t m_loc, int_t fst_row, int_t *rowptr,
+		      int_t *colind, void *nzval, MPI_Comm comm)
+{
+    superlu_bin_header_t hdr;
+    MPI_File fh;
+    MPI_Status status;
+    MPI_Datatype valtype;
+    size_t valsz = bin_valsize(dtype);
+    int64_t mine[2], *blk, nnz_fst = 0, nnz, *xrow;
+    int iam, nprocs, p, err, info = 0;
+    int_t i;
+
+    MPI_Comm_rank(comm, &iam);
+    MPI_Comm_size(comm, &nprocs);
+
+    /* First row and first nonzero of the blocks */
+    mine[0] = fst_row;
+    mine[1] = rowptr[m_loc];
+    if ( !(blk = (int64_t *) SUPERLU_MALLOC(2 * (nprocs + 1) * sizeof(int64_t))) )
+	ABORT("Malloc fails for blk[].");
+    MPI_Allgather(mine, 2, MPI_INT64_T, blk, 2, MPI_INT64_T, comm);
+    for (p = 0, nnz = 0; p < nprocs; ++p) {
+	int64_t cnt = blk[2*p+1];
+	if ( p == iam ) nnz_fst = nnz;
+	blk[2*p+1] = nnz;
+	nnz += cnt;
+    }
+    blk[2*nprocs] = m;
+    blk[2*nprocs+1] = nnz;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, SLU_BIN_MAGIC, 8);
+    hdr.version = SLU_BIN_VERSION;
+    hdr.byteorder = SLU_BIN_BYTEORDER;
+    hdr.dtype = dtype;
+    hdr.index_size = sizeof(int_t);
+    hdr.flags = flags;
+    hdr.m = m;
+    hdr.n = n;
+    hdr.nnz = nnz;
+    hdr.nblocks = nprocs;
+    hdr.blk_off = sizeof(superlu_bin_header_t);
+    hdr.rowptr_off = hdr.blk_off + 16 * (int64_t) (nprocs + 1);
+    hdr.colind_off = hdr.rowptr_off + 8 * (int64_t) (m + 1);
+    hdr.nzval_off = BIN_ALIGN(hdr.colind_off + hdr.index_size * nnz);
+
+    err = MPI_File_open(comm, filename, MPI_MODE_WRONLY | MPI_MODE_CREATE,
+			MPI_INFO_NULL, &fh);
+    if ( err != MPI_SUCCESS ) {
+	SUPERLU_FREE(blk);
+	return 1;
+    }
+    MPI_File_set_size(fh, hdr.nzval_off + nnz * (int64_t) valsz);
+    if ( !iam ) {
+	MPI_File_write_at(fh, 0, &hdr, sizeof(hdr), MPI_BYTE, &status);
+	MPI_File_write_at(fh, hdr.blk_off, blk, 2 * (nprocs + 1),
+			  MPI_INT64_T, &status);
+    }
+
+    /* My part of rowptr; the last process also writes rowptr[m] */
+    if ( !(xrow = (int64_t *) SUPERLU_MALLOC((m_loc + 1) * sizeof(int64_t))) )
+	ABORT("Malloc fails for xrow[].");
+    for (i = 0; i <= m_loc; ++i) xrow[i] = nnz_fst + rowptr[i];
+    MPI_File_write_at_all(fh, hdr.rowptr_off + 8 * (int64_t) fst_row, xrow,
+			  m_loc + (iam == nprocs - 1), MPI_INT64_T, &status);
+    MPI_File_write_at_all(fh, hdr.colind_off + hdr.index_size * nnz_fst,
+			  colind, rowptr[m_loc], mpi_int_t, &status);
+    MPI_Type_contiguous(valsz, MPI_BYTE, &valtype);
+    MPI_Type_commit(&valtype);
+    MPI_File_write_at_all(fh, hdr.nzval_off + valsz * nnz_fst, nzval,
+			  rowptr[m_loc], valtype, &status);
+    MPI_Type_free(&valtype);
+    if ( MPI_File_close(&fh) != MPI_SUCCESS ) info = 1;
+
+    SUPERLU_FREE(xrow);
+    SUPERLU_FREE(blk);
+    MPI_Allreduce(MPI_IN_PLACE, &info, 1, MPI_INT, MPI_MAX, comm);
+    return info;
+}
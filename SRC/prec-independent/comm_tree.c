@@ -2,6 +2,118 @@
 #include "dcomplex.h"
 #include "superlu_defs.h"
 
+/* Keyval of the node map cached on a tree communicator: nodeOf[r] is the
+   rank (in that communicator) of the first process on the node of rank r. */
+static int C_Tree_keyval = MPI_KEYVAL_INVALID;
+
+static int C_Tree_DeleteNodes(MPI_Comm comm, int keyval, void *attr, void *extra){
+	SUPERLU_FREE(attr);
+	return MPI_SUCCESS;
+}
+
+/* Collective on comm: record the node of every rank so that the trees
+   later built over comm cross node boundaries as few times as possible.
+   Trees over a communicator without this map treat all ranks as on-node. */
+void C_Tree_SetTopology(MPI_Comm comm){
+	MPI_Comm node;
+	int *nodeOf, nprocs, myrank, leader, flag;
+	void *attr;
+
+	if(!get_tree_topo() || get_acc_solve()) return;
+	if(C_Tree_keyval==MPI_KEYVAL_INVALID)
+		MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, C_Tree_DeleteNodes, &C_Tree_keyval, NULL);
+	MPI_Comm_get_attr(comm, C_Tree_keyval, &attr, &flag);
+	if(flag) return;
+
+	MPI_Comm_size(comm,&nprocs);
+	MPI_Comm_rank(comm,&myrank);
+	MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myrank, MPI_INFO_NULL, &node);
+	leader=myrank;
+	MPI_Bcast(&leader, 1, MPI_INT, 0, node);
+	MPI_Comm_free(&node);
+
+	nodeOf=(int*)SUPERLU_MALLOC(nprocs*sizeof(int));
+	MPI_Allgather(&leader, 1, MPI_INT, nodeOf, 1, MPI_INT, comm);
+	MPI_Comm_set_attr(comm, C_Tree_keyval, nodeOf);
+}
+
+/* Intra-node fan-out for a message of msgBytes: wide and shallow while
+   latency dominates, binary once bandwidth does. Node leaders keep two
+   more slots for the binary tree across nodes. */
+static int C_Tree_Degree(int msgBytes){
+	if(msgBytes<=4096) return DEG_TREE_MAX-2;
+	if(msgBytes<=32768) return SUPERLU_MIN(4,DEG_TREE_MAX-2);
+	return DEG_TREE;
+}
+
+/* Set myIdx, myRoot_ and myDests_ of the tree over ranks[0:rank_cnt),
+   rooted at ranks[0]. The ranks of each node form a DEG-ary tree under
+   their first rank in the list, and these node leaders form a binary
+   tree under the root. */
+static void C_Tree_SetDests(C_Tree* tree, int* ranks, int rank_cnt, int msgBytes){
+	int *nodeOf=NULL, *lead, *grp, *mem;
+	int flag=0, deg, nlead, nmem, g, m=0, ii, j;
+
+	for (ii=0;ii<rank_cnt;ii++)
+		if(tree->myRank_ == ranks[ii]){
+			tree->myIdx = ii;
+			break;
+		}
+
+	/* The GPU solve indexes its receive slots by myIdx%2 with two slots
+	   per block, so it keeps the binary heap over the rank list. */
+	if(!get_tree_topo() || get_acc_solve()){ /* fixed fan-out over the rank list */
+		for (ii=0;ii<DEG_TREE;ii++){
+			if(tree->myIdx*DEG_TREE+1+ii<rank_cnt)
+				tree->myDests_[tree->destCnt_++]=ranks[tree->myIdx*DEG_TREE+1+ii];
+		}
+		if(tree->myIdx!=0)
+			tree->myRoot_ = ranks[(tree->myIdx-1)/DEG_TREE];
+		else
+			tree->myRoot_ = tree->myRank_;
+		return;
+	}
+
+	if(C_Tree_keyval!=MPI_KEYVAL_INVALID)
+		MPI_Comm_get_attr(tree->comm_, C_Tree_keyval, &nodeOf, &flag);
+	if(!flag) nodeOf=NULL;
+	deg=C_Tree_Degree(msgBytes);
+
+	/* lead[]: list positions of the node leaders; grp[]: node of each
+	   position; mem[]: list positions of the ranks on my node. */
+	lead=(int*)SUPERLU_MALLOC(3*rank_cnt*sizeof(int));
+	grp=lead+rank_cnt;
+	mem=grp+rank_cnt;
+	nlead=0;
+	for (ii=0;ii<rank_cnt;ii++){
+		for (j=0;j<nlead;j++)
+			if(!nodeOf || nodeOf[ranks[lead[j]]]==nodeOf[ranks[ii]]) break;
+		if(j==nlead) lead[nlead++]=ii;
+		grp[ii]=j;
+	}
+	g=grp[tree->myIdx];
+	nmem=0;
+	for (ii=0;ii<rank_cnt;ii++)
+		if(grp[ii]==g){
+			if(ii==tree->myIdx) m=nmem;
+			mem[nmem++]=ii;
+		}
+
+	if(m==0){ /* node leader: inter-node children go first */
+		for (ii=0;ii<2;ii++)
+			if(g*2+1+ii<nlead)
+				tree->myDests_[tree->destCnt_++]=ranks[lead[g*2+1+ii]];
+		tree->myRoot_ = g>0 ? ranks[lead[(g-1)/2]] : tree->myRank_;
+	}else{
+		tree->myRoot_ = ranks[mem[(m-1)/deg]];
+	}
+	for (ii=0;ii<deg;ii++)
+		if(m*deg+1+ii<nmem)
+			tree->myDests_[tree->destCnt_++]=ranks[mem[m*deg+1+ii]];
+
+	SUPERLU_FREE(lead);
+}
+
 	void C_BcTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, int msgSize, char precision, int* needrecv){
 		assert(msgSize>0);
 
@@ -13,11 +125,12 @@
       tree->myRoot_= -1; 
       tree->tag_=-1;
       tree->destCnt_=0;
-      tree->myDests_[0]=-1;
-      tree->myDests_[1]=-1;
-	  tree->sendRequests_[0]=MPI_REQUEST_NULL;
-	  tree->sendRequests_[1]=MPI_REQUEST_NULL;
+      for (int ii=0;ii<DEG_TREE_MAX;ii++){
+          tree->myDests_[ii]=-1;
+          tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+      }
       tree->empty_= NO;  // non-empty if rank_cnt>1
+      tree->rma_=NULL;
 	  if(precision=='d'){
 	  tree->type_=MPI_DOUBLE;
 	  }
@@ -33,29 +146,11 @@
 	 }
 
       tree->myIdx = 0;
-      int ii=0;
-	  int child,root;
-	  //printf("Tree,rank_cnt=%d\n",rank_cnt);
-        for (ii=0;ii<rank_cnt;ii++)
-		  if(tree->myRank_ == ranks[ii]){
-			  tree->myIdx = ii;
-              //printf("Tree,tree->myIdx=%d\n",tree->myIdx);
-			  break;
-		  }
-	  for (ii=0;ii<DEG_TREE;ii++){
-		  if((tree->myIdx)*DEG_TREE+1+ii<rank_cnt){
-			   child = ranks[(tree->myIdx)*DEG_TREE+1+ii];
-			   tree->myDests_[tree->destCnt_++]=child;
-               //*mysendmsg_num+=1;
-                //printf("Tree,destCnt=%d,mymsg=%d\n",tree->destCnt_,*mysendmsg_num);
-		  }
-	  }
-	  if(tree->myIdx!=0){
-		  tree->myRoot_ = ranks[(int)floor((double)(tree->myIdx-1.0)/(double)DEG_TREE)];
+	  int typeSize;
+	  MPI_Type_size(tree->type_,&typeSize);
+	  C_Tree_SetDests(tree, ranks, rank_cnt, msgSize*typeSize);
+	  if(tree->myRoot_ != tree->myRank_)
 		  *needrecv=1;
-	  }else{
-		  tree->myRoot_ = tree->myRank_;
-	  }
 
        // int myIdx = 0;
        // int ii=0;
@@ -133,11 +228,12 @@
       tree->myRoot_= -1; 
       tree->tag_=-1;
       tree->destCnt_=0;
-      tree->myDests_[0]=-1;
-      tree->myDests_[1]=-1;
-	  tree->sendRequests_[0]=MPI_REQUEST_NULL;
-	  tree->sendRequests_[1]=MPI_REQUEST_NULL;
+      for (int ii=0;ii<DEG_TREE_MAX;ii++){
+          tree->myDests_[ii]=-1;
+          tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+      }
       tree->empty_= YES; 
+      tree->rma_=NULL;
 	  tree->comm_=MPI_COMM_NULL;
 	  tree->type_=MPI_DATATYPE_NULL; 
 	}	
@@ -149,6 +245,11 @@
 	void C_BcTree_forwardMessageSimple(C_Tree* tree, void* localBuffer, int msgSize){
         MPI_Status status;
 		int flag;
+		if(tree->rma_){
+			for( int idxRecv = 0; idxRecv < tree->destCnt_; ++idxRecv )
+				C_RmaBox_Put(tree->rma_, tree->myDests_[idxRecv], tree->tag_, localBuffer, msgSize);
+			return;
+		}
 		for( int idxRecv = 0; idxRecv < tree->destCnt_; ++idxRecv ){
           int iProc = tree->myDests_[idxRecv];
           // Use Isend to send to multiple targets
@@ -236,11 +337,12 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
     tree->myRoot_= -1;
     tree->tag_=-1;
     tree->destCnt_=0;
-    tree->myDests_[0]=-1;
-    tree->myDests_[1]=-1;
-    tree->sendRequests_[0]=MPI_REQUEST_NULL;
-    tree->sendRequests_[1]=MPI_REQUEST_NULL;
+    for (int ii=0;ii<DEG_TREE_MAX;ii++){
+        tree->myDests_[ii]=-1;
+        tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+    }
     tree->empty_= NO;  // non-empty if rank_cnt>1
+    tree->rma_=NULL;
     
 	if(precision=='d'){
 	    tree->type_=MPI_DOUBLE;
@@ -251,29 +353,12 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
 	if(precision=='s'){
 	    tree->type_=MPI_FLOAT;
 	}
-    //int myIdx = 0;
-    int ii=0;
-    int child,root;
-    for (ii=0;ii<rank_cnt;ii++)
-        if(tree->myRank_ == ranks[ii]){
-            tree->myIdx = ii;
-            break;
-        }
-
-    for (ii=0;ii<DEG_TREE;ii++){
-        if(tree->myIdx*DEG_TREE+1+ii<rank_cnt){
-            child = ranks[tree->myIdx*DEG_TREE+1+ii];
-            tree->myDests_[tree->destCnt_++]=child;
-        }
-    }
+    int typeSize;
+    MPI_Type_size(tree->type_,&typeSize);
+    C_Tree_SetDests(tree, ranks, rank_cnt, msgSize*typeSize);
     *needrecvrd=tree->destCnt_;
-
-    if(tree->myIdx!=0){
-        tree->myRoot_ = ranks[(int)floor((double)(tree->myIdx-1.0)/(double)DEG_TREE)];
+    if(tree->myRoot_ != tree->myRank_)
         *needsendrd+=1;
-    }else{
-        tree->myRoot_ = tree->myRank_;
-    }
     //*mysendmsg_num_rd+=1;
 }
 
@@ -283,11 +368,12 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
       tree->myRoot_= -1; 
       tree->tag_=-1;
       tree->destCnt_=0;
-      tree->myDests_[0]=-1;
-      tree->myDests_[1]=-1;
-	  tree->sendRequests_[0]=MPI_REQUEST_NULL;
-	  tree->sendRequests_[1]=MPI_REQUEST_NULL;
+      for (int ii=0;ii<DEG_TREE_MAX;ii++){
+          tree->myDests_[ii]=-1;
+          tree->sendRequests_[ii]=MPI_REQUEST_NULL;
+      }
       tree->empty_= YES; 
+      tree->rma_=NULL;
 	  tree->comm_=MPI_COMM_NULL;
 	  tree->type_=MPI_DATATYPE_NULL; 
 	}	
@@ -304,6 +390,10 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
 		if(Tree->myRank_!=Tree->myRoot_){	
 			  //forward to my root if I have reseived everything
 			  int iProc = Tree->myRoot_;
+			  if(Tree->rma_){
+				  C_RmaBox_Put(Tree->rma_, iProc, Tree->tag_, localBuffer, msgSize);
+				  return;
+			  }
 			  // Use Isend to send to multiple targets
 
 			  int error_code = MPI_Isend(localBuffer, msgSize, Tree->type_, 
@@ -325,3 +415,109 @@ void C_RdTree_Create_nv(C_Tree* tree, MPI_Comm comm, int* ranks, int rank_cnt, i
         }			
 	}
 	
+
+
+/* Size of the flag preceding each slot, and of the slot counter at the
+   beginning of the window. */
+#define RMA_SLOT_H ((MPI_Aint) sizeof(int64_t))
+
+static MPI_Aint C_RmaBox_SlotBytes(C_RmaBox* box){
+	MPI_Aint nbytes = (MPI_Aint) box->slotSize_ * box->typeSize_;
+	return RMA_SLOT_H + ((nbytes + RMA_SLOT_H - 1) / RMA_SLOT_H) * RMA_SLOT_H;
+}
+
+/* Collective on wincomm: every process allocates room for the nslots
+   messages it will receive, each holding at most slotSize elements of type.
+   Targets are given as ranks in comm, which must be a subset of wincomm.
+   In the 3D solve, wincomm is the 3D grid communicator: some MPI libraries
+   cannot tell apart windows created at the same time on the disjoint 2D
+   layer communicators split from it. */
+void C_RmaBox_Create(C_RmaBox* box, MPI_Comm comm, MPI_Comm wincomm, int nslots, int slotSize, MPI_Datatype type){
+	MPI_Aint winsize;
+
+	box->type_=type;
+	MPI_Type_size(type,&box->typeSize_);
+	box->slotSize_=slotSize;
+	box->nslots_=nslots;
+	box->next_=0;
+	box->ranks_=NULL;
+	MPI_Comm_rank(wincomm,&box->myRank_);
+	if(comm!=wincomm){
+		int np, *ranks;
+		MPI_Group group, wingroup;
+		MPI_Comm_size(comm,&np);
+		ranks=(int*)SUPERLU_MALLOC(np*sizeof(int));
+		box->ranks_=(int*)SUPERLU_MALLOC(np*sizeof(int));
+		for (int i=0;i<np;i++) ranks[i]=i;
+		MPI_Comm_group(comm,&group);
+		MPI_Comm_group(wincomm,&wingroup);
+		MPI_Group_translate_ranks(group,np,ranks,wingroup,box->ranks_);
+		MPI_Group_free(&group);
+		MPI_Group_free(&wingroup);
+		SUPERLU_FREE(ranks);
+	}
+
+	winsize = RMA_SLOT_H + (MPI_Aint) nslots * C_RmaBox_SlotBytes(box);
+	MPI_Win_allocate(winsize, 1, MPI_INFO_NULL, wincomm, &box->base_, &box->win_);
+	memset(box->base_, 0, winsize);
+	MPI_Win_lock_all(MPI_MODE_NOCHECK, box->win_);
+	MPI_Win_sync(box->win_);
+	MPI_Barrier(wincomm); /* all counters and flags are cleared */
+}
+
+/* Collective on the wincomm used in C_RmaBox_Create. */
+void C_RmaBox_Free(C_RmaBox* box){
+	MPI_Win_unlock_all(box->win_);
+	MPI_Win_free(&box->win_);
+	SUPERLU_FREE(box->ranks_);
+	box->base_=NULL;
+	box->nslots_=0;
+}
+
+/* Deliver localBuffer[0:msgSize) to the next free slot of target. The
+   payload is complete at the target before the flag becomes visible. */
+void C_RmaBox_Put(C_RmaBox* box, int target, int tag, void* localBuffer, int msgSize){
+	int64_t one=1, slot, flag=tag;
+	MPI_Aint disp;
+
+	assert(msgSize<=box->slotSize_);
+	if(box->ranks_) target=box->ranks_[target];
+	MPI_Fetch_and_op(&one, &slot, MPI_INT64_T, target, 0, MPI_SUM, box->win_);
+	MPI_Win_flush(target, box->win_);
+
+	disp = RMA_SLOT_H + (MPI_Aint) slot * C_RmaBox_SlotBytes(box);
+	MPI_Put(localBuffer, msgSize, box->type_, target, disp + RMA_SLOT_H,
+		msgSize, box->type_, box->win_);
+	MPI_Win_flush(target, box->win_);
+
+	MPI_Accumulate(&flag, 1, MPI_INT64_T, target, disp, 1, MPI_INT64_T,
+		MPI_REPLACE, box->win_);
+	MPI_Win_flush(target, box->win_);
+}
+
+/* Wait for the next slot to be filled; return a pointer to its payload,
+   which stays valid until C_RmaBox_Free(), and the tag of the message. */
+void* C_RmaBox_Recv(C_RmaBox* box, int* tag){
+	int64_t flag=0;
+	MPI_Aint disp;
+
+	assert(box->next_<box->nslots_);
+	disp = RMA_SLOT_H + (MPI_Aint) box->next_ * C_RmaBox_SlotBytes(box);
+	do {
+		MPI_Fetch_and_op(NULL, &flag, MPI_INT64_T, box->myRank_, disp,
+			MPI_NO_OP, box->win_);
+		MPI_Win_flush(box->myRank_, box->win_);
+	} while (flag==0);
+	MPI_Win_sync(box->win_);
+
+	++box->next_;
+	*tag=(int) flag;
+	return box->base_ + disp + RMA_SLOT_H;
+}
+
+/* Route the messages of all non-empty trees through box (NULL restores
+   the two-sided Isend path). */
+void C_Tree_AttachRma(C_Tree* trees, int ntrees, C_RmaBox* box){
+	for (int i=0;i<ntrees;i++)
+		if(trees[i].empty_==NO) trees[i].rma_=box;
+}
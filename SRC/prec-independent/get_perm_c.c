@@ -154,6 +154,106 @@ get_colamd_dist(
 #endif // HAVE_COLAMD    
 }
 
+/* Number of threads used to form A'+A or A'*A: the OpenMP threads of the
+   caller, but at least GRAPH_CHUNK columns per thread. */
+#define GRAPH_CHUNK 4096
+
+static int
+graph_nthreads(int_t n)
+{
+#ifdef _OPENMP
+    int_t nthr = SUPERLU_MIN(omp_get_max_threads(), n / GRAPH_CHUNK);
+    return (int) SUPERLU_MAX(nthr, 1);
+#else
+    return 1;
+#endif
+}
+
+/* The first column j with colptr[j] >= pos. */
+static int_t
+first_col_dist(int_t *colptr, int_t n, int_t pos)
+{
+    int_t lo = 0, hi = n, j;
+    while ( lo < hi ) {
+        j = (lo + hi) / 2;
+        if ( colptr[j] < pos ) lo = j + 1; else hi = j;
+    }
+    return lo;
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Transpose the pattern of the m-by-n matrix (colptr, rowind) into
+ * (t_colptr, t_rowind), using nthr threads. Each thread counts the row
+ * indices of a contiguous block of columns holding about nz/nthr
+ * entries in its own slice of cnt[] (size nthr*m); a prefix sum over the
+ * rows and then over the threads gives every thread its own positions.
+ * Within each column of T the indices increase, exactly as in a serial
+ * transpose.
+ * </pre>
+ */
+static void
+transpose_pattern_dist(int_t m, int_t n, int_t *colptr, int_t *rowind,
+		       int_t *t_colptr, int_t *t_rowind, int_t *cnt, int nthr)
+{
+    int_t nz = colptr[n];
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
+#endif
+    {
+	int_t i, j, lo, hi, c, off, *mycnt;
+#ifdef _OPENMP
+	int tid = omp_get_thread_num();
+#else
+	int tid = 0;
+#endif
+	int t;
+
+	/* Columns lo .. hi-1 hold entries nz*tid/nthr .. nz*(tid+1)/nthr-1. */
+	lo = first_col_dist(colptr, n, (int_t) (((long long) nz * tid) / nthr));
+	hi = tid == nthr - 1 ? n
+	     : first_col_dist(colptr, n, (int_t) (((long long) nz * (tid + 1)) / nthr));
+
+	mycnt = cnt + (size_t) tid * m;
+	for (i = 0; i < m; ++i) mycnt[i] = 0;
+	for (j = lo; j < hi; ++j)
+	    for (i = colptr[j]; i < colptr[j+1]; ++i) ++mycnt[rowind[i]];
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp for
+#endif
+	for (i = 0; i < m; ++i) {
+	    c = 0;
+	    for (t = 0; t < nthr; ++t) c += cnt[(size_t) t * m + i];
+	    t_colptr[i+1] = c;
+	}
+#ifdef _OPENMP
+#pragma omp single
+#endif
+	{
+	    t_colptr[0] = 0;
+	    for (i = 0; i < m; ++i) t_colptr[i+1] += t_colptr[i];
+	}
+#ifdef _OPENMP
+#pragma omp for
+#endif
+	for (i = 0; i < m; ++i) {
+	    off = t_colptr[i];
+	    for (t = 0; t < nthr; ++t) {
+		c = cnt[(size_t) t * m + i];
+		cnt[(size_t) t * m + i] = off;
+		off += c;
+	    }
+	}
+
+	for (j = lo; j < hi; ++j)
+	    for (i = colptr[j]; i < colptr[j+1]; ++i)
+		t_rowind[mycnt[rowind[i]]++] = j;
+    }
+}
+
 /*! \brief
  *
  * <pre>
@@ -169,6 +269,11 @@ get_colamd_dist(
  * The complexity of this algorithm is: SUM_{i=1,m} r(i)^2,
  * i.e., the sum of the square of the row counts.
  *
+ * The columns of A'*A are formed independently on the OpenMP threads of
+ * the caller: one pass counts them, a prefix sum gives the column
+ * pointers, and a second pass fills them in. The output is the same for
+ * any number of threads.
+ *
  * Questions
  * =========
  *     o  Do I need to withhold the *dense* rows?
@@ -188,39 +293,25 @@ getata_dist(
 	    int_t **ata_rowind  /* out - size *atanz */
 	    )
 {
-
-    register int_t i, j, k, col, num_nz, ti, trow;
-    int_t *marker, *b_colptr, *b_rowind;
+    int_t *work, *b_colptr, *b_rowind;
     int_t *t_colptr, *t_rowind; /* a column oriented form of T = A' */
+    int nthr = graph_nthreads(n);
 
-    if ( !(marker = (int_t*) SUPERLU_MALLOC( (SUPERLU_MAX(m,n)+1) * sizeof(int_t)) ) )
-	ABORT("SUPERLU_MALLOC fails for marker[]");
+    if ( !(work = (int_t*) SUPERLU_MALLOC( ((size_t) nthr * SUPERLU_MAX(m,n) + 1)
+					   * sizeof(int_t)) ) )
+	ABORT("SUPERLU_MALLOC fails for work[]");
     if ( !(t_colptr = (int_t*) SUPERLU_MALLOC( (m+1) * sizeof(int_t)) ) )
 	ABORT("SUPERLU_MALLOC t_colptr[]");
     if ( !(t_rowind = (int_t*) SUPERLU_MALLOC( nz * sizeof(int_t)) ) )
 	ABORT("SUPERLU_MALLOC fails for t_rowind[]");
 
-    
-    /* Get counts of each column of T, and set up column pointers */
-    for (i = 0; i < m; ++i) marker[i] = 0;
-    for (j = 0; j < n; ++j) {
-	for (i = colptr[j]; i < colptr[j+1]; ++i)
-	    ++marker[rowind[i]];
-    }
-    t_colptr[0] = 0;
-    for (i = 0; i < m; ++i) {
-	t_colptr[i+1] = t_colptr[i] + marker[i];
-	marker[i] = t_colptr[i];
-    }
-
     /* Transpose the matrix from A to T */
-    for (j = 0; j < n; ++j)
-	for (i = colptr[j]; i < colptr[j+1]; ++i) {
-	    col = rowind[i];
-	    t_rowind[marker[col]] = j;
-	    ++marker[col];
-	}
+    transpose_pattern_dist(m, n, colptr, rowind, t_colptr, t_rowind, work, nthr);
 
+    if ( !(*ata_colptr = (int_t*) SUPERLU_MALLOC( (n+1) * sizeof(int_t)) ) )
+	ABORT("SUPERLU_MALLOC fails for ata_colptr[]");
+    b_colptr = *ata_colptr; /* aliasing */
+    b_rowind = NULL;
     
     /* ----------------------------------------------------------------
        compute B = T * A, where column j of B is:
@@ -235,67 +326,81 @@ getata_dist(
          T * A_*j = (T_*1, ..., T_*m) * A_*j.  )
        ---------------------------------------------------------------- */
 
-    /* Zero the diagonal flag */
-    for (i = 0; i < n; ++i) marker[i] = -1;
-
-    /* First pass determines number of nonzeros in B */
-    num_nz = 0;
-    for (j = 0; j < n; ++j) {
-	/* Flag the diagonal so it's not included in the B matrix */
-	marker[j] = j;
-
-	for (i = colptr[j]; i < colptr[j+1]; ++i) {
-	    /* A_kj is nonzero, add pattern of column T_*k to B_*j */
-	    k = rowind[i];
-	    for (ti = t_colptr[k]; ti < t_colptr[k+1]; ++ti) {
-		trow = t_rowind[ti];
-		if ( marker[trow] != j ) {
-		    marker[trow] = j;
-		    num_nz++;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
+#endif
+    {
+	int_t i, j, k, ti, trow, num_nz, *marker, *rw;
+#ifdef _OPENMP
+	marker = work + (size_t) omp_get_thread_num() * n;
+#else
+	marker = work;
+#endif
+
+	/* First pass determines number of nonzeros in each column of B */
+	for (i = 0; i < n; ++i) marker[i] = -1;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+	for (j = 0; j < n; ++j) {
+	    /* Flag the diagonal so it's not included in the B matrix */
+	    marker[j] = j;
+	    num_nz = 0;
+	    for (i = colptr[j]; i < colptr[j+1]; ++i) {
+		/* A_kj is nonzero, add pattern of column T_*k to B_*j */
+		k = rowind[i];
+		for (ti = t_colptr[k]; ti < t_colptr[k+1]; ++ti) {
+		    trow = t_rowind[ti];
+		    if ( marker[trow] != j ) {
+			marker[trow] = j;
+			++num_nz;
+		    }
 		}
 	    }
+	    b_colptr[j+1] = num_nz;
 	}
-    }
-    *atanz = num_nz;
-    
-    /* Allocate storage for A'*A */
-    if ( !(*ata_colptr = (int_t*) SUPERLU_MALLOC( (n+1) * sizeof(int_t)) ) )
-	ABORT("SUPERLU_MALLOC fails for ata_colptr[]");
-    if ( *atanz ) {
-	if ( !(*ata_rowind = (int_t*)SUPERLU_MALLOC(*atanz*sizeof(int_t)) ) ) {
-	    fprintf(stderr, ".. atanz = %lld\n", (long long) *atanz);
-	    ABORT("SUPERLU_MALLOC fails for ata_rowind[]");
-	}
-    }
-    b_colptr = *ata_colptr; /* aliasing */
-    b_rowind = *ata_rowind;
-    
-    /* Zero the diagonal flag */
-    for (i = 0; i < n; ++i) marker[i] = -1;
-    
-    /* Compute each column of B, one at a time */
-    num_nz = 0;
-    for (j = 0; j < n; ++j) {
-	b_colptr[j] = num_nz;
-	
-	/* Flag the diagonal so it's not included in the B matrix */
-	marker[j] = j;
-
-	for (i = colptr[j]; i < colptr[j+1]; ++i) {
-	    /* A_kj is nonzero, add pattern of column T_*k to B_*j */
-	    k = rowind[i];
-	    for (ti = t_colptr[k]; ti < t_colptr[k+1]; ++ti) {
-		trow = t_rowind[ti];
-		if ( marker[trow] != j ) {
-		    marker[trow] = j;
-		    b_rowind[num_nz++] = trow;
+
+#ifdef _OPENMP
+#pragma omp single
+#endif
+	{
+	    b_colptr[0] = 0;
+	    for (j = 0; j < n; ++j) b_colptr[j+1] += b_colptr[j];
+	    *atanz = b_colptr[n];
+
+	    /* Allocate storage for A'*A */
+	    if ( *atanz ) {
+		if ( !(b_rowind = (int_t*)SUPERLU_MALLOC(*atanz*sizeof(int_t))) ) {
+		    fprintf(stderr, ".. atanz = %lld\n", (long long) *atanz);
+		    ABORT("SUPERLU_MALLOC fails for ata_rowind[]");
+		}
+		*ata_rowind = b_rowind;
+	    }
+	} /* implicit barrier */
+	rw = b_rowind;
+
+	/* Compute each column of B */
+	for (i = 0; i < n; ++i) marker[i] = -1;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+	for (j = 0; j < n; ++j) {
+	    marker[j] = j;
+	    num_nz = b_colptr[j];
+	    for (i = colptr[j]; i < colptr[j+1]; ++i) {
+		k = rowind[i];
+		for (ti = t_colptr[k]; ti < t_colptr[k+1]; ++ti) {
+		    trow = t_rowind[ti];
+		    if ( marker[trow] != j ) {
+			marker[trow] = j;
+			rw[num_nz++] = trow;
+		    }
 		}
 	    }
 	}
     }
-    b_colptr[n] = num_nz;
        
-    SUPERLU_FREE(marker);
+    SUPERLU_FREE(work);
     SUPERLU_FREE(t_colptr);
     SUPERLU_FREE(t_rowind);
 }
@@ -310,6 +415,10 @@ getata_dist(
  * format represented by (colptr, rowind). The output A'+A is in column
  * oriented format (symmetrically, also row oriented), represented by
  * (b_colptr, b_rowind).
+ *
+ * As in getata_dist(), the columns are counted and then filled in on the
+ * OpenMP threads of the caller, and the output does not depend on the
+ * number of threads.
  * </pre>
  */
 void
@@ -324,40 +433,24 @@ at_plus_a_dist(
 	       int_t **b_rowind  /* out - size *bnz */
 	       )
 {
-
-    register int_t i, j, k, col, num_nz;
     int_t *t_colptr, *t_rowind; /* a column oriented form of T = A' */
-    int_t *marker;
+    int_t *work, *bc, *br;
+    int nthr = graph_nthreads(n);
 
-    if ( !(marker = (int_t*) SUPERLU_MALLOC( n * sizeof(int_t)) ) )
-	ABORT("SUPERLU_MALLOC fails for marker[]");
+    if ( !(work = (int_t*) SUPERLU_MALLOC( ((size_t) nthr * n + 1) * sizeof(int_t)) ) )
+	ABORT("SUPERLU_MALLOC fails for work[]");
     if ( !(t_colptr = (int_t*) SUPERLU_MALLOC( (n+1) * sizeof(int_t)) ) )
 	ABORT("SUPERLU_MALLOC fails for t_colptr[]");
     if ( !(t_rowind = (int_t*) SUPERLU_MALLOC( nz * sizeof(int_t)) ) )
 	ABORT("SUPERLU_MALLOC fails t_rowind[]");
 
-    /* Get counts of each column of T, and set up column pointers */
-    for (i = 0; i < n; ++i) marker[i] = 0;
-    for (j = 0; j < n; ++j) {
-	for (i = colptr[j]; i < colptr[j+1]; ++i)
-	    ++marker[rowind[i]];
-    }
-
-    t_colptr[0] = 0;
-    for (i = 0; i < n; ++i) {
-	t_colptr[i+1] = t_colptr[i] + marker[i];
-	marker[i] = t_colptr[i];
-    }
-
     /* Transpose the matrix from A to T */
-    for (j = 0; j < n; ++j) {
-	for (i = colptr[j]; i < colptr[j+1]; ++i) {
-	    col = rowind[i];
-	    t_rowind[marker[col]] = j;
-	    ++marker[col];
-	}
-    }
+    transpose_pattern_dist(n, n, colptr, rowind, t_colptr, t_rowind, work, nthr);
 
+    if ( !(*b_colptr = (int_t*) SUPERLU_MALLOC( (n+1) * sizeof(int_t)) ) )
+	ABORT("SUPERLU_MALLOC fails for b_colptr[]");
+    bc = *b_colptr;
+    br = NULL;
 
     /* ----------------------------------------------------------------
        compute B = A + T, where column j of B is:
@@ -367,76 +460,90 @@ at_plus_a_dist(
        do not include the diagonal entry
        ---------------------------------------------------------------- */
 
-    /* Zero the diagonal flag */
-    for (i = 0; i < n; ++i) marker[i] = -1;
-
-    /* First pass determines number of nonzeros in B */
-    num_nz = 0;
-    for (j = 0; j < n; ++j) {
-	/* Flag the diagonal so it's not included in the B matrix */
-	marker[j] = j;
-
-	/* Add pattern of column A_*k to B_*j */
-	for (i = colptr[j]; i < colptr[j+1]; ++i) {
-	    k = rowind[i];
-	    if ( marker[k] != j ) {
-		marker[k] = j;
-		++num_nz;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
+#endif
+    {
+	int_t i, j, k, num_nz, *marker, *rw;
+#ifdef _OPENMP
+	marker = work + (size_t) omp_get_thread_num() * n;
+#else
+	marker = work;
+#endif
+
+	/* First pass determines number of nonzeros in each column of B */
+	for (i = 0; i < n; ++i) marker[i] = -1;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1024)
+#endif
+	for (j = 0; j < n; ++j) {
+	    /* Flag the diagonal so it's not included in the B matrix */
+	    marker[j] = j;
+	    num_nz = 0;
+
+	    /* Add pattern of column A_*k to B_*j */
+	    for (i = colptr[j]; i < colptr[j+1]; ++i) {
+		k = rowind[i];
+		if ( marker[k] != j ) {
+		    marker[k] = j;
+		    ++num_nz;
+		}
 	    }
-	}
 
-	/* Add pattern of column T_*k to B_*j */
-	for (i = t_colptr[j]; i < t_colptr[j+1]; ++i) {
-	    k = t_rowind[i];
-	    if ( marker[k] != j ) {
-		marker[k] = j;
-		++num_nz;
+	    /* Add pattern of column T_*k to B_*j */
+	    for (i = t_colptr[j]; i < t_colptr[j+1]; ++i) {
+		k = t_rowind[i];
+		if ( marker[k] != j ) {
+		    marker[k] = j;
+		    ++num_nz;
+		}
 	    }
+	    bc[j+1] = num_nz;
 	}
-    }
-    *bnz = num_nz;
 
-
-    /* Allocate storage for A+A' */
-    if ( !(*b_colptr = (int_t*) SUPERLU_MALLOC( (n+1) * sizeof(int_t)) ) )
-	ABORT("SUPERLU_MALLOC fails for b_colptr[]");
-    if ( *bnz ) {
-	if ( !(*b_rowind = (int_t*) SUPERLU_MALLOC( *bnz * sizeof(int_t)) ) )
-	    ABORT("SUPERLU_MALLOC fails for b_rowind[]");
-    }
-    
-    /* Zero the diagonal flag */
-    for (i = 0; i < n; ++i) marker[i] = -1;
-    
-    /* Compute each column of B, one at a time */
-    num_nz = 0;
-    for (j = 0; j < n; ++j) {
-	(*b_colptr)[j] = num_nz;
-	
-	/* Flag the diagonal so it's not included in the B matrix */
-	marker[j] = j;
-
-	/* Add pattern of column A_*k to B_*j */
-	for (i = colptr[j]; i < colptr[j+1]; ++i) {
-	    k = rowind[i];
-	    if ( marker[k] != j ) {
-		marker[k] = j;
-		(*b_rowind)[num_nz++] = k;
+#ifdef _OPENMP
+#pragma omp single
+#endif
+	{
+	    bc[0] = 0;
+	    for (j = 0; j < n; ++j) bc[j+1] += bc[j];
+	    *bnz = bc[n];
+
+	    /* Allocate storage for A+A' */
+	    if ( *bnz ) {
+		if ( !(br = (int_t*) SUPERLU_MALLOC( *bnz * sizeof(int_t)) ) )
+		    ABORT("SUPERLU_MALLOC fails for b_rowind[]");
+		*b_rowind = br;
 	    }
-	}
+	} /* implicit barrier */
+	rw = br;
 
-	/* Add pattern of column T_*k to B_*j */
-	for (i = t_colptr[j]; i < t_colptr[j+1]; ++i) {
-	    k = t_rowind[i];
-	    if ( marker[k] != j ) {
-		marker[k] = j;
-		(*b_rowind)[num_nz++] = k;
+	/* Compute each column of B */
+	for (i = 0; i < n; ++i) marker[i] = -1;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1024)
+#endif
+	for (j = 0; j < n; ++j) {
+	    marker[j] = j;
+	    num_nz = bc[j];
+	    for (i = colptr[j]; i < colptr[j+1]; ++i) {
+		k = rowind[i];
+		if ( marker[k] != j ) {
+		    marker[k] = j;
+		    rw[num_nz++] = k;
+		}
+	    }
+	    for (i = t_colptr[j]; i < t_colptr[j+1]; ++i) {
+		k = t_rowind[i];
+		if ( marker[k] != j ) {
+		    marker[k] = j;
+		    rw[num_nz++] = k;
+		}
 	    }
 	}
     }
-    (*b_colptr)[n] = num_nz;
        
-    SUPERLU_FREE(marker);
+    SUPERLU_FREE(work);
     SUPERLU_FREE(t_colptr);
     SUPERLU_FREE(t_rowind);
 } /* at_plus_a_dist */
@@ -462,6 +569,7 @@ at_plus_a_dist(
  *         = MMD_AT_PLUS_A: minimum degree ordering on structure of A'+A
  *         = MMD_ATA: minimum degree ordering on structure of A'*A
  *         = METIS_AT_PLUS_A: MeTis on A'+A
+ *         = ND_AT_PLUS_A: built-in nested dissection on A'+A
  * 
  * A       (input) SuperMatrix*
  *         Matrix A in A*X=B, of dimension (A->nrow, A->ncol). The number
@@ -477,7 +585,20 @@ at_plus_a_dist(
  */
 void
 get_perm_c_dist(int_t pnum, int_t ispec, SuperMatrix *A, int_t *perm_c)
+{
+    get_perm_c_stat(pnum, ispec, A, perm_c, NULL);
+}
 
+/*! \brief
+ *
+ * <pre>
+ * GET_PERM_C_STAT is get_perm_c_dist() that also records in
+ * stat->utime[GRAPH] the time to form A'+A or A'*A. stat may be NULL.
+ * </pre>
+ */
+void
+get_perm_c_stat(int_t pnum, int_t ispec, SuperMatrix *A, int_t *perm_c,
+		SuperLUStat_t *stat)
 {
     NCformat *Astore = A->Store;
     int_t m, n, bnz = 0, *b_colptr, *b_rowind, i;
@@ -486,7 +607,7 @@ get_perm_c_dist(int_t pnum, int_t ispec, SuperMatrix *A, int_t *perm_c)
     double t, SuperLU_timer_();
 
 #if ( DEBUGlevel>=1 )
-    CHECK_MALLOC((int)pnum, "Enter get_perm_c_dist()");
+    CHECK_MALLOC((int)pnum, "Enter get_perm_c_stat()");
 #endif
 
     m = A->nrow;
@@ -508,7 +629,7 @@ get_perm_c_dist(int_t pnum, int_t ispec, SuperMatrix *A, int_t *perm_c)
 	      at_plus_a_dist(n, Astore->nnz, Astore->colptr, Astore->rowind,
 			     &bnz, &b_colptr, &b_rowind);
 	      t = SuperLU_timer_() - t;
-	      /*printf("Form A'+A time = %8.3f\n", t);*/
+	      if ( stat ) stat->utime[GRAPH] = t;
 #if ( PRNTlevel>=1 )
 	      if ( !pnum ) printf(".. Use minimum degree ordering on A'+A.\n");
 #endif
@@ -518,7 +639,7 @@ get_perm_c_dist(int_t pnum, int_t ispec, SuperMatrix *A, int_t *perm_c)
 	      getata_dist(m, n, Astore->nnz, Astore->colptr, Astore->rowind,
 			  &bnz, &b_colptr, &b_rowind);
 	      t = SuperLU_timer_() - t;
-	      /*printf("Form A'*A time = %8.3f\n", t);*/
+	      if ( stat ) stat->utime[GRAPH] = t;
 #if ( PRNTlevel>=1 )
 	      if ( !pnum ) printf(".. Use minimum degree ordering on A'*A\n");
 #endif
@@ -536,6 +657,7 @@ get_perm_c_dist(int_t pnum, int_t ispec, SuperMatrix *A, int_t *perm_c)
 	      if ( m != n ) ABORT("Matrix is not square");
 	      at_plus_a_dist(n, Astore->nnz, Astore->colptr, Astore->rowind,
 			     &bnz, &b_colptr, &b_rowind);
+	      if ( stat ) stat->utime[GRAPH] = SuperLU_timer_() - t;
 
 	      if ( bnz ) { /* non-empty adjacency structure */
 		  get_metis_dist(n, bnz, b_colptr, b_rowind, perm_c);
@@ -551,6 +673,25 @@ get_perm_c_dist(int_t pnum, int_t ispec, SuperMatrix *A, int_t *perm_c)
 	      return;
 #endif /* matching ifdef HAVE_PARMETIS */
 
+        case ND_AT_PLUS_A: /* Built-in nested dissection on A'+A */
+	      if ( m != n ) ABORT("Matrix is not square");
+	      at_plus_a_dist(n, Astore->nnz, Astore->colptr, Astore->rowind,
+			     &bnz, &b_colptr, &b_rowind);
+	      if ( stat ) stat->utime[GRAPH] = SuperLU_timer_() - t;
+
+	      if ( bnz ) { /* non-empty adjacency structure */
+		  get_perm_c_nd(n, bnz, b_colptr, b_rowind, perm_c, NULL);
+	      } else { /* e.g., diagonal matrix */
+		  for (i = 0; i < n; ++i) perm_c[i] = i;
+		  SUPERLU_FREE(b_colptr);
+		  /* b_rowind is not allocated in this case */
+	      }
+
+#if ( PRNTlevel>=1 )
+	      if ( !pnum ) printf(".. Use built-in nested dissection on A'+A\n");
+#endif
+	      return;
+
         default:
 	      ABORT("Invalid ISPEC");
     }
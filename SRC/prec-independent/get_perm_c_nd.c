@@ -0,0 +1,765 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief Native multilevel nested-dissection ordering of A'+A
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Each subgraph larger than ND_LEAF is split by a vertex separator:
+ *   1. coarsen by heavy-edge matching down to about ND_COARSEST vertices,
+ *   2. bisect the coarsest graph by greedy graph growing from a few
+ *      seeds, keeping the smallest balanced edge cut, and turn the cut
+ *      into a vertex separator,
+ *   3. project the separator back level by level, refining it at each
+ *      level by Fiduccia-Mattheyses vertex moves.
+ * The two halves are ordered recursively (as OpenMP tasks when large
+ * enough), the separator is numbered last, and subgraphs of at most
+ * ND_LEAF vertices are ordered by multiple minimum degree (genmmd_dist_).
+ * All choices are made in a fixed order, so the ordering does not depend
+ * on the number of threads.
+ * </pre>
+ */
+
+#include "superlu_dist_config.h"
+#include "superlu_defs.h"
+
+#define ND_LEAF      200  /* order subgraphs up to this size by MMD */
+#define ND_COARSEST  80   /* stop coarsening below this many vertices */
+#define ND_MAXLVL    48   /* at most this many coarsening levels */
+#define ND_TASK      2000 /* order subgraphs at least this big as tasks */
+#define ND_NTRIES    4    /* initial bisections tried on the coarsest graph */
+#define ND_NPASS     8    /* refinement passes per level */
+#define ND_UBFACTOR  0.55 /* largest part weight, as a fraction of the total */
+
+/* Graph of one subproblem, CSR without self loops. */
+typedef struct {
+    int_t nv;
+    int_t *xadj, *adj;
+    int_t *vwgt, *ewgt;   /* NULL means unit weights */
+} ndGraph_t;
+
+#define ND_VW(g, v) ( (g)->vwgt ? (g)->vwgt[v] : 1 )
+#define ND_EW(g, e) ( (g)->ewgt ? (g)->ewgt[e] : 1 )
+
+/* Shared state of the recursion. The separator tree nodes are recorded
+   in creation order and put in postorder at the end. */
+typedef struct {
+    int_t *perm_c;
+    int_t *deg;       /* degree of each vertex in the whole graph */
+    int_t want_tree;
+    int_t nnodes;
+    int_t *own, *hi, *depth, *parent; /* per tree node, size 2*n */
+} ndCtx_t;
+
+static void *nd_malloc(size_t size)
+{
+    void *p = SUPERLU_MALLOC(SUPERLU_MAX(size, 1));
+    if ( !p ) ABORT("SUPERLU_MALLOC fails in get_perm_c_nd()");
+    return p;
+}
+
+static void nd_free_graph(ndGraph_t *g)
+{
+    SUPERLU_FREE(g->xadj);
+    SUPERLU_FREE(g->adj);
+    if ( g->vwgt ) SUPERLU_FREE(g->vwgt);
+    if ( g->ewgt ) SUPERLU_FREE(g->ewgt);
+}
+
+/*! \brief Coarsen g by heavy-edge matching; cmap[v] is the coarse vertex
+ * that v is merged into.
+ */
+static void nd_coarsen(ndGraph_t *g, int_t *cmap, ndGraph_t *cg)
+{
+    int_t nv = g->nv, nnz = g->xadj[nv];
+    int_t i, j, k, v, u, w, c, cw, best, bestw, cnv, maxdeg;
+    int_t *order, *match, *htable, *cfine, *cxadj, *cadj, *cvwgt, *cewgt;
+
+    /* Visit the vertices by increasing degree, so that low-degree vertices
+       find a partner before their neighbors are taken. */
+    maxdeg = 0;
+    for (v = 0; v < nv; ++v)
+        maxdeg = SUPERLU_MAX(maxdeg, g->xadj[v+1] - g->xadj[v]);
+    order = (int_t *) nd_malloc((nv + maxdeg + 2) * sizeof(int_t));
+    match = (int_t *) nd_malloc(4 * nv * sizeof(int_t));
+    cfine = match + 2 * nv; /* the one or two fine vertices of each coarse one */
+    htable = order + nv;  /* degree counts, reused below */
+    for (k = 0; k <= maxdeg + 1; ++k) htable[k] = 0;
+    for (v = 0; v < nv; ++v) ++htable[g->xadj[v+1] - g->xadj[v] + 1];
+    for (k = 0; k < maxdeg; ++k) htable[k+1] += htable[k];
+    for (v = 0; v < nv; ++v) order[htable[g->xadj[v+1] - g->xadj[v]]++] = v;
+
+    for (v = 0; v < nv; ++v) match[v] = SLU_EMPTY;
+    cnv = 0;
+    for (k = 0; k < nv; ++k) {
+        v = order[k];
+        if ( match[v] != SLU_EMPTY ) continue;
+        best = v;
+        bestw = -1;
+        for (j = g->xadj[v]; j < g->xadj[v+1]; ++j) {
+            u = g->adj[j];
+            if ( match[u] == SLU_EMPTY && u != v && ND_EW(g, j) > bestw ) {
+                best = u;
+                bestw = ND_EW(g, j);
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+        cfine[2*cnv] = v;
+        cfine[2*cnv+1] = best;
+        cmap[v] = cmap[best] = cnv++;
+    }
+    SUPERLU_FREE(order);
+
+    /* Build the coarse graph; htable[cw] is the position of edge (c,cw). */
+    cxadj = (int_t *) nd_malloc((cnv + 1) * sizeof(int_t));
+    cadj = (int_t *) nd_malloc(nnz * sizeof(int_t));
+    cewgt = (int_t *) nd_malloc(nnz * sizeof(int_t));
+    cvwgt = (int_t *) nd_malloc(cnv * sizeof(int_t));
+    htable = match + nv;
+    for (c = 0; c < cnv; ++c) htable[c] = SLU_EMPTY;
+
+    k = 0;
+    cxadj[0] = 0;
+    for (c = 0; c < cnv; ++c) {
+        v = cfine[2*c];
+        u = cfine[2*c+1];
+        cvwgt[c] = ND_VW(g, v) + (u != v ? ND_VW(g, u) : 0);
+        for (i = 0; i < 2; ++i) {
+            w = i ? u : v;
+            if ( i && u == v ) break;
+            for (j = g->xadj[w]; j < g->xadj[w+1]; ++j) {
+                cw = cmap[g->adj[j]];
+                if ( cw == c ) continue;
+                if ( htable[cw] >= cxadj[c] ) {
+                    cewgt[htable[cw]] += ND_EW(g, j);
+                } else {
+                    htable[cw] = k;
+                    cadj[k] = cw;
+                    cewgt[k++] = ND_EW(g, j);
+                }
+            }
+        }
+        cxadj[c+1] = k;
+    }
+    SUPERLU_FREE(match);
+
+    cg->nv = cnv;
+    cg->xadj = cxadj;
+    cg->adj = cadj;
+    cg->vwgt = cvwgt;
+    cg->ewgt = cewgt;
+}
+
+/*! \brief Greedy boundary refinement of the bisection where[] (0/1):
+ * move vertices that reduce the edge cut, or keep it and improve the
+ * balance, as long as no part grows beyond maxw.
+ */
+static void nd_refine_edge(ndGraph_t *g, int_t *where, int_t *pw, int_t maxw)
+{
+    int_t pass, v, j, from, to, vw, id, ed, gain, moved;
+
+    for (pass = 0; pass < ND_NPASS; ++pass) {
+        moved = 0;
+        for (v = 0; v < g->nv; ++v) {
+            from = where[v];
+            to = 1 - from;
+            id = ed = 0;
+            for (j = g->xadj[v]; j < g->xadj[v+1]; ++j) {
+                if ( where[g->adj[j]] == from ) id += ND_EW(g, j);
+                else ed += ND_EW(g, j);
+            }
+            vw = ND_VW(g, v);
+            gain = ed - id;
+            if ( ed == 0 ) continue; /* interior vertex */
+            if ( pw[to] + vw > maxw && pw[from] <= maxw ) continue;
+            if ( gain > 0
+                 || (pw[to] + vw < pw[from] && (gain == 0 || pw[from] > maxw)) ) {
+                where[v] = to;
+                pw[from] -= vw;
+                pw[to] += vw;
+                ++moved;
+            }
+        }
+        if ( !moved ) break;
+    }
+}
+
+static int_t nd_edge_cut(ndGraph_t *g, int_t *where)
+{
+    int_t v, j, cut = 0;
+    for (v = 0; v < g->nv; ++v)
+        for (j = g->xadj[v]; j < g->xadj[v+1]; ++j)
+            if ( where[g->adj[j]] != where[v] ) cut += ND_EW(g, j);
+    return cut / 2;
+}
+
+/*! \brief Bisect g by breadth-first graph growing from seed: part 0 takes
+ * vertices in BFS order until it holds half of the weight.
+ */
+static void nd_grow(ndGraph_t *g, int_t seed, int_t tw, int_t *where,
+                    int_t *queue, int_t *pw)
+{
+    int_t nv = g->nv, head = 0, tail = 0, next = 0, v, j, u;
+
+    for (v = 0; v < nv; ++v) where[v] = 1;
+    pw[0] = 0;
+    pw[1] = tw;
+    where[seed] = 0;
+    queue[tail++] = seed;
+    while ( 2 * pw[0] < tw ) {
+        if ( head == tail ) { /* disconnected: restart elsewhere */
+            while ( next < nv && where[next] == 0 ) ++next;
+            if ( next == nv ) break;
+            where[next] = 0;
+            queue[tail++] = next;
+        }
+        v = queue[head++];
+        pw[0] += ND_VW(g, v);
+        pw[1] -= ND_VW(g, v);
+        for (j = g->xadj[v]; j < g->xadj[v+1]; ++j) {
+            u = g->adj[j];
+            if ( where[u] == 1 ) {
+                where[u] = 0;
+                queue[tail++] = u;
+            }
+        }
+    }
+    /* Vertices queued but not reached stay in part 1. */
+    while ( head < tail ) where[queue[head++]] = 1;
+}
+
+/*! \brief Initial bisection of the coarsest graph, of total vertex
+ * weight tw: the best of ND_NTRIES grown and refined bisections.
+ */
+static void nd_bisect(ndGraph_t *g, int_t tw, int_t *where, int_t *pw,
+                      int_t maxw)
+{
+    int_t nv = g->nv, t, v, seed, cut, bestcut = -1;
+    int_t bpw[2], tpw[2];
+    int_t *queue = (int_t *) nd_malloc(2 * nv * sizeof(int_t));
+    int_t *trial = queue + nv;
+
+    for (t = 0; t < ND_NTRIES; ++t) {
+        if ( t == 0 ) { /* a pseudo-peripheral vertex: the last one reached */
+            nd_grow(g, 0, 2 * tw + 2, trial, queue, tpw);
+            seed = queue[nv - 1];
+        } else {
+            seed = (t * nv) / ND_NTRIES;
+        }
+        nd_grow(g, seed, tw, trial, queue, tpw);
+        nd_refine_edge(g, trial, tpw, maxw);
+        cut = nd_edge_cut(g, trial);
+        if ( SUPERLU_MAX(tpw[0], tpw[1]) > maxw ) cut += tw; /* unbalanced */
+        if ( bestcut < 0 || cut < bestcut ) {
+            bestcut = cut;
+            for (v = 0; v < nv; ++v) where[v] = trial[v];
+            bpw[0] = tpw[0];
+            bpw[1] = tpw[1];
+        }
+    }
+    pw[0] = bpw[0];
+    pw[1] = bpw[1];
+    SUPERLU_FREE(queue);
+}
+
+/* Indexed max-heap of vertices keyed by a gain. */
+typedef struct {
+    int_t n;
+    int_t *h, *pos, *key;  /* pos[v] is SLU_EMPTY when v is not queued */
+} ndHeap_t;
+
+static void nd_heap_swap(ndHeap_t *q, int_t i, int_t j)
+{
+    int_t t = q->h[i];
+    q->h[i] = q->h[j];
+    q->h[j] = t;
+    q->pos[q->h[i]] = i;
+    q->pos[q->h[j]] = j;
+}
+
+static void nd_heap_fix(ndHeap_t *q, int_t i)
+{
+    int_t p, c;
+    while ( i > 0 && q->key[q->h[p = (i - 1) / 2]] < q->key[q->h[i]] ) {
+        nd_heap_swap(q, i, p);
+        i = p;
+    }
+    while ( (c = 2 * i + 1) < q->n ) {
+        if ( c + 1 < q->n && q->key[q->h[c+1]] > q->key[q->h[c]] ) ++c;
+        if ( q->key[q->h[c]] <= q->key[q->h[i]] ) break;
+        nd_heap_swap(q, i, c);
+        i = c;
+    }
+}
+
+static void nd_heap_set(ndHeap_t *q, int_t v, int_t key)
+{
+    q->key[v] = key;
+    if ( q->pos[v] == SLU_EMPTY ) {
+        q->h[q->n] = v;
+        q->pos[v] = q->n++;
+    }
+    nd_heap_fix(q, q->pos[v]);
+}
+
+static void nd_heap_remove(ndHeap_t *q, int_t v)
+{
+    int_t i = q->pos[v];
+    if ( i == SLU_EMPTY ) return;
+    q->pos[v] = SLU_EMPTY;
+    if ( i == --q->n ) return;
+    q->h[i] = q->h[q->n];
+    q->pos[q->h[i]] = i;
+    nd_heap_fix(q, i);
+}
+
+/* Gain of moving separator vertex v to side t: its own weight, less the
+   weight of its neighbors on side 1-t, which must enter the separator. */
+static int_t nd_sep_gain(ndGraph_t *g, int_t *where, int_t v, int_t t)
+{
+    int_t j, gain = ND_VW(g, v);
+    for (j = g->xadj[v]; j < g->xadj[v+1]; ++j)
+        if ( where[g->adj[j]] == 1 - t ) gain -= ND_VW(g, g->adj[j]);
+    return gain;
+}
+
+/*! \brief Fiduccia-Mattheyses refinement of the vertex separator
+ * where[v] == 2, with vertex weights. Each pass moves every separator
+ * vertex at most once, to the side that gains most while no part grows
+ * beyond maxw, allows a limited run of uphill moves, and rolls back to
+ * the smallest separator seen.
+ */
+static void nd_refine_sep(ndGraph_t *g, int_t *where, int_t *pw, int_t maxw)
+{
+    int_t nv = g->nv, pass, i, j, k, v, u, t, nmoves, npulled, best, bestbal;
+    int_t bestmoves, bestpulled, limit, hv[2];
+    int_t *locked, *mvtx, *mside, *mcnt, *pulled;
+    ndHeap_t q[2];
+
+    locked = (int_t *) nd_malloc((12 * nv + 1) * sizeof(int_t));
+    mvtx = locked + nv;
+    mside = mvtx + nv;
+    mcnt = mside + nv;
+    pulled = mcnt + nv;
+    for (t = 0; t < 2; ++t) {
+        q[t].h = pulled + 2 * nv + 3 * t * nv; /* a vertex is pulled at
+                                                  most twice per pass */
+        q[t].pos = q[t].h + nv;
+        q[t].key = q[t].pos + nv;
+    }
+    limit = SUPERLU_MAX(20, SUPERLU_MIN(nv / 50, 200));
+
+    for (pass = 0; pass < ND_NPASS; ++pass) {
+        for (v = 0; v < nv; ++v) locked[v] = 0;
+        for (v = 0; v < nv; ++v) q[0].pos[v] = q[1].pos[v] = SLU_EMPTY;
+        q[0].n = q[1].n = 0;
+        for (v = 0; v < nv; ++v)
+            if ( where[v] == 2 )
+                for (t = 0; t < 2; ++t)
+                    nd_heap_set(&q[t], v, nd_sep_gain(g, where, v, t));
+
+        best = pw[2];
+        bestbal = SUPERLU_MAX(pw[0], pw[1]);
+        nmoves = npulled = bestmoves = bestpulled = 0;
+        while ( nmoves - bestmoves < limit ) {
+            /* The feasible move of largest gain, the lighter side first. */
+            for (t = 0; t < 2; ++t)
+                hv[t] = q[t].n && pw[t] + ND_VW(g, q[t].h[0]) <= maxw
+                        ? q[t].h[0] : SLU_EMPTY;
+            if ( hv[0] == SLU_EMPTY && hv[1] == SLU_EMPTY ) break;
+            if ( hv[0] == SLU_EMPTY ) t = 1;
+            else if ( hv[1] == SLU_EMPTY ) t = 0;
+            else if ( q[0].key[hv[0]] != q[1].key[hv[1]] )
+                t = q[0].key[hv[0]] > q[1].key[hv[1]] ? 0 : 1;
+            else t = pw[0] <= pw[1] ? 0 : 1;
+            v = hv[t];
+
+            nd_heap_remove(&q[0], v);
+            nd_heap_remove(&q[1], v);
+            locked[v] = 1;
+            where[v] = t;
+            pw[t] += ND_VW(g, v);
+            pw[2] -= ND_VW(g, v);
+            mvtx[nmoves] = v;
+            mside[nmoves] = t;
+            mcnt[nmoves] = 0;
+            /* v is now on side t: moving its separator neighbors to 1-t
+               would pull it back. */
+            for (j = g->xadj[v]; j < g->xadj[v+1]; ++j) {
+                u = g->adj[j];
+                if ( where[u] == 2 && q[1-t].pos[u] != SLU_EMPTY )
+                    nd_heap_set(&q[1-t], u, q[1-t].key[u] - ND_VW(g, v));
+            }
+            for (j = g->xadj[v]; j < g->xadj[v+1]; ++j) {
+                u = g->adj[j];
+                if ( where[u] != 1 - t ) continue;
+                where[u] = 2;
+                pw[1-t] -= ND_VW(g, u);
+                pw[2] += ND_VW(g, u);
+                pulled[npulled++] = u;
+                ++mcnt[nmoves];
+                if ( !locked[u] )
+                    for (i = 0; i < 2; ++i)
+                        nd_heap_set(&q[i], u, nd_sep_gain(g, where, u, i));
+                /* u left side 1-t: moving its separator neighbors to t
+                   now pulls less. */
+                for (k = g->xadj[u]; k < g->xadj[u+1]; ++k) {
+                    i = g->adj[k];
+                    if ( where[i] == 2 && i != u && q[t].pos[i] != SLU_EMPTY )
+                        nd_heap_set(&q[t], i, q[t].key[i] + ND_VW(g, u));
+                }
+            }
+            ++nmoves;
+
+            if ( pw[2] < best || (pw[2] == best
+                                  && SUPERLU_MAX(pw[0], pw[1]) < bestbal) ) {
+                best = pw[2];
+                bestbal = SUPERLU_MAX(pw[0], pw[1]);
+                bestmoves = nmoves;
+                bestpulled = npulled;
+            }
+        }
+
+        /* Undo the moves after the best point. */
+        while ( nmoves > bestmoves ) {
+            --nmoves;
+            v = mvtx[nmoves];
+            t = mside[nmoves];
+            for (k = 0; k < mcnt[nmoves]; ++k) {
+                u = pulled[--npulled];
+                where[u] = 1 - t;
+                pw[1-t] += ND_VW(g, u);
+                pw[2] -= ND_VW(g, u);
+            }
+            where[v] = 2;
+            pw[t] -= ND_VW(g, v);
+            pw[2] += ND_VW(g, v);
+        }
+        if ( bestmoves == 0 ) break;
+    }
+    SUPERLU_FREE(locked);
+}
+
+/*! \brief Compute a vertex separator of the unit-weight graph g:
+ * on exit where[v] is 0 or 1 for the two parts and 2 for the separator.
+ * The separator is found on the coarsest graph and refined on every
+ * level while it is projected back.
+ */
+static void nd_separator(ndGraph_t *g, int_t *where)
+{
+    ndGraph_t G[ND_MAXLVL];
+    int_t *cmap[ND_MAXLVL];
+    int_t *wc, *wf, pw[3], maxw, L, l, v, j, b0, b1, side;
+
+    /* Coarsen. */
+    G[0] = *g;
+    L = 0;
+    while ( G[L].nv > ND_COARSEST && L + 1 < ND_MAXLVL ) {
+        cmap[L] = (int_t *) nd_malloc(G[L].nv * sizeof(int_t));
+        nd_coarsen(&G[L], cmap[L], &G[L+1]);
+        if ( 20 * G[L+1].nv > 19 * G[L].nv ) { /* matching stalled */
+            nd_free_graph(&G[L+1]);
+            SUPERLU_FREE(cmap[L]);
+            break;
+        }
+        ++L;
+    }
+
+    /* Bisect the coarsest graph and turn the edge cut into a vertex
+       separator: the boundary of the side with fewer boundary vertices. */
+    maxw = (int_t) (ND_UBFACTOR * g->nv) + 1;
+    wc = L ? (int_t *) nd_malloc(G[L].nv * sizeof(int_t)) : where;
+    nd_bisect(&G[L], g->nv, wc, pw, maxw);
+    b0 = b1 = 0;
+    for (v = 0; v < G[L].nv; ++v)
+        for (j = G[L].xadj[v]; j < G[L].xadj[v+1]; ++j)
+            if ( wc[G[L].adj[j]] != wc[v] ) {
+                if ( wc[v] == 0 ) b0 += ND_VW(&G[L], v);
+                else b1 += ND_VW(&G[L], v);
+                break;
+            }
+    side = b0 <= b1 ? 0 : 1;
+    for (v = 0; v < G[L].nv; ++v) {
+        if ( wc[v] != side ) continue;
+        for (j = G[L].xadj[v]; j < G[L].xadj[v+1]; ++j)
+            if ( wc[G[L].adj[j]] == 1 - side ) {
+                wc[v] = 2;
+                break;
+            }
+    }
+    pw[0] = pw[1] = pw[2] = 0;
+    for (v = 0; v < G[L].nv; ++v) pw[wc[v]] += ND_VW(&G[L], v);
+    nd_refine_sep(&G[L], wc, pw, maxw);
+
+    /* Project back: both halves of a coarse vertex keep its label. */
+    for (l = L - 1; l >= 0; --l) {
+        wf = l ? (int_t *) nd_malloc(G[l].nv * sizeof(int_t)) : where;
+        for (v = 0; v < G[l].nv; ++v) wf[v] = wc[cmap[l][v]];
+        SUPERLU_FREE(wc);
+        nd_free_graph(&G[l+1]);
+        SUPERLU_FREE(cmap[l]);
+        nd_refine_sep(&G[l], wf, pw, maxw);
+        wc = wf;
+    }
+}
+
+/*! \brief Subgraph of g induced by the vertices with where[v] == side. */
+static void nd_extract(ndGraph_t *g, int_t *gid, int_t *where, int_t side,
+                       int_t *lmap, ndGraph_t *sub, int_t **subgid)
+{
+    int_t v, j, k, nsub = 0, nnz = 0;
+
+    for (v = 0; v < g->nv; ++v)
+        if ( where[v] == side ) {
+            lmap[v] = nsub++;
+            for (j = g->xadj[v]; j < g->xadj[v+1]; ++j)
+                if ( where[g->adj[j]] == side ) ++nnz;
+        }
+    sub->nv = nsub;
+    sub->xadj = (int_t *) nd_malloc((nsub + 1) * sizeof(int_t));
+    sub->adj = (int_t *) nd_malloc(nnz * sizeof(int_t));
+    sub->vwgt = sub->ewgt = NULL;
+    *subgid = (int_t *) nd_malloc(nsub * sizeof(int_t));
+
+    k = 0;
+    sub->xadj[0] = 0;
+    for (v = 0; v < g->nv; ++v) {
+        if ( where[v] != side ) continue;
+        for (j = g->xadj[v]; j < g->xadj[v+1]; ++j)
+            if ( where[g->adj[j]] == side ) sub->adj[k++] = lmap[g->adj[j]];
+        (*subgid)[lmap[v]] = gid[v];
+        sub->xadj[lmap[v] + 1] = k;
+    }
+}
+
+static int_t nd_new_node(ndCtx_t *ctx, int_t own, int_t hi, int_t depth,
+                         int_t parent)
+{
+    int_t id;
+
+    if ( !ctx->want_tree ) return SLU_EMPTY;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+    id = ctx->nnodes++;
+    ctx->own[id] = own;
+    ctx->hi[id] = hi;
+    ctx->depth[id] = depth;
+    ctx->parent[id] = parent;
+    return id;
+}
+
+/*! \brief Order a leaf subgraph by multiple minimum degree. */
+static void nd_leaf(ndCtx_t *ctx, ndGraph_t *g, int_t *gid, int_t lo,
+                    int_t parent, int_t depth)
+{
+    int_t nv = g->nv, nnz = g->xadj[nv], v;
+    int_t delta = 0, maxint = 2147483647, nofsub;
+    int_t *xadj, *adjncy, *invp, *perm, *dhead, *qsize, *llist, *marker;
+
+    nd_new_node(ctx, lo, lo + nv, depth, parent);
+    if ( nnz == 0 ) {
+        for (v = 0; v < nv; ++v) ctx->perm_c[gid[v]] = lo + v;
+        return;
+    }
+
+    /* genmmd_dist_ takes 1-based input and destroys adjncy. */
+    xadj = (int_t *) nd_malloc((7 * nv + 1 + nnz) * sizeof(int_t));
+    invp = xadj + nv + 1;
+    perm = invp + nv;
+    dhead = perm + nv;
+    qsize = dhead + nv;
+    llist = qsize + nv;
+    marker = llist + nv;
+    adjncy = marker + nv;
+    for (v = 0; v <= nv; ++v) xadj[v] = g->xadj[v] + 1;
+    for (v = 0; v < nnz; ++v) adjncy[v] = g->adj[v] + 1;
+
+    genmmd_dist_(&nv, xadj, adjncy, invp, perm, &delta, dhead, qsize,
+                 llist, marker, &maxint, &nofsub);
+
+    for (v = 0; v < nv; ++v) ctx->perm_c[gid[v]] = lo + invp[v] - 1;
+    SUPERLU_FREE(xadj);
+}
+
+/*! \brief Order the subgraph g into positions lo .. lo+g->nv-1.
+ * g and gid (local to global vertex numbers) are freed on return.
+ */
+static void nd_order(ndCtx_t *ctx, ndGraph_t g, int_t *gid, int_t lo,
+                     int_t parent, int_t depth)
+{
+    int_t nv = g.nv, hi = lo + nv, na, nb, ns, v, k, node;
+    int_t *where, *lmap, *gidA, *gidB;
+    ndGraph_t gA, gB;
+
+    if ( nv <= ND_LEAF ) {
+        nd_leaf(ctx, &g, gid, lo, parent, depth);
+        nd_free_graph(&g);
+        SUPERLU_FREE(gid);
+        return;
+    }
+
+    where = (int_t *) nd_malloc(2 * nv * sizeof(int_t));
+    lmap = where + nv;
+    nd_separator(&g, where);
+    na = nb = ns = 0;
+    for (v = 0; v < nv; ++v) {
+        if ( where[v] == 0 ) ++na;
+        else if ( where[v] == 1 ) ++nb;
+    }
+    ns = nv - na - nb;
+    if ( na == 0 || nb == 0 ) { /* no useful separator, e.g. a clique */
+        SUPERLU_FREE(where);
+        nd_leaf(ctx, &g, gid, lo, parent, depth);
+        nd_free_graph(&g);
+        SUPERLU_FREE(gid);
+        return;
+    }
+
+    /* The separator is numbered last. Its vertices adjacent to ancestor
+       separators go first: each of them brings its own row into the
+       structure, so keeping them together leaves the rest of the
+       separator as one wide supernode. */
+    node = nd_new_node(ctx, hi - ns, hi, depth, parent);
+    k = hi - ns;
+    for (v = 0; v < nv; ++v)
+        if ( where[v] == 2 && ctx->deg[gid[v]] > g.xadj[v+1] - g.xadj[v] )
+            ctx->perm_c[gid[v]] = k++;
+    for (v = 0; v < nv; ++v)
+        if ( where[v] == 2 && ctx->deg[gid[v]] == g.xadj[v+1] - g.xadj[v] )
+            ctx->perm_c[gid[v]] = k++;
+
+    nd_extract(&g, gid, where, 0, lmap, &gA, &gidA);
+    nd_extract(&g, gid, where, 1, lmap, &gB, &gidB);
+    SUPERLU_FREE(where);
+    nd_free_graph(&g);
+    SUPERLU_FREE(gid);
+
+#ifdef _OPENMP
+#pragma omp task if (na >= ND_TASK)
+#endif
+    nd_order(ctx, gA, gidA, lo, node, depth + 1);
+    nd_order(ctx, gB, gidB, lo + na, node, depth + 1);
+}
+
+/* Postorder key: own start, subtree end, then deeper first. */
+static int nd_node_cmp(const void *a, const void *b)
+{
+    const int_t *x = (const int_t *) a, *y = (const int_t *) b;
+    if ( x[0] != y[0] ) return x[0] < y[0] ? -1 : 1;
+    if ( x[1] != y[1] ) return x[1] < y[1] ? -1 : 1;
+    if ( x[2] != y[2] ) return x[2] > y[2] ? -1 : 1;
+    return 0;
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * GET_PERM_C_ND computes a nested-dissection ordering of the n-by-n
+ * symmetric structure (b_colptr, b_rowind), e.g. A'+A from
+ * at_plus_a_dist(), without the diagonal. It needs no third-party
+ * library and runs on the OpenMP threads of the calling process.
+ * As in get_metis_dist(), b_colptr and b_rowind are freed on exit.
+ *
+ * perm_c  (output) int_t*, size n
+ *         perm_c[i] = j means column i is in position j.
+ *
+ * septree (output) ndSepTree_t*
+ *         If not NULL, the separator tree of the ordering; free it with
+ *         Destroy_ndSepTree().
+ * </pre>
+ */
+void
+get_perm_c_nd(int_t n, int_t bnz, int_t *b_colptr, int_t *b_rowind,
+              int_t *perm_c, ndSepTree_t *septree)
+{
+    ndCtx_t ctx;
+    ndGraph_t g;
+    int_t *gid, *key, *newid, i, k;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(0, "Enter get_perm_c_nd()");
+#endif
+
+    ctx.perm_c = perm_c;
+    ctx.want_tree = (septree != NULL);
+    ctx.nnodes = 0;
+    if ( ctx.want_tree ) {
+        /* Every internal node has two nonempty children: < 2n nodes. */
+        ctx.own = (int_t *) nd_malloc(8 * SUPERLU_MAX(n, 1) * sizeof(int_t));
+        ctx.hi = ctx.own + 2 * n;
+        ctx.depth = ctx.hi + 2 * n;
+        ctx.parent = ctx.depth + 2 * n;
+    }
+
+    g.nv = n;
+    g.xadj = b_colptr;
+    g.adj = bnz ? b_rowind : (int_t *) nd_malloc(sizeof(int_t));
+    g.vwgt = g.ewgt = NULL;
+    gid = (int_t *) nd_malloc(n * sizeof(int_t));
+    ctx.deg = (int_t *) nd_malloc(n * sizeof(int_t));
+    for (i = 0; i < n; ++i) {
+        gid[i] = i;
+        ctx.deg[i] = b_colptr[i+1] - b_colptr[i];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#pragma omp single
+#endif
+    nd_order(&ctx, g, gid, 0, SLU_EMPTY, 0);
+    SUPERLU_FREE(ctx.deg);
+
+    if ( ctx.want_tree ) {
+        /* Renumber the nodes in postorder. */
+        key = (int_t *) nd_malloc(5 * SUPERLU_MAX(ctx.nnodes, 1) * sizeof(int_t));
+        newid = key + 4 * ctx.nnodes;
+        for (k = 0; k < ctx.nnodes; ++k) {
+            key[4*k] = ctx.own[k];
+            key[4*k+1] = ctx.hi[k];
+            key[4*k+2] = ctx.depth[k];
+            key[4*k+3] = k;
+        }
+        qsort(key, ctx.nnodes, 4 * sizeof(int_t), nd_node_cmp);
+        for (k = 0; k < ctx.nnodes; ++k) newid[key[4*k+3]] = k;
+
+        septree->nnodes = ctx.nnodes;
+        septree->fstVtx = intMalloc_dist(ctx.nnodes + 1);
+        septree->parent = intMalloc_dist(ctx.nnodes + 1);
+        for (k = 0; k < ctx.nnodes; ++k) {
+            i = key[4*k+3];
+            septree->fstVtx[k] = ctx.own[i];
+            septree->parent[k] = ctx.parent[i] == SLU_EMPTY ? SLU_EMPTY
+                                                        : newid[ctx.parent[i]];
+        }
+        septree->fstVtx[ctx.nnodes] = n;
+        SUPERLU_FREE(key);
+        SUPERLU_FREE(ctx.own);
+    }
+
+#if ( DEBUGlevel>=1 )
+    check_perm_dist("nd perm_c", n, perm_c);
+    CHECK_MALLOC(0, "Exit get_perm_c_nd()");
+#endif
+}
+
+void Destroy_ndSepTree(ndSepTree_t *septree)
+{
+    SUPERLU_FREE(septree->fstVtx);
+    SUPERLU_FREE(septree->parent);
+    septree->nnodes = 0;
+}
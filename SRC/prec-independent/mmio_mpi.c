@@ -0,0 +1,452 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief Parallel reading of Matrix Market files with MPI-IO
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Precision-independent part of the p[sdz]readMM_loc() readers. Process 0
+ * parses the header; the entries are then split in equal byte ranges, each
+ * process reads its range with MPI-IO and keeps the lines that start in it,
+ * parses them, and the entries are sent to the process owning their row in
+ * the block-row distribution used by the examples: each process gets
+ * m / nprocs consecutive rows, the last one also gets the remainder.
+ * </pre>
+ */
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include "superlu_defs.h"
+
+#define MM_IO_PIECE  (1 << 30)  /* largest single MPI-IO read, in bytes */
+#define MM_IO_TAIL   4096       /* read size used to complete the last line */
+
+/*! \brief Parse an integer in [p, end), skipping leading blanks.
+ *
+ * Returns the position after the integer, or NULL if there is none.
+ */
+const char *
+superlu_parse_int(const char *p, const char *end, int_t *val)
+{
+    int_t v = 0;
+    int neg = 0;
+    const char *q;
+
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    for (q = p; p < end && (unsigned) (*p - '0') < 10; ++p)
+	v = 10 * v + (*p - '0');
+    if (p == q) return NULL;
+    *val = neg ? -v : v;
+    return p;
+}
+
+/* Scan the decimal number starting at p. Returns the position after it,
+   with its leading 19 significant digits in *mant and the exponent of ten
+   to apply to them in *e10, or NULL if it has more digits or is not a
+   plain decimal number (inf, nan, hexadecimal). */
+static const char *
+scan_decimal(const char *p, const char *end, unsigned long long *mant,
+	     int *e10, int *neg)
+{
+    const char *q;
+    int ndig = 0, exact = 1, any = 0, eneg = 0, ev = 0;
+
+    *mant = 0;
+    *e10 = *neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) *neg = (*p++ == '-');
+    for ( ; p < end && (unsigned) (*p - '0') < 10; ++p, any = 1) {
+	if (ndig < 19) {
+	    *mant = 10 * *mant + (*p - '0');
+	    if (*mant) ++ndig;
+	} else {
+	    ++*e10; exact = 0;
+	}
+    }
+    if (p < end && *p == '.') {
+	for (++p; p < end && (unsigned) (*p - '0') < 10; ++p, any = 1) {
+	    if (ndig < 19) {
+		*mant = 10 * *mant + (*p - '0');
+		if (*mant) ++ndig;
+		--*e10;
+	    } else exact = 0;
+	}
+    }
+    if (!any) return NULL;
+    if (p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
+	++p;
+	if (p < end && (*p == '-' || *p == '+')) eneg = (*p++ == '-');
+	for (q = p; p < end && (unsigned) (*p - '0') < 10; ++p)
+	    if (ev < 100000) ev = 10 * ev + (*p - '0');
+	if (p == q) return NULL;
+	*e10 += eneg ? -ev : ev;
+    }
+    if (p < end && !isspace((unsigned char) *p)) return NULL;
+    return exact ? p : NULL;
+}
+
+/* Convert the number starting at tok with strtod(), or strtof() if fval
+   is not NULL. */
+static const char *
+scan_slow(const char *tok, const char *end, double *dval, float *fval)
+{
+    const char *p, *q;
+    char buf[64];
+    size_t len;
+
+    for (p = tok; p < end && !isspace((unsigned char) *p); ++p) ;
+    len = SUPERLU_MIN((size_t) (p - tok), sizeof(buf) - 1);
+    if (len == 0) return NULL;
+    memcpy(buf, tok, len);
+    buf[len] = '\0';
+    for (q = buf; *q; ++q)
+	if (*q == 'd' || *q == 'D') buf[q - buf] = 'e';
+    if (fval) *fval = strtof(buf, (char **) &q);
+    else *dval = strtod(buf, (char **) &q);
+    if (q == buf) return NULL;
+    return tok + (q - buf);
+}
+
+/*! \brief Parse a floating-point number in [p, end), skipping leading
+ * blanks.
+ *
+ * The digits are accumulated in a 64-bit integer and scaled by an exact
+ * power of ten, which is correctly rounded when the mantissa has at most
+ * 53 bits and the decimal exponent is at most 22 in magnitude. Other
+ * numbers (long mantissas, large exponents, inf, nan) go through strtod().
+ * Returns the position after the number, or NULL if there is none.
+ */
+const char *
+superlu_parse_double(const char *p, const char *end, double *val)
+{
+    static const double pow10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    const char *q;
+    unsigned long long mant;
+    int e10, neg;
+    double v;
+
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    q = scan_decimal(p, end, &mant, &e10, &neg);
+    if (!q || mant > (1ULL << 53) || e10 > 22 || e10 < -22)
+	return scan_slow(p, end, val, NULL);
+
+    v = (double) mant;
+    v = e10 < 0 ? v / pow10[-e10] : v * pow10[e10];
+    *val = neg ? -v : v;
+    return q;
+}
+
+/*! \brief Parse a single precision number in [p, end), skipping leading
+ * blanks.
+ *
+ * Same as superlu_parse_double(), with the exact cases of single
+ * precision: at most 24 bits of mantissa and exponents up to 10, so that
+ * the result is the same as strtof() without a double rounding.
+ */
+const char *
+superlu_parse_float(const char *p, const char *end, float *val)
+{
+    static const float pow10[] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+    const char *q;
+    unsigned long long mant;
+    int e10, neg;
+    float v;
+
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    q = scan_decimal(p, end, &mant, &e10, &neg);
+    if (!q || mant > (1ULL << 24) || e10 > 10 || e10 < -10)
+	return scan_slow(p, end, NULL, val);
+
+    v = (float) mant;
+    v = e10 < 0 ? v / pow10[-e10] : v * pow10[e10];
+    *val = neg ? -v : v;
+    return q;
+}
+
+/*! \brief Read the header of a Matrix Market file on process 0 and
+ * broadcast it.
+ *
+ * Returns 0 on success, and on all the processes of comm:
+ *   1 if the file cannot be opened,
+ *   2 if the header is not "%%MatrixMarket matrix coordinate ...",
+ *   3 if the size line cannot be read.
+ */
+int
+superlu_mm_read_header(char *filename, superlu_mm_header_t *hdr,
+		       MPI_Comm comm)
+{
+    long long buf[6];
+    int iam, info = 0;
+
+    MPI_Comm_rank(comm, &iam);
+    if ( !iam ) {
+	FILE *fp;
+	char line[512], banner[64], mtx[64], crd[64], arith[64], sym[64], *p;
+	long long m, n, nnz;
+
+	buf[0] = buf[1] = buf[2] = buf[5] = 0;
+	buf[3] = SLU_MM_REAL;
+	buf[4] = SLU_MM_GENERAL;
+	if ( !(fp = fopen(filename, "r")) ) {
+	    info = 1;
+	} else if ( !fgets(line, 512, fp) ) {
+	    info = 2;
+	} else {
+	    for (p = line; *p != '\0'; *p = tolower(*p), p++);
+	    if (sscanf(line, "%s %s %s %s %s", banner, mtx, crd, arith, sym) != 5
+		|| strcmp(banner, "%%matrixmarket") || strcmp(mtx, "matrix")
+		|| strcmp(crd, "coordinate")) {
+		info = 2;
+	    } else {
+		if ( !strcmp(arith, "complex") ) buf[3] = SLU_MM_COMPLEX;
+		else if ( !strcmp(arith, "integer") ) buf[3] = SLU_MM_INTEGER;
+		else if ( !strcmp(arith, "pattern") ) buf[3] = SLU_MM_PATTERN;
+		else if ( strcmp(arith, "real") ) info = 2;
+		if ( !strcmp(sym, "symmetric") ) buf[4] = SLU_MM_SYMMETRIC;
+		else if ( !strcmp(sym, "skew-symmetric") ) buf[4] = SLU_MM_SKEW;
+		else if ( !strcmp(sym, "hermitian") ) buf[4] = SLU_MM_HERMITIAN;
+		else if ( strcmp(sym, "general") ) info = 2;
+
+		/* Skip comments and blank lines */
+		do {
+		    if ( !fgets(line, 512, fp) ) { info = 3; break; }
+		} while (line[0] == '%' || strspn(line, " \t\r\n") == strlen(line));
+		if ( !info ) {
+		    if (sscanf(line, "%lld%lld%lld", &m, &n, &nnz) != 3) info = 3;
+		    buf[0] = m; buf[1] = n; buf[2] = nnz;
+		    buf[5] = (long long) ftell(fp);
+		}
+	    }
+	    fclose(fp);
+	}
+	if ( info == 1 )
+	    fprintf(stderr, "%s: cannot open file\n", filename);
+	else if ( info == 2 )
+	    fprintf(stderr, "%s: invalid Matrix Market header\n", filename);
+	else if ( info == 3 )
+	    fprintf(stderr, "%s: cannot read the matrix size\n", filename);
+    }
+    MPI_Bcast(&info, 1, MPI_INT, 0, comm);
+    if ( info ) return info;
+
+    MPI_Bcast(buf, 6, MPI_LONG_LONG_INT, 0, comm);
+    hdr->m = (int_t) buf[0];
+    hdr->n = (int_t) buf[1];
+    hdr->nnz = (int_t) buf[2];
+    hdr->field = (int) buf[3];
+    hdr->symmetry = (int) buf[4];
+    hdr->data_offset = buf[5];
+    return 0;
+}
+
+/*! \brief Read the entry lines owned by my process.
+ *
+ * The bytes after the header are split in nprocs equal ranges. A process
+ * owns the lines that start in its range; it reads its range collectively,
+ * plus the byte before it to find its first line, and then completes its
+ * last line with independent reads past the end of its range.
+ * On return, *len is the number of bytes of the returned buffer, which
+ * contains complete lines only. The buffer is freed with SUPERLU_FREE.
+ */
+char *
+superlu_mm_read_lines(char *filename, superlu_mm_header_t *hdr,
+		      MPI_Comm comm, size_t *len)
+{
+    MPI_File fh;
+    MPI_Offset fsize, beg, end, off, cnt;
+    MPI_Status status;
+    long long npieces, maxpieces, k;
+    size_t cap, nread, first, i;
+    char *buf;
+    int iam, nprocs, got, skip;
+
+    MPI_Comm_rank(comm, &iam);
+    MPI_Comm_size(comm, &nprocs);
+    if ( MPI_File_open(comm, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh)
+	 != MPI_SUCCESS )
+	ABORT("MPI_File_open fails.");
+    MPI_File_get_size(fh, &fsize);
+
+    /* My byte range [beg, end), extended by one byte on the left */
+    off = hdr->data_offset;
+    beg = off + (fsize - off) * iam / nprocs;
+    end = off + (fsize - off) * (iam + 1) / nprocs;
+    if ( (skip = (beg > off)) ) --beg;
+
+    cap = (size_t) (end - beg) + MM_IO_TAIL + 1;
+    if ( !(buf = (char *) SUPERLU_MALLOC(cap)) )
+	ABORT("Malloc fails for buf[].");
+
+    /* Collective reads of at most MM_IO_PIECE bytes */
+    npieces = (end - beg + MM_IO_PIECE - 1) / MM_IO_PIECE;
+    MPI_Allreduce(&npieces, &maxpieces, 1, MPI_LONG_LONG_INT, MPI_MAX, comm);
+    for (k = 0, nread = 0; k < maxpieces; ++k) {
+	cnt = SUPERLU_MIN(end - beg - (MPI_Offset) nread, MM_IO_PIECE);
+	MPI_File_read_at_all(fh, beg + nread, buf + nread, (int) cnt,
+			     MPI_CHAR, &status);
+	nread += cnt;
+    }
+
+    /* First line: the one following the first newline, unless my range
+       starts right after the header */
+    first = 0;
+    if ( skip ) {
+	while ( first < nread && buf[first] != '\n' ) ++first;
+	++first;
+    }
+
+    /* Complete the last line past the end of my range */
+    if ( first < nread && buf[nread - 1] != '\n' && end < fsize ) {
+	off = end;
+	do {
+	    if ( nread + MM_IO_TAIL + 1 > cap ) {
+		char *nbuf;
+		cap = 2 * cap + MM_IO_TAIL;
+		if ( !(nbuf = (char *) SUPERLU_MALLOC(cap)) )
+		    ABORT("Malloc fails for buf[].");
+		memcpy(nbuf, buf, nread);
+		SUPERLU_FREE(buf);
+		buf = nbuf;
+	    }
+	    cnt = SUPERLU_MIN(fsize - off, MM_IO_TAIL);
+	    MPI_File_read_at(fh, off, buf + nread, (int) cnt, MPI_CHAR,
+			     &status);
+	    MPI_Get_count(&status, MPI_CHAR, &got);
+	    for (i = 0; i < (size_t) got && buf[nread + i] != '\n'; ++i) ;
+	    nread += (i < (size_t) got) ? i + 1 : (size_t) got;
+	    off += got;
+	} while ( got > 0 && buf[nread - 1] != '\n' && off < fsize );
+    }
+    MPI_File_close(&fh);
+
+    if ( first > nread ) first = nread;
+    *len = nread - first;
+    if ( first ) memmove(buf, buf + first, *len);
+    buf[*len] = '\0';
+    return buf;
+}
+
+/*! \brief First row and number of rows of my process in the block-row
+ * distribution of m rows.
+ */
+void
+superlu_mm_block_rows(int_t m, int iam, int nprocs, int_t *m_loc,
+		      int_t *fst_row)
+{
+    int_t m_loc_fst = m / nprocs;
+
+    *fst_row = iam * m_loc_fst;
+    *m_loc = (iam == nprocs - 1) ? m - m_loc_fst * (nprocs - 1) : m_loc_fst;
+}
+
+/*! \brief Send the entries to the process owning their row, and build
+ * the local rows in compressed row format.
+ *
+ * ij[2*k], ij[2*k+1] are the 0-based row and column of entry k, whose
+ * value of valsz bytes is at val + k*valsz. The entries of a row are kept
+ * in the order they are received. rowptr[], colind[] and nzval[] are
+ * allocated here.
+ */
+void
+superlu_mm_distribute(int_t m, int_t nnz, int_t *ij, void *val,
+		      size_t valsz, MPI_Datatype valtype, MPI_Comm comm,
+		      int_t *m_loc, int_t *fst_row, int_t *nnz_loc,
+		      int_t **rowptr, int_t **colind, void **nzval)
+{
+    int iam, nprocs, p;
+    int *sendcnt, *recvcnt, *sdispls, *rdispls, *pos;
+    int_t m_loc_fst, k, i, nrecv, *sij, *rij, *xrow;
+    char *sval, *rval, *a;
+
+    MPI_Comm_rank(comm, &iam);
+    MPI_Comm_size(comm, &nprocs);
+    superlu_mm_block_rows(m, iam, nprocs, m_loc, fst_row);
+    m_loc_fst = m / nprocs;
+
+    if ( !(sendcnt = int32Malloc_dist(5 * nprocs)) )
+	ABORT("Malloc fails for sendcnt[].");
+    recvcnt = sendcnt + nprocs;
+    sdispls = recvcnt + nprocs;
+    rdispls = sdispls + nprocs;
+    pos     = rdispls + nprocs;
+
+#define MM_OWNER(r) ( m_loc_fst ? SUPERLU_MIN((r) / m_loc_fst, nprocs - 1) \
+		                : nprocs - 1 )
+    for (p = 0; p < nprocs; ++p) sendcnt[p] = 0;
+    for (k = 0; k < nnz; ++k) ++sendcnt[MM_OWNER(ij[2*k])];
+    MPI_Alltoall(sendcnt, 1, MPI_INT, recvcnt, 1, MPI_INT, comm);
+    sdispls[0] = rdispls[0] = 0;
+    for (p = 1; p < nprocs; ++p) {
+	sdispls[p] = sdispls[p-1] + sendcnt[p-1];
+	rdispls[p] = rdispls[p-1] + recvcnt[p-1];
+    }
+    nrecv = (int_t) rdispls[nprocs-1] + recvcnt[nprocs-1];
+    if ( (int_t) rdispls[nprocs-1] + recvcnt[nprocs-1] > INT_MAX )
+	ABORT("Too many entries received by one process.");
+
+    /* Pack the entries by destination */
+    sij = intMalloc_dist(2 * SUPERLU_MAX(nnz, 1));
+    sval = (char *) SUPERLU_MALLOC(SUPERLU_MAX(nnz, 1) * valsz);
+    rij = intMalloc_dist(2 * SUPERLU_MAX(nrecv, 1));
+    rval = (char *) SUPERLU_MALLOC(SUPERLU_MAX(nrecv, 1) * valsz);
+    if ( !sij || !sval || !rij || !rval )
+	ABORT("Malloc fails for the entries to exchange.");
+    for (p = 0; p < nprocs; ++p) pos[p] = sdispls[p];
+    for (k = 0; k < nnz; ++k) {
+	p = MM_OWNER(ij[2*k]);
+	sij[2*pos[p]] = ij[2*k];
+	sij[2*pos[p]+1] = ij[2*k+1];
+	memcpy(sval + pos[p] * valsz, (char *) val + k * valsz, valsz);
+	++pos[p];
+    }
+#undef MM_OWNER
+
+    MPI_Alltoallv(sval, sendcnt, sdispls, valtype,
+		  rval, recvcnt, rdispls, valtype, comm);
+    for (p = 0; p < nprocs; ++p) {
+	sendcnt[p] *= 2; sdispls[p] *= 2;
+	recvcnt[p] *= 2; rdispls[p] *= 2;
+    }
+    MPI_Alltoallv(sij, sendcnt, sdispls, mpi_int_t,
+		  rij, recvcnt, rdispls, mpi_int_t, comm);
+    SUPERLU_FREE(sij);
+    SUPERLU_FREE(sval);
+
+    /* Compressed row storage of my rows */
+    if ( !(xrow = intCalloc_dist(*m_loc + 1)) )
+	ABORT("Malloc fails for rowptr[].");
+    for (k = 0; k < nrecv; ++k) ++xrow[rij[2*k] - *fst_row + 1];
+    for (i = 0; i < *m_loc; ++i) xrow[i+1] += xrow[i];
+    *colind = intMalloc_dist(SUPERLU_MAX(nrecv, 1));
+    a = (char *) SUPERLU_MALLOC(SUPERLU_MAX(nrecv, 1) * valsz);
+    if ( !*colind || !a ) ABORT("Malloc fails for colind[] or nzval[].");
+    for (k = 0; k < nrecv; ++k) {
+	i = rij[2*k] - *fst_row;
+	(*colind)[xrow[i]] = rij[2*k+1];
+	memcpy(a + xrow[i] * valsz, rval + k * valsz, valsz);
+	++xrow[i];
+    }
+    for (i = *m_loc; i > 0; --i) xrow[i] = xrow[i-1];
+    xrow[0] = 0;
+
+    SUPERLU_FREE(rij);
+    SUPERLU_FREE(rval);
+    SUPERLU_FREE(sendcnt);
+    *rowptr = xrow;
+    *nzval = a;
+    *nnz_loc = nrecv;
+}
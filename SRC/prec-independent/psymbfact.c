@@ -73,7 +73,7 @@ symbfact_free
 
 static int_t
 denseSep_symbfact 
-(int , int_t, int, int, int, int_t *, int_t *, int, 
+(int , int_t, int, int, int, int, int_t *, int_t *, int, 
  int,  int, int_t, int_t, int_t *, int_t *, int_t *,
  int_t *, int_t *, MPI_Comm, MPI_Comm *, Llu_symbfact_t *,
  Pslu_freeable_t *_freeable, vtcsInfo_symbfact_t *, 
@@ -99,10 +99,10 @@ initLvl_symbfact
  int_t *, int_t, int_t);
 
 static void
-createComm (int, int, MPI_Comm *, MPI_Comm *);
+createComm (int, int, int *, int *, MPI_Comm *, MPI_Comm *);
 
 static void
-freeComm (int, int, MPI_Comm *, MPI_Comm *);
+freeComm (int, int, int *, int *, MPI_Comm *, MPI_Comm *);
 
 static void
 domain_symbfact
@@ -125,6 +125,10 @@ symbfact_alloc
 (superlu_dist_options_t *, int_t, int, Pslu_freeable_t *, Llu_symbfact_t *, 
  vtcsInfo_symbfact_t *, comm_symbfact_t *, psymbfact_stat_t *);
 
+static float 
+symbfact_mapNodes
+(int, int, int_t *, vtcsInfo_symbfact_t *, psymbfact_stat_t *);
+
 static float 
 symbfact_mapVtcs
 (int, int, int, SuperMatrix *, int_t *, int_t *, 
@@ -153,8 +157,7 @@ float symbfact_dist
 (
  superlu_dist_options_t *options,
  int         nprocs_num,  /* Input - no of processors */
- int         nprocs_symb, /* Input - no of processors for the symbolic
-			     factorization */
+ int         noDomains,   /* Input - no of leaves in the separator tree */
  SuperMatrix *A,          /* Input - distributed input matrix */
  int_t       *perm_c,     /* Input - column permutation */
  int_t       *perm_r,     /* Input - row permutation */
@@ -188,12 +191,13 @@ float symbfact_dist
  *         Number of processors SuperLU_DIST is executed on, and the input 
  *         matrix is distributed on.
  *
- * nprocs_symb (input) int
- *         Number of processors on which the symbolic factorization is
- *         performed.  It is equal to the number of independent domains
- *         idenfied in the graph partitioning algorithm executed
- *         previously and has to be a power of 2.  It corresponds to
- *         number of leaves in the separator tree.
+ * noDomains (input) int
+ *         Number of independent domains idenfied in the graph
+ *         partitioning algorithm executed previously.  It corresponds
+ *         to the number of leaves in the separator tree and has to be
+ *         a power of 2 not larger than nprocs_num.  The symbolic
+ *         factorization is performed on all the nprocs_num processors,
+ *         which do not need to be a power of 2.
  *
  * A       (input) SuperMatrix*
  *         Matrix A in A*X=B, of dimension (A->nrow, A->ncol). The
@@ -227,10 +231,13 @@ float symbfact_dist
  *         Communicator for numerical factorization 
  *
  * symb_comm (input) MPI_Comm*
- *         Communicator for symbolic factorization 
+ *         Communicator of the noDomains processors used by the graph
+ *         partitioning.  Not referenced, the symbolic factorization
+ *         communicates on a duplicate of num_comm.
  *
- * symb_mem_usage (input) superlu_dist_mem_usage_t *
- *         Statistics on memory usage.
+ * symb_mem_usage (output) superlu_dist_mem_usage_t *
+ *         Statistics on memory usage of my processor: for_lu, total,
+ *         expansions, and the global nnzL and nnzU.
  *
  * Return value
  * ============
@@ -240,26 +247,30 @@ float symbfact_dist
  * Sketch of the algorithm
  * =======================
  *
- *  Distrbute the vertices on the processors using a subtree to
- *  subcube algorithm.
+ *  Map the processors on the nodes of the separator tree, splitting
+ *  the processors of a node among its two children in proportion to
+ *  the estimated memory of their subtrees, and distribute the vertices
+ *  of each node on its processors.
  *
  *  Redistribute the structure of the input matrix A according to the
- *  subtree to subcube computed previously for the symbolic
- *  factorization routine.  This implies in particular a distribution
- *  from nprocs_num processors to nprocs_symb processors.
+ *  mapping computed previously for the symbolic factorization routine.
  *
  *  Perform symbolic factorization guided by the separator tree provided by
  *  a graph partitioning algorithm.  The symbolic factorization uses a 
  *  combined left-looking, right-looking approach. 
  * </pre>
  */
-  int iam, szSep, fstP, lstP, npNode, lvl, iSep, jSep;
+  int iam, szSep, fstP, lstP, lvl, iSep, jSep;
+  int nprocs_symb; /* no of processors for the symbolic factorization */
   int iinfo; /* return code */
   int_t n;
   int_t nextl, nextu, neltsZr, neltsTotal, nsuper_loc, szLGr, szUGr;
   int_t ind_blk, nsuper, vtx, szsn;
-  long long int nnzL, nnzU, nnzLU;
+  long long int nnzL, nnzU, nnzLU, nnz_loc[2], nnz_glob[2];
   float stat_loc[23], stat_glob[23], mem_glob[15];
+#if ( PRNTlevel>=1 )
+  struct { float val; int rank; } mem_loc, mem_max;
+#endif
   
   Llu_symbfact_t Llu_symbfact; /* local L and U and pruned L and U data structures */
   vtcsInfo_symbfact_t VInfo; /* local information on number of blocks,
@@ -279,6 +290,7 @@ float symbfact_dist
   int_t fill_rcmd; /* fill ratio */
   float totalMemLU, overestimMem;
   MPI_Comm *commLvls;  
+  MPI_Comm psymb_comm; /* duplicate of num_comm used for communication */
 
   /* maximum block size */
   int_t  maxSzBlk;
@@ -293,17 +305,18 @@ float symbfact_dist
   
   /* Initialization */
   MPI_Comm_rank ((*num_comm), &iam);
+  nprocs_symb = nprocs_num;
   commLvls = NULL;
 #if ( DEBUGlevel>=1 )
   CHECK_MALLOC(iam, "Enter psymbfact()");
 #endif
   initParmsAndStats (options, &PS);
   if (nprocs_symb != 1) {
-    if (!(commLvls = (MPI_Comm *) SUPERLU_MALLOC(2*nprocs_symb*sizeof(MPI_Comm)))) {
+    if (!(commLvls = (MPI_Comm *) SUPERLU_MALLOC(2*noDomains*sizeof(MPI_Comm)))) {
       fprintf (stderr, "Malloc fails for commLvls[].");  
       return (PS.allocMem);
     }
-    PS.allocMem += 2 * nprocs_symb * sizeof(MPI_Comm);
+    PS.allocMem += 2 * noDomains * sizeof(MPI_Comm);
   }
   
 #if ( PROFlevel>=1 )
@@ -324,7 +337,7 @@ float symbfact_dist
   VInfo.maxSzBlk = sp_ienv_dist(3, options);
   maxSzBlk = VInfo.maxSzBlk;
   
-  mark = SLU_EMPTY;
+  mark = 0;
   nsuper_loc = 0;
   nextl   = 0; nextu      = 0;
   neltsZr = 0; neltsTotal = 0;
@@ -342,9 +355,14 @@ float symbfact_dist
   t = SuperLU_timer_();
 #endif
   
+  /* Map processors on the nodes of the separator tree */
+  if ((flinfo = symbfact_mapNodes (nprocs_symb, noDomains, sizes, 
+				   &VInfo, &PS)) > 0)
+      return (flinfo);
+
   /* Distribute vertices on processors */
   if ((flinfo = 
-       symbfact_mapVtcs (iam, nprocs_num, nprocs_symb, A, fstVtxSep, sizes, 
+       symbfact_mapVtcs (iam, nprocs_num, noDomains, A, fstVtxSep, sizes, 
 			 Pslu_freeable, &VInfo, tempArray, maxSzBlk, &PS)) > 0) 
       return (flinfo); /* Number of bytes alllocated so far when run out of memory */
 
@@ -360,6 +378,7 @@ float symbfact_dist
   /* THE REST OF THE SYMBOLIC FACTORIZATION IS EXECUTED ONLY BY NPROCS_SYMB
      PROCESSORS */
   if ( iam < nprocs_symb ) {
+    MPI_Comm_dup ((*num_comm), &psymb_comm);
     
 #if ( PROFlevel>=1 )
     t_symbFact_loc[0] = SuperLU_timer_() - t;
@@ -396,12 +415,13 @@ float symbfact_dist
     SUPERLU_FREE( AS.ind_asup );  
 
     if (nprocs_symb != 1) {
-      createComm (iam, nprocs_symb, commLvls, symb_comm);    
+      createComm (iam, noDomains, VInfo.fstPSep, VInfo.lstPSep, 
+		  commLvls, &psymb_comm);
 
 #if ( PROFlevel>=1 )
       t_symbFact_loc[2] = SuperLU_timer_();
 #endif
-      if ((flinfo = cntsVtcs (n, iam, nprocs_symb, Pslu_freeable, &Llu_symbfact, 
+      if ((flinfo = cntsVtcs (n, iam, noDomains, Pslu_freeable, &Llu_symbfact, 
 			      &VInfo, tempArray, fstVtxSep, sizes, &PS, commLvls)) > 0) 
 	return (flinfo);
 			     
@@ -414,21 +434,23 @@ float symbfact_dist
     for (i = 0; i < n; i++)
       tempArray[i] = SLU_EMPTY;
     
-    szSep = nprocs_symb;
+    szSep = noDomains;
     iSep = 0;
     lvl = 0;
     while (szSep >= 1) {
       /* for each level in the separator tree */
-      npNode = nprocs_symb / szSep; 
-      fstP = 0; 
       /* for each node in the level */
       for (jSep = iSep; jSep < iSep + szSep; jSep++) {
 	fstVtx = fstVtxSep[jSep];
 	lstVtx  = fstVtx + sizes[jSep];
+	fstP = VInfo.fstPSep[jSep];
+	lstP = VInfo.lstPSep[jSep];
 	/* if this is the first level */
-	if (szSep == nprocs_symb) {
-	  /* compute symbolic factorization for my domain */
-	  if (fstP == iam) {
+	if (szSep == noDomains) {
+	  /* compute symbolic factorization for my domain, the other
+	     processors affected to this leaf own no vertex of it */
+	  if (fstP <= iam && iam < lstP) {
+	    if (iam != fstP) lstVtx = fstVtx;
 	    /* allocate storage for the pruned structures */
 #if ( PROFlevel>=1 )
 	    t1 = SuperLU_timer_();
@@ -457,7 +479,6 @@ float symbfact_dist
 	  }
 	}
 	else {
-	  lstP = fstP + npNode;
 	  if (fstP <= iam && iam < lstP) {
 #if ( PROFlevel>=1 )
 	    t1 = SuperLU_timer_();	  
@@ -474,7 +495,7 @@ float symbfact_dist
 			       iSep, jSep, sizes, fstVtxSep, 
 			       &nextl, &nextu, &nsuper_loc, &mark, tempArray,
 			       &Llu_symbfact, Pslu_freeable, &CS, &VInfo, &PS,
-			       commLvls[jSep], symb_comm);
+			       commLvls[jSep], &psymb_comm);
 #if ( PROFlevel>=1 )
 	    t1 = SuperLU_timer_();
 	    time_lvls[3*lvl+1] = t1 - t2;
@@ -484,14 +505,13 @@ float symbfact_dist
 		(A, iam, lvl, szSep, iSep, jSep, sizes, fstVtxSep, fstP, lstP, 
 		 fstVtx, lstVtx, Pslu_freeable, &Llu_symbfact, &VInfo, &CS, &PS,
 		 tempArray, &mark, &nextl, &nextu, &neltsZr, &neltsTotal, 
-		 &nsuper_loc, commLvls[jSep], symb_comm);
+		 &nsuper_loc, commLvls[jSep], &psymb_comm);
 #if ( PROFlevel>=1 )
 	    t2 = SuperLU_timer_();
 	    time_lvls[3*lvl+2] = t2 - t1;		 
 #endif
 	  }
 	}
-	fstP += npNode;
       }
       iSep += szSep;
       szSep = szSep / 2;
@@ -577,6 +597,17 @@ float symbfact_dist
     estimate_memUsage (n, iam,  symb_mem_usage, 
 		       &totalMemLU, &overestimMem, 
 		       Pslu_freeable, &Llu_symbfact, &VInfo, &CS, &PS);
+
+    /* Collect the number of nonzeros in L and U */
+    nnz_loc[0] = nnzL; nnz_loc[1] = nnzU;
+    MPI_Allreduce (nnz_loc, nnz_glob, 2, MPI_LONG_LONG_INT, 
+		   MPI_SUM, psymb_comm);
+    Pslu_freeable->nnzLU = nnz_glob[0] + nnz_glob[1];
+    symb_mem_usage->nnzL = nnz_glob[0];
+    symb_mem_usage->nnzU = nnz_glob[1];
+    symb_mem_usage->expansions = (int) (Llu_symbfact.no_expand + 
+					Llu_symbfact.no_expcp +
+					Llu_symbfact.no_expand_pr);
 #if ( PRNTlevel>=1 )
     stat_loc[0] = (float) nnzL;
     stat_loc[1] = (float) nnzU;  
@@ -604,9 +635,9 @@ float symbfact_dist
     stat_loc[22] = PS.fill_pelt[5];
     
     MPI_Allreduce (stat_loc, stat_glob, 23, MPI_FLOAT, 
-		MPI_SUM,  (*symb_comm));
+		MPI_SUM,  (psymb_comm));
     MPI_Allreduce (&(stat_loc[5]), mem_glob, 14, MPI_FLOAT, 
-		MPI_MAX,  (*symb_comm));
+		MPI_MAX,  (psymb_comm));
     fill_rcmd = (int_t) mem_glob[10];
     PS.fill_pelt[0] = stat_glob[19];
     PS.fill_pelt[1] = mem_glob[12];
@@ -616,13 +647,18 @@ float symbfact_dist
     PS.fill_pelt[5] = stat_glob[22];
     if (PS.fill_pelt[2] == 0.) PS.fill_pelt[2] = 1.;
     if (PS.fill_pelt[5] == 0.) PS.fill_pelt[5] = 1.;
+    /* peak memory per processor, and the processor reaching it */
+    mem_loc.val = totalMemLU;
+    mem_loc.rank = iam;
+    MPI_Reduce (&mem_loc, &mem_max, 1, MPI_FLOAT_INT, 
+		MPI_MAXLOC, 0, psymb_comm);
     
 #if ( PROFlevel>=1 )
     MPI_Reduce (t_symbFact_loc, t_symbFact, 3, MPI_DOUBLE,
-		MPI_MAX, 0, (*symb_comm));
+		MPI_MAX, 0, (psymb_comm));
     MPI_Gather (time_lvls, 3 * nlvls, MPI_DOUBLE,
 		time_lvlsT, 3 * nlvls , MPI_DOUBLE,
-		0, (*symb_comm));
+		0, (psymb_comm));
 #endif
     
     stat_msgs_l[0] = (float) PS.maxsz_msgSnd;
@@ -639,15 +675,14 @@ float symbfact_dist
     stat_msgs_l[8] = PS.sz_msgsSnd;
     stat_msgs_l[9] = PS.sz_msgsSnd + PS.sz_msgsCol;
     MPI_Reduce (stat_msgs_l, stat_msgs_g, 4, MPI_FLOAT,
-		MPI_MAX, 0, (*symb_comm));
+		MPI_MAX, 0, (psymb_comm));
     MPI_Reduce (&(stat_msgs_l[4]), &(stat_msgs_g[4]), 6, MPI_FLOAT,
-		MPI_SUM, 0, (*symb_comm));
+		MPI_SUM, 0, (psymb_comm));
     if (stat_msgs_g[6] == 0) stat_msgs_g[6] = 1;
     if (stat_msgs_g[7] == 0) stat_msgs_g[7] = 1;
     
-	Pslu_freeable->nnzLU=(long long) stat_glob[0]+(long long) stat_glob[1];					
     if (!iam) {
-      nnzL   = (long long) stat_glob[0]; nnzU  = (long long) stat_glob[1];
+      nnzL   = nnz_glob[0]; nnzU  = nnz_glob[1];
       nsuper = (int_t) stat_glob[2];
       szLGr  = (int_t) stat_glob[3]; szUGr = (int_t) stat_glob[4];
       printf("\tMax szBlk          %ld\n", (long) VInfo.maxSzBlk);
@@ -667,8 +702,8 @@ float symbfact_dist
       printf("\tSize of G(U)   %ld\n", (long) szUGr);
       printf("\tSize of G(L+U) %ld\n", (long) (szLGr+szUGr));
 
-      printf("\tParSYMBfact (MB)      :\tL\\U MAX %.2f\tAVG %.2f\n",
-	     mem_glob[0]*1e-6, 
+      printf("\tParSYMBfact (MB)      :\tL\\U MAX %.2f (PE %d)\tAVG %.2f\n",
+	     mem_max.val*1e-6, mem_max.rank,
 	     stat_glob[5]/nprocs_symb*1e-6);
       /* the allocated memory recorded by PS.allocMem is still needed in distribution */
       printf("\t\tworking memory PS.allocMem (MB):\t%.2f\n", PS.allocMem*1e-6);
@@ -762,6 +797,10 @@ float symbfact_dist
        but seems does not free PS.allocMem part
     */
     symbfact_free (iam, nprocs_symb, &Llu_symbfact, &VInfo, &CS);
+    if (nprocs_symb != 1) 
+      freeComm (iam, noDomains, VInfo.fstPSep, VInfo.lstPSep, 
+		commLvls, &psymb_comm);
+    MPI_Comm_free (&psymb_comm);
   } /* if (iam < nprocs_symb) */  
   else {
     /* update Pslu_freeable before returning */
@@ -776,10 +815,10 @@ float symbfact_dist
     PS.allocMem -= n * sizeof(int_t);
   }
 
-  if (iam < nprocs_symb && nprocs_symb != 1) 
-    freeComm (iam, nprocs_symb, commLvls, symb_comm);     
   if (commLvls != NULL)
     SUPERLU_FREE( commLvls );
+  SUPERLU_FREE( VInfo.fstPSep ); /* lstPSep is in the same array */
+  PS.allocMem -= 2 * (2 * noDomains - 1) * sizeof(int);
   
 #if ( DEBUGlevel>=1 )
   CHECK_MALLOC(iam, "Exit psymbfact()");
@@ -851,7 +890,7 @@ cntsVtcs
 (
  int_t  n,           /* Input - order of the input matrix */
  int    iam,         /* Input - my processor number */
- int    nprocs_symb, /* Input - no of processors for symbolic factorization */
+ int    noDomains,   /* Input - no of leaves in the separator tree */
  Pslu_freeable_t *Pslu_freeable, /* Input -globToLoc and maxNvtcsPProc */
  Llu_symbfact_t  *Llu_symbfact, /* Input/Output -local L, U data structures */
  vtcsInfo_symbfact_t *VInfo,  /* Input - local info on vertices distribution */
@@ -873,7 +912,7 @@ cntsVtcs
  * </pre>
  */
 {
-  int   fstP, lstP, szSep, npNode, i, j;
+  int   fstP, lstP, szSep, i, j;
   int_t nvtcs_loc, ind_blk, vtx, vtx_lid, ii, jj, lv, vtx_elt, cur_blk;
   int_t fstVtx, lstVtx, fstVtx_blk, lstVtx_blk;
   int_t nelts, nelts_new_blk;
@@ -903,19 +942,18 @@ cntsVtcs
   for (ii = 0; ii < nvtcs_loc; ii++)
     cntelt_vtcs[ii] = 0;
 
-  szSep = nprocs_symb;
+  szSep = noDomains;
   i = 0;
   cur_blk = 0;
   vtx_lid = 0;
   while (szSep >= 1) {
     /* for each level in the separator tree */
-    npNode = nprocs_symb / szSep; 
-    fstP = 0; 
     /* for each node in the level */
     for (j = i; j < i + szSep; j++) {
       fstVtx = fstVtxSep[j];
       lstVtx  = fstVtx + sizes[j];
-      lstP = fstP + npNode;
+      fstP = VInfo->fstPSep[j];
+      lstP = VInfo->lstPSep[j];
 
       if (fstP <= iam && iam < lstP) {      
 	ind_blk = cur_blk;
@@ -940,13 +978,13 @@ cntsVtcs
 	    }
 	  }	  
 	} 
-	if (szSep == nprocs_symb) 
+	if (szSep == noDomains) 
 	  vtx_lid = ii;
 	else {
 	  MPI_Allreduce (&(tempArray[fstVtx]), &(minElt_vtx[fstVtx]), 
 			 (int) (n - fstVtx), mpi_int_t, MPI_MIN, commLvls[j]);
 #if ( PRNTlevel>=1 )
-	  PS->no_msgsCol += (float) (2 * (int) LOG2( npNode ));
+	  PS->no_msgsCol += (float) (2 * (int) LOG2( lstP - fstP ));
 	  PS->sz_msgsCol += (float) (n - fstVtx);
 	  if (PS->maxsz_msgCol < n - fstVtx) 
 	    PS->maxsz_msgCol = n - fstVtx;      
@@ -985,10 +1023,9 @@ cntsVtcs
 	    }
 	    nelts += nelts_new_blk;
 	  }
-	} /* if (szSep != nprocs_symb) */
+	} /* if (szSep != noDomains) */
 	cur_blk = ind_blk;
       }
-      fstP += npNode;
     }
     i += szSep;
     szSep = szSep / 2;
@@ -1001,12 +1038,122 @@ cntsVtcs
   return (SUCCES_RET);
 } /* cntsVtcs */
 
+static float
+symbfact_mapNodes
+(
+ int nprocs,          /* Input -number of processors */
+ int noDomains,       /* Input -number of leaves in the separator tree */
+ int_t *sizes,        /* Input -size of each separator in the separator tree */
+ vtcsInfo_symbfact_t *VInfo, /* Output -fstPSep and lstPSep computed */
+ psymbfact_stat_t *PS /* Input/Output -statistics */
+ ) 
+{
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ *  symbfact_mapNodes maps the nprocs processors on the nodes of the
+ *  separator tree.  All the processors are affected to the root.  The
+ *  processors of a node are split between its two children in
+ *  proportion to the weight of their subtrees, where the weight of a
+ *  separator of size s whose ancestors have t vertices is
+ *  s * (s/2 + t), the number of elements of its columns of L (or rows
+ *  of U) when they are dense.  Each child keeps at least one processor
+ *  per leaf of its subtree, so that when nprocs equals noDomains this
+ *  is the subtree to subcube mapping.
+ * </pre>
+ *
+ * Return:  0 : ssuccess
+ *         >0 : number of bytes allocated during parallel symbolic factorization
+ *              when run out of memory
+ */
+  int nnodes, szSep, iSep, jSep, k, ch, np, np0, nleaves;
+  int *fstPSep, *lstPSep;
+  double *wgt, *anc, sz;
+
+  nnodes = 2 * noDomains - 1;
+  if (!(fstPSep = (int *) SUPERLU_MALLOC(2 * nnodes * sizeof(int)))) {
+    fprintf (stderr, "Malloc fails for fstPSep[].");
+    return (PS->allocMem);
+  }
+  PS->allocMem += 2 * nnodes * sizeof(int);
+  lstPSep = fstPSep + nnodes;
+  if (!(wgt = (double *) SUPERLU_MALLOC(2 * nnodes * sizeof(double)))) {
+    fprintf (stderr, "Malloc fails for wgt[].");
+    return (PS->allocMem);
+  }
+  anc = wgt + nnodes;
+
+  /* number of vertices in the ancestors of each node */
+  anc[nnodes - 1] = 0.;
+  iSep = nnodes - 1;
+  szSep = 1;
+  while (szSep < noDomains) {
+    ch = iSep - 2 * szSep;
+    for (jSep = iSep; jSep < iSep + szSep; jSep++) {
+      k = ch + 2 * (jSep - iSep);
+      anc[k] = anc[jSep] + (double) sizes[jSep];
+      anc[k + 1] = anc[k];
+    }
+    iSep = ch;
+    szSep *= 2;
+  }
+
+  /* weight of the subtree rooted at each node */
+  for (jSep = 0; jSep < noDomains; jSep++)
+    wgt[jSep] = 0.;
+  iSep = 0;
+  szSep = noDomains;
+  while (szSep > 1) {
+    for (k = iSep, jSep = iSep + szSep; k < iSep + szSep; k += 2, jSep++) {
+      sz = (double) sizes[jSep];
+      wgt[jSep] = sz * (sz / 2. + anc[jSep]) + wgt[k] + wgt[k + 1];
+    }
+    iSep += szSep;
+    szSep /= 2;
+  }
+
+  /* split the processors of each node between its children */
+  fstPSep[nnodes - 1] = 0;
+  lstPSep[nnodes - 1] = nprocs;
+  iSep = nnodes - 1;
+  szSep = 1;
+  nleaves = noDomains / 2;
+  while (szSep < noDomains) {
+    ch = iSep - 2 * szSep;
+    for (jSep = iSep; jSep < iSep + szSep; jSep++) {
+      k = ch + 2 * (jSep - iSep);
+      np = lstPSep[jSep] - fstPSep[jSep];
+      if (wgt[k] + wgt[k + 1] > 0.)
+	np0 = (int) ((double) np * wgt[k] / (wgt[k] + wgt[k + 1]) + 0.5);
+      else
+	np0 = np / 2;
+      np0 = SUPERLU_MAX( np0, nleaves );
+      np0 = SUPERLU_MIN( np0, np - nleaves );
+      fstPSep[k] = fstPSep[jSep];
+      lstPSep[k] = fstPSep[k] + np0;
+      fstPSep[k + 1] = lstPSep[k];
+      lstPSep[k + 1] = lstPSep[jSep];
+    }
+    iSep = ch;
+    szSep *= 2;
+    nleaves /= 2;
+  }
+
+  SUPERLU_FREE (wgt);
+  VInfo->fstPSep = fstPSep;
+  VInfo->lstPSep = lstPSep;
+  return SUCCES_RET;
+} /* symbfact_mapNodes */
+
 static float
 symbfact_mapVtcs
 (
  int iam,             /* Input -process number */
  int nprocs_num,      /* Input -number of processors */
- int nprocs_symb,     /* Input -number of procs for symbolic factorization */
+ int noDomains,       /* Input -number of leaves in the separator tree */
  SuperMatrix *A,      /* Input -input distributed matrix A */
  int_t *fstVtxSep,    /* Input -first vertex in each separator */
  int_t *sizes,        /* Input -size of each separator in the separator tree */
@@ -1025,19 +1172,20 @@ symbfact_mapVtcs
  * =======
  *
  *  symbfact_mapVtcs maps the vertices of the graph of the input
- *  matrix A on nprocs_symb processors, using the separator tree
+ *  matrix A on nprocs_num processors, using the separator tree
  *  returned by a graph partitioning algorithm from the previous step
- *  of the symbolic factorization.  The number of processors
- *  nprocs_symb must be a power of 2.
+ *  of the symbolic factorization.
  *
  * Description of the algorithm
  * ============================
  *
- *  A subtree to subcube algorithm is used first to map the processors
- *  on the nodes of the separator tree.
+ *  The processors are mapped on the nodes of the separator tree by
+ *  symbfact_mapNodes.
  *
- *  For each node of the separator tree, its corresponding vertices
- *  are distributed on the processors affected to this node, using a
+ *  The vertices of a leaf are owned by the first processor affected
+ *  to it, the other processors of the leaf are kept for the upper
+ *  levels.  For each separator, its corresponding vertices are
+ *  distributed on the processors affected to this node, using a
  *  block cyclic distribution.
  *
  *  After the distribution, fields of the VInfo structure are
@@ -1049,7 +1197,7 @@ symbfact_mapVtcs
  *         >0 : number of bytes allocated during parallel symbolic factorization
  *              when run out of memory
  */
-  int szSep, npNode, firstP, p, iSep, jSep, ind_ap_s, ind_ap_d;
+  int szSep, npNode, firstP, lastP, p, iSep, jSep, ind_ap_s, ind_ap_d;
   int_t k, n, kk;
   int_t fstVtx, lstVtx;
   int_t ind_blk;
@@ -1073,20 +1221,20 @@ symbfact_mapVtcs
     return (PS->allocMem);
   }
   PS->allocMem += (n+1) * sizeof(int_t);
-  if (!(avail_pes = (int *) SUPERLU_MALLOC(nprocs_symb*sizeof(int)))) {
+  if (!(avail_pes = (int *) SUPERLU_MALLOC(nprocs_num*sizeof(int)))) {
     fprintf (stderr, "Malloc fails for avail_pes[].");
     return (PS->allocMem);
   }
-  PS->allocMem += nprocs_symb*sizeof(int);
-  if (!(vtcs_pe = (int_t *) SUPERLU_MALLOC(nprocs_symb*sizeof(int_t)))) {
+  PS->allocMem += nprocs_num*sizeof(int);
+  if (!(vtcs_pe = (int_t *) SUPERLU_MALLOC(nprocs_num*sizeof(int_t)))) {
     fprintf (stderr, "Malloc fails for vtcs_pe[].");
     return (PS->allocMem);
   }
-  PS->allocMem += nprocs_symb*sizeof(int_t);
+  PS->allocMem += nprocs_num*sizeof(int_t);
   
   /* Initialization */
   globToLoc[n] = n;  
-  for (p = 0; p < nprocs_symb; p++) {
+  for (p = 0; p < nprocs_num; p++) {
     vtcs_pe[p] = 0;
     avail_pes[p] = SLU_EMPTY;
   }
@@ -1096,22 +1244,24 @@ symbfact_mapVtcs
   maxNeltsVtx     = 0;
   
   /* distribute data among processors */
-  szSep = nprocs_symb;
+  szSep = noDomains;
   iSep = 0;
   while (szSep >= 1) {
     /* for each level in the separator tree */
-    npNode = nprocs_symb / szSep; 
-    firstP = 0; 
     nvtcsNds_loc = 0;
     
     for (jSep = iSep; jSep < iSep + szSep; jSep++) {
       /* for each node in the level */
       fstVtx = fstVtxSep[jSep];
       lstVtx = fstVtx + sizes[jSep];
-      if (firstP <= iam && iam < firstP + npNode)
+      firstP = VInfo->fstPSep[jSep];
+      lastP  = VInfo->lstPSep[jSep];
+      npNode = lastP - firstP;
+      if ((szSep == noDomains) ? firstP == iam : 
+	  (firstP <= iam && iam < lastP))
 	maxNeltsVtx += lstVtx - fstVtx;
 
-      if (szSep == nprocs_symb) {
+      if (szSep == noDomains) {
 	/* leaves of the separator tree */
 	for (k = fstVtx; k < lstVtx; k++) {
 	  globToLoc[k] = (int_t) firstP;
@@ -1122,15 +1272,21 @@ symbfact_mapVtcs
 	  if (fstVtx != lstVtx)
 	    nblks_loc ++;
 	}
+	/* the other processors of the leaf are used first at the
+	   next level */
+	if ((jSep - iSep) % 2 == 0) ind_ap_d = firstP;
+	for (p = firstP + 1; p < lastP; p ++) {
+	  avail_pes[ind_ap_d] = p; ind_ap_d ++;
+	}
       }
       else {
 	/* superior levels of the separator tree */
 	k = fstVtx;
 	noVtcsProc = maxSzBlk;
 	// fstVtxBlk = fstVtx;
-	if ((jSep - iSep) % 2 == 0) ind_ap_d = (jSep - iSep) * npNode;
+	if ((jSep - iSep) % 2 == 0) ind_ap_d = firstP;
 	/* first allocate processors from previous levels */	
-	for (ind_ap_s = (jSep-iSep) * npNode; ind_ap_s < (jSep-iSep+1) * npNode; ind_ap_s ++) {
+	for (ind_ap_s = firstP; ind_ap_s < lastP; ind_ap_s ++) {
 	  p = avail_pes[ind_ap_s];
 	  if (p != SLU_EMPTY && k < lstVtx) {
 	    /* for each column in the separator */	  
@@ -1156,7 +1312,7 @@ symbfact_mapVtcs
 	  }
 	} 
 	noBlk = 0;
-	p = firstP + npNode;
+	p = lastP;
 	while (k < lstVtx) {
 	  /* for each column in the separator */
 	  kk = 0;
@@ -1175,13 +1331,12 @@ symbfact_mapVtcs
 	  noBlk ++;
 	} /* while (k < lstVtx) */
 	/* Add the unused processors to the avail_pes list of pes */
-	for (p = p + 1; p < firstP + npNode; p ++) {
+	for (p = p + 1; p < lastP; p ++) {
 	  avail_pes[ind_ap_d] = p; ind_ap_d ++;
 	}
       }
-      firstP += npNode;
     }
-    if (maxNvtcsNds_loc < nvtcsNds_loc && szSep != nprocs_symb)
+    if (maxNvtcsNds_loc < nvtcsNds_loc && szSep != noDomains)
       maxNvtcsNds_loc = nvtcsNds_loc;
     iSep += szSep;
     szSep = szSep / 2;
@@ -1189,12 +1344,12 @@ symbfact_mapVtcs
   
 #if ( PRNTlevel>=2 )
   if (!iam)
-    PrintInt10 (" novtcs_pe", nprocs_symb, vtcs_pe);
+    PrintInt10 (" novtcs_pe", nprocs_num, vtcs_pe);
 #endif
   /* determine maximum number of vertices among processors */
   maxNvtcsPProc = vtcs_pe[0];
   vtcs_pe[0] = 0;
-  for (p = 1; p < nprocs_symb; p++) {
+  for (p = 1; p < nprocs_num; p++) {
     if (maxNvtcsPProc < vtcs_pe[p])
       maxNvtcsPProc = vtcs_pe[p];
     vtcs_pe[p] = 0;
@@ -1202,11 +1357,10 @@ symbfact_mapVtcs
 #if ( PRNTlevel>=2 )
   if (!iam)
     printf ("  MaxNvtcsPerProc %d MaxNvtcs/Avg %e\n\n", 
-	    maxNvtcsPProc, ((float) maxNvtcsPProc * nprocs_symb)/(float)n);
+	    maxNvtcsPProc, ((float) maxNvtcsPProc * nprocs_num)/(float)n);
 #endif
 
-  if (iam < nprocs_symb)
-    if (!(begEndBlks_loc = intMalloc_symbfact(2 * nblks_loc + 1)))
+  if (!(begEndBlks_loc = intMalloc_symbfact(2 * nblks_loc + 1)))
       ABORT("Malloc fails for begEndBlks_loc[].");
   
   ind_blk = 0;
@@ -1225,26 +1379,23 @@ symbfact_mapVtcs
       ind_blk += 2;
     }
   }
-  if (iam < nprocs_symb)
-    begEndBlks_loc[2 * nblks_loc] = n;
+  begEndBlks_loc[2 * nblks_loc] = n;
  
   SUPERLU_FREE (avail_pes);
   SUPERLU_FREE (vtcs_pe);
   
   Pslu_freeable->maxNvtcsPProc   = maxNvtcsPProc;
   Pslu_freeable->globToLoc       = globToLoc;
-  if (iam < nprocs_symb) {
-    VInfo->maxNvtcsNds_loc = maxNvtcsNds_loc;
-    VInfo->nblks_loc       = nblks_loc;
-    VInfo->nvtcs_loc       = nvtcs_loc;
-    VInfo->curblk_loc      = 0;
-    VInfo->maxNeltsVtx     = maxNeltsVtx;
-    VInfo->filledSep       = FALSE;
-    VInfo->xlsub_nextLvl   = 0;
-    VInfo->xusub_nextLvl   = 0;
-    VInfo->begEndBlks_loc  = begEndBlks_loc;
-    VInfo->fstVtx_nextLvl  = begEndBlks_loc[0];
-  }
+  VInfo->maxNvtcsNds_loc = maxNvtcsNds_loc;
+  VInfo->nblks_loc       = nblks_loc;
+  VInfo->nvtcs_loc       = nvtcs_loc;
+  VInfo->curblk_loc      = 0;
+  VInfo->maxNeltsVtx     = maxNeltsVtx;
+  VInfo->filledSep       = FALSE;
+  VInfo->xlsub_nextLvl   = 0;
+  VInfo->xusub_nextLvl   = 0;
+  VInfo->begEndBlks_loc  = begEndBlks_loc;
+  VInfo->fstVtx_nextLvl  = begEndBlks_loc[0];
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(iam, "Exit symbfact_mapVtcs()");
 #endif
@@ -3782,7 +3933,7 @@ dnsCurSep_symbfact
  int_t *sizes,     /* Input - sizes of each node in the separator tree */
  int_t *fstVtxSep, /* Input - first vertex of each node in the tree */
  int   szSep,
- int   npNode,
+ int   lvl,        /* Input - level of the current node in the tree */
  int_t rcvd_dnsSep,
  int_t *p_nextl,     
  int_t *p_nextu, 
@@ -3804,7 +3955,7 @@ dnsCurSep_symbfact
   int_t *sub, *xsub, *minElt_vtx;
   int_t mark, next, *x_newelts, *x_newelts_L, *x_newelts_U;
   int_t *newelts_L, *newelts_U, *newelts;
-  int_t *globToLoc, maxNvtcsPProc, lvl;
+  int_t *globToLoc, maxNvtcsPProc;
   int_t prval, kmin, kmax, maxElt, ktemp, prpos;
   float mem_dnsCS;
 
@@ -3820,7 +3971,6 @@ dnsCurSep_symbfact
   cur_blk = VInfo->curblk_loc;
   fstVtx_dns = VInfo->begEndBlks_loc[cur_blk];
   fstVtx_dns_lid = LOCAL_IND( globToLoc[fstVtx_dns] );
-  lvl = (int_t) LOG2( npNode );
   x_newelts_U = NULL;
   newelts_L = NULL;
   newelts_U = NULL;
@@ -3887,7 +4037,7 @@ dnsCurSep_symbfact
 		   n - lstVtx, mpi_int_t, MPI_MIN, ndCom);
 
 #if ( PRNTlevel>=1 )
-    PS->no_msgsCol += (float) (2 * (int_t) LOG2( npNode ));
+    PS->no_msgsCol += (float) (2 * lvl);
     PS->sz_msgsCol += (float) (n - lstVtx);
     if (PS->maxsz_msgCol < n - lstVtx) 
       PS->maxsz_msgCol = n - lstVtx;      
@@ -4170,6 +4320,7 @@ denseSep_symbfact
 		       =0 if myPE determined that separator is full */
  int_t n,           /* Input - order of the matrix */
  int   iam,         /* Input - my processor number */
+ int   lvl,         /* Input - level of the current node in the tree */
  int   ind_sizes1,
  int   ind_sizes2,
  int_t *sizes,     /* Input - sizes of each separator in the separator tree */
@@ -4255,7 +4406,7 @@ denseSep_symbfact
   if (VInfo->filledSep == FILLED_SEP) {
       if ( (mem_error = 
 	    dnsCurSep_symbfact (n, iam, ind_sizes1, ind_sizes2, sizes, fstVtxSep, 
-				szSep, lstP - fstP, rcvd_dnsSep, p_nextl, 
+				szSep, lvl, rcvd_dnsSep, p_nextl, 
 				p_nextu, p_mark, p_nsuper_loc, marker, ndCom,
 				Llu_symbfact, Pslu_freeable, VInfo, CS, PS)) )
       return (mem_error);
@@ -4692,15 +4843,17 @@ static void
 freeComm
 (
  int   iam,          /* Input -my processor number */
- int   nprocs,       /* Input -number of procs for the symbolic fact. */
+ int   noDomains,    /* Input -number of leaves in the separator tree */
+ int   *fstPSep,     /* Input -first processor of each node in the tree */
+ int   *lstPSep,     /* Input -last processor (+1) of each node in the tree */
  MPI_Comm *commLvls, /* Input -communicators for the nodes in the sep tree */
  MPI_Comm *symb_comm /* Input - communicator for symbolic factorization */
  )
 {
   int szSep, i, j;
-  int npNode, fstP, lstP, ind;
+  int ind;
 
-  i = 2 * nprocs - 2;
+  i = 2 * noDomains - 2;
   MPI_Comm_free (&(commLvls[i]));
   
   szSep = 2;
@@ -4708,15 +4861,11 @@ freeComm
   
   while (i > 0) {
     /* for each level in the separator tree */
-    npNode = nprocs / szSep; 
-    fstP = 0; 
     /* for each node in the level */
     for (j = i; j < i + szSep; j++) {
-      lstP = fstP + npNode;
-      if (fstP <= iam && iam < lstP) {
+      if (fstPSep[j] <= iam && iam < lstPSep[j]) {
 	ind = j;
       }
-      fstP += npNode;
     }
     MPI_Comm_free ( &(commLvls[ind]) );
     szSep *= 2;
@@ -4728,46 +4877,39 @@ static void
 createComm 
 (
  int   iam,          /* Input -my processor number */
- int   nprocs,       /* Input -number of procs for the symbolic factorization */
+ int   noDomains,    /* Input -number of leaves in the separator tree */
+ int   *fstPSep,     /* Input -first processor of each node in the tree */
+ int   *lstPSep,     /* Input -last processor (+1) of each node in the tree */
  MPI_Comm *commLvls, /* Output -communicators for the nodes in the sep tree */
  MPI_Comm *symb_comm
  )
 {
-  int szSep, i, j, *pranks;
-  int npNode, fstP, lstP, ind, col, key;
+  int szSep, i, j;
+  int ind, col, key;
   
-  for (i=0; i < 2*nprocs; i++)
+  for (i=0; i < 2*noDomains; i++)
     commLvls[i] = MPI_COMM_NULL;
 
-  /* Make a list of the processes in the new communicator. */
-  pranks = (int *) SUPERLU_MALLOC( nprocs * sizeof(int) );
-  
-  i = 2 * nprocs - 2;
+  i = 2 * noDomains - 2;
   MPI_Comm_dup ((*symb_comm), &(commLvls[i]));
   szSep = 2;
   i -= szSep;
 
   while (i > 0) {
     /* for each level in the separator tree */
-    npNode = nprocs / szSep; 
-    fstP = 0; 
     /* for each node in the level */
     for (j = i; j < i + szSep; j++) {
-      lstP = fstP + npNode;
-      if (fstP <= iam && iam < lstP) {
+      if (fstPSep[j] <= iam && iam < lstPSep[j]) {
 	ind = j;
-	key = iam - fstP;
-	col = fstP;
+	key = iam - fstPSep[j];
+	col = fstPSep[j];
       }
-      fstP += npNode;
     }
     MPI_Comm_split ((*symb_comm), col, key, &(commLvls[ind]) );
     
     szSep *= 2;
     i -= szSep;
   }
-  
-  SUPERLU_FREE (pranks);
 }
 
 static void
@@ -4993,7 +5135,7 @@ intraLvl_symbfact
   
     if (VInfo->filledSep) {
       mem_error = 
-	denseSep_symbfact (1, n, iam, ind_sizes1, ind_sizes2, sizes, fstVtxSep,
+	denseSep_symbfact (1, n, iam, lvl, ind_sizes1, ind_sizes2, sizes, fstVtxSep,
 			   szSep, fstP, lstP, fstVtx_blkCyc, nblk_loc,
 			   p_nextl, p_nextu, p_mark, p_nsuper_loc, marker,
 			   ndComm, symb_comm, Llu_symbfact, Pslu_freeable, VInfo, CS, PS);
@@ -5032,7 +5174,7 @@ intraLvl_symbfact
 	if (VInfo->filledSep == FILLED_SEPS) {
 	  for (p = fstP; p < lstP; p++)
 	    rcv_intraLvl[p] = maxNmsgsToRcv * VInfo->filledSep + rcv_intraLvl[p];
-	  denseSep_symbfact (0, n, iam, ind_sizes1, ind_sizes2, sizes, fstVtxSep,
+	  denseSep_symbfact (0, n, iam, lvl, ind_sizes1, ind_sizes2, sizes, fstVtxSep,
 			     szSep, fstP, lstP, fstVtx_blkCyc, nblk_loc,
 			     p_nextl, p_nextu, p_mark, p_nsuper_loc, marker, ndComm, 
 			     symb_comm, Llu_symbfact, Pslu_freeable, VInfo, CS, PS);
@@ -5220,7 +5362,7 @@ intraLvl_symbfact
 	    usub = Llu_symbfact->usub;
 	  }
 	  if (VInfo->filledSep == FILLED_SEP)
-	    denseSep_symbfact (0, n, iam, ind_sizes1, ind_sizes2, sizes, fstVtxSep,
+	    denseSep_symbfact (0, n, iam, lvl, ind_sizes1, ind_sizes2, sizes, fstVtxSep,
 			       szSep, fstP, lstP, fstVtx_blkCyc, nblk_loc,
 			       p_nextl, p_nextu, p_mark, p_nsuper_loc, marker, ndComm, 
 			       symb_comm, Llu_symbfact, Pslu_freeable, VInfo, CS, PS);
@@ -0,0 +1,194 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief Column maxima of a matrix distributed by rows
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Precision-independent part of p[sdz]gsequ_ruiz(). Column j is owned by
+ * the process owning row j. The partial maxima of the columns met in the
+ * local rows go to their owners with MPI_Neighbor_alltoallv() over a
+ * distributed graph, and the maxima of whole columns come back over the
+ * reverse graph, instead of an MPI_Allreduce() over all the columns.
+ * </pre>
+ */
+#include <stdlib.h>
+#include "superlu_defs.h"
+
+static int
+cmp_int_t(const void *a, const void *b)
+{
+    int_t x = *(const int_t *) a, y = *(const int_t *) b;
+    return x < y ? -1 : (x > y);
+}
+
+/* Position of v in the increasing array x[0:n-1]. */
+static int_t
+find_int_t(int_t *x, int_t n, int_t v)
+{
+    int_t lo = 0, hi = n, k;
+    while ( lo < hi ) {
+	k = (lo + hi) / 2;
+	if ( x[k] < v ) lo = k + 1; else hi = k;
+    }
+    return lo;
+}
+
+/*! \brief Set up the exchange of column maxima for a square matrix whose
+ * rows fst_row .. fst_row+m_loc-1 are stored in (rowptr, colind) on this
+ * process. Collective over grid->comm.
+ */
+void
+pxgsequ_colmax_init(int_t m_loc, int_t fst_row, int_t *rowptr,
+		    int_t *colind, gridinfo_t *grid, pxgsequ_colmax_t *cm)
+{
+    int procs = grid->nprow * grid->npcol, p, q, k, no, ni, nown;
+    int_t nnz_loc = rowptr[m_loc], i, s, mine[2], *fst, *ord;
+    int *cnt, *dests, *srcs;
+
+    /* The distinct columns of my rows, and the slot of each nonzero. */
+    if ( !(cm->col = intMalloc_dist(SUPERLU_MAX(nnz_loc, 1))) )
+	ABORT("Malloc fails for col[].");
+    for (i = 0; i < nnz_loc; ++i) cm->col[i] = colind[i];
+    qsort(cm->col, nnz_loc, sizeof(int_t), cmp_int_t);
+    for (i = 0, s = 0; i < nnz_loc; ++i)
+	if ( s == 0 || cm->col[i] != cm->col[s-1] ) cm->col[s++] = cm->col[i];
+    cm->nslot = s;
+    if ( !(cm->slot = intMalloc_dist(SUPERLU_MAX(nnz_loc, 1))) )
+	ABORT("Malloc fails for slot[].");
+    for (i = 0; i < nnz_loc; ++i)
+	cm->slot[i] = find_int_t(cm->col, cm->nslot, colind[i]);
+
+    /* The first rows of the processes having rows, in increasing order. */
+    if ( !(fst = intMalloc_dist(3 * procs)) )
+	ABORT("Malloc fails for fst[].");
+    ord = fst + 2 * procs;
+    mine[0] = fst_row;
+    mine[1] = m_loc;
+    MPI_Allgather(mine, 2, mpi_int_t, fst, 2, mpi_int_t, grid->comm);
+    for (p = 0, nown = 0; p < procs; ++p)
+	if ( fst[2*p+1] > 0 ) ord[nown++] = p;
+    for (p = 1; p < nown; ++p)  /* insertion sort on the first rows */
+	for (q = p; q > 0 && fst[2*ord[q-1]] > fst[2*ord[q]]; --q) {
+	    k = ord[q]; ord[q] = ord[q-1]; ord[q-1] = k;
+	}
+    cm->fst_col = fst_row;
+    cm->ncol = m_loc;
+
+    /* Count the slots of each owner; the slots are increasing, so that
+       the slots of an owner are contiguous. */
+    if ( !(cnt = SUPERLU_MALLOC(2 * procs * sizeof(int))) )
+	ABORT("Malloc fails for cnt[].");
+    for (p = 0; p < 2 * procs; ++p) cnt[p] = 0;
+    for (s = 0, q = 0; s < cm->nslot; ++s) {
+	while ( q < nown - 1 && cm->col[s] >= fst[2*ord[q+1]] ) ++q;
+	++cnt[ord[q]];
+    }
+    MPI_Alltoall(cnt, 1, MPI_INT, cnt + procs, 1, MPI_INT, grid->comm);
+
+    for (p = 0, no = 0, ni = 0; p < procs; ++p) {
+	if ( cnt[p] ) ++no;
+	if ( cnt[procs + p] ) ++ni;
+    }
+    cm->outdeg = no;
+    cm->indeg = ni;
+    if ( !(dests = SUPERLU_MALLOC((3 * (no + ni) + 2) * sizeof(int))) )
+	ABORT("Malloc fails for dests[].");
+    srcs = dests + no;
+    cm->SendCnt = srcs + ni;
+    cm->sdispls = cm->SendCnt + no;
+    cm->RecvCnt = cm->sdispls + no + 1;
+    cm->rdispls = cm->RecvCnt + ni;
+
+    /* Destinations in the order of their slots. */
+    cm->sdispls[0] = 0;
+    for (q = 0, no = 0; q < nown; ++q) {
+	p = ord[q];
+	if ( cnt[p] ) {
+	    dests[no] = p;
+	    cm->SendCnt[no] = cnt[p];
+	    cm->sdispls[no+1] = cm->sdispls[no] + cnt[p];
+	    ++no;
+	}
+    }
+    cm->rdispls[0] = 0;
+    for (p = 0, ni = 0; p < procs; ++p)
+	if ( cnt[procs + p] ) {
+	    srcs[ni] = p;
+	    cm->RecvCnt[ni] = cnt[procs + p];
+	    cm->rdispls[ni+1] = cm->rdispls[ni] + cnt[procs + p];
+	    ++ni;
+	}
+
+    /* The slot counts are the edge weights, as in pxgstrs_nbr_init();
+       the spare entries of dests[] keep them valid for a zero degree. */
+    MPI_Dist_graph_create_adjacent(grid->comm, ni, srcs, cm->RecvCnt,
+				   no, dests, cm->SendCnt, MPI_INFO_NULL,
+				   0, &cm->fwd);
+    MPI_Dist_graph_create_adjacent(grid->comm, no, dests, cm->SendCnt,
+				   ni, srcs, cm->RecvCnt, MPI_INFO_NULL,
+				   0, &cm->bwd);
+
+    /* The owners learn which of their columns my slots are. */
+    s = cm->rdispls[ni];
+    if ( !(cm->ridx = intMalloc_dist(SUPERLU_MAX(s, 1))) )
+	ABORT("Malloc fails for ridx[].");
+    if ( !(cm->rbuf = SUPERLU_MALLOC(SUPERLU_MAX(s, 1) * sizeof(double))) )
+	ABORT("Malloc fails for rbuf[].");
+    if ( !(cm->cmax = SUPERLU_MALLOC(SUPERLU_MAX(m_loc, 1) * sizeof(double))) )
+	ABORT("Malloc fails for cmax[].");
+    MPI_Neighbor_alltoallv(cm->col, cm->SendCnt, cm->sdispls, mpi_int_t,
+			   cm->ridx, cm->RecvCnt, cm->rdispls, mpi_int_t,
+			   cm->fwd);
+    for (i = 0; i < s; ++i) cm->ridx[i] -= fst_row;
+
+    SUPERLU_FREE(cnt);
+    SUPERLU_FREE(fst);
+}
+
+/*! \brief On entry smax[] holds the maxima over my rows of the columns
+ * cm->col[]; on exit the maxima over all the rows. The maxima of my own
+ * columns are left in cm->cmax[]. Collective over the neighbors.
+ */
+void
+pxgsequ_colmax(pxgsequ_colmax_t *cm, double *smax)
+{
+    int_t j, k, nr = cm->rdispls[cm->indeg];
+
+    MPI_Neighbor_alltoallv(smax, cm->SendCnt, cm->sdispls, MPI_DOUBLE,
+			   cm->rbuf, cm->RecvCnt, cm->rdispls, MPI_DOUBLE,
+			   cm->fwd);
+    for (j = 0; j < cm->ncol; ++j) cm->cmax[j] = 0.;
+    for (k = 0; k < nr; ++k) {
+	j = cm->ridx[k];
+	cm->cmax[j] = SUPERLU_MAX(cm->cmax[j], cm->rbuf[k]);
+    }
+    for (k = 0; k < nr; ++k) cm->rbuf[k] = cm->cmax[cm->ridx[k]];
+    MPI_Neighbor_alltoallv(cm->rbuf, cm->RecvCnt, cm->rdispls, MPI_DOUBLE,
+			   smax, cm->SendCnt, cm->sdispls, MPI_DOUBLE,
+			   cm->bwd);
+}
+
+void
+pxgsequ_colmax_free(pxgsequ_colmax_t *cm)
+{
+    MPI_Comm_free(&cm->fwd);
+    MPI_Comm_free(&cm->bwd);
+    /* SendCnt points past dests[] and srcs[] in the same allocation. */
+    SUPERLU_FREE(cm->SendCnt - (cm->outdeg + cm->indeg));
+    SUPERLU_FREE(cm->col);
+    SUPERLU_FREE(cm->slot);
+    SUPERLU_FREE(cm->ridx);
+    SUPERLU_FREE(cm->rbuf);
+    SUPERLU_FREE(cm->cmax);
+}
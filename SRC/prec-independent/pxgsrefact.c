@@ -0,0 +1,96 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief Supernodes affected by a change in a subset of the rows or
+ * columns of A
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Precision-independent part of p[sdz]gsrefact_mark(). With the static
+ * pivoting of pdgstrf(), a change of the entry (i,j) of Pc*Pr*A*Pc' only
+ * alters the panels L(:,k) and U(k,:) of the supernodes k on the path of
+ * the elimination tree from supno[min(i,j)] to the root, because the
+ * panel of a supernode depends only on its own entries and on the panels
+ * of its descendants.
+ * </pre>
+ */
+#include "superlu_defs.h"
+
+/*! \brief Mark the supernodes to refactor after the rows rows[0:nrow-1]
+ * and the columns cols[0:ncol-1] of A changed.
+ *
+ * <pre>
+ * A is distributed by rows (SLU_NR_loc) in its original ordering, i.e.
+ * as it is passed to p[sdz]gssvx(); row i of A is row perm_c[perm_r[i]]
+ * of the factored matrix and column j is column perm_c[j]. etree[] is the
+ * postordered elimination tree of the previous factorization. The lists
+ * of changed rows and columns may differ between processes; their union
+ * is used. Collective over grid->comm.
+ *
+ * On exit, (*mask)[k] = 1 if supernode k must be refactored, and the
+ * number of such supernodes is returned.
+ * </pre>
+ */
+int_t
+pxgsrefact_mask(int_t n, SuperMatrix *A, int_t *perm_r, int_t *perm_c,
+		int_t *etree, Glu_persist_t *Glu_persist, int_t nrow,
+		int_t *rows, int_t ncol, int_t *cols, gridinfo_t *grid,
+		int **mask)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+    int_t *rowptr = Astore->rowptr, *colind = Astore->colind;
+    int_t fst_row = Astore->fst_row, m_loc = Astore->m_loc;
+    int_t *supno = Glu_persist->supno, *xsup = Glu_persist->xsup;
+    int_t nsupers = supno[n-1] + 1, i, j, p, irow, jcol, k, *setree, nmark;
+    int *chg, *mark;
+
+    if ( !(chg = SUPERLU_MALLOC(n * sizeof(int))) )
+	ABORT("Malloc fails for chg[].");
+    if ( !(mark = SUPERLU_MALLOC(nsupers * sizeof(int))) )
+	ABORT("Malloc fails for mark[].");
+    for (j = 0; j < n; ++j) chg[j] = 0;
+    for (k = 0; k < nsupers; ++k) mark[k] = 0;
+
+    /* Bit 0: row changed, bit 1: column changed (original indices). */
+    for (i = 0; i < nrow; ++i) chg[rows[i]] |= 1;
+    for (j = 0; j < ncol; ++j) {
+	chg[cols[j]] |= 2;
+	mark[supno[perm_c[cols[j]]]] = 1;
+    }
+
+    /* Start the paths at the leading entry of every changed nonzero. */
+    for (i = 0; i < m_loc; ++i) {
+	irow = perm_c[perm_r[i + fst_row]];
+	if ( chg[i + fst_row] & 1 ) mark[supno[irow]] = 1;
+	for (p = rowptr[i]; p < rowptr[i+1]; ++p) {
+	    if ( !(chg[i + fst_row] & 1) && !(chg[colind[p]] & 2) ) continue;
+	    jcol = perm_c[colind[p]];
+	    mark[supno[SUPERLU_MIN(irow, jcol)]] = 1;
+	}
+    }
+    MPI_Allreduce(MPI_IN_PLACE, mark, nsupers, MPI_INT, MPI_MAX, grid->comm);
+
+    /* The parent of a supernode is numbered after it in the postorder,
+       so that one sweep closes the marks up to the root. */
+    setree = supernodal_etree(nsupers, etree, supno, xsup);
+    for (k = 0, nmark = 0; k < nsupers; ++k) {
+	if ( !mark[k] ) continue;
+	++nmark;
+	if ( setree[k] < nsupers ) mark[setree[k]] = 1;
+    }
+
+    SUPERLU_FREE(setree);
+    SUPERLU_FREE(chg);
+    *mask = mark;
+    return nmark;
+}
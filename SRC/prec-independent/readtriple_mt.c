@@ -0,0 +1,312 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief Multithreaded reading of triplet files
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * Precision-independent part of [sdz]readtriple_dist() and
+ * [sdz]readtriple_noheader(). The rest of the file is mapped in memory and
+ * split in one chunk of whole lines per OpenMP thread; the threads count
+ * the entries of their chunks, then parse them in place, so that the
+ * triplets keep the order of the file. The compressed column storage is
+ * built by a stable counting sort, giving the same arrays as the serial
+ * reader.
+ * </pre>
+ */
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "superlu_defs.h"
+
+#define TRIPLE_CHUNK  (1 << 20)  /* smallest chunk per thread, in bytes */
+
+/*! \brief Map the part of a file after the current position of fp.
+ *
+ * Returns the first byte after the position and its length in *len, with
+ * the mapping to release with superlu_unmap_stream() in *base and *size;
+ * or NULL if fp is not a regular file or there is nothing left to read,
+ * in which case the caller reads it with stdio. The position of fp is
+ * left unchanged.
+ */
+char *
+superlu_map_stream(FILE *fp, size_t *len, void **base, size_t *size)
+{
+    struct stat st;
+    long pos = ftell(fp);
+
+    if ( pos < 0 || fstat(fileno(fp), &st) || !S_ISREG(st.st_mode)
+	 || st.st_size <= pos ) return NULL;
+    *size = (size_t) st.st_size;
+    *base = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if ( *base == MAP_FAILED ) return NULL;
+    *len = *size - pos;
+    return (char *) *base + pos;
+}
+
+void
+superlu_unmap_stream(void *base, size_t size)
+{
+    munmap(base, size);
+}
+
+/* Skip the blanks of a line ending at eol. */
+static const char *
+skip_blanks(const char *p, const char *eol)
+{
+    while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+/* Parse "row col value" in [p, eol), or "row col real imag" for the
+   complex types, into entry k. Returns 0 on success. */
+static int
+parse_triple(const char *p, const char *eol, int dtype, int_t k,
+	     int_t *row, int_t *col, void *val)
+{
+    if ( !(p = superlu_parse_int(p, eol, &row[k])) ) return 1;
+    if ( !(p = superlu_parse_int(p, eol, &col[k])) ) return 1;
+    switch (dtype) {
+      case SLU_S:
+	  p = superlu_parse_float(p, eol, (float *) val + k);
+	  break;
+      case SLU_D:
+	  p = superlu_parse_double(p, eol, (double *) val + k);
+	  break;
+      case SLU_C:
+	  if ( (p = superlu_parse_float(p, eol, (float *) val + 2*k)) )
+	      p = superlu_parse_float(p, eol, (float *) val + 2*k+1);
+	  break;
+      case SLU_Z:
+	  if ( (p = superlu_parse_double(p, eol, (double *) val + 2*k)) )
+	      p = superlu_parse_double(p, eol, (double *) val + 2*k+1);
+	  break;
+    }
+    return p == NULL;
+}
+
+/*! \brief Parse the triplets of buf[0:len-1], one per nonblank line.
+ *
+ * At most maxnz triplets are stored in row[], col[] and val[], whose type
+ * is given by dtype (SLU_S, SLU_D, SLU_C or SLU_Z); with maxnz < 0 and
+ * row == NULL the triplets are only counted. Returns the number of
+ * triplets stored or counted, or -1 if a line cannot be parsed.
+ */
+int_t
+superlu_parse_triples(const char *buf, size_t len, int dtype, int_t maxnz,
+		      int_t *row, int_t *col, void *val)
+{
+    const char *end = buf + len, **bnd;
+    int_t *off, nz;
+    int nthr = 1, t, err = 0;
+
+#ifdef _OPENMP
+    nthr = (int) SUPERLU_MAX(1, SUPERLU_MIN((size_t) omp_get_max_threads(),
+					    len / TRIPLE_CHUNK));
+#endif
+    if ( !(bnd = (const char **) SUPERLU_MALLOC((nthr + 1) * sizeof(char *))) )
+	ABORT("Malloc fails for bnd[].");
+    if ( !(off = intMalloc_dist(nthr + 1)) )
+	ABORT("Malloc fails for off[].");
+
+    /* Chunk t starts at the first line starting at or after t*len/nthr. */
+    bnd[0] = buf;
+    bnd[nthr] = end;
+    for (t = 1; t < nthr; ++t) {
+	const char *p = buf + (len / nthr) * t;
+	if ( p[-1] != '\n' ) {
+	    p = memchr(p, '\n', end - p);
+	    p = p ? p + 1 : end;
+	}
+	bnd[t] = SUPERLU_MAX(p, bnd[t-1]);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
+#endif
+    {
+#ifdef _OPENMP
+	int tid = omp_get_thread_num();
+#else
+	int tid = 0;
+#endif
+	const char *p, *eol, *hi = bnd[tid+1];
+	int_t cnt = 0, k;
+
+	/* Count the nonblank lines of my chunk. */
+	for (p = bnd[tid]; p < hi; p = eol + 1) {
+	    if ( !(eol = memchr(p, '\n', hi - p)) ) eol = hi;
+	    if ( skip_blanks(p, eol) < eol ) ++cnt;
+	}
+	off[tid+1] = cnt;
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+	{
+	    off[0] = 0;
+	    for (t = 0; t < nthr; ++t) off[t+1] += off[t];
+	}
+
+	/* Parse them into their places in the file order. */
+	if ( row ) {
+	    k = off[tid];
+	    for (p = bnd[tid]; p < hi && (maxnz < 0 || k < maxnz); p = eol + 1) {
+		if ( !(eol = memchr(p, '\n', hi - p)) ) eol = hi;
+		if ( skip_blanks(p, eol) == eol ) continue;
+		if ( parse_triple(p, eol, dtype, k, row, col, val) ) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+		    err = 1;
+		    break;
+		}
+		++k;
+	    }
+	}
+    }
+
+    nz = maxnz < 0 ? off[nthr] : SUPERLU_MIN(off[nthr], maxnz);
+    SUPERLU_FREE(bnd);
+    SUPERLU_FREE(off);
+    return err ? -1 : nz;
+}
+
+/*! \brief Change the triplets to zero-based indexing if needed and check
+ * that they are inside an m-by-n matrix.
+ *
+ * Returns the first out-of-bound triplet, or -1 if there is none.
+ */
+int_t
+superlu_check_triples(int_t m, int_t n, int_t nnz, int zero_base,
+		      int_t *row, int_t *col)
+{
+    int_t k, bad = nnz;
+
+#ifdef _OPENMP
+#pragma omp parallel for reduction(min: bad)
+#endif
+    for (k = 0; k < nnz; ++k) {
+	if ( !zero_base ) {
+	    --row[k];
+	    --col[k];
+	}
+	if ( row[k] < 0 || row[k] >= m || col[k] < 0 || col[k] >= n )
+	    bad = SUPERLU_MIN(bad, k);
+    }
+    return bad < nnz ? bad : -1;
+}
+
+/* Threads used to sort nnz triplets on n columns: each one keeps a
+   count per column, so they should not cost more than the triplets. */
+static int
+csc_nthreads(int_t n, int_t nnz)
+{
+#ifdef _OPENMP
+    int_t nthr = SUPERLU_MIN(omp_get_max_threads(),
+			     nnz / SUPERLU_MAX(n, TRIPLE_CHUNK / 64));
+    return (int) SUPERLU_MAX(nthr, 1);
+#else
+    return 1;
+#endif
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Store the nnz zero-based triplets (row, col, val) of a matrix with n
+ * columns in compressed column format (xa, asub, a). The values have
+ * valsz bytes each. Each thread counts the columns of a contiguous block
+ * of triplets in its own slice of a count array (size nthr*n); a prefix
+ * sum over the columns and then over the threads gives every thread its
+ * own positions. Within each column the entries keep the order of the
+ * triplets, exactly as in a serial counting sort; duplicates are kept.
+ * </pre>
+ */
+void
+superlu_triples_to_csc(int_t n, int_t nnz, int_t *row, int_t *col,
+		       void *val, size_t valsz, int_t *xa, int_t *asub,
+		       void *a)
+{
+    int nthr = csc_nthreads(n, nnz);
+    int_t *cnt;
+
+    if ( !(cnt = intMalloc_dist((int_t) SUPERLU_MAX((size_t) nthr * n, 1))) )
+	ABORT("Malloc fails for cnt[].");
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
+#endif
+    {
+	int_t j, k, c, pos, lo, hi, *mycnt;
+#ifdef _OPENMP
+	int tid = omp_get_thread_num();
+#else
+	int tid = 0;
+#endif
+	int t;
+
+	lo = (int_t) (((long long) nnz * tid) / nthr);
+	hi = (int_t) (((long long) nnz * (tid + 1)) / nthr);
+	mycnt = cnt + (size_t) tid * n;
+	for (j = 0; j < n; ++j) mycnt[j] = 0;
+	for (k = lo; k < hi; ++k) ++mycnt[col[k]];
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp for
+#endif
+	for (j = 0; j < n; ++j) {
+	    c = 0;
+	    for (t = 0; t < nthr; ++t) c += cnt[(size_t) t * n + j];
+	    xa[j+1] = c;
+	}
+#ifdef _OPENMP
+#pragma omp single
+#endif
+	{
+	    xa[0] = 0;
+	    for (j = 0; j < n; ++j) xa[j+1] += xa[j];
+	}
+#ifdef _OPENMP
+#pragma omp for
+#endif
+	for (j = 0; j < n; ++j) {
+	    pos = xa[j];
+	    for (t = 0; t < nthr; ++t) {
+		c = cnt[(size_t) t * n + j];
+		cnt[(size_t) t * n + j] = pos;
+		pos += c;
+	    }
+	}
+
+	/* The values are copied with a constant size, so that the copies
+	   are plain loads and stores. */
+#define SCATTER(sz)						\
+	for (k = lo; k < hi; ++k) {				\
+	    pos = mycnt[col[k]]++;				\
+	    asub[pos] = row[k];					\
+	    memcpy((char *) a + (size_t) pos * (sz),			\
+		   (char *) val + (size_t) k * (sz), (sz));		\
+	}
+	switch (valsz) {
+	  case 4:  SCATTER(4);  break;
+	  case 8:  SCATTER(8);  break;
+	  case 16: SCATTER(16); break;
+	  default: SCATTER(valsz);
+	}
+#undef SCATTER
+    }
+
+    SUPERLU_FREE(cnt);
+}
@@ -290,6 +290,7 @@ void slu_SCT_init(SCT_t* SCT)
 
     SCT->commVolFactor =0.0;
     SCT->commVolRed =0.0;
+    SCT->tSupernode = NULL;
 } /* slu_SCT_init */
 
 void slu_SCT_free(SCT_t* SCT)
@@ -307,6 +308,7 @@ void slu_SCT_free(SCT_t* SCT)
     SUPERLU_FREE(SCT->Local_Dgstrf2_Thread_tl);
     SUPERLU_FREE(SCT->GetAijLock_Thread_tl);
 #endif
+    if (SCT->tSupernode) SUPERLU_FREE(SCT->tSupernode);
     SUPERLU_FREE(SCT); // sherry added
 }
 
@@ -547,7 +549,7 @@ void treeImbalance3D(gridinfo3d_t *grid3d, SCT_t* SCT)
         double tmax;
         MPI_Reduce( &SCT->tFactor3D[i], &tmax,  1, MPI_DOUBLE, MPI_MAX, 0, grid3d->zscp.comm );
         
-        double tavg = tsum /(grid3d->zscp.Np>>i);
+        double tavg = tsum /((grid3d->zscp.Np + (1 << i) - 1) >> i);
         double lLmb =  100*(tmax-tavg)/tavg;
         sprintf( funName, "Imbalance Factor:Level-%d    ",  (int) maxLvl-1-i);
         if(!grid3d->zscp.Iam)
@@ -622,6 +624,125 @@ get_new3dsolvetreecomm ()
         return 1;  // default      
 }
 
+/* Whether the CPU triangular solve exchanges x and lsum with MPI-3
+   one-sided operations (C_RmaBox) instead of Isend/Recv. */
+int
+get_rma_solve ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_RMA_SOLVE");
+    if (ttemp)
+        return atoi (ttemp);
+    else
+        return 0;  // default      
+}
+
+/* Whether the broadcast and reduction trees of the triangular solve
+   group the ranks by node and pick their fan-out from the message size;
+   0 restores the fixed DEG_TREE fan-out over the rank list, which is
+   always used with the GPU solve (get_acc_solve()). */
+int
+get_tree_topo ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_TREE_TOPO");
+    if (ttemp)
+        return atoi (ttemp);
+    else
+        return 1;  // default
+}
+
+/* Whether pdgssvx keeps the inverted diagonal blocks (DiagInv=YES)
+   in single precision, see pdCompute_Diag_Inv_s. */
+int
+get_diaginv_single ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_DIAGINV_SINGLE");
+    if (ttemp)
+        return atoi (ttemp);
+    else
+        return 0;  // default      
+}
+
+/* Whether the single-rank CPU triangular solve follows a precomputed
+   level-set schedule (LvlSched_t) instead of the leaf taskloop. */
+int
+get_lvl_solve ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_LVL_SOLVE");
+    if (ttemp)
+        return atoi (ttemp);
+    else
+        return 0;  // default      
+}
+
+/* Maximum number of iterations of the distributed Ruiz equilibration
+   used instead of p[sdz]gsequ() when Equil = YES; 0 keeps p[sdz]gsequ(). */
+int
+get_equil_ruiz ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_EQUIL_RUIZ");
+    if (ttemp)
+        return atoi (ttemp);
+    else
+        return 0;  // default
+}
+
+/* Tolerance on the row and column maxima of the Ruiz equilibration;
+   also decides whether the previous R and C are kept with SamePattern. */
+double
+get_equil_tol ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_EQUIL_TOL");
+    if (ttemp)
+        return atof (ttemp);
+    else
+        return 1e-2;  // default
+}
+
+/* Directory holding the cached orderings and symbolic factorizations,
+   see symbfact_cache_load(); NULL disables the cache. */
+char *
+get_symb_cache_dir ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_SYMB_CACHE");
+    if (ttemp && *ttemp)
+        return ttemp;
+    else
+        return NULL;  // default
+}
+
+/* File of the measured supernode costs used to partition the 3D
+   elimination forest, see saveSupernodeCost(); NULL disables it. */
+char *
+get_lbs_profile ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_LBS_PROFILE");
+    if (ttemp && *ttemp)
+        return ttemp;
+    else
+        return NULL;  // default
+}
+
+/* Rank at which the low-rank updates attached to a factorization by
+   p[sdz]gsupdate_lowrank() request a refactorization. */
+int
+get_lowrank_max ()
+{
+    char *ttemp;
+    ttemp = getenv ("SUPERLU_LOWRANK_MAX");
+    if (ttemp && atoi (ttemp) > 0)
+        return atoi (ttemp);
+    else
+        return 32;  // default, also for a value <= 0
+}
+
 
 
 void Free_HyP(HyP_t* HyP)
@@ -0,0 +1,440 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief Choose the shape of the process grid from the symbolic
+ * factorization
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * superlu_symbstats() summarizes the supernodal elimination tree of A by
+ * depth; superlu_grid_advise() predicts the times of the factorization
+ * and of the solve on every nprow x npcol x npdep grid of the available
+ * processes with a simple computation/communication model, and returns
+ * the fastest shape. Both are advisory and run before the grids are
+ * created, e.g. on process 0 only.
+ * </pre>
+ */
+#include <math.h>
+#include "superlu_ddefs.h"
+
+/*! \brief Per-depth statistics of the symbolic factorization of A.
+ *
+ * <pre>
+ * colptr[] and rowind[] are the pattern of the global m-by-n matrix A in
+ * compressed column format; they are not modified. The column ordering
+ * options->ColPerm and the supernode parameters of options are those of
+ * p[sdz]gssvx(); options->RowPerm is ignored, i.e. the statistics are
+ * those of A without the row permutation, which does not change the
+ * pattern of L+U much for matrices with a nonzero diagonal. PARMETIS and
+ * MY_PERMC are replaced by METIS_AT_PLUS_A, or by ND_AT_PLUS_A when
+ * SuperLU_DIST is built without (Par)METIS.
+ *
+ * The arrays of stats are allocated here and freed by
+ * superlu_symbstats_free(). Serial; returns the value of symbfact().
+ * </pre>
+ */
+int_t
+superlu_symbstats(superlu_dist_options_t *options, int_t m, int_t n,
+		  int_t nnz, int_t *colptr, int_t *rowind,
+		  superlu_symbstats_t *stats)
+{
+    superlu_dist_options_t opts = *options;
+    SuperMatrix GA, GAC;
+    NCformat *GAstore;
+    NCPformat *GACstore;
+    Glu_persist_t Glu_persist;
+    Glu_freeable_t Glu_freeable;
+    int_t *perm_c, *etree, *setree, *depth, *rows, *xsup, *supno, *xlsub;
+    int_t i, j, k, s, fnz, nsupers, w, h, info;
+    double *uent, *flops, *fill;
+    int nlvl;
+
+    if ( !(GAstore = (NCformat *) SUPERLU_MALLOC(sizeof(NCformat))) )
+	ABORT("Malloc fails for GAstore.");
+    GAstore->nnz = nnz;
+    GAstore->nzval = NULL;
+    GAstore->colptr = colptr;
+    /* sp_colorder() shares rowind[] with GAC, which is permuted below. */
+    if ( !(GAstore->rowind = intMalloc_dist(nnz)) )
+	ABORT("Malloc fails for rowind[].");
+    for (i = 0; i < nnz; ++i) GAstore->rowind[i] = rowind[i];
+    GA.Stype = SLU_NC;
+    GA.Dtype = SLU_D;
+    GA.Mtype = SLU_GE;
+    GA.nrow = m;
+    GA.ncol = n;
+    GA.Store = GAstore;
+
+    if ( opts.ColPerm == PARMETIS || opts.ColPerm == MY_PERMC )
+	opts.ColPerm = METIS_AT_PLUS_A;
+#ifndef HAVE_PARMETIS
+    if ( opts.ColPerm == METIS_AT_PLUS_A ) opts.ColPerm = ND_AT_PLUS_A;
+#endif
+    opts.Fact = DOFACT;
+    opts.PrintStat = NO;
+
+    perm_c = intMalloc_dist(n);
+    etree = intMalloc_dist(n);
+    if ( !perm_c || !etree ) ABORT("Malloc fails for perm_c[]/etree[].");
+    get_perm_c_dist(0, opts.ColPerm, &GA, perm_c);
+    sp_colorder(&opts, &GA, perm_c, etree, &GAC);
+
+    /* Pc*A*Pc^T, as in pdgssvx() */
+    GACstore = (NCPformat *) GAC.Store;
+    for (j = 0; j < n; ++j)
+	for (i = GACstore->colbeg[j]; i < GACstore->colend[j]; ++i)
+	    GACstore->rowind[i] = perm_c[GACstore->rowind[i]];
+
+    info = symbfact(&opts, 0, &GAC, perm_c, etree, &Glu_persist,
+		    &Glu_freeable);
+    Destroy_CompCol_Permuted_dist(&GAC);
+    SUPERLU_FREE(GAstore->rowind);
+    SUPERLU_FREE(GAstore);
+    if ( info > 0 ) {
+	SUPERLU_FREE(perm_c);
+	SUPERLU_FREE(etree);
+	return info;
+    }
+
+    xsup = Glu_persist.xsup;
+    supno = Glu_persist.supno;
+    xlsub = Glu_freeable.xlsub;
+    nsupers = supno[n-1] + 1;
+
+    /* Entries of U to the right of the diagonal block of each supernode;
+       every segment of usub[] runs from fnz to the end of its block. */
+    if ( !(uent = doubleCalloc_dist(nsupers)) )
+	ABORT("Calloc fails for uent[].");
+    for (j = 0; j < n; ++j)
+	for (i = Glu_freeable.xusub[j]; i < Glu_freeable.xusub[j+1]; ++i) {
+	    fnz = Glu_freeable.usub[i];
+	    s = supno[fnz];
+	    uent[s] += xsup[s+1] - fnz;
+	}
+
+    /* The parent of a supernode is numbered after it, so that one
+       downward sweep sets the depths. */
+    setree = supernodal_etree(nsupers, etree, supno, xsup);
+    depth = intMalloc_dist(nsupers);
+    for (k = nsupers - 1, nlvl = 0; k >= 0; --k) {
+	depth[k] = setree[k] < nsupers ? depth[setree[k]] + 1 : 0;
+	nlvl = SUPERLU_MAX(nlvl, depth[k] + 1);
+    }
+
+    stats->n = n;
+    stats->nsupers = nsupers;
+    stats->nlvl = nlvl;
+    stats->lvlNsupers = intCalloc_dist(nlvl);
+    stats->lvlCols = intCalloc_dist(nlvl);
+    stats->lvlRows = intCalloc_dist(nlvl);
+    stats->lvlFlops = doubleCalloc_dist(nlvl);
+    stats->lvlFill = doubleCalloc_dist(nlvl);
+    rows = intMalloc_dist(nsupers);
+    flops = doubleMalloc_dist(nsupers);
+    fill = doubleMalloc_dist(nsupers);
+    if ( !stats->lvlNsupers || !stats->lvlCols || !stats->lvlRows
+	 || !stats->lvlFlops || !stats->lvlFill || !rows || !flops || !fill )
+	ABORT("Calloc fails for stats.");
+    for (k = 0; k < nsupers; ++k) {
+	double dw, dh, du;
+	w = xsup[k+1] - xsup[k];
+	h = SUPERLU_MAX(xlsub[xsup[k]+1] - xlsub[xsup[k]], w);
+	dw = w; dh = h; du = uent[k];
+	rows[k] = h;
+	fill[k] = dw * dh + du;
+	/* diagonal block, L and U panels, Schur complement update */
+	flops[k] = 2.0/3.0 * dw*dw*dw + dw*dw * (dh - dw)
+		   + dw * du + 2.0 * (dh - dw) * du;
+	i = depth[k];
+	stats->lvlNsupers[i] += 1;
+	stats->lvlCols[i] += w;
+	stats->lvlRows[i] += h;
+	stats->lvlFill[i] += fill[k];
+	stats->lvlFlops[i] += flops[k];
+    }
+    /* kept for the 3D forests, see superlu_grid_advise() */
+    stats->setree = setree;
+    stats->xsup = xsup;
+    stats->depth = depth;
+    stats->rows = rows;
+    stats->flops = flops;
+    stats->fill = fill;
+
+    SUPERLU_FREE(uent);
+    SUPERLU_FREE(perm_c);
+    SUPERLU_FREE(etree);
+    SUPERLU_FREE(Glu_persist.supno);
+    symbfact_SubFree(&Glu_freeable);
+    return 0;
+}
+
+/*! \brief Free the arrays allocated by superlu_symbstats(). */
+void
+superlu_symbstats_free(superlu_symbstats_t *stats)
+{
+    SUPERLU_FREE(stats->lvlNsupers);
+    SUPERLU_FREE(stats->lvlCols);
+    SUPERLU_FREE(stats->lvlRows);
+    SUPERLU_FREE(stats->lvlFlops);
+    SUPERLU_FREE(stats->lvlFill);
+    SUPERLU_FREE(stats->setree);
+    SUPERLU_FREE(stats->xsup);
+    SUPERLU_FREE(stats->depth);
+    SUPERLU_FREE(stats->rows);
+    SUPERLU_FREE(stats->flops);
+    SUPERLU_FREE(stats->fill);
+}
+
+/* Bandwidth of a process in a group of size processes whose ranks are
+   stride apart: within a node if the group fits in ranksPerNode
+   consecutive ranks, otherwise the node's link is shared. */
+static double
+group_bw(int size, int stride, int ranksPerNode, superlu_machine_t *mach)
+{
+    if ( (double) size * stride <= ranksPerNode )
+	return mach->bwIntra;
+    return mach->bwInter / ranksPerNode;
+}
+
+/* Summary of the supernodes of one forest of the 3D partition by depth,
+   as superlu_symbstats() does for the whole etree; only n, nsupers, nlvl
+   and the lvl arrays of fs are set, for the depths of the forest. */
+static void
+forest_stats(superlu_symbstats_t *stats, sForest_t *forest,
+	     superlu_symbstats_t *fs)
+{
+    int_t i, k, l, lo, hi;
+
+    memset(fs, 0, sizeof(superlu_symbstats_t));
+    if ( !forest || forest->nNodes == 0 ) return;
+    lo = hi = stats->depth[forest->nodeList[0]];
+    for (i = 1; i < forest->nNodes; ++i) {
+	k = forest->nodeList[i];
+	lo = SUPERLU_MIN(lo, stats->depth[k]);
+	hi = SUPERLU_MAX(hi, stats->depth[k]);
+    }
+    fs->nlvl = hi - lo + 1;
+    fs->lvlNsupers = intCalloc_dist(fs->nlvl);
+    fs->lvlCols = intCalloc_dist(fs->nlvl);
+    fs->lvlRows = intCalloc_dist(fs->nlvl);
+    fs->lvlFlops = doubleCalloc_dist(fs->nlvl);
+    fs->lvlFill = doubleCalloc_dist(fs->nlvl);
+    if ( !fs->lvlNsupers || !fs->lvlCols || !fs->lvlRows
+	 || !fs->lvlFlops || !fs->lvlFill )
+	ABORT("Calloc fails for fs.");
+    for (i = 0; i < forest->nNodes; ++i) {
+	k = forest->nodeList[i];
+	l = stats->depth[k] - lo;
+	fs->nsupers += 1;
+	fs->n += stats->xsup[k+1] - stats->xsup[k];
+	fs->lvlNsupers[l] += 1;
+	fs->lvlCols[l] += stats->xsup[k+1] - stats->xsup[k];
+	fs->lvlRows[l] += stats->rows[k];
+	fs->lvlFlops[l] += stats->flops[k];
+	fs->lvlFill[l] += stats->fill[k];
+    }
+}
+
+static void
+free_forests(int_t nforests, sForest_t **sForests)
+{
+    int_t i;
+    for (i = 0; i < nforests; ++i) {
+	if ( sForests[i] ) {
+	    SUPERLU_FREE(sForests[i]->nodeList);
+	    SUPERLU_FREE((sForests[i]->topoInfo).eTreeTopLims);
+	    SUPERLU_FREE((sForests[i]->topoInfo).myIperm);
+	    SUPERLU_FREE(sForests[i]);
+	}
+    }
+    SUPERLU_FREE(sForests);
+}
+
+/* Predicted times of the factorization and of the solve with nrhs
+   right-hand sides of the supernodes of fs on an nprow x npcol grid.
+   The rank layout is that of superlu_gridinit3d(), the Cartesian grid
+   {npdep, nprow, npcol}: the npcol processes of a process row are
+   consecutive, a process column has stride npcol, and the layers have
+   stride nprow*npcol. */
+static void
+grid2d_model(int nprow, int npcol, int ranksPerNode, int nrhs,
+	     superlu_symbstats_t *fs, superlu_machine_t *mach,
+	     double *tFactor, double *tSolve)
+{
+    double P2 = (double) nprow * npcol, alpha = mach->latency;
+    double bwRow = group_bw(npcol, 1, ranksPerNode, mach);
+    double bwCol = group_bw(nprow, npcol, ranksPerNode, mach);
+    double lgr = log2((double) nprow), lgc = log2((double) npcol);
+    double tf = 0.0, ts = 0.0;
+    int l;
+
+    for (l = 0; l < fs->nlvl; ++l) {
+	double ns, eff, fill, tcomm;
+	if ( fs->lvlNsupers[l] == 0 ) continue;
+	ns = fs->lvlNsupers[l];
+	fill = fs->lvlFill[l];
+	/* Blocks per process in the panels of a supernode, h/w per side */
+	eff = (double) fs->lvlRows[l] / fs->lvlCols[l];
+	eff = SUPERLU_MIN(1.0, ns * eff * eff / P2);
+
+	/* Factorization: panel broadcasts along the rows and columns */
+	tcomm = ns * alpha * (lgr + lgc);
+	if ( npcol > 1 ) tcomm += 4.0 * fill / (nprow * bwRow);
+	if ( nprow > 1 ) tcomm += 4.0 * fill / (npcol * bwCol);
+	tf += fs->lvlFlops[l] / (P2 * eff * mach->flopRate) + tcomm;
+
+	/* Solve: one pass over L and U, latency bound along the path */
+	ts += 2.0 * fill * nrhs / (P2 * eff * mach->flopRate)
+	      + 2.0 * ns * alpha * (lgr + lgc);
+    }
+    *tFactor = tf;
+    *tSolve = ts;
+}
+
+/* Predicted times on an nprow x npcol x npdep grid. fs[] summarizes the
+   forests that getForests() builds for npdep layers, see forest_stats().
+   The forests of one level are factored concurrently, from the leaves
+   up; the slowest one sets the time of the level. Before the next
+   level, the layers of each sibling forest reduce along Z all the
+   ancestors they replicate. */
+static void
+grid_model(int nprow, int npcol, int npdep, int ranksPerNode, int nrhs,
+	   superlu_symbstats_t *fs, superlu_machine_t *mach,
+	   double *tFactor, double *tSolve)
+{
+    double P2 = (double) nprow * npcol, alpha = mach->latency;
+    double bwZ = group_bw(npdep, nprow * npcol, ranksPerNode, mach);
+    double tf = 0.0, ts = 0.0;
+    int_t maxLvl = log2i(npdep) + 1, lvl, tr, a, l;
+
+    for (lvl = maxLvl - 1; lvl >= 0; --lvl) {
+	double lvlf = 0.0, lvls = 0.0;
+	for (tr = (1 << lvl) - 1; tr < (1 << (lvl + 1)) - 1; ++tr) {
+	    double f = 0.0, s = 0.0, fill;
+	    if ( forestNumLayers(tr, lvl, maxLvl, npdep) == 0 ) continue;
+	    if ( fs[tr].nsupers )
+		grid2d_model(nprow, npcol, ranksPerNode, nrhs, &fs[tr], mach,
+			     &f, &s);
+	    if ( lvl > 0 && forestNumLayers(tr % 2 ? tr + 1 : tr - 1, lvl,
+					    maxLvl, npdep) ) {
+		for (a = (tr - 1) / 2; ; a = (a - 1) / 2) {
+		    for (l = 0, fill = 0.0; l < fs[a].nlvl; ++l)
+			fill += fs[a].lvlFill[l];
+		    f += 8.0 * fill / P2 / bwZ + 2.0 * alpha * fs[a].nsupers;
+		    s += 2.0 * (alpha * fs[a].nsupers
+				+ 8.0 * fs[a].n * nrhs / P2 / bwZ);
+		    if ( a == 0 ) break;
+		}
+	    }
+	    lvlf = SUPERLU_MAX(lvlf, f);
+	    lvls = SUPERLU_MAX(lvls, s);
+	}
+	tf += lvlf;
+	ts += lvls;
+    }
+    *tFactor = tf;
+    *tSolve = ts;
+}
+
+/*! \brief Choose the process grid shape for nprocs processes.
+ *
+ * <pre>
+ * stats is computed by superlu_symbstats(). ranksPerNode is the number
+ * of MPI ranks per node, numbered consecutively; maxdep bounds npdep
+ * (1 for a 2D grid). mach gives the machine parameters; with NULL, or
+ * for the fields <= 0, the defaults are a flop rate of 5 GFlop/s per
+ * process, a latency of 2 us, a bandwidth of 10 GB/s within a node and
+ * 2.5 GB/s out of a node.
+ *
+ * On exit, shape holds the nprow x npcol x npdep grid, nprow*npcol*npdep
+ * = nprocs, with the smallest predicted time of one factorization plus
+ * one solve with nrhs right-hand sides, and the two predicted times.
+ * Among equal predictions, the smallest npdep and the most square 2D
+ * grid, with nprow <= npcol, are chosen.
+ * </pre>
+ */
+void
+superlu_grid_advise(int nprocs, int ranksPerNode, int maxdep, int nrhs,
+		    superlu_symbstats_t *stats, superlu_machine_t *mach,
+		    superlu_gridshape_t *shape)
+{
+    superlu_machine_t m = {5e9, 2e-6, 1e10, 2.5e9};
+    superlu_symbstats_t *fs;
+    sForest_t **sForests;
+    treeList_t *treeList = NULL;
+    double tf, ts, best = -1.0;
+    int pz, pr, pc, P2;
+    int_t maxLvl, nforests, tr;
+
+    if ( mach ) {
+	if ( mach->flopRate > 0 ) m.flopRate = mach->flopRate;
+	if ( mach->latency > 0 ) m.latency = mach->latency;
+	if ( mach->bwIntra > 0 ) m.bwIntra = mach->bwIntra;
+	if ( mach->bwInter > 0 ) m.bwInter = mach->bwInter;
+    }
+    ranksPerNode = SUPERLU_MAX(ranksPerNode, 1);
+    nrhs = SUPERLU_MAX(nrhs, 1);
+
+    shape->nprow = 1;
+    shape->npcol = nprocs;
+    shape->npdep = 1;
+    shape->tFactor = shape->tSolve = 0.0;
+    for (pz = 1; pz <= SUPERLU_MAX(maxdep, 1) && pz <= nprocs; ++pz) {
+	if ( nprocs % pz ) continue;
+	P2 = nprocs / pz;
+	maxLvl = log2i(pz) + 1;
+	nforests = ((int_t) 1 << maxLvl) - 1;
+	if ( pz == 1 ) {
+	    fs = stats;
+	} else {
+	    /* the partition of pdgssvx3d(), without a cost profile */
+	    if ( !treeList ) {
+		treeList = setree2list(stats->nsupers, stats->setree);
+		calcTreeWeight(stats->nsupers, stats->setree, treeList,
+			       stats->xsup, NULL);
+	    }
+	    sForests = getForests(maxLvl, pz, stats->nsupers, stats->setree,
+				  treeList);
+	    if ( !sForests ) continue;
+	    if ( !(fs = SUPERLU_MALLOC(nforests * sizeof(superlu_symbstats_t))) )
+		ABORT("Malloc fails for fs[].");
+	    for (tr = 0; tr < nforests; ++tr)
+		forest_stats(stats, sForests[tr], &fs[tr]);
+	    free_forests(nforests, sForests);
+	}
+	for (pr = 1; pr <= P2; ++pr) {
+	    if ( P2 % pr ) continue;
+	    pc = P2 / pr;
+	    grid_model(pr, pc, pz, ranksPerNode, nrhs, fs, &m, &tf, &ts);
+	    if ( best >= 0.0 && tf + ts > best * (1.0 - 1e-9) ) {
+		/* a tie: keep the smaller npdep, then the squarer grid */
+		if ( tf + ts > best * (1.0 + 1e-9) || pz != shape->npdep
+		     || abs(pr - pc) > abs(shape->nprow - shape->npcol)
+		     || (abs(pr - pc) == abs(shape->nprow - shape->npcol)
+			 && pr > pc) )
+		    continue;
+	    }
+	    best = tf + ts;
+	    shape->nprow = pr;
+	    shape->npcol = pc;
+	    shape->npdep = pz;
+	    shape->tFactor = tf;
+	    shape->tSolve = ts;
+	}
+	if ( fs != stats ) {
+	    for (tr = 0; tr < nforests; ++tr) superlu_symbstats_free(&fs[tr]);
+	    SUPERLU_FREE(fs);
+	}
+    }
+    if ( treeList ) free_treelist(stats->nsupers, treeList);
+}
@@ -26,23 +26,29 @@ int_t calcTopInfoForest(sForest_t *forest,
                         int_t nsupers, int_t* setree);
 
 
-sForest_t**  getForests( int_t maxLvl, int_t nsupers, int_t*setree, treeList_t* treeList)
+/* Np is the number of Z layers. When it is not a power of two, the
+   greedy partitioning splits every level in proportion to the layers on
+   each side, and the nested dissection one, which halves the etree, is
+   not used. */
+sForest_t**  getForests( int_t maxLvl, int_t Np, int_t nsupers, int_t*setree, treeList_t* treeList)
 {
 	// treePartStrat tps;
 	if (getenv("SUPERLU_LBS"))
 	{
-		if (strcmp(getenv("SUPERLU_LBS"), "ND" ) == 0)
+		if (strcmp(getenv("SUPERLU_LBS"), "ND" ) == 0
+		    && Np == (1 << (maxLvl - 1)))
 		{
 			return getNestDissForests( maxLvl, nsupers, setree, treeList);
 		}
-		if (strcmp(getenv("SUPERLU_LBS"), "GD" ) == 0)
+		if (strcmp(getenv("SUPERLU_LBS"), "GD" ) == 0
+		    || strcmp(getenv("SUPERLU_LBS"), "ND" ) == 0)
 		{
-			return getGreedyLoadBalForests( maxLvl, nsupers, setree, treeList);
+			return getGreedyLoadBalForests( maxLvl, Np, nsupers, setree, treeList);
 		}
 	}
 	else
 	{
-		return getGreedyLoadBalForests( maxLvl, nsupers, setree, treeList);
+		return getGreedyLoadBalForests( maxLvl, Np, nsupers, setree, treeList);
 	}
 	return 0;
 }
@@ -461,10 +467,95 @@ void printGantt(int root, int numForests, char* nodename, double scale, double*
 	}
 }
 
+/* Checksum of the supernodal partition xsup[0:nsupers], which keys the
+   file of the supernode costs. */
+unsigned long long supernodeCostKey(int_t nsupers, int_t* xsup)
+{
+	unsigned long long h = 14695981039346656037ULL; /* FNV-1a */
+	for (int_t i = 0; i <= nsupers; ++i)
+	{
+		h ^= (unsigned long long) xsup[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+/* Write the measured factorization time of every supernode, summed over
+   all the processes, to the file named by SUPERLU_LBS_PROFILE. The next
+   partitioning of the same matrix uses them as the supernode weights,
+   see estimateWeight(). */
+void saveSupernodeCost(int_t nsupers, int_t* xsup, double* tSupernode,
+                       gridinfo3d_t* grid3d)
+{
+	char* fname = get_lbs_profile();
+	double* cost = NULL;
+	FILE* fp;
+
+	if (!grid3d->iam) cost = DOUBLE_ALLOC(nsupers);
+	MPI_Reduce(tSupernode, cost, nsupers, MPI_DOUBLE, MPI_SUM, 0, grid3d->comm);
+
+	if (!grid3d->iam)
+	{
+		if ((fp = fopen(fname, "w")) == NULL)
+		{
+			fprintf(stderr, "Cannot open %s for the supernode costs\n", fname);
+		}
+		else
+		{
+			fprintf(fp, "%lld %lld %llu\n", (long long) nsupers, (long long) xsup[nsupers],
+			        supernodeCostKey(nsupers, xsup));
+			for (int_t i = 0; i < nsupers; ++i)
+				fprintf(fp, "%.6e\n", cost[i]);
+			fclose(fp);
+		}
+		SUPERLU_FREE(cost);
+	}
+}
+
+/* Print the load imbalance of every level of the forest partition,
+   100*(max-avg)/avg as in treeImbalance3D(), predicted from the forest
+   weights and achieved by the factorization times. */
+void forestImbalance3D(sForest_t**  sForests, SCT_t* SCT, gridinfo3d_t* grid3d)
+{
+	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
+
+	if (!grid3d->iam)
+		printf("|Level | predicted imbalance | achieved imbalance |\n");
+	for (int ilvl = maxLvl - 1; ilvl > -1; --ilvl)
+	{
+		/* the forests of level ilvl are numbered from first; the nfr
+		   first ones have a Z layer */
+		int first = (1 << (maxLvl - 1 - ilvl)) - 1;
+		int nfr = (grid3d->zscp.Np + (1 << ilvl) - 1) >> ilvl;
+		double wsum = 0, wmax = 0;
+		for (int i = first; i < first + nfr; ++i)
+		{
+			double wt = sForests[i] ? sForests[i]->weight : 0.0;
+			wsum += wt;
+			wmax = SUPERLU_MAX(wmax, wt);
+		}
+
+		double tsum, tmax;
+		MPI_Reduce( &SCT->tFactor3D[ilvl], &tsum,  1, MPI_DOUBLE, MPI_SUM, 0, grid3d->zscp.comm );
+		MPI_Reduce( &SCT->tFactor3D[ilvl], &tmax,  1, MPI_DOUBLE, MPI_MAX, 0, grid3d->zscp.comm );
+
+		if (!grid3d->iam)
+		{
+			double wavg = wsum / nfr;
+			double tavg = tsum / nfr;
+			printf("|%d     | %8.1f %%          | %8.1f %%         |\n",
+			       (int) (maxLvl - 1 - ilvl),
+			       wavg > 0 ? 100 * (wmax - wavg) / wavg : 0.0,
+			       tavg > 0 ? 100 * (tmax - tavg) / tavg : 0.0);
+		}
+	}
+}
+
 #define ABS(a) ((a)<0?-(a):a)
+/* frac is the share of the Z layers that go to the first part. */
 double getLoadImbalance(int_t nTrees,
                         int_t * treeIndx,				// index of tree in gtrees
-                        double * gTreeWeights)
+                        double * gTreeWeights, double frac)
 {
 
 	if (nTrees < 1)
@@ -483,7 +574,7 @@ double getLoadImbalance(int_t nTrees,
 	for (int i = nTrees - 2 ; i > -1; --i)
 	{
 		/* code */
-		if (w1 > w2)
+		if (w1 / frac > w2 / (1 - frac))
 		{
 			/* code */
 			w2 += gTreeWeights[wSortIdx[i]];
@@ -497,6 +588,8 @@ double getLoadImbalance(int_t nTrees,
 	}
 
 	SUPERLU_FREE(wSortIdx);
+	w1 /= frac;
+	w2 /= 1 - frac;
 	return ABS(w2 - w1) / (w2 + w1);
 	// return trPart;
 
@@ -574,7 +667,7 @@ sForest_t*  createForestNew(int_t numTrees, int_t nsupers, int_t * nodeCounts,
 
 void oneLeveltreeFrPartition( int_t nTrees, int_t * trCount, int_t** trList,
                               int_t * treeSet,
-                              double * sWeightArr)
+                              double * sWeightArr, double frac)
 {
 	if (nTrees < 1)
 	{
@@ -599,7 +692,7 @@ void oneLeveltreeFrPartition( int_t nTrees, int_t * trCount, int_t** trList,
 	for (int i = nTrees - 2 ; i > -1; --i)
 	{
 		/* code */
-		if (w1 > w2)
+		if (w1 / frac > w2 / (1 - frac))
 		{
 			/* code */
 			w2 += sWeightArr[wSortIdx[i]];
@@ -637,7 +730,12 @@ void resizeArr(void** A, int oldSize, int newSize, size_t typeSize)
 	return; 
 
 }
-forestPartition_t iterativeFrPartitioning(rForest_t* rforest, int_t nsupers, int_t * setree, treeList_t* treeList)
+/* Split rforest between two subtrees of the Z layer tree, the first of
+   which holds the share frac of the layers. With frac = 1, the second
+   subtree has no layer: every tree goes to the first one, and there is
+   no common ancestor. */
+forestPartition_t iterativeFrPartitioning(rForest_t* rforest, int_t nsupers, int_t * setree, treeList_t* treeList,
+                                          double frac)
 {
 
     int_t nTreeSet = rforest->ntrees;
@@ -659,7 +757,8 @@ forestPartition_t iterativeFrPartitioning(rForest_t* rforest, int_t nsupers, int
 		weightArr[i] = treeList[treeHeads[i]].iWeight;
 	}
 
-	while (getLoadImbalance(nTreeSet, treeSet, weightArr) > ACCEPTABLE_TREE_IMBALANCE )
+	while (frac < 1.0
+	       && getLoadImbalance(nTreeSet, treeSet, weightArr, frac) > ACCEPTABLE_TREE_IMBALANCE )
 	{
 		// get index of maximum weight subtree
 		int_t idx = 0;
@@ -749,9 +848,16 @@ forestPartition_t iterativeFrPartitioning(rForest_t* rforest, int_t nsupers, int
 	trList[1] = intMalloc_dist(nTreeSet);
 #endif
 
-	oneLeveltreeFrPartition( nTreeSet, trCount, trList,
-	                         treeSet,
-	                         sWeightArr);
+	if (frac < 1.0)
+	    oneLeveltreeFrPartition( nTreeSet, trCount, trList,
+	                             treeSet,
+	                             sWeightArr, frac);
+	else
+	{
+	    for (int i = 0; i < nTreeSet; ++i)
+		trList[0][i] = treeSet[i];
+	    trCount[0] = nTreeSet;
+	}
 
 	rForest_t *rforestS1, *rforestS2;
 #if 0
@@ -830,7 +936,16 @@ sForest_t* r2sForest(rForest_t* rforest, int_t nsupers, int_t * setree, treeList
 } /* r2sForest */
 
 
-sForest_t**  getGreedyLoadBalForests( int_t maxLvl, int_t nsupers, int_t * setree, treeList_t* treeList)
+/* Number of the Np Z layers under the forest tr of level lvl; the
+   layer tree has 2^(maxLvl-1) leaves, the last of which may be empty. */
+int_t forestNumLayers(int_t tr, int_t lvl, int_t maxLvl, int_t Np)
+{
+	int_t width = (int_t) 1 << (maxLvl - 1 - lvl);
+	int_t first = (tr - ((1 << lvl) - 1)) * width;
+	return SUPERLU_MAX(SUPERLU_MIN(Np - first, width), 0);
+}
+
+sForest_t**  getGreedyLoadBalForests( int_t maxLvl, int_t Np, int_t nsupers, int_t * setree, treeList_t* treeList)
 {
 
 	// assert(maxLvl == 2);
@@ -885,7 +1000,10 @@ sForest_t**  getGreedyLoadBalForests( int_t maxLvl, int_t nsupers, int_t * setre
 		for (int_t tr = lvlSt; tr < lvlEnd; ++tr)
 		{
 		    /* code */
-		    forestPartition_t frPr_t = iterativeFrPartitioning(&rForests[tr], nsupers, setree, treeList);
+		    int_t nLeft = forestNumLayers(2 * tr + 1, lvl + 1, maxLvl, Np);
+		    int_t nRight = forestNumLayers(2 * tr + 2, lvl + 1, maxLvl, Np);
+		    double frac = nLeft + nRight ? (double) nLeft / (nLeft + nRight) : 1.0;
+		    forestPartition_t frPr_t = iterativeFrPartitioning(&rForests[tr], nsupers, setree, treeList, frac);
 		    sForests[tr] = frPr_t.Ans;
 
 		    if (lvl == maxLvl - 2) {
@@ -976,7 +1094,7 @@ sForest_t**  getOneLevelBalForests( int_t maxLvl, int_t nsupers, int_t * setree,
 		for (int_t tr = lvlSt; tr < lvlEnd; ++tr)
 		{
 			/* code */
-			forestPartition_t frPr_t = iterativeFrPartitioning(&rForests[tr], nsupers, setree, treeList);
+			forestPartition_t frPr_t = iterativeFrPartitioning(&rForests[tr], nsupers, setree, treeList, 0.5);
 			sForests[tr] = frPr_t.Ans;
 
 			if (lvl == maxLvl - 2)
@@ -14,10 +14,13 @@
 //#include "supernodal_etree.h"
 
 #define INT_T_ALLOC(x)  ((int_t *) SUPERLU_MALLOC ( (x) * sizeof (int_t)))
+/* Smallest l with 2^l >= index. The Z layers of a 3D grid are the leaves
+   of a binary tree with 2^(maxLvl-1) leaves, maxLvl = log2i(Np) + 1; when
+   Np is not a power of two, the leaves Np, Np+1, ... have no grid. */
 int_t log2i(int_t index)
 {
 	int_t targetlevel = 0;
-	while (index >>= 1) ++targetlevel;
+	while (((int_t) 1 << targetlevel) < index) ++targetlevel;
 	return targetlevel;
 }
 
@@ -125,6 +128,52 @@ int  free_treelist(int_t nsuper, treeList_t* treeList)
     return 0;
 }
 
+/* Replace the estimated weights by the supernode costs recorded by
+   saveSupernodeCost() in the file named by SUPERLU_LBS_PROFILE, if it
+   was written for the same supernodal partition, see
+   supernodeCostKey(). Collective over grid3d->comm: process 0, which
+   also writes the file, reads it and broadcasts the costs, so that all
+   the processes build the same forests. */
+static int loadSupernodeCost(int_t nsupers, treeList_t* treeList, int_t* xsup,
+                             gridinfo3d_t* grid3d)
+{
+	char* fname = get_lbs_profile();
+	long long ns, n;
+	unsigned long long key;
+	double total = 0.0;
+	int_t i = 0;
+	int loaded = 0;
+	FILE* fp;
+
+	if (!fname) return 0;
+	double* cost = doubleMalloc_dist(nsupers);
+	if (!grid3d->iam && (fp = fopen(fname, "r")) != NULL)
+	{
+		if (fscanf(fp, "%lld %lld %llu", &ns, &n, &key) == 3 && ns == nsupers
+		    && n == xsup[nsupers] && key == supernodeCostKey(nsupers, xsup))
+		{
+			for (i = 0; i < nsupers; ++i)
+			{
+				if (fscanf(fp, "%lf", &cost[i]) != 1 || cost[i] < 0) break;
+				total += cost[i];
+			}
+			/* a profile without any time, e.g. from the GPU
+			   factorization, is not used */
+			loaded = (i == nsupers && total > 0);
+		}
+		fclose(fp);
+	}
+	MPI_Bcast(&loaded, 1, MPI_INT, 0, grid3d->comm);
+	if (loaded)
+	{
+		MPI_Bcast(cost, nsupers, MPI_DOUBLE, 0, grid3d->comm);
+		for (i = 0; i < nsupers; ++i)
+			treeList[i].weight = cost[i];
+	}
+	SUPERLU_FREE(cost);
+	return loaded;
+}
+
 int_t estimateWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* xsup)
 {
 	if (getenv("WF"))
@@ -207,7 +256,8 @@ int_t estimateWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* x
 } /* estimateWeight */
 
 
-int_t calcTreeWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* xsup)
+int_t calcTreeWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* xsup,
+                     gridinfo3d_t* grid3d)
 {
 
 	// initializing naive weight
@@ -246,6 +296,9 @@ int_t calcTreeWeight(int_t nsupers, int_t*setree, treeList_t* treeList, int_t* x
 	// }
 
 	estimateWeight(nsupers, setree, treeList, xsup);
+	/* measured costs of a previous factorization; none without grid3d,
+	   e.g. in superlu_grid_advise() */
+	if (grid3d) loadSupernodeCost(nsupers, treeList, xsup, grid3d);
 
 	for (int i = 0; i < nsupers; ++i)
 	{
@@ -841,7 +894,7 @@ int_t* getGridTrees( gridinfo3d_t* grid3d)
 {
 	int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
 	int_t* myTreeIdx = (int_t*) SUPERLU_MALLOC (maxLvl * sizeof (int_t));
-	myTreeIdx[0] = grid3d->zscp.Np - 1 + grid3d->zscp.Iam ;
+	myTreeIdx[0] = (1 << (maxLvl - 1)) - 1 + grid3d->zscp.Iam ;
 	for (int i = 1; i < maxLvl; ++i)
 	{
 		/* code */
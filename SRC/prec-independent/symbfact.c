@@ -38,21 +38,50 @@ at the top-level directory.
 /* What type of supernodes we want */
 #define T2_SUPER
 
+/* Threads used by symbfact(): the OpenMP threads of the caller, but at
+   least SYMB_CHUNK columns per thread. */
+#define SYMB_CHUNK 1024
+
+/* Columns fst:lst of the postordered etree, closed under descendants,
+   factored by one thread in storage of its own; see symbfact_forests(). */
+typedef struct {
+    int_t fst, lst;
+    int_t info;
+    int_t *work;     /* segrep, supno, xsup, xlsub, xusub, xprune */
+    int_t *xprune;
+    Glu_persist_t  Glu_persist;
+    Glu_freeable_t Glu_freeable;
+} symb_forest_t;
 
 /*
  * Internal protypes
  */
 static void  relax_snode(int_t, int_t *, int_t, int_t *, int_t *);
-static int_t snode_dfs(SuperMatrix *, const int_t, const int_t, int_t *,
-		       int_t *,	Glu_persist_t *, Glu_freeable_t *);
-static int_t column_dfs(superlu_dist_options_t *, SuperMatrix *,
+static int_t symbfact_sym(superlu_dist_options_t *, int, SuperMatrix *,
+			  int_t *, Glu_persist_t *, Glu_freeable_t *);
+static int_t symbfact_cols(const int_t, const int_t, SuperMatrix *,
+			   const int_t, const int_t, int_t *, int_t *,
+			   int_t *, int_t *, int_t *, int_t *, int_t *,
+			   int_t *, Glu_persist_t *, Glu_freeable_t *);
+static symb_forest_t *symbfact_partition(const int_t, int_t *, int_t *,
+					 const int_t, const int, int_t *);
+static int_t symbfact_forests(const int_t, SuperMatrix *, const int_t,
+			      symb_forest_t *, int_t *, int_t *, int_t *,
+			      int_t *, int_t *, const int);
+static int_t symbfact_splice(symb_forest_t *, const int_t, int_t *, int_t *,
+			     int_t *, Glu_persist_t *, Glu_freeable_t *);
+static int_t symb_xpand(const int_t, int_t, int_t, int_t, MemType, int_t *,
+			Glu_freeable_t *);
+static int_t snode_dfs(const int_t, SuperMatrix *, const int_t, const int_t,
+		       int_t *, int_t *, Glu_persist_t *, Glu_freeable_t *);
+static int_t column_dfs(const int_t, const int_t, SuperMatrix *,
 			const int_t, int_t *, int_t *, int_t *,
 			int_t *, int_t *, int_t *, int_t *, int_t *,
 			Glu_persist_t *, Glu_freeable_t *);
 static int_t pivotL(const int_t, int_t *, int_t *,
 		    Glu_persist_t *, Glu_freeable_t *);
-static int_t set_usub(const int_t, const int_t, const int_t, int_t *, int_t *,
-		      Glu_persist_t *, Glu_freeable_t *);
+static int_t set_usub(const int_t, const int_t, const int_t, const int_t,
+		      int_t *, int_t *, Glu_persist_t *, Glu_freeable_t *);
 static void  pruneL(const int_t, const int_t *, const int_t, const int_t,
 		    const int_t *, const int_t *, int_t *,
 		    Glu_persist_t *, Glu_freeable_t *);
@@ -71,6 +100,17 @@ static void  pruneL(const int_t, const int_t *, const int_t, const int_t,
  *        o supernodes
  *        o symmetric structure pruning
  *
+ *   With several OpenMP threads, the etree is split into forests of
+ *   subtrees that do not depend on each other (see symbfact_partition()),
+ *   which are factored concurrently, each in storage of its own. Going
+ *   through the columns in order, the forests are then copied into place
+ *   and the columns of their common ancestors are factored as usual. The
+ *   output is the same as with one thread.
+ *
+ *   With options->SymPattern = YES and a square A, the etree is that of
+ *   A'+A and the structure is obtained from its column counts instead;
+ *   see symbfact_sym().
+ *
  * Return value
  * ============
  *   < 0, number of bytes needed for LSUB.
@@ -91,12 +131,15 @@ int_t symbfact
  )
 {
 
-    int_t m, n, min_mn, j, i, k, irep, nseg, pivrow, info;
+    int_t m, n, min_mn, j, k, info;
     int_t *iwork, *perm_r, *segrep, *repfnz;
     int_t *xprune, *marker, *parent, *xplore;
-    int_t relax, *desc, *relax_end;
+    int_t relax, maxsuper, *desc, *relax_end;
     int_t nnzLU, nnzLSUB;
     int_t nnzL, nnzU;
+    int_t nforest = 0, f;
+    symb_forest_t *forest = NULL;
+    int   nthr = 1;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(pnum, "Enter symbfact()");
@@ -106,6 +149,11 @@ int_t symbfact
     n = A->ncol;
     min_mn = SUPERLU_MIN(m, n);
 
+    if ( options->SymPattern == YES && m == n
+	 && options->ColPerm != MMD_ATA && n > 1 )
+	return symbfact_sym(options, pnum, A, etree, Glu_persist,
+			    Glu_freeable);
+
     /* Allocate storage common to the symbolic factor routines */
     info = symbfact_SubInit(options, DOFACT, NULL, 0, m, n,
 			    ((NCPformat*)A->Store)->nnz,
@@ -123,6 +171,7 @@ int_t symbfact
     xprune = xplore + m;
     relax_end = xprune + n;
     relax = sp_ienv_dist(2, options);
+    maxsuper = sp_ienv_dist(3, options);
     ifill_dist(perm_r, m, SLU_EMPTY);
     ifill_dist(repfnz, m, SLU_EMPTY);
     ifill_dist(marker, m, SLU_EMPTY);
@@ -137,14 +186,390 @@ int_t symbfact
     if ( !(desc = intMalloc_dist(n+1)) )
 	ABORT("Malloc fails for desc[]");;
     relax_snode(n, etree, relax, desc, relax_end);
+
+#ifdef _OPENMP
+    if ( m == n )
+	nthr = (int) SUPERLU_MIN(omp_get_max_threads(), n / SYMB_CHUNK);
+#endif
+    if ( nthr > 1 ) {
+	/* Factor the independent subtrees on the threads. */
+	forest = symbfact_partition(n, etree, desc, relax, nthr, &nforest);
+	if ( nforest > 1 ) 
+	    info = symbfact_forests(maxsuper, A, nforest, forest, relax_end,
+				    perm_r, repfnz, parent, xplore, nthr);
+	else
+	    nforest = 0;
+#if ( PRNTlevel>=2 )
+	if ( !pnum )
+	    printf(".. symbfact(): " IFMT " forests on %d threads\n",
+		   nforest, nthr);
+#endif
+    }
     SUPERLU_FREE(desc);
-    
-    for (j = 0; j < min_mn; ) {
+    if ( info != 0 )
+	return info;
+
+    for (j = 0, f = 0; j < min_mn; ) {
+	if ( f < nforest && j == forest[f].fst ) {
+	    /* Copy the factored forest into place. */
+	    if ( (info = symbfact_splice(&forest[f], n, relax_end, xprune,
+					 marker, Glu_persist, Glu_freeable)) )
+		return info;
+	    j = forest[f++].lst + 1;
+	} else {
+	    /* Factor the columns up to the next forest. */
+	    k = f < nforest ? forest[f].fst : min_mn;
+	    if ( (info = symbfact_cols(0, maxsuper, A, j, k-1, relax_end,
+				       perm_r, segrep, repfnz, xprune, marker,
+				       parent, xplore, Glu_persist,
+				       Glu_freeable)) )
+		return info;
+	    j = k;
+	}
+    } /* for j ... */
+    if ( forest ) SUPERLU_FREE(forest);
+
+    countnz_dist(min_mn, xprune, &nnzL, &nnzU, Glu_persist, Glu_freeable);
+    Glu_freeable->nnzLU = nnzL + nnzU - min_mn;	
+    /* Apply perm_r to L; Compress LSUB array. */
+    nnzLSUB = fixupL_dist(min_mn, perm_r, Glu_persist, Glu_freeable);
+
+    if ( !pnum && (options->PrintStat == YES)) {
+	nnzLU = nnzL + nnzU - min_mn;				   
+	printf("\tMatrix size min_mn  " IFMT "\n", min_mn);
+	printf("\tNonzeros in L       " IFMT "\n", nnzL);
+	printf("\tNonzeros in U       " IFMT "\n", nnzU);
+	printf("\tnonzeros in L+U     " IFMT "\n", nnzLU);
+	printf("\tnonzeros in LSUB    " IFMT "\n", nnzLSUB);
+    }
+    SUPERLU_FREE(iwork);
+
+#if ( PRNTlevel>=3 )
+    PrintInt10("lsub", Glu_freeable->xlsub[n], Glu_freeable->lsub);
+    PrintInt10("xlsub", n+1, Glu_freeable->xlsub);
+    PrintInt10("xprune", n, xprune);
+    PrintInt10("usub", Glu_freeable->xusub[n], Glu_freeable->usub);
+    PrintInt10("xusub", n+1, Glu_freeable->xusub);
+    PrintInt10("supno", n, Glu_persist->supno);
+    PrintInt10("xsup", (Glu_persist->supno[n])+2, Glu_persist->xsup);
+#endif
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(pnum, "Exit symbfact()");
+#endif
+
+    /* return (-i); */
+    return (-nnzLSUB);
+
+} /* SYMBFACT */
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   symbfact_sym() is the symbolic factorization used by symbfact() when
+ *   options->SymPattern = YES. It treats A as having the pattern of A'+A,
+ *   so that L is the Cholesky factor of that pattern and U = L'. Instead
+ *   of a DFS per column it
+ *        o computes the column counts of L from the etree of A'+A, using
+ *          the row subtrees and their leaves (Gilbert, Ng and Peyton);
+ *        o forms the supernodes from the counts: column j joins column
+ *          j-1 if etree[j-1] = j and the count drops by one (T2);
+ *        o merges the structures of the child supernodes into their
+ *          parent, in storage sized exactly from the counts;
+ *        o sets the U skeleton by transposing the L structure, since the
+ *          first nonzero of each U-segment is the first column of its
+ *          supernode.
+ *   The whole is linear in nnz(A) + |lsub| + |usub|, up to the inverse
+ *   Ackermann factor of the path compression.
+ *
+ *   The supernodes, the sets of subscripts and nnzLU are those of the
+ *   general algorithm when the pattern of A is symmetric. Only the order
+ *   of the subscripts below the diagonal block of a supernode, and of the
+ *   segments of a U column, may differ. There is no structural pruning,
+ *   and no memory expansion.
+ *
+ * Return value
+ * ============
+ *   < 0, number of bytes needed for LSUB.
+ *   = 0, matrix dimension is 1.
+ * </pre>
+ */
+static int_t symbfact_sym
+/************************************************************************/
+(
+ superlu_dist_options_t *options, /* input options */
+ int         pnum,     /* process number */
+ SuperMatrix *A,       /* original matrix A permuted by columns (input) */
+ int_t       *etree,   /* postordered etree of A'+A (input) */
+ Glu_persist_t *Glu_persist,  /* output */
+ Glu_freeable_t *Glu_freeable /* output */
+ )
+{
+    NCPformat *Astore = A->Store;
+    int_t  *asub = Astore->rowind;
+    int_t  *xa_begin = Astore->colbeg, *xa_end = Astore->colend;
+    int_t  n = A->ncol;
+    int_t  relax, maxsuper, nsuper, fsupc, nsupc, lst;
+    int_t  i, j, k, p, q, s, jprev;
+    int_t  nnzL, nnzU, nextl, nextu;
+    int_t  *iwork, *bp, *bi, *cc, *first, *maxfirst, *prevleaf;
+    int_t  *ancestor, *marker, *relax_end, *desc, *head, *next;
+    int_t  *xsup, *supno, *xlsub, *lsub, *xusub, *usub;
+    extern int_t no_expand;
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(pnum, "Enter symbfact_sym()");
+#endif
+
+    relax = sp_ienv_dist(2, options);
+    maxsuper = sp_ienv_dist(3, options);
+
+    iwork = intMalloc_dist(8*n + 2);
+    bp = iwork;                /* n+1 */
+    cc = bp + n + 1;
+    first = cc + n;
+    maxfirst = first + n;
+    prevleaf = maxfirst + n;
+    ancestor = prevleaf + n;
+    marker = ancestor + n;
+    relax_end = marker + n;    /* n+1, with the spare one of bp */
+    if ( !iwork || !(desc = intMalloc_dist(n+1)) )
+	ABORT("Malloc fails for iwork[]");
+
+    /* Strictly lower part of the pattern of A'+A, by columns. */
+    ifill_dist(bp, n+1, 0);
+    for (j = 0; j < n; ++j)
+	for (p = xa_begin[j]; p < xa_end[j]; ++p) {
+	    i = asub[p];
+	    if ( i > j ) ++bp[j+1];
+	    else if ( i < j ) ++bp[i+1];
+	}
+    for (j = 0; j < n; ++j) bp[j+1] += bp[j];
+    if ( !(bi = intMalloc_dist(SUPERLU_MAX(bp[n], 1))) )
+	ABORT("Malloc fails for bi[]");
+    for (j = 0; j < n; ++j) marker[j] = bp[j];
+    for (j = 0; j < n; ++j)
+	for (p = xa_begin[j]; p < xa_end[j]; ++p) {
+	    i = asub[p];
+	    if ( i > j ) bi[marker[j]++] = i;
+	    else if ( i < j ) bi[marker[i]++] = j;
+	}
+
+    /* Column counts of L, with the diagonal. The etree is postordered,
+       so the columns are visited in postorder by j = 0, 1, ... */
+    ifill_dist(first, n, SLU_EMPTY);
+    ifill_dist(maxfirst, n, SLU_EMPTY);
+    ifill_dist(prevleaf, n, SLU_EMPTY);
+    for (j = 0; j < n; ++j) {
+	cc[j] = (first[j] == SLU_EMPTY); /* leaf of the etree */
+	for (k = j; k < n && first[k] == SLU_EMPTY; k = etree[k])
+	    first[k] = j;
+	ancestor[j] = j;
+    }
+    for (j = 0; j < n; ++j) {
+	if ( etree[j] < n ) --cc[etree[j]];
+	for (p = bp[j]; p < bp[j+1]; ++p) {
+	    i = bi[p];
+	    /* Is j a leaf of the row subtree of i? */
+	    if ( first[j] <= maxfirst[i] ) continue;
+	    maxfirst[i] = first[j];
+	    jprev = prevleaf[i];
+	    prevleaf[i] = j;
+	    ++cc[j];
+	    if ( jprev == SLU_EMPTY ) continue; /* first leaf */
+	    /* Subtract at the least common ancestor of jprev and j. */
+	    for (q = jprev; q != ancestor[q]; q = ancestor[q]) ;
+	    for (s = jprev; s != q; s = k) {
+		k = ancestor[s];
+		ancestor[s] = q;
+	    }
+	    --cc[q];
+	}
+	if ( etree[j] < n ) ancestor[j] = etree[j];
+    }
+    for (j = 0; j < n; ++j)
+	if ( etree[j] < n ) cc[etree[j]] += cc[j];
+
+    /* Supernode partition, with the same rules as column_dfs(). */
+    if ( !(Glu_persist->xsup = intMalloc_dist(n+1)) ||
+	 !(Glu_persist->supno = intMalloc_dist(n+1)) ||
+	 !(Glu_freeable->xlsub = intMalloc_dist(n+1)) ||
+	 !(Glu_freeable->xusub = intMalloc_dist(n+1)) )
+	ABORT("Malloc fails for xsup[]/supno[]/xlsub[]/xusub[]");
+    xsup = Glu_persist->xsup;
+    supno = Glu_persist->supno;
+    xlsub = Glu_freeable->xlsub;
+    xusub = Glu_freeable->xusub;
+
+    relax_snode(n, etree, relax, desc, relax_end);
+    nsuper = -1;
+    for (j = 0; j < n; ) {
+	if ( relax_end[j] != SLU_EMPTY ) {
+	    xsup[++nsuper] = j;
+	    for (k = j; k <= relax_end[j]; ++k) supno[k] = nsuper;
+	    j = relax_end[j] + 1;
+	    continue;
+	}
+	if ( j == 0 || etree[j-1] != j || cc[j] != cc[j-1] - 1
+	     || j - xsup[nsuper] >= maxsuper
+	     || (relax_end[xsup[nsuper]] != SLU_EMPTY
+		 && relax_end[xsup[nsuper]] > xsup[nsuper]) )
+	    xsup[++nsuper] = j; /* Starts a new supernode */
+	supno[j++] = nsuper;
+    }
+    xsup[nsuper+1] = n;
+    supno[n] = nsuper;
+
+    /* Exact size of the compressed L subscripts. */
+    nextl = 0;
+    for (k = 0; k <= nsuper; ++k) {
+	fsupc = xsup[k];
+	lst = xsup[k+1] - 1;
+	xlsub[fsupc] = nextl;
+	nextl += lst - fsupc + cc[lst];
+	for (j = fsupc + 1; j <= lst; ++j) xlsub[j] = nextl;
+    }
+    xlsub[n] = nextl;
+    if ( !(lsub = intMalloc_dist(SUPERLU_MAX(nextl, 1))) )
+	ABORT("Malloc fails for lsub[]");
+
+    /* Each supernode takes its diagonal block, the entries of A below it,
+       and the structures of its children below it. The children are kept
+       in linked lists head/next (reusing first/maxfirst). */
+    head = first;
+    next = maxfirst;
+    ifill_dist(head, nsuper+1, SLU_EMPTY);
+    ifill_dist(marker, n, SLU_EMPTY);
+    ifill_dist(xusub, n+1, 0);
+    for (k = 0; k <= nsuper; ++k) {
+	fsupc = xsup[k];
+	lst = xsup[k+1] - 1;
+	nextl = xlsub[fsupc];
+	for (i = fsupc; i <= lst; ++i) lsub[nextl++] = i;
+	for (j = fsupc; j <= lst; ++j)
+	    for (p = bp[j]; p < bp[j+1]; ++p) {
+		i = bi[p];
+		if ( i > lst && marker[i] != k ) {
+		    marker[i] = k;
+		    lsub[nextl++] = i;
+		}
+	    }
+	for (s = head[k]; s != SLU_EMPTY; s = next[s]) {
+	    for (p = xlsub[xsup[s]]; p < xlsub[xsup[s]+1]; ++p) {
+		i = lsub[p];
+		if ( i > lst && marker[i] != k ) {
+		    marker[i] = k;
+		    lsub[nextl++] = i;
+		}
+	    }
+	}
+	assert( nextl == xlsub[fsupc+1] );
+	/* Count the U-segment of supernode k in the columns below it. */
+	for (p = xlsub[fsupc] + lst - fsupc + 1; p < nextl; ++p)
+	    ++xusub[lsub[p]+1];
+	if ( etree[lst] < n ) {
+	    s = supno[etree[lst]];
+	    next[k] = head[s];
+	    head[s] = k;
+	}
+    }
+
+    /* U skeleton: the first column of each supernode whose structure
+       contains the row. */
+    for (j = 0; j < n; ++j) xusub[j+1] += xusub[j];
+    nextu = xusub[n];
+    if ( !(usub = intMalloc_dist(SUPERLU_MAX(nextu, 1))) )
+	ABORT("Malloc fails for usub[]");
+    for (j = 0; j < n; ++j) marker[j] = xusub[j];
+    nnzL = nnzU = 0;
+    for (k = 0; k <= nsuper; ++k) {
+	fsupc = xsup[k];
+	nsupc = xsup[k+1] - fsupc;
+	nextl = xlsub[fsupc+1] - xlsub[fsupc];
+	for (p = xlsub[fsupc] + nsupc; p < xlsub[fsupc+1]; ++p)
+	    usub[marker[lsub[p]]++] = fsupc;
+	nnzL += nsupc * nextl - nsupc * (nsupc - 1) / 2;
+	nnzU += nsupc * (nsupc + 1) / 2 + (nextl - nsupc) * nsupc;
+    }
+
+    Glu_freeable->lsub = lsub;
+    Glu_freeable->usub = usub;
+    Glu_freeable->nzlmax = xlsub[n];
+    Glu_freeable->nzumax = nextu;
+    Glu_freeable->MemModel = SYSTEM;
+    Glu_freeable->nnzLU = nnzL + nnzU - n;
+    /* QuerySpace_dist() reports the expansions through no_expand;
+       none happened here. */
+    no_expand = 1;
+
+    if ( !pnum && (options->PrintStat == YES)) {
+	printf("\tMatrix size min_mn  " IFMT "\n", n);
+	printf("\tNonzeros in L       " IFMT "\n", nnzL);
+	printf("\tNonzeros in U       " IFMT "\n", nnzU);
+	printf("\tnonzeros in L+U     " IFMT "\n", nnzL + nnzU - n);
+	printf("\tnonzeros in LSUB    " IFMT "\n", xlsub[n]);
+    }
+
+    SUPERLU_FREE(bi);
+    SUPERLU_FREE(desc);
+    SUPERLU_FREE(iwork);
+
+#if ( DEBUGlevel>=1 )
+    CHECK_MALLOC(pnum, "Exit symbfact_sym()");
+#endif
+
+    return (-xlsub[n]);
+
+} /* SYMBFACT_SYM */
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   symbfact_cols() performs the symbolic factorization of columns
+ *   jfst:jlst, one relaxed supernode or one column at a time. With
+ *   priv = 0 it works on the global structures, otherwise on those of
+ *   a forest (see symbfact_forest()).
+ *
+ * Return value
+ * ============
+ *     0  success;
+ *   > 0  number of bytes allocated when run out of space.
+ * </pre>
+ */
+static int_t symbfact_cols
+/************************************************************************/
+(
+ const int_t priv,      /* private storage of a forest? (input) */
+ const int_t maxsuper,  /* maximum supernode size (input) */
+ SuperMatrix *A,        /* original matrix A permuted by columns (input) */
+ const int_t jfst,      /* first column (input) */
+ const int_t jlst,      /* last column (input) */
+ int_t       *relax_end,/* last column of each relaxed snode (input) */
+ int_t       *perm_r,   /* row permutation vector (modified) */
+ int_t       *segrep,   /* working array */
+ int_t       *repfnz,   /* working array */
+ int_t       *xprune,   /* pruned location in each adjacency list (output) */
+ int_t       *marker,   /* working array */
+ int_t       *parent,   /* working array */
+ int_t       *xplore,   /* working array */
+ Glu_persist_t *Glu_persist,   /* LU data structures (modified) */
+ Glu_freeable_t *Glu_freeable
+ )
+{
+    int_t j, i, k, irep, nseg, pivrow, info;
+
+    for (j = jfst; j <= jlst; ) {
 	if ( relax_end[j] != SLU_EMPTY ) { /* beginning of a relaxed snode */
    	    k = relax_end[j];          /* end of the relaxed snode */
 	 
 	    /* Determine union of the row structure of supernode (j:k). */
-	    if ( (info = snode_dfs(A, j, k, xprune, marker,
+	    if ( (info = snode_dfs(priv, A, j, k, xprune, marker,
 				   Glu_persist, Glu_freeable)) != 0 )
 		return info;
 
@@ -155,13 +580,13 @@ int_t symbfact
 	} else {
 	    /* Perform a symbolic factorization on column j, and detects
 	       whether column j starts a new supernode. */
-	    if ((info = column_dfs(options, A, j, perm_r, &nseg, segrep, repfnz,
-				   xprune, marker, parent, xplore,
-				   Glu_persist, Glu_freeable)) != 0)
+	    if ((info = column_dfs(priv, maxsuper, A, j, perm_r, &nseg,
+				   segrep, repfnz, xprune, marker, parent,
+				   xplore, Glu_persist, Glu_freeable)) != 0)
 		return info;
 	    
 	    /* Copy the U-segments to usub[*]. */
-	    if ((info = set_usub(min_mn, j, nseg, segrep, repfnz,
+	    if ((info = set_usub(priv, A->ncol, j, nseg, segrep, repfnz,
 				 Glu_persist, Glu_freeable)) != 0)
 		return info;
 
@@ -181,39 +606,328 @@ int_t symbfact
 	} /* else */
     } /* for j ... */
 
-    countnz_dist(min_mn, xprune, &nnzL, &nnzU, Glu_persist, Glu_freeable);
-    Glu_freeable->nnzLU = nnzL + nnzU - min_mn;	
-    /* Apply perm_r to L; Compress LSUB array. */
-    nnzLSUB = fixupL_dist(min_mn, perm_r, Glu_persist, Glu_freeable);
+    return 0;
+} /* SYMBFACT_COLS */
 
-    if ( !pnum && (options->PrintStat == YES)) {
-	nnzLU = nnzL + nnzU - min_mn;				   
-	printf("\tMatrix size min_mn  " IFMT "\n", min_mn);
-	printf("\tNonzeros in L       " IFMT "\n", nnzL);
-	printf("\tNonzeros in U       " IFMT "\n", nnzU);
-	printf("\tnonzeros in L+U     " IFMT "\n", nnzLU);
-	printf("\tnonzeros in LSUB    " IFMT "\n", nnzLSUB);
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   symbfact_partition() splits the postordered etree into forests that
+ *   can be factored independently: the largest subtrees with at most
+ *   maxcols columns, adjacent ones grouped up to maxcols columns. The
+ *   structure of L and U in a column only involves the column's
+ *   descendants and ancestors, so a forest reads and writes nothing
+ *   outside its own columns, except for the rows of the ancestors in L.
+ *   maxcols >= relax, so that every relaxed supernode lies inside a
+ *   forest. The remaining columns are the common ancestors of the
+ *   forests.
+ * </pre>
+ */
+static symb_forest_t *symbfact_partition
+/************************************************************************/
+(
+ const int_t n,      /* number of columns (input) */
+ int_t       *etree, /* postordered column elimination tree (input) */
+ int_t       *desc,  /* number of descendants of each node (input) */
+ const int_t relax,  /* max no of columns in a relaxed snode (input) */
+ const int   nthr,   /* number of threads (input) */
+ int_t       *nforest/* number of forests (output) */
+ )
+{
+    int_t maxcols = SUPERLU_MAX(n / (2 * nthr), relax);
+    int_t r, fst, nf = 0;
+    symb_forest_t *forest;
+
+    /* Root of a largest subtree: desc[r] < maxcols <= desc[etree[r]]. */
+    for (r = 0; r < n; ++r)
+	if ( desc[r] < maxcols && (etree[r] == n || desc[etree[r]] >= maxcols) )
+	    ++nf;
+    if ( !(forest = (symb_forest_t *)
+	   SUPERLU_MALLOC(SUPERLU_MAX(nf, 1) * sizeof(symb_forest_t))) )
+	ABORT("Malloc fails for forest[]");
+
+    nf = 0;
+    for (r = 0; r < n; ++r) {
+	if ( desc[r] >= maxcols || (etree[r] != n && desc[etree[r]] < maxcols) )
+	    continue;
+	fst = r - desc[r];
+	if ( nf && forest[nf-1].lst == fst - 1 && r - forest[nf-1].fst < maxcols )
+	    forest[nf-1].lst = r;
+	else {
+	    forest[nf].fst = fst;
+	    forest[nf].lst = r;
+	    ++nf;
+	}
     }
-    SUPERLU_FREE(iwork);
 
-#if ( PRNTlevel>=3 )
-    PrintInt10("lsub", Glu_freeable->xlsub[n], Glu_freeable->lsub);
-    PrintInt10("xlsub", n+1, Glu_freeable->xlsub);
-    PrintInt10("xprune", n, xprune);
-    PrintInt10("usub", Glu_freeable->xusub[n], Glu_freeable->usub);
-    PrintInt10("xusub", n+1, Glu_freeable->xusub);
-    PrintInt10("supno", n, Glu_persist->supno);
-    PrintInt10("xsup", (Glu_persist->supno[n])+2, Glu_persist->xsup);
+    *nforest = nf;
+    return forest;
+} /* SYMBFACT_PARTITION */
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   symbfact_forest() factors the columns F->fst:F->lst in storage of its
+ *   own: lsub[] and usub[] start at 0, and the supernodes are numbered
+ *   from 0. The arrays indexed by column are addressed with the global
+ *   column numbers through pointers shifted by F->fst. xsup[-1] stands for
+ *   the supernode before the forest: column_dfs() does not compress it.
+ *   perm_r[], repfnz[], parent[] and xplore[] are shared, since each forest
+ *   only touches the entries of its own columns; marker[] belongs to the
+ *   thread.
+ * </pre>
+ */
+static int_t symbfact_forest
+/************************************************************************/
+(
+ const int_t maxsuper,
+ SuperMatrix *A,
+ symb_forest_t *F,
+ int_t *relax_end, int_t *perm_r, int_t *repfnz, int_t *parent,
+ int_t *xplore, int_t *marker
+ )
+{
+    NCPformat *Astore = (NCPformat *) A->Store;
+    Glu_persist_t *Glu_persist = &F->Glu_persist;
+    Glu_freeable_t *Glu_freeable = &F->Glu_freeable;
+    int_t fst = F->fst, lst = F->lst, nc = lst - fst + 1;
+    int_t annz = 0, j, *work, *xlsub;
+
+    for (j = fst; j <= lst; ++j) annz += Astore->colend[j] - Astore->colbeg[j];
+
+    if ( !(work = intMalloc_dist(6 * nc + 6)) )
+	return (6 * nc + 6) * sizeof(int_t);
+    F->work = work;                         /* segrep[nc] */
+    Glu_persist->supno = work + nc - fst;   /* fst : lst+1 */
+    Glu_persist->xsup = work + 2*nc + 2;    /* -1 : nc */
+    xlsub = work + 3*nc + 4 - fst;          /* fst-1 : lst+1 */
+    Glu_freeable->xusub = work + 4*nc + 5 - fst; /* fst : lst+1 */
+    F->xprune = work + 5*nc + 6 - fst;      /* fst : lst */
+    Glu_freeable->xlsub = xlsub;
+
+    Glu_freeable->nzlmax = 2 * annz + nc;
+    Glu_freeable->nzumax = annz + nc;
+    Glu_freeable->lsub = intMalloc_dist(Glu_freeable->nzlmax);
+    Glu_freeable->usub = intMalloc_dist(Glu_freeable->nzumax);
+    Glu_freeable->MemModel = SYSTEM;
+    if ( !Glu_freeable->lsub || !Glu_freeable->usub )
+	return (Glu_freeable->nzlmax + Glu_freeable->nzumax) * sizeof(int_t);
+
+    Glu_persist->supno[fst] = SLU_EMPTY;
+    Glu_persist->xsup[-1] = Glu_persist->xsup[0] = fst;
+    xlsub[fst-1] = xlsub[fst] = 0;
+    Glu_freeable->xusub[fst] = 0;
+
+    return symbfact_cols(1, maxsuper, A, fst, lst, relax_end, perm_r, work,
+			 repfnz, F->xprune, marker, parent, xplore,
+			 Glu_persist, Glu_freeable);
+} /* SYMBFACT_FOREST */
+
+static void symbfact_forest_free(symb_forest_t *F)
+{
+    if ( F->work ) SUPERLU_FREE(F->work);
+    if ( F->Glu_freeable.lsub ) SUPERLU_FREE(F->Glu_freeable.lsub);
+    if ( F->Glu_freeable.usub ) SUPERLU_FREE(F->Glu_freeable.usub);
+}
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   symbfact_forests() factors the forests on nthr threads.
+ *
+ * Return value
+ * ============
+ *     0  success;
+ *   > 0  number of bytes allocated when run out of space.
+ * </pre>
+ */
+static int_t symbfact_forests
+/************************************************************************/
+(
+ const int_t maxsuper, SuperMatrix *A, const int_t nforest,
+ symb_forest_t *forest, int_t *relax_end, int_t *perm_r, int_t *repfnz,
+ int_t *parent, int_t *xplore, const int nthr
+ )
+{
+    int_t m = A->nrow, f, info = 0;
+
+    for (f = 0; f < nforest; ++f) {
+	forest[f].work = NULL;
+	forest[f].Glu_freeable.lsub = forest[f].Glu_freeable.usub = NULL;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthr)
 #endif
+    {
+	int_t ff, *marker = intMalloc_dist(m);
 
-#if ( DEBUGlevel>=1 )
-    CHECK_MALLOC(pnum, "Exit symbfact()");
+	if ( !marker ) ABORT("Malloc fails for marker[]");
+	ifill_dist(marker, m, SLU_EMPTY);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
 #endif
+	for (ff = 0; ff < nforest; ++ff)
+	    forest[ff].info = symbfact_forest(maxsuper, A, &forest[ff],
+					      relax_end, perm_r, repfnz,
+					      parent, xplore, marker);
+	SUPERLU_FREE(marker);
+    }
 
-    /* return (-i); */
-    return (-nnzLSUB);
+    for (f = 0; f < nforest; ++f)
+	if ( forest[f].info ) { info = forest[f].info; break; }
+    if ( info ) {
+	for (f = 0; f < nforest; ++f) symbfact_forest_free(&forest[f]);
+	SUPERLU_FREE(forest);
+    }
+    return info;
+} /* SYMBFACT_FORESTS */
 
-} /* SYMBFACT */
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *   symbfact_splice() copies a factored forest into the global structures,
+ *   leaving them as if its columns had been factored there, and frees its
+ *   storage. Before column F->fst, column_dfs() would have compressed the
+ *   previous supernode (see column_dfs()); this is done here. The rows of
+ *   L in the last column are marked, for the supernode test of the next
+ *   column.
+ *
+ * Return value
+ * ============
+ *     0  success;
+ *   > 0  number of bytes allocated when run out of space.
+ * </pre>
+ */
+static int_t symbfact_splice
+/************************************************************************/
+(
+ symb_forest_t *F,
+ const int_t n,
+ int_t *relax_end,
+ int_t *xprune,
+ int_t *marker,
+ Glu_persist_t *Glu_persist,
+ Glu_freeable_t *Glu_freeable
+ )
+{
+    int_t fst = F->fst, lst = F->lst, nsuper, fsupc, jm1ptr, jptr;
+    int_t ito, ifrom, istop, nextl, nextu, nl, nu, j, k, mem_error;
+    int_t nzlmax = Glu_freeable->nzlmax, nzumax = Glu_freeable->nzumax;
+    int_t *xsup = Glu_persist->xsup, *supno = Glu_persist->supno;
+    int_t *xlsub = Glu_freeable->xlsub, *xusub = Glu_freeable->xusub;
+    int_t *lsub, *usub;
+    Glu_persist_t *Fp = &F->Glu_persist;
+    Glu_freeable_t *Ff = &F->Glu_freeable;
+
+    nsuper = supno[fst];  /* last supernode before the forest */
+    if ( fst > 0 && relax_end[fst] == SLU_EMPTY ) {
+	fsupc = xsup[nsuper];
+	if ( fsupc < fst - 2 ) {  /* >= 3 columns in nsuper */
+	    lsub = Glu_freeable->lsub;
+	    jm1ptr = xlsub[fst-1];
+	    jptr = xlsub[fst];
+	    ito = xlsub[fsupc+1];
+	    xlsub[fst-1] = ito;
+	    istop = ito + jptr - jm1ptr;
+	    xprune[fst-1] = istop;
+	    for (ifrom = jm1ptr; ifrom < jptr; ++ifrom, ++ito)
+		lsub[ito] = lsub[ifrom];
+	    xlsub[fst] = istop;
+	}
+    }
+
+    nextl = xlsub[fst];
+    nextu = xusub[fst];
+    nl = Ff->xlsub[lst+1];
+    nu = Ff->xusub[lst+1];
+    while ( nextl + nl >= nzlmax )
+	if ( (mem_error = symbfact_SubXpand(n, fst, nextl, (MemType) LSUB,
+					    &nzlmax, Glu_freeable)) )
+	    return (mem_error);
+    while ( nextu + nu > nzumax )
+	if ( (mem_error = symbfact_SubXpand(n, fst, nextu, (MemType) USUB,
+					    &nzumax, Glu_freeable)) )
+	    return (mem_error);
+    lsub = Glu_freeable->lsub;
+    usub = Glu_freeable->usub;
+
+    memcpy(&lsub[nextl], Ff->lsub, nl * sizeof(int_t));
+    memcpy(&usub[nextu], Ff->usub, nu * sizeof(int_t));
+    for (j = fst; j <= lst; ++j) {
+	xlsub[j+1] = Ff->xlsub[j+1] + nextl;
+	xusub[j+1] = Ff->xusub[j+1] + nextu;
+	xprune[j] = F->xprune[j] + nextl;
+	supno[j+1] = Fp->supno[j+1] + nsuper + 1;
+    }
+    supno[fst] = Fp->supno[fst] + nsuper + 1;
+    for (k = 0; k <= Fp->supno[lst] + 1; ++k)
+	xsup[nsuper + 1 + k] = Fp->xsup[k];
+
+    for (k = xlsub[lst]; k < xlsub[lst+1]; ++k) marker[lsub[k]] = lst;
+
+    symbfact_forest_free(F);
+    return 0;
+} /* SYMBFACT_SPLICE */
+
+/************************************************************************/
+/*! \brief
+ *
+ * <pre>
+ * Expand lsub[] or usub[]: the global ones with symbfact_SubXpand(), the
+ * private ones of a forest by copying them into an array 1.5 times as
+ * long, since expanders[] is shared.
+ * Return value:   0 - successful return
+ *               > 0 - number of bytes allocated when run out of space
+ * </pre>
+ */
+static int_t symb_xpand
+/************************************************************************/
+(
+ const int_t priv,  /* private storage of a forest? */
+ int_t n,           /* total number of columns */
+ int_t jcol,        /* current column */
+ int_t next,        /* number of elements currently in the factors */
+ MemType mem_type,  /* which type of memory to expand  */
+ int_t *maxlen,     /* modified - maximum length of a data structure */
+ Glu_freeable_t *Glu_freeable  /* modified - LU data structures */
+ )
+{
+    int_t len, *old, *new_mem;
+
+    if ( !priv )
+	return symbfact_SubXpand(n, jcol, next, mem_type, maxlen, Glu_freeable);
+
+    len = 1.5 * *maxlen + 1;
+    old = mem_type == LSUB ? Glu_freeable->lsub : Glu_freeable->usub;
+    if ( !(new_mem = intMalloc_dist(len)) ) {
+    	fprintf(stderr, "Can't expand MemType %d: jcol " IFMT "\n", mem_type, jcol);
+	return (len * sizeof(int_t) + n);
+    }
+    memcpy(new_mem, old, next * sizeof(int_t));
+    SUPERLU_FREE(old);
+    if ( mem_type == LSUB ) {
+	Glu_freeable->lsub   = new_mem;
+	Glu_freeable->nzlmax = len;
+    } else {
+	Glu_freeable->usub   = new_mem;
+	Glu_freeable->nzumax = len;
+    }
+    *maxlen = len;
+    return 0;
+} /* SYMB_XPAND */
 
 /************************************************************************/
 /*! \brief
@@ -292,6 +1006,7 @@ static void relax_snode
 static int_t snode_dfs
 /************************************************************************/
 (
+ const int_t priv,      /* private storage of a forest? (input) */
  SuperMatrix *A,       /* original matrix A permuted by columns (input) */
  const int_t jcol,      /* beginning of the supernode (input) */
  const int_t kcol,      /* end of the supernode (input) */
@@ -332,7 +1047,7 @@ static int_t snode_dfs
 		marker[krow] = kcol;
 		lsub[nextl++] = krow;
 		if ( nextl >= nzlmax ) {
-		    if ((mem_error = symbfact_SubXpand(A->ncol, jcol, nextl,
+		    if ((mem_error = symb_xpand(priv, A->ncol, jcol, nextl,
 						      (MemType) LSUB, &nzlmax,
 						       Glu_freeable)))
 			return (mem_error);
@@ -347,8 +1062,8 @@ static int_t snode_dfs
     /* Supernode > 1, then make a copy of the subscripts for pruning */
     if ( jcol < kcol ) {
 	new_next = nextl + (nextl - xlsub[jcol]);
-	while ( new_next > nzlmax ) {
-	    if ((mem_error = symbfact_SubXpand(A->ncol, jcol, nextl, (MemType) LSUB,
+	while ( new_next >= nzlmax ) { /* keep nextl < nzlmax */
+	    if ((mem_error = symb_xpand(priv, A->ncol, jcol, nextl, (MemType) LSUB,
 					       &nzlmax, Glu_freeable)))
 		return (mem_error);
 	    lsub = Glu_freeable->lsub;
@@ -459,7 +1174,8 @@ static int_t snode_dfs
 static int_t column_dfs
 /************************************************************************/
 (
- superlu_dist_options_t *options,
+ const int_t priv,      /* private storage of a forest? (input) */
+ const int_t maxsuper,  /* maximum supernode size (input) */
  SuperMatrix *A,        /* original matrix A permuted by columns (input) */
  const int_t jcol,      /* current column number (input) */
  int_t       *perm_r,   /* row permutation vector (input) */
@@ -487,7 +1203,6 @@ static int_t column_dfs
     int_t     ito, ifrom, istop;	/* used to compress row subscripts */
     int_t     *xsup, *supno, *lsub, *xlsub;
     int_t     nzlmax;
-    static int_t first = 1, maxsuper;
     int_t     mem_error;
     
     /* Initializations */
@@ -504,10 +1219,6 @@ static int_t column_dfs
     jcolm1   = jcol - 1;
     jsuper   = nsuper = supno[jcol];
     nextl    = xlsub[jcol];
-    if ( first ) {
-	maxsuper = sp_ienv_dist(3, options);
-	first = 0;
-    }
     
     *nseg = 0;
 
@@ -533,7 +1244,7 @@ static int_t column_dfs
 	     */
 	    lsub[nextl++] = krow; 	/* krow is indexed into A */
 	    if ( nextl >= nzlmax ) {
-		if ( (mem_error = symbfact_SubXpand(A->ncol, jcol, nextl, (MemType) LSUB,
+		if ( (mem_error = symb_xpand(priv, A->ncol, jcol, nextl, (MemType) LSUB,
 						    &nzlmax, Glu_freeable)) )
 		    return (mem_error);
 		lsub = Glu_freeable->lsub;
@@ -576,7 +1287,7 @@ static int_t column_dfs
 				lsub[nextl++] = kchild;
 				if ( nextl >= nzlmax ) {
 				    if ( (mem_error =
-					symbfact_SubXpand(A->ncol, jcol, nextl,
+					symb_xpand(priv, A->ncol, jcol, nextl,
 							  (MemType) LSUB, &nzlmax,
 							  Glu_freeable)) )
 					return (mem_error);
@@ -764,6 +1475,7 @@ static int_t pivotL
 static int_t set_usub
 /************************************************************************/
 (
+ const int_t priv,    /* private storage of a forest? (input) */
  const int_t n,       /* total number of columns (input) */
  const int_t jcol,    /* current column number (input) */
  const int_t nseg,    /* number of supernodal segments in U[*,jcol] (input) */
@@ -791,7 +1503,7 @@ static int_t set_usub
 
     new_next = nextu + nseg;
     while ( new_next > nzumax ) {
-	if ( (mem_error = symbfact_SubXpand(n, jcol, nextu, (MemType) USUB, &nzumax,
+	if ( (mem_error = symb_xpand(priv, n, jcol, nextu, (MemType) USUB, &nzumax,
 					    Glu_freeable)) )
 	    return (mem_error);
 	usub = Glu_freeable->usub;
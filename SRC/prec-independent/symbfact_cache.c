@@ -0,0 +1,332 @@
+/*! \file
+Copyright (c) 2003, The Regents of the University of California, through
+Lawrence Berkeley National Laboratory (subject to receipt of any required
+approvals from U.S. Dept. of Energy)
+
+All rights reserved.
+
+The source code is distributed under BSD license, see the file License.txt
+at the top-level directory.
+*/
+/*! @file
+ * \brief On-disk cache of the column ordering and symbolic factorization
+ *
+ * <pre>
+ * -- Distributed SuperLU routine (version 9.0) --
+ * Lawrence Berkeley National Lab, Univ. of California Berkeley.
+ *
+ * When the environment variable SUPERLU_SYMB_CACHE names a directory, the
+ * drivers that run the serial symbolic factorization store its result,
+ * keyed by a fingerprint of the sparsity pattern of Pr*A and of the
+ * options that affect it. The file is named after one 64-bit hash; a
+ * second, independent hash and the dimensions of A are stored in the
+ * entry and compared as well before it is used. A later factorization (in the same or another
+ * run) with the same fingerprint reads perm_c, the column etree, the
+ * supernode partition and the structures of L and U back instead of
+ * recomputing them, and proceeds directly to the distribution.
+ *
+ * Each entry is one file, <dir>/symb-<fingerprint>.bin, written by
+ * process 0 and read by process 0, which broadcasts it.
+ * </pre>
+ */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "superlu_defs.h"
+
+#define SYMB_CACHE_MAGIC  0x3248434d59534c53LL  /* "SLSYMCH2" */
+#define SYMB_CACHE_HDR    12
+
+extern int_t no_expand;  /* in memory.c */
+
+/* FNV-1a style mixing, one 64-bit word at a time. */
+static uint64_t
+cache_mix(uint64_t h, uint64_t x)
+{
+    return (h ^ x) * 0x100000001b3ULL;
+}
+
+/* The second hash: each word is scrambled by the splitmix64 finalizer
+   and added to the rotated sum. */
+static uint64_t
+cache_mix2(uint64_t h, uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return ((h << 7) | (h >> 57)) + (x ^ (x >> 31));
+}
+
+#define CACHE_MIX(x) \
+    ( h = cache_mix(h, (uint64_t) (x)), h2 = cache_mix2(h2, (uint64_t) (x)) )
+
+/*! \brief Fingerprint of the pattern of GA = Pr*A and of the options
+ * used by the ordering and the symbolic factorization.
+ */
+static void
+symbfact_cache_key(superlu_dist_options_t *options, SuperMatrix *GA,
+                   int_t *perm_c, symbfact_cache_key_t *key)
+{
+    NCformat *GAstore = (NCformat *) GA->Store;
+    int_t n = GA->ncol, nnz = GAstore->nnz, i;
+    int_t *colptr = GAstore->colptr, *rowind = GAstore->rowind;
+    uint64_t h = 0xcbf29ce484222325ULL, h2 = 0;
+
+    CACHE_MIX(sizeof(int_t));
+    CACHE_MIX(GA->nrow);
+    CACHE_MIX(n);
+    CACHE_MIX(nnz);
+    CACHE_MIX(options->ColPerm);
+    CACHE_MIX(options->ILU_level);
+    CACHE_MIX(options->SymPattern);
+    CACHE_MIX(sp_ienv_dist(2, options)); /* relax */
+    CACHE_MIX(sp_ienv_dist(3, options)); /* maxsuper */
+    for (i = 0; i <= n; ++i) CACHE_MIX(colptr[i]);
+    for (i = 0; i < nnz; ++i) CACHE_MIX(rowind[i]);
+    if ( options->ColPerm == MY_PERMC )
+        for (i = 0; i < n; ++i) CACHE_MIX(perm_c[i]);
+    key->hash = h;
+    key->hash2 = h2;
+    key->m = GA->nrow;
+    key->nnz = nnz;
+}
+
+static void
+symbfact_cache_name(char *name, size_t len, char *dir, uint64_t key)
+{
+    snprintf(name, len, "%s/symb-%016llx.bin", dir, (unsigned long long) key);
+}
+
+/* Broadcast an int_t array that may have more than INT_MAX entries. */
+static void
+cache_bcast(int_t *buf, int64_t cnt, MPI_Comm comm)
+{
+    int64_t k, chunk = 1 << 28;
+    for (k = 0; k < cnt; k += chunk)
+        MPI_Bcast(buf + k, (int) SUPERLU_MIN(chunk, cnt - k), mpi_int_t,
+                  0, comm);
+}
+
+static int
+cache_read(FILE *fp, int_t *buf, int64_t cnt)
+{
+    return fread(buf, sizeof(int_t), (size_t) cnt, fp) == (size_t) cnt;
+}
+
+/*! \brief
+ *
+ * <pre>
+ * Purpose
+ * =======
+ *
+ * symbfact_cache_load() looks up the ordering and the serial symbolic
+ * factorization of GA = Pr*A in the cache directory. It is called by all
+ * processes in grid->comm, with the same GA, in place of get_perm_c_dist(),
+ * sp_colorder() and symbfact() when options->Fact = DOFACT.
+ *
+ * Arguments
+ * =========
+ *
+ * options (input) superlu_dist_options_t*
+ *         ColPerm, ILU_level, SymPattern and the relax/maxsuper parameters
+ *         are part of the fingerprint.
+ *
+ * GA      (input) SuperMatrix*
+ *         The global matrix Pr*A in NCformat; only the pattern is used.
+ *
+ * perm_c  (input/output) int_t*, dimension n
+ *         On entry, if ColPerm = MY_PERMC, the user's ordering, which is
+ *         part of the fingerprint. On a hit, the postordered perm_c as
+ *         returned by sp_colorder().
+ *
+ * etree   (output) int_t*, dimension n
+ *         On a hit, the column elimination tree of Pc*Pr*A*Pc'.
+ *
+ * Glu_persist (output) Glu_persist_t*
+ *         On a hit, xsup[] and supno[] are allocated and filled.
+ *
+ * Glu_freeable (output) Glu_freeable_t**
+ *         On a hit, *Glu_freeable is allocated and holds lsub[], xlsub[],
+ *         usub[] and xusub[] as after symbfact(); it is released by
+ *         symbfact_SubFree() as usual.
+ *
+ * symb_mem_usage (output) superlu_dist_mem_usage_t*
+ *         On a hit, the memory of the symbolic structures.
+ *
+ * grid    (input) gridinfo_t*
+ *
+ * key     (output) symbfact_cache_key_t*
+ *         On process 0, the fingerprint to pass to symbfact_cache_store()
+ *         after a miss; key->hash is 0 if the cache is disabled.
+ *
+ * Return value
+ * ============
+ *
+ * 1 if the cached entry was loaded, 0 otherwise (on all processes).
+ * </pre>
+ */
+int
+symbfact_cache_load(superlu_dist_options_t *options, SuperMatrix *GA,
+                    int_t *perm_c, int_t *etree, Glu_persist_t *Glu_persist,
+                    Glu_freeable_t **Glu_freeable,
+                    superlu_dist_mem_usage_t *symb_mem_usage,
+                    gridinfo_t *grid, symbfact_cache_key_t *key)
+{
+    int_t n = GA->ncol;
+    int64_t hdr[SYMB_CACHE_HDR];
+    int hit = 0;
+    char *dir, name[4096];
+    FILE *fp = NULL;
+    Glu_freeable_t *Glu;
+
+    memset(key, 0, sizeof(symbfact_cache_key_t));
+    if ( !grid->iam && (dir = get_symb_cache_dir()) ) {
+        symbfact_cache_key(options, GA, perm_c, key);
+        symbfact_cache_name(name, sizeof(name), dir, key->hash);
+        if ( (fp = fopen(name, "rb")) ) {
+            hit = fread(hdr, sizeof(int64_t), SYMB_CACHE_HDR, fp)
+                  == SYMB_CACHE_HDR
+                  && hdr[0] == SYMB_CACHE_MAGIC
+                  && hdr[1] == (int64_t) sizeof(int_t)
+                  && (uint64_t) hdr[2] == key->hash && hdr[3] == (int64_t) n
+                  && (uint64_t) hdr[8] == key->hash2 && hdr[9] == key->m
+                  && hdr[10] == key->nnz;
+            /* Reject a short file up front, so that perm_c[] is not
+               overwritten when falling back to the ordering. */
+            if ( hit ) {
+                long pos = ftell(fp);
+                hit = !fseek(fp, 0, SEEK_END) && ftell(fp) - pos ==
+                      (long) sizeof(int_t) * (5 * (long) n + 4 + hdr[4]
+                                              + hdr[5] + hdr[6])
+                      && !fseek(fp, pos, SEEK_SET);
+                if ( !hit ) fprintf(stderr, "symbfact_cache_load: "
+                                    "%s is truncated\n", name);
+            }
+            if ( !hit ) fclose(fp);
+        }
+    }
+    MPI_Bcast(&hit, 1, MPI_INT, 0, grid->comm);
+    if ( !hit ) return 0;
+
+    /* hdr[] = magic, sizeof(int_t), hash, n, nsuper, |lsub|, |usub|,
+       nnzLU, hash2, m, nnz(A), reserved. */
+    MPI_Bcast(hdr, SYMB_CACHE_HDR, MPI_INT64_T, 0, grid->comm);
+
+    if ( !(Glu = (Glu_freeable_t *) SUPERLU_MALLOC(sizeof(Glu_freeable_t))) )
+        ABORT("Malloc fails for Glu_freeable.");
+    if ( !(Glu_persist->xsup = intMalloc_dist(n+1)) ||
+         !(Glu_persist->supno = intMalloc_dist(n+1)) ||
+         !(Glu->xlsub = intMalloc_dist(n+1)) ||
+         !(Glu->xusub = intMalloc_dist(n+1)) ||
+         !(Glu->lsub = intMalloc_dist(SUPERLU_MAX(hdr[5], 1))) ||
+         !(Glu->usub = intMalloc_dist(SUPERLU_MAX(hdr[6], 1))) )
+        ABORT("Malloc fails for the cached symbolic factorization.");
+    Glu->nzlmax = hdr[5];
+    Glu->nzumax = hdr[6];
+    Glu->MemModel = SYSTEM;
+    Glu->nnzLU = hdr[7];
+
+    if ( !grid->iam ) {
+        hit = cache_read(fp, perm_c, n) && cache_read(fp, etree, n)
+              && cache_read(fp, Glu_persist->xsup, hdr[4] + 1)
+              && cache_read(fp, Glu_persist->supno, n + 1)
+              && cache_read(fp, Glu->xlsub, n + 1)
+              && cache_read(fp, Glu->lsub, hdr[5])
+              && cache_read(fp, Glu->xusub, n + 1)
+              && cache_read(fp, Glu->usub, hdr[6]);
+        fclose(fp);
+        if ( !hit ) fprintf(stderr, "symbfact_cache_load: cannot read %s\n",
+                            name);
+    }
+    MPI_Bcast(&hit, 1, MPI_INT, 0, grid->comm);
+    if ( !hit ) {
+        SUPERLU_FREE(Glu_persist->xsup);
+        SUPERLU_FREE(Glu_persist->supno);
+        symbfact_SubFree(Glu);
+        SUPERLU_FREE(Glu);
+        return 0;
+    }
+
+    cache_bcast(perm_c, n, grid->comm);
+    cache_bcast(etree, n, grid->comm);
+    cache_bcast(Glu_persist->xsup, hdr[4] + 1, grid->comm);
+    cache_bcast(Glu_persist->supno, n + 1, grid->comm);
+    cache_bcast(Glu->xlsub, n + 1, grid->comm);
+    cache_bcast(Glu->lsub, hdr[5], grid->comm);
+    cache_bcast(Glu->xusub, n + 1, grid->comm);
+    cache_bcast(Glu->usub, hdr[6], grid->comm);
+
+    /* QuerySpace_dist() reports the expansions of the last symbfact()
+       through no_expand; none happened here. */
+    no_expand = 1;
+    QuerySpace_dist(n, Glu->xlsub[n], Glu, symb_mem_usage);
+    *Glu_freeable = Glu;
+#if ( PRNTlevel>=1 )
+    if ( !grid->iam )
+        printf(".. symbolic factorization read from %s\n", name);
+#endif
+    return 1;
+}
+
+/*! \brief Store the result of the serial symbolic factorization under the
+ * fingerprint key returned by symbfact_cache_load(). Only process 0 writes;
+ * the file is renamed into place so that concurrent runs never see a
+ * partial entry. Failures are reported and otherwise ignored.
+ */
+void
+symbfact_cache_store(symbfact_cache_key_t *key, int_t n, int_t *perm_c,
+                     int_t *etree,
+                     Glu_persist_t *Glu_persist, Glu_freeable_t *Glu_freeable,
+                     gridinfo_t *grid)
+{
+    int64_t hdr[SYMB_CACHE_HDR];
+    char *dir, name[4096], tmp[4200];
+    FILE *fp;
+    int ok;
+
+    if ( grid->iam || !key->hash || !(dir = get_symb_cache_dir()) ) return;
+
+    hdr[0] = SYMB_CACHE_MAGIC;
+    hdr[1] = sizeof(int_t);
+    hdr[2] = (int64_t) key->hash;
+    hdr[3] = n;
+    hdr[4] = Glu_persist->supno[n-1] + 1;
+    hdr[5] = Glu_freeable->xlsub[n];
+    hdr[6] = Glu_freeable->xusub[n];
+    hdr[7] = Glu_freeable->nnzLU;
+    hdr[8] = (int64_t) key->hash2;
+    hdr[9] = key->m;
+    hdr[10] = key->nnz;
+    hdr[11] = 0;
+
+    if ( mkdir(dir, 0777) && errno != EEXIST ) {
+        fprintf(stderr, "symbfact_cache_store: cannot create %s\n", dir);
+        return;
+    }
+    symbfact_cache_name(name, sizeof(name), dir, key->hash);
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", name, (int) getpid());
+    if ( !(fp = fopen(tmp, "wb")) ) {
+        fprintf(stderr, "symbfact_cache_store: cannot write %s\n", tmp);
+        return;
+    }
+    ok = fwrite(hdr, sizeof(int64_t), SYMB_CACHE_HDR, fp) == SYMB_CACHE_HDR
+      && fwrite(perm_c, sizeof(int_t), n, fp) == (size_t) n
+      && fwrite(etree, sizeof(int_t), n, fp) == (size_t) n
+      && fwrite(Glu_persist->xsup, sizeof(int_t), hdr[4] + 1, fp)
+         == (size_t) hdr[4] + 1
+      && fwrite(Glu_persist->supno, sizeof(int_t), n + 1, fp) == (size_t) n + 1
+      && fwrite(Glu_freeable->xlsub, sizeof(int_t), n + 1, fp) == (size_t) n + 1
+      && fwrite(Glu_freeable->lsub, sizeof(int_t), hdr[5], fp) == (size_t) hdr[5]
+      && fwrite(Glu_freeable->xusub, sizeof(int_t), n + 1, fp) == (size_t) n + 1
+      && fwrite(Glu_freeable->usub, sizeof(int_t), hdr[6], fp) == (size_t) hdr[6];
+    ok = (fclose(fp) == 0) && ok;
+    if ( !ok || rename(tmp, name) ) {
+        fprintf(stderr, "symbfact_cache_store: cannot write %s\n", name);
+        remove(tmp);
+    }
+#if ( PRNTlevel>=1 )
+    else printf(".. symbolic factorization saved in %s\n", name);
+#endif
+}
@@ -2768,13 +2768,13 @@ sForest_t **compute_sForests(int_t nsupers,  Glu_persist_t *Glu_persist, int_t *
     treeList_t *treeList = setree2list(nsupers, setree);
 
     // Calculation of tree weight
-    calcTreeWeight(nsupers, setree, treeList, Glu_persist->xsup);
+    calcTreeWeight(nsupers, setree, treeList, Glu_persist->xsup, grid3d);
 
     // Calculation of maximum level
     int_t maxLvl = log2i(grid3d->zscp.Np) + 1;
 
     // Generation of forests
-    sForest_t **sForests = getForests(maxLvl, nsupers, setree, treeList);
+    sForest_t **sForests = getForests(maxLvl, grid3d->zscp.Np, nsupers, setree, treeList);
 
     // Allocate trf3d data structure
     // LUstruct->trf3Dpart = (dtrf3Dpartition_t *)SUPERLU_MALLOC(sizeof(dtrf3Dpartition_t));
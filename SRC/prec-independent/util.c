@@ -315,8 +315,93 @@ void print_sp_ienv_dist(superlu_dist_options_t *options)
     printf("**************************************************\n");
 }
 
+/*! \brief Build the neighborhood of one B <-> X redistribution pattern.
+ *
+ * SendCnt[] is the 8*procs block set up in pxgstrs_init(), i.e.
+ * SendCnt, SendCnt_nrhs, RecvCnt, RecvCnt_nrhs, sdispls, sdispls_nrhs,
+ * rdispls, rdispls_nrhs. Only the ranks with nonzero counts become graph
+ * neighbors, so the exchange in pxReDistribute_* touches O(neighbors)
+ * instead of O(procs) ranks. Collective over grid->comm.
+ */
+void pxgstrs_nbr_init(int *SendCnt, gridinfo_t *grid, pxgstrs_nbr_t *nbr)
+{
+    int procs = grid->nprow * grid->npcol;
+    int *SendCnt_nrhs = SendCnt + procs;
+    int *RecvCnt      = SendCnt + 2*procs;
+    int *RecvCnt_nrhs = SendCnt + 3*procs;
+    int *sdispls      = SendCnt + 4*procs;
+    int *sdispls_nrhs = SendCnt + 5*procs;
+    int *rdispls      = SendCnt + 6*procs;
+    int *rdispls_nrhs = SendCnt + 7*procs;
+    int *dests, *srcs, *ibuf;
+    int p, no, ni;
+
+    nbr->comm = MPI_COMM_NULL;
+    nbr->outdeg = nbr->indeg = 0;
+    nbr->SendCnt = NULL;
+    if ( procs == 1 ) return;
+
+    for (p = 0; p < procs; ++p) {
+        if ( SendCnt[p] > 0 ) ++nbr->outdeg;
+        if ( RecvCnt[p] > 0 ) ++nbr->indeg;
+    }
+    no = nbr->outdeg;
+    ni = nbr->indeg;
+
+    /* dests[no], srcs[ni], then the compacted counts and displacements. */
+    if ( !(ibuf = SUPERLU_MALLOC((5*(no + ni) + 1) * sizeof(int))) )
+        ABORT("Malloc fails for pxgstrs_nbr_t.");
+    dests = ibuf;
+    srcs = dests + no;
+    nbr->SendCnt      = srcs + ni;
+    nbr->SendCnt_nrhs = nbr->SendCnt + no;
+    nbr->sdispls      = nbr->SendCnt_nrhs + no;
+    nbr->sdispls_nrhs = nbr->sdispls + no;
+    nbr->RecvCnt      = nbr->sdispls_nrhs + no;
+    nbr->RecvCnt_nrhs = nbr->RecvCnt + ni;
+    nbr->rdispls      = nbr->RecvCnt_nrhs + ni;
+    nbr->rdispls_nrhs = nbr->rdispls + ni;
+
+    for (p = 0, no = 0, ni = 0; p < procs; ++p) {
+        if ( SendCnt[p] > 0 ) {
+	    dests[no] = p;
+	    nbr->SendCnt[no] = SendCnt[p];
+	    nbr->SendCnt_nrhs[no] = SendCnt_nrhs[p];
+	    nbr->sdispls[no] = sdispls[p];
+	    nbr->sdispls_nrhs[no] = sdispls_nrhs[p];
+	    ++no;
+	}
+        if ( RecvCnt[p] > 0 ) {
+	    srcs[ni] = p;
+	    nbr->RecvCnt[ni] = RecvCnt[p];
+	    nbr->RecvCnt_nrhs[ni] = RecvCnt_nrhs[p];
+	    nbr->rdispls[ni] = rdispls[p];
+	    nbr->rdispls_nrhs[ni] = rdispls_nrhs[p];
+	    ++ni;
+	}
+    }
+
+    /* The message lengths are the edge weights.  Passing arrays rather
+       than MPI_UNWEIGHTED also keeps a zero degree well defined: ibuf[]
+       has one spare entry, so no pointer here is to an empty region. */
+    MPI_Dist_graph_create_adjacent(grid->comm, ni, srcs, nbr->RecvCnt,
+                                   no, dests, nbr->SendCnt, MPI_INFO_NULL,
+                                   0, &nbr->comm);
+}
+
+void pxgstrs_nbr_free(pxgstrs_nbr_t *nbr)
+{
+    if ( nbr->comm != MPI_COMM_NULL ) MPI_Comm_free(&nbr->comm);
+    /* SendCnt points past dests[] and srcs[] in the same allocation. */
+    if ( nbr->SendCnt )
+        SUPERLU_FREE(nbr->SendCnt - (nbr->outdeg + nbr->indeg));
+    nbr->SendCnt = NULL;
+}
+
 void pxgstrs_finalize(pxgstrs_comm_t *gstrs_comm)
 {
+    pxgstrs_nbr_free(&gstrs_comm->B_to_X_nbr);
+    pxgstrs_nbr_free(&gstrs_comm->X_to_B_nbr);
     SUPERLU_FREE(gstrs_comm->B_to_X_SendCnt);
     SUPERLU_FREE(gstrs_comm->X_to_B_SendCnt);
     SUPERLU_FREE(gstrs_comm->ptr_to_ibuf);
@@ -391,6 +476,8 @@ void PStatPrint(superlu_dist_options_t *options, SuperLUStat_t *stat, gridinfo_t
 	    printf("\tROWPERM time       %8.3f\n", utime[ROWPERM]);
 	if ( options->ColPerm != NATURAL )
 	    printf("\tCOLPERM time       %8.3f\n", utime[COLPERM]);
+	if ( utime[GRAPH] != 0.0 )
+	    printf("\t. A'+A / A'*A time %8.3f\n", utime[GRAPH]);
         printf("\tSYMBFACT time      %8.3f\n", utime[SYMBFAC]);
 	printf("\tDISTRIBUTE time    %8.3f\n", utime[DIST]);
     }
@@ -44,10 +44,291 @@ int file_sPrint_CompRowLoc_to_Triples(SuperMatrix *A)
     return 0;
 }
 
+/* Whether two members have the same pattern once permuted, so that the
+   symbolic factorization of one serves for the other. */
+static int
+ssame_batch_pattern(SuperMatrix *A, int *perm_c, SuperMatrix *B, int *perm_cB)
+{
+    NCformat *Astore = (NCformat *) A->Store, *Bstore = (NCformat *) B->Store;
+    int_t n = A->ncol;
+
+    return Astore->nnz == Bstore->nnz
+	&& !memcmp(perm_c, perm_cB, n * sizeof(int))
+	&& !memcmp(Astore->colptr, Bstore->colptr, (n + 1) * sizeof(int_t))
+	&& !memcmp(Astore->rowind, Bstore->rowind, Astore->nnz * sizeof(int_t));
+}
+
+/* Give the results of members lo..hi-1, computed by process p, to all
+   the processes in two broadcasts: the scaling indicators and the
+   permutations of the members packed in one integer message, then their
+   scalings, solutions and backward errors packed in one float message. */
+static void
+sbcast_batch_results(int lo, int hi, int p, int m, int n, int nrhs,
+		     float **ReqPtr, float **CeqPtr, int **RpivPtr,
+		     int **CpivPtr, DiagScale_t *DiagScale, float **Xptr,
+		     int *ldX, float **Berrs, int iam, MPI_Comm comm)
+{
+    int nb = hi - lo, ni = 1 + m + n, d, k, ds, *ibuf, *ip;
+    long long len;
+    float *buf, *dp;
+
+    if ( nb <= 0 ) return;
+    if ( (long long) nb * ni > INT_MAX )
+	ABORT("Too many batch results for one message.");
+    if ( !(ibuf = int32Malloc_dist(nb * ni)) )
+	ABORT("Malloc fails for ibuf[].");
+    if ( iam == p )
+	for (d = lo, ip = ibuf; d < hi; ++d, ip += ni) {
+	    ip[0] = (int) DiagScale[d];
+	    memcpy(&ip[1], RpivPtr[d], m * sizeof(int));
+	    memcpy(&ip[1 + m], CpivPtr[d], n * sizeof(int));
+	}
+    MPI_Bcast(ibuf, nb * ni, MPI_INT, p, comm);
+
+    len = 0;
+    for (d = lo, ip = ibuf; d < hi; ++d, ip += ni) {
+	ds = ip[0];
+	if ( iam != p ) {
+	    if ( (ds == ROW || ds == BOTH) && DiagScale[d] != ROW
+		 && DiagScale[d] != BOTH )
+		if ( !(ReqPtr[d] = floatMalloc_dist(m)) )
+		    ABORT("Malloc fails for R[].");
+	    if ( (ds == COL || ds == BOTH) && DiagScale[d] != COL
+		 && DiagScale[d] != BOTH )
+		if ( !(CeqPtr[d] = floatMalloc_dist(n)) )
+		    ABORT("Malloc fails for C[].");
+	    DiagScale[d] = (DiagScale_t) ds;
+	    memcpy(RpivPtr[d], &ip[1], m * sizeof(int));
+	    memcpy(CpivPtr[d], &ip[1 + m], n * sizeof(int));
+	}
+	if ( ds == ROW || ds == BOTH ) len += m;
+	if ( ds == COL || ds == BOTH ) len += n;
+	len += (long long) nrhs * (n + 1);
+    }
+    SUPERLU_FREE(ibuf);
+    if ( len > INT_MAX )
+	ABORT("Too many batch results for one message.");
+    if ( !(buf = floatMalloc_dist(len)) )
+	ABORT("Malloc fails for buf[].");
+
+    if ( iam == p )
+	for (d = lo, dp = buf; d < hi; ++d) {
+	    ds = (int) DiagScale[d];
+	    if ( ds == ROW || ds == BOTH ) {
+		memcpy(dp, ReqPtr[d], m * sizeof(float));
+		dp += m;
+	    }
+	    if ( ds == COL || ds == BOTH ) {
+		memcpy(dp, CeqPtr[d], n * sizeof(float));
+		dp += n;
+	    }
+	    for (k = 0; k < nrhs; ++k, dp += n)
+		memcpy(dp, &Xptr[d][k * ldX[d]], n * sizeof(float));
+	    memcpy(dp, Berrs[d], nrhs * sizeof(float));
+	    dp += nrhs;
+	}
+    MPI_Bcast(buf, (int) len, MPI_FLOAT, p, comm);
+    if ( iam != p )
+	for (d = lo, dp = buf; d < hi; ++d) {
+	    ds = (int) DiagScale[d];
+	    if ( ds == ROW || ds == BOTH ) {
+		memcpy(ReqPtr[d], dp, m * sizeof(float));
+		dp += m;
+	    }
+	    if ( ds == COL || ds == BOTH ) {
+		memcpy(CeqPtr[d], dp, n * sizeof(float));
+		dp += n;
+	    }
+	    for (k = 0; k < nrhs; ++k, dp += n)
+		memcpy(&Xptr[d][k * ldX[d]], dp, n * sizeof(float));
+	    memcpy(Berrs[d], dp, nrhs * sizeof(float));
+	    dp += nrhs;
+	}
+    SUPERLU_FREE(buf);
+}
+
+/*! \brief Batch solver on the CPU
+ *
+ * <pre>
+ * The members of the batch are split in contiguous blocks among the
+ * processes of grid3d->comm. Each process preprocesses its members, then
+ * factors and solves them one at a time with psgssvx() on a 1-by-1 grid,
+ * using its OpenMP threads; a member with the same permuted pattern as the
+ * previous one is factored with Fact = SamePattern_SameRowPerm, reusing its
+ * symbolic factorization and data structures. The results are finally
+ * broadcast, so that all the processes get all the solutions, as with the
+ * block diagonal solver.
+ * </pre>
+ */
+static void
+sgssvx_batch_cpu(superlu_dist_options_t *options, int batchCount, int m,
+		 int n, int nrhs, handle_t *SparseMatrix_handles,
+		 float **RHSptr, int *ldRHS, float **ReqPtr, float **CeqPtr,
+		 int **RpivPtr, int **CpivPtr, DiagScale_t *DiagScale,
+		 float **Xptr, int *ldX, float **Berrs, gridinfo3d_t *grid3d,
+		 SuperLUStat_t *stat, int *info)
+{
+    superlu_dist_options_t options1;
+    sScalePermstruct_t ScalePermstruct;
+    sLUstruct_t LUstruct;
+    sSOLVEstruct_t SOLVEstruct;
+    SuperLUStat_t stat1;
+    gridinfo_t grid;
+    SuperMatrix *A, *Aprev = NULL, A1;
+    NCformat *Astore;
+    float *nzval_d, *b, *berr, *rhs, *x, *R, *C, bn, rn;
+    double t;
+    float alpha = -1.0, beta = 1.0;
+    int_t *rowptr_d, *colind_d, i, k;
+    int *perm_r, *perm_c, *perm_cprev = NULL;
+    int nprocs = grid3d->nprow * grid3d->npcol * grid3d->npdep;
+    int iam = grid3d->iam, lo, hi, nb, d, p, iinfo, ph, have_lu = 0;
+
+    *info = 0;
+    lo = (int) ((long long) batchCount * iam / nprocs);
+    hi = (int) ((long long) batchCount * (iam + 1) / nprocs);
+    nb = hi - lo;
+
+    /**** preprocessing of my members, as in the block diagonal solver ****/
+    t = SuperLU_timer_();
+    if ( nb ) sequil_batch(options, nb, m, n, SparseMatrix_handles + lo,
+			   ReqPtr + lo, CeqPtr + lo, DiagScale + lo);
+    stat->utime[EQUIL] = SuperLU_timer_() - t;
+    t = SuperLU_timer_();
+    if ( nb ) spivot_batch(options, nb, m, n, SparseMatrix_handles + lo,
+			   ReqPtr + lo, CeqPtr + lo, DiagScale + lo, RpivPtr + lo);
+    stat->utime[ROWPERM] = SuperLU_timer_() - t;
+    t = SuperLU_timer_();
+    if ( nb ) get_perm_c_batch(options, nb, SparseMatrix_handles + lo,
+			       CpivPtr + lo);
+    stat->utime[COLPERM] = SuperLU_timer_() - t;
+
+    superlu_gridinit(MPI_COMM_SELF, 1, 1, &grid);
+    set_default_options_dist(&options1);
+    options1.Equil = NO;
+    options1.ColPerm = NATURAL;
+    options1.RowPerm = NOROWPERM;
+    options1.ParSymbFact = NO;
+    options1.ReplaceTinyPivot = options->ReplaceTinyPivot;
+    options1.IterRefine = options->IterRefine;
+    options1.Trans = options->Trans;
+    options1.PrintStat = NO;
+    sScalePermstructInit(m, n, &ScalePermstruct);
+    sLUstructInit(n, &LUstruct);
+    PStatInit(&stat1);
+    for (ph = 0; ph < NPHASES; ++ph)
+	if ( ph != EQUIL && ph != ROWPERM && ph != COLPERM )
+	    stat->utime[ph] = stat->ops[ph] = 0.;
+    if ( !(b = floatMalloc_dist(SUPERLU_MAX(m * nrhs, 1))) )
+	ABORT("Malloc fails for b[].");
+    if ( !(berr = floatMalloc_dist(SUPERLU_MAX(nrhs, 1))) )
+	ABORT("Malloc fails for berr[].");
+
+    for (d = lo; d < hi; ++d) {
+	A = (SuperMatrix *) SparseMatrix_handles[d];
+	Astore = (NCformat *) A->Store;
+	perm_r = RpivPtr[d];
+	perm_c = CpivPtr[d];
+
+	/* Pc*A, then Pc*A*Pc' in compressed rows */
+	for (i = 0; i < Astore->nnz; ++i)
+	    Astore->rowind[i] = perm_c[Astore->rowind[i]];
+	sCompCol_to_CompRow_dist(m, n, Astore->nnz, Astore->nzval,
+				 Astore->colptr, Astore->rowind,
+				 &nzval_d, &rowptr_d, &colind_d);
+	for (i = 0; i < Astore->nnz; ++i) colind_d[i] = perm_c[colind_d[i]];
+	sCreate_CompRowLoc_Matrix_dist(&A1, m, n, Astore->nnz, m, 0, nzval_d,
+				       colind_d, rowptr_d, SLU_NR_loc, SLU_S,
+				       SLU_GE);
+
+	/* B <= Pc*Pr*R*B */
+	rhs = RHSptr[d];
+	R = ReqPtr[d];
+	for (k = 0; k < nrhs; ++k, rhs += ldRHS[d]) {
+	    if ( DiagScale[d] == ROW || DiagScale[d] == BOTH )
+		for (i = 0; i < m; ++i) rhs[i] *= R[i];
+	    for (i = 0; i < m; ++i) b[k * m + perm_c[perm_r[i]]] = rhs[i];
+	}
+
+	/* Reuse the symbolic factorization of the previous member. */
+	if ( Aprev && ssame_batch_pattern(A, perm_c, Aprev, perm_cprev) ) {
+	    options1.Fact = SamePattern_SameRowPerm;
+	} else {
+	    if ( have_lu ) sDestroy_LU(n, &grid, &LUstruct);
+	    options1.Fact = DOFACT;
+	}
+	have_lu = 1;
+	PStatClear(&stat1);
+	psgssvx(&options1, &A1, &ScalePermstruct, b, m, nrhs, &grid,
+		&LUstruct, &SOLVEstruct, berr, &stat1, &iinfo);
+	for (ph = 0; ph < NPHASES; ++ph)
+	    if ( ph != EQUIL && ph != ROWPERM && ph != COLPERM ) {
+		stat->utime[ph] += stat1.utime[ph];
+		stat->ops[ph] += stat1.ops[ph];
+	    }
+	stat->TinyPivots += stat1.TinyPivots;
+	stat->RefineSteps += stat1.RefineSteps;
+	Destroy_CompRowLoc_Matrix_dist(&A1);
+	Aprev = A;
+	perm_cprev = perm_c;
+	if ( iinfo ) {
+#if ( PRNTlevel>=1 )
+	    printf("System %d: INFO = %d returned from psgssvx()\n", d, iinfo);
+#endif
+	    if ( !*info ) *info = iinfo;
+	    Aprev = NULL;  /* do not reuse a failed factorization */
+	}
+
+	/* X <= Pc'*Y, then the residual Pc*Pr*R*B - (Pc*Pr*R*A*C)*X */
+	x = Xptr[d];
+	for (k = 0; k < nrhs; ++k, x += ldX[d]) {
+	    for (i = 0; i < n; ++i) x[i] = b[k * m + perm_c[i]];
+	    rhs = RHSptr[d] + k * ldRHS[d];
+	    bn = 0.;
+	    for (i = 0; i < m; ++i) {
+		bn = SUPERLU_MAX( bn, fabs(rhs[i]) );
+		b[k * m + perm_c[perm_r[i]]] = rhs[i];
+	    }
+	    sp_sgemv_dist("N", alpha, A, x, 1, beta, &b[k * m], 1);
+	    rn = 0.;
+	    for (i = 0; i < m; ++i) rn = SUPERLU_MAX( rn, fabs(b[k * m + i]) );
+	    Berrs[d][k] = rn / bn;
+
+	    /* Solution of the original system: X <= C*X */
+	    if ( DiagScale[d] == COL || DiagScale[d] == BOTH ) {
+		C = CeqPtr[d];
+		for (i = 0; i < n; ++i) x[i] *= C[i];
+	    }
+	}
+    } /* end for d ... */
+
+    if ( have_lu ) sDestroy_LU(n, &grid, &LUstruct);
+    if ( options1.SolveInitialized ) sSolveFinalize(&options1, &SOLVEstruct);
+    sScalePermstructFree(&ScalePermstruct);
+    sLUstructFree(&LUstruct);
+    PStatFree(&stat1);
+    SUPERLU_FREE(b);
+    SUPERLU_FREE(berr);
+    superlu_gridexit(&grid);
+
+    /**** all the processes get all the results ****/
+    for (p = 0; p < nprocs; ++p)
+	sbcast_batch_results((int) ((long long) batchCount * p / nprocs),
+			     (int) ((long long) batchCount * (p + 1) / nprocs),
+			     p, m, n, nrhs, ReqPtr, CeqPtr, RpivPtr, CpivPtr,
+			     DiagScale, Xptr, ldX, Berrs, iam, grid3d->comm);
+    MPI_Allreduce(MPI_IN_PLACE, info, 1, MPI_INT, MPI_MAX, grid3d->comm);
+}
+
 /*! \brief Solve a batch of linear systems Ai * Xi = Bi with direct method,
  *    computing the LU factorization of each matrix Ai; <br>
  * This is the fixed-size interface: all the input matrices have the same sparsity structure
  *
+ * Without GPU offload, the batch is shared among the processes of grid3d,
+ * and each member is solved by one process with its threads, reusing the
+ * symbolic factorization of the previous member when the patterns match.
+ * Otherwise the members are stacked in a block diagonal matrix.
+ *
  * <pre>
  * @param[in]      options solver options
  * @param[in]      batchCount number of matrices in the batch
@@ -137,9 +418,9 @@ psgssvx3d_csc_batch(
 
     if (Fact < 0 || Fact > FACTORED)
 	*info = -1;
-    else if (options->RowPerm < 0 || options->RowPerm > MY_PERMR)
+    else if (options->RowPerm < 0 || options->RowPerm > LargeDiag_AUCTION)
 	*info = -1;
-    else if (options->ColPerm < 0 || options->ColPerm > MY_PERMC)
+    else if (options->ColPerm < 0 || options->ColPerm > ND_AT_PLUS_A)
 	*info = -1;
     else if (options->IterRefine < 0 || options->IterRefine > SLU_EXTRA)
 	*info = -1;
@@ -166,6 +447,18 @@ psgssvx3d_csc_batch(
     CHECK_MALLOC(grid3d->iam, "Enter psgssvx3d_csc_batch()");
 #endif
 
+    int cpu_batch = 1;
+#ifdef GPU_ACC
+    cpu_batch = !sp_ienv_dist(10, options);
+#endif
+    if ( cpu_batch ) {
+	sgssvx_batch_cpu(options, batchCount, m, n, nrhs, SparseMatrix_handles,
+			 RHSptr, ldRHS, ReqPtr, CeqPtr, RpivPtr, CpivPtr,
+			 DiagScale, Xptr, ldX, Berrs, grid3d, stat, info);
+	if ( grid3d->zscp.Iam == 0 ) PStatPrint(options, stat, &(grid3d->grid2d));
+	return 0;
+    }
+
     int colequ, Equil, factored, job, notran, rowequ, need_value;
     int_t i, iinfo, j, k, irow;
     int ldx; /* LDA for matrix X (local). */
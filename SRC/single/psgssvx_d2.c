@@ -330,6 +330,9 @@ at the top-level directory.
  *                        off-diagonal.
  *           = MY_PERMR:  use the ordering given in ScalePermstruct->perm_r
  *                        input by the user.
+ *           = LargeDiag_AUCTION: like LargeDiag_MC64, but the matching is
+ *                        computed by a distributed auction on the local
+ *                        rows of A, without gathering A to one process.
  *
  *         o ColPerm (colperm_t)
  *           Specifies what type of column permutation to use to reduce fill.
@@ -559,6 +562,8 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
     float    GA_mem_use = 0.0;    /* memory usage by global A */
     float    dist_mem_use = 0.0;  /* memory usage during distribution */
     superlu_dist_mem_usage_t num_mem_usage, symb_mem_usage;
+    symbfact_cache_key_t symb_key = {0};  /* fingerprint for the symbolic cache */
+    int      symb_cached = 0;
     int64_t  nnzLU;
     int_t    nnz_tot;
     float *nzval_a;
@@ -620,9 +625,10 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
     Fact = options->Fact;
     if ( Fact < DOFACT || Fact > FACTORED )
 	*info = -1;
-    else if ( options->RowPerm < NOROWPERM || options->RowPerm > MY_PERMR )
+    else if ( options->RowPerm < NOROWPERM ||
+              options->RowPerm > LargeDiag_AUCTION )
 	*info = -1;
-    else if ( options->ColPerm < NATURAL || options->ColPerm > MY_PERMC )
+    else if ( options->ColPerm < NATURAL || options->ColPerm > ND_AT_PLUS_A )
 	*info = -1;
     else if ( options->IterRefine < NOREFINE || options->IterRefine > SLU_EXTRA )
 	*info = -1;
@@ -836,8 +842,9 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
 	            	irow = rowind[i];
 		    	rowind[i] = perm_r[irow];
 	            }
-	        } else if ( options->RowPerm == LargeDiag_MC64 ) {
-	            /* Get a new perm_r[] from MC64 */
+	        } else if ( options->RowPerm == LargeDiag_MC64 ||
+	                    options->RowPerm == LargeDiag_AUCTION ) {
+	            /* Get a new perm_r[] from MC64 or the auction */
 	            if ( job == 5 ) {
 		        /* Allocate storage for scaling factors. */
 		        if ( !(R1 = floatMalloc_dist(m)) )
@@ -846,7 +853,10 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
 		            ABORT("SUPERLU_MALLOC fails for C1[]");
 	            }
 
-	            if ( !iam ) { /* Process 0 finds a row permutation */
+	            if ( options->RowPerm == LargeDiag_AUCTION ) {
+		        /* All processes match their own rows of A. */
+		        iinfo = psldperm_dist(job, A, grid, perm_r, R1, C1);
+	            } else if ( !iam ) { /* Process 0 finds a row permutation */
 		        iinfo = sldperm_dist(job, m, nnz, colptr, rowind, a_GA,
 		                perm_r, R1, C1);
 
@@ -1050,7 +1060,14 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
 	    }
         }
 
-	if ( permc_spec != MY_PERMC && Fact == DOFACT ) {
+	/* Look up the ordering and the serial symbolic factorization of
+	   this pattern in the cache directory given by SUPERLU_SYMB_CACHE. */
+	if ( parSymbFact == NO && Fact == DOFACT && permc_spec != PARMETIS )
+	    symb_cached = symbfact_cache_load(options, &GA, perm_c, etree,
+	                          Glu_persist, &Glu_freeable, &symb_mem_usage,
+	                          grid, &symb_key);
+
+	if ( !symb_cached && permc_spec != MY_PERMC && Fact == DOFACT ) {
           /* Reuse perm_c if Fact == SamePattern, or SamePattern_SameRowPerm */
 	  if ( permc_spec == PARMETIS ) {
 	// #pragma omp parallel
@@ -1074,8 +1091,10 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
 		  *info = flinfo;
 		  return;
      	      }
-	  } else {
-	      get_perm_c_dist(iam, permc_spec, &GA, perm_c);
+	  } else if ( parSymbFact == NO || permc_spec != NATURAL ) {
+	      /* perm_c is already the identity for ParSymbFact, where GA
+	         may not have been formed */
+	      get_perm_c_stat(iam, permc_spec, &GA, perm_c, stat);
           }
         }
 
@@ -1083,7 +1102,10 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
 
 	/* Symbolic factorization. */
 	if ( Fact != SamePattern_SameRowPerm ) {
-	    if ( parSymbFact == NO ) { /* Perform serial symbolic factorization */
+	    if ( parSymbFact == NO && symb_cached ) {
+		nnzLU = Glu_freeable->nnzLU;
+		stat->utime[SYMBFAC] = 0.0;
+	    } else if ( parSymbFact == NO ) { /* Perform serial symbolic factorization */
 		/* GA = Pr*A, perm_r[] is already applied. */
 	        int_t *GACcolbeg, *GACcolend, *GACrowind;
 
@@ -1127,6 +1149,8 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
 	    	stat->utime[SYMBFAC] = SuperLU_timer_() - t;
 	    	if ( iinfo <= 0 ) { /* Successful return */
 		    QuerySpace_dist(n, -iinfo, Glu_freeable, &symb_mem_usage);
+		    symbfact_cache_store(&symb_key, n, perm_c, etree, Glu_persist,
+		                         Glu_freeable, grid);
 #if ( PRNTlevel>=1 )
 		    if ( !iam ) {
 		    	printf("\tNo of supers " IFMT "\n", Glu_persist->supno[n-1]+1);
@@ -1171,7 +1195,7 @@ psgssvx_d2(superlu_dist_options_t *options, SuperMatrix *A,
             /* Destroy global GA */
             if ( parSymbFact == NO || options->RowPerm != NO )
                 Destroy_CompCol_Matrix_dist(&GA);
-            if ( parSymbFact == NO )
+            if ( parSymbFact == NO && !symb_cached )
  	        Destroy_CompCol_Permuted_dist(&GAC);
 
 	} /* end if Fact != SamePattern_SameRowPerm ... */
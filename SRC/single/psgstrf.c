@@ -251,11 +251,11 @@ psgstrf(superlu_dist_options_t * options, int m, int n, float anorm,
 #endif
     float zero = 0.0, alpha = 1.0, beta = 0.0;
     int_t *xsup;
-    int_t *lsub, *lsub1, *usub, *Usub_buf;
+    int_t *lsub, *lsub1, *usub = NULL, *Usub_buf;
     int_t **Lsub_buf_2, **Usub_buf_2;
     float **Lval_buf_2, **Uval_buf_2;          /* pointers to starts of bufs */
     float *lusup, *lusup1, *uval, *Uval_buf;   /* pointer to current buf     */
-    int_t fnz, i, ib, ijb, ilst, it, iukp, jj, klst,
+    int_t fnz, i, ib, ijb, ilst, it, iukp, jj, klst = 0,
           ldv, lptr, lptr0, lptrj, luptr, luptr0, luptrj,
           nlb, nub, rel, rukp, il, iu;
     int jb, ljb, nsupc, knsupc, lb, lib;	
@@ -301,6 +301,9 @@ psgstrf(superlu_dist_options_t * options, int m, int n, float anorm,
     int **msgcnts, **msgcntsU; /* counts in the look-ahead window */
     int *factored;  /* factored[j] == 0 : L col panel j is factorized. */
     int *factoredU; /* factoredU[i] == 1 : U row panel i is factorized. */
+    int *refact_mask; /* refact_mask[k] == 0 : panels of k are kept. */
+    int keep_k;       /* k is kept, only its updates into refactored
+			 blocks are applied. */
     int nnodes, *sendcnts, *sdispls, *recvcnts, *rdispls, *srows, *rrows;
     etree_node *head, *tail, *ptr;
     int *num_child;
@@ -549,6 +552,7 @@ psgstrf(superlu_dist_options_t * options, int m, int n, float anorm,
     if (!(factoredU = SUPERLU_MALLOC (nsupers * sizeof (int))))
         ABORT ("Malloc fails for factoredU[].");
     for (i = 0; i < nsupers; i++) factored[i] = factoredU[i] = -1;
+    refact_mask = Llu->refact_mask;
 
     log_memory(2 * nsupers * iword, stat);
 
@@ -1598,6 +1602,7 @@ psgstrf(superlu_dist_options_t * options, int m, int n, float anorm,
             rukp = 0;           /* Pointer to nzval[] of U(k,:) */
             nub = usub[0];      /* Number of blocks in the block row U(k,:) */
             klst = FstBlockC (k + 1);
+            keep_k = refact_mask && !refact_mask[k];
 
             /* -------------------------------------------------------------
                Update the look-ahead block columns A(:,k+1:k+num_look_ahead)
@@ -209,6 +209,9 @@ psgstrf2_trsm
 	U_diag_blk_send_req[myrow] = MPI_REQUEST_NULL;
     }
 
+    /* Partial refactorization: L(:,k) and U(k,k) are kept. */
+    if ( Llu->refact_mask && !Llu->refact_mask[k] ) return;
+
     if (iam == pkk) {            /* diagonal process */
 	/* ++++ First step compute diagonal block ++++++++++ */
         for (j = 0; j < jlst - jfst; ++j) {  /* for each column in panel */
@@ -873,6 +876,7 @@ void psgstrs2_omp
     /* Quick return. */
     lk = LBi (k, grid);         /* Local block number */
     if (!Llu->Unzval_br_ptr[lk]) return;
+    if ( Llu->refact_mask && !Llu->refact_mask[k] ) return; /* U(k,:) kept */
 
     /* Initialization. */
     iam = grid->iam;
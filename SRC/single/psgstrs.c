@@ -168,8 +168,8 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
 		      Glu_persist_t *Glu_persist,
 		      gridinfo_t *grid, sSOLVEstruct_t *SOLVEstruct)
 {
-    int  *SendCnt, *SendCnt_nrhs, *RecvCnt, *RecvCnt_nrhs;
-    int  *sdispls, *sdispls_nrhs, *rdispls, *rdispls_nrhs;
+    int  *SendCnt, *RecvCnt;
+    int  *sdispls, *rdispls, *rdispls_nrhs;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
     int_t  *perm_r, *perm_c; /* row and column permutation vectors */
     int_t  *send_ibuf, *recv_ibuf;
@@ -178,9 +178,7 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
     int_t  i, ii, irow, gbi, j, jj, k, knsupc, l, lk, nbrow;
     int    p, procs;
     pxgstrs_comm_t *gstrs_comm = SOLVEstruct->gstrs_comm;
-	MPI_Request req_i, req_d, *req_send, *req_recv;
-	MPI_Status status, *status_send, *status_recv;
-	int Nreq_recv, Nreq_send, pp, pps, ppr;
+	pxgstrs_nbr_t *nbr;
 	double t;
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter psReDistribute_B_to_X()");
@@ -195,11 +193,8 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
     xsup = Glu_persist->xsup;
     supno = Glu_persist->supno;
     SendCnt      = gstrs_comm->B_to_X_SendCnt;
-    SendCnt_nrhs = gstrs_comm->B_to_X_SendCnt +   procs;
     RecvCnt      = gstrs_comm->B_to_X_SendCnt + 2*procs;
-    RecvCnt_nrhs = gstrs_comm->B_to_X_SendCnt + 3*procs;
     sdispls      = gstrs_comm->B_to_X_SendCnt + 4*procs;
-    sdispls_nrhs = gstrs_comm->B_to_X_SendCnt + 5*procs;
     rdispls      = gstrs_comm->B_to_X_SendCnt + 6*procs;
     rdispls_nrhs = gstrs_comm->B_to_X_SendCnt + 7*procs;
     ptr_to_ibuf  = gstrs_comm->ptr_to_ibuf;
@@ -250,14 +245,6 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
 		if ( !(send_dbuf = floatMalloc_dist((k + l)* (size_t)nrhs)) )
 			ABORT("Malloc fails for send_dbuf[].");
 		recv_dbuf = send_dbuf + k * nrhs;
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -284,80 +271,15 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
 		// t = SuperLU_timer_() - t;
 		// printf(".. copy to send buffer time\t%8.4f\n", t);
 
-#if 0
-	#if 1
-		/* Communicate the (permuted) row indices. */
-		MPI_Alltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-			  recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm);
- 		/* Communicate the numerical values. */
-		MPI_Alltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, MPI_FLOAT,
-			  recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_FLOAT,
-			  grid->comm);
-	#else
- 		/* Communicate the (permuted) row indices. */
-		MPI_Ialltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-				recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm, &req_i);
- 		/* Communicate the numerical values. */
-		MPI_Ialltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, MPI_FLOAT,
-				recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_FLOAT,
-				grid->comm, &req_d);
-		MPI_Wait(&req_i,&status);
-		MPI_Wait(&req_d,&status);
- 	#endif
-#endif
-	MPI_Barrier( grid->comm );
-
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-
-		if(SendCnt[pps]>0){
-			MPI_Isend(&send_ibuf[sdispls[pps]], SendCnt[pps], mpi_int_t, pps, 0, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt[ppr]>0){
-			MPI_Irecv(&recv_ibuf[rdispls[ppr]], RecvCnt[ppr], mpi_int_t, ppr, 0, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt_nrhs[pps]>0){
-			MPI_Isend(&send_dbuf[sdispls_nrhs[pps]], SendCnt_nrhs[pps], MPI_FLOAT, pps, 1, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt_nrhs[ppr]>0){
-			MPI_Irecv(&recv_dbuf[rdispls_nrhs[ppr]], RecvCnt_nrhs[ppr], MPI_FLOAT, ppr, 1, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
+	/* Exchange with the graph neighbors only; the distributed-graph
+	   communicator was built once in psgstrs_init(). */
+	nbr = &gstrs_comm->B_to_X_nbr;
+	MPI_Neighbor_alltoallv(send_ibuf, nbr->SendCnt, nbr->sdispls, mpi_int_t,
+			       recv_ibuf, nbr->RecvCnt, nbr->rdispls, mpi_int_t,
+			       nbr->comm);
+	MPI_Neighbor_alltoallv(send_dbuf, nbr->SendCnt_nrhs, nbr->sdispls_nrhs, MPI_FLOAT,
+			       recv_dbuf, nbr->RecvCnt_nrhs, nbr->rdispls_nrhs, MPI_FLOAT,
+			       nbr->comm);
 
 
 		/* ------------------------------------------------------------
@@ -391,10 +313,6 @@ psReDistribute_B_to_X(float *B, int_t m_loc, int nrhs, int_t ldb,
 
 		SUPERLU_FREE(send_ibuf);
 		SUPERLU_FREE(send_dbuf);
-		SUPERLU_FREE(req_send);
-		SUPERLU_FREE(req_recv);
-		SUPERLU_FREE(status_send);
-		SUPERLU_FREE(status_recv);
 	}
 
 
@@ -428,8 +346,8 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
 {
     int_t  i, ii, irow, j, jj, k, knsupc, nsupers, l, lk;
     int_t  *xsup, *supno;
-    int  *SendCnt, *SendCnt_nrhs, *RecvCnt, *RecvCnt_nrhs;
-    int  *sdispls, *rdispls, *sdispls_nrhs, *rdispls_nrhs;
+    int  *SendCnt, *RecvCnt;
+    int  *sdispls, *rdispls, *sdispls_nrhs;
     int  *ptr_to_ibuf, *ptr_to_dbuf;
     int_t  *send_ibuf, *recv_ibuf;
     float *send_dbuf, *recv_dbuf;
@@ -437,9 +355,7 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
     pxgstrs_comm_t *gstrs_comm = SOLVEstruct->gstrs_comm;
     int  iam, p, q, pkk, procs;
     int_t  num_diag_procs, *diag_procs;
-	MPI_Request req_i, req_d, *req_send, *req_recv;
-	MPI_Status status, *status_send, *status_recv;
-	int Nreq_recv, Nreq_send, pp,pps,ppr;
+	pxgstrs_nbr_t *nbr;
 
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Enter psReDistribute_X_to_B()");
@@ -455,13 +371,10 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
     procs = grid->nprow * grid->npcol;
 
     SendCnt      = gstrs_comm->X_to_B_SendCnt;
-    SendCnt_nrhs = gstrs_comm->X_to_B_SendCnt +   procs;
     RecvCnt      = gstrs_comm->X_to_B_SendCnt + 2*procs;
-    RecvCnt_nrhs = gstrs_comm->X_to_B_SendCnt + 3*procs;
     sdispls      = gstrs_comm->X_to_B_SendCnt + 4*procs;
     sdispls_nrhs = gstrs_comm->X_to_B_SendCnt + 5*procs;
     rdispls      = gstrs_comm->X_to_B_SendCnt + 6*procs;
-    rdispls_nrhs = gstrs_comm->X_to_B_SendCnt + 7*procs;
     ptr_to_ibuf  = gstrs_comm->ptr_to_ibuf;
     ptr_to_dbuf  = gstrs_comm->ptr_to_dbuf;
 
@@ -503,14 +416,6 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
 		recv_ibuf = send_ibuf + k;
 		if ( !(send_dbuf = floatMalloc_dist((k + l)*nrhs)) )
 			ABORT("Malloc fails for send_dbuf[].");
-		if ( !(req_send = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_send[].");
-		if ( !(req_recv = (MPI_Request*) SUPERLU_MALLOC(procs*sizeof(MPI_Request))) )
-			ABORT("Malloc fails for req_recv[].");
-		if ( !(status_send = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_send[].");
-		if ( !(status_recv = (MPI_Status*) SUPERLU_MALLOC(procs*sizeof(MPI_Status))) )
-			ABORT("Malloc fails for status_recv[].");
 		recv_dbuf = send_dbuf + k * nrhs;
 		for (p = 0; p < procs; ++p) {
 			ptr_to_ibuf[p] = sdispls[p];
@@ -550,76 +455,16 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
 		/* ------------------------------------------------------------
 			COMMUNICATE THE (PERMUTED) ROW INDICES AND NUMERICAL VALUES.
 		   ------------------------------------------------------------*/
-#if 0
-	#if 1
-		MPI_Alltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-			  recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm);
-		MPI_Alltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs,MPI_FLOAT,
-			  recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_FLOAT,
-			  grid->comm);
-	#else
-		MPI_Ialltoallv(send_ibuf, SendCnt, sdispls, mpi_int_t,
-				recv_ibuf, RecvCnt, rdispls, mpi_int_t, grid->comm,&req_i);
-		MPI_Ialltoallv(send_dbuf, SendCnt_nrhs, sdispls_nrhs, MPI_FLOAT,
-				recv_dbuf, RecvCnt_nrhs, rdispls_nrhs, MPI_FLOAT,
-				grid->comm,&req_d);
- 		MPI_Wait(&req_i,&status);
-		MPI_Wait(&req_d,&status);
-	#endif
-#endif
-
-	MPI_Barrier( grid->comm );
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt[pps]>0){
-			MPI_Isend(&send_ibuf[sdispls[pps]], SendCnt[pps], mpi_int_t, pps, 0, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt[ppr]>0){
-			MPI_Irecv(&recv_ibuf[rdispls[ppr]], RecvCnt[ppr], mpi_int_t, ppr, 0, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
-
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-	// MPI_Barrier( grid->comm );
-
-	Nreq_send=0;
-	Nreq_recv=0;
-	for (pp=0;pp<procs;pp++){
-		pps = grid->iam+1+pp;
-		if(pps>=procs)pps-=procs;
-		if(pps<0)pps+=procs;
-		ppr = grid->iam-1+pp;
-		if(ppr>=procs)ppr-=procs;
-		if(ppr<0)ppr+=procs;
-		if(SendCnt_nrhs[pps]>0){
-			MPI_Isend(&send_dbuf[sdispls_nrhs[pps]], SendCnt_nrhs[pps], MPI_FLOAT, pps, 1, grid->comm,
-			&req_send[Nreq_send] );
-			Nreq_send++;
-		}
-		if(RecvCnt_nrhs[ppr]>0){
-			MPI_Irecv(&recv_dbuf[rdispls_nrhs[ppr]], RecvCnt_nrhs[ppr], MPI_FLOAT, ppr, 1, grid->comm,
-			&req_recv[Nreq_recv] );
-			Nreq_recv++;
-		}
-	}
-
 
-	if(Nreq_send>0)MPI_Waitall(Nreq_send,req_send,status_send);
-	if(Nreq_recv>0)MPI_Waitall(Nreq_recv,req_recv,status_recv);
-	// MPI_Barrier( grid->comm );
+	/* Exchange with the graph neighbors only; the distributed-graph
+	   communicator was built once in psgstrs_init(). */
+	nbr = &gstrs_comm->X_to_B_nbr;
+	MPI_Neighbor_alltoallv(send_ibuf, nbr->SendCnt, nbr->sdispls, mpi_int_t,
+			       recv_ibuf, nbr->RecvCnt, nbr->rdispls, mpi_int_t,
+			       nbr->comm);
+	MPI_Neighbor_alltoallv(send_dbuf, nbr->SendCnt_nrhs, nbr->sdispls_nrhs, MPI_FLOAT,
+			       recv_dbuf, nbr->RecvCnt_nrhs, nbr->rdispls_nrhs, MPI_FLOAT,
+			       nbr->comm);
 
 
 		/* ------------------------------------------------------------
@@ -635,10 +480,6 @@ psReDistribute_X_to_B(int_t n, float *B, int_t m_loc, int_t ldb, int_t fst_row,
 
     SUPERLU_FREE(send_ibuf);
     SUPERLU_FREE(send_dbuf);
-	SUPERLU_FREE(req_send);
-	SUPERLU_FREE(req_recv);
-	SUPERLU_FREE(status_send);
-	SUPERLU_FREE(status_recv);
 }
 #if ( DEBUGlevel>=1 )
     CHECK_MALLOC(grid->iam, "Exit psReDistribute_X_to_B()");
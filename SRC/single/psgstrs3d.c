@@ -227,6 +227,9 @@ int strs_compute_communication_structure(superlu_dist_options_t *options, int_t
     int *h_recv_cnt;
     int *h_recv_cnt_u;
 
+    /* Node map used to shape the broadcast and reduction trees below */
+    C_Tree_SetTopology(grid->comm);
+
     /* Reconstruct the global L structure and compute the communication metadata */
 
     if ( !(tmpglo = intCalloc_dist(nsupers)) )
@@ -1429,6 +1432,7 @@ int_t strs_x_reduction_newsolve(int_t nsupers, float* x, int nrhs, sLUstruct_t *
                 sender = myGrid;
                 receiver = myGrid - (1 << (ilvl-1));
             }
+            if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
             int_t tr =  tree;
             for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
             {
@@ -1470,6 +1474,7 @@ int_t strs_x_broadcast_newsolve(int_t nsupers, float* x, int nrhs, sLUstruct_t *
                 sender = myGrid - (1 << (ilvl-1));
                 receiver = myGrid ;
             }
+            if (receiver >= grid3d->zscp.Np) continue; /* no partner grid */
             int_t tr =  tree;
             for (int_t alvl = ilvl; alvl < maxLvl; alvl++)
             {
@@ -1573,6 +1578,7 @@ int_t strs_X_gather3d(float* x, int nrhs, strf3Dpartition_t*  trf3Dpartition,
 				sender = myGrid;
 				receiver = myGrid - (1 << ilvl);
 			}
+			if (sender >= grid3d->zscp.Np) continue; /* no partner grid */
 			for (int_t alvl = 0; alvl <= ilvl; alvl++)
 			{
 				int_t diffLvl  = ilvl - alvl;
@@ -1751,6 +1757,7 @@ int_t sbsolve_Xt_bcast(int_t ilvl, sxT_struct *xT_s, int nrhs, strf3Dpartition_t
 		receiver = myGrid;
 		sender = myGrid - (1 << ilvl);
 	}
+	if (receiver >= grid3d->zscp.Np) return 0; /* no partner grid */
 
 	for (int_t alvl = ilvl + 1; alvl < maxLvl; ++alvl)
 	{
@@ -7426,6 +7433,7 @@ int_t psgsTrForwardSolve3d(superlu_dist_options_t *options, int_t n, sLUstruct_t
                     receiver = myGrid - (1 << ilvl);
                 }
                 double tx = SuperLU_timer_();
+                if (sender < grid3d->zscp.Np) /* else no partner grid */
                 for (int_t alvl = ilvl + 1; alvl <  maxLvl; ++alvl)
                 {
                     /* code */
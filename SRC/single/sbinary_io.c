@@ -40,3 +40,84 @@ swrite_binary(int_t n, int_t nnz,
       fclose(fp1);
       return 0;
 }
+
+/*! \brief Read a binary matrix file into a distributed matrix
+ *
+ * <pre>
+ * The file (see binary_io.c) is mapped in memory on all processes of
+ * grid, and each process copies its rows: A is returned in the block-row
+ * distributed format SLU_NR_loc, each process owning m / nprocs
+ * consecutive rows (the last one also owns the remainder).
+ *
+ * Returns 0 on success, a positive value on all processes otherwise.
+ * </pre>
+ */
+int
+psread_binary_loc(char *filename, SuperMatrix *A, gridinfo_t *grid)
+{
+    superlu_bin_t bin;
+    int_t m_loc, fst_row, nnz_loc, *rowptr, *colind;
+    void *nzval;
+    int iam, nprocs, info;
+
+    MPI_Comm_rank(grid->comm, &iam);
+    MPI_Comm_size(grid->comm, &nprocs);
+    info = superlu_bin_open(filename, &bin);
+    if ( !info && bin.hdr->dtype != SLU_S ) info = 5;
+    MPI_Allreduce(MPI_IN_PLACE, &info, 1, MPI_INT, MPI_MAX, grid->comm);
+    if ( info ) {
+	if ( !iam ) fprintf(stderr, "%s: cannot read binary matrix file (%d)\n",
+			    filename, info);
+	superlu_bin_close(&bin);
+	return info;
+    }
+
+    superlu_mm_block_rows(bin.hdr->m, iam, nprocs, &m_loc, &fst_row);
+    info = superlu_bin_get_rows(&bin, fst_row, m_loc, &nnz_loc, &rowptr,
+				&colind, &nzval);
+    MPI_Allreduce(MPI_IN_PLACE, &info, 1, MPI_INT, MPI_MAX, grid->comm);
+    if ( info ) {
+	if ( !iam ) fprintf(stderr, "%s: cannot read binary matrix file (%d)\n",
+			    filename, info);
+	if ( rowptr ) {
+	    SUPERLU_FREE(rowptr);
+	    SUPERLU_FREE(colind);
+	    SUPERLU_FREE(nzval);
+	}
+	superlu_bin_close(&bin);
+	return info;
+    }
+    sCreate_CompRowLoc_Matrix_dist(A, bin.hdr->m, bin.hdr->n, nnz_loc, m_loc,
+				   fst_row, (float *) nzval, colind, rowptr,
+				   SLU_NR_loc, SLU_S, SLU_GE);
+    if ( !iam ) {
+	printf("m %lld, n %lld, nonz %lld\n", (long long) bin.hdr->m,
+	       (long long) bin.hdr->n, (long long) bin.hdr->nnz);
+	fflush(stdout);
+    }
+    superlu_bin_close(&bin);
+    return 0;
+}
+
+/*! \brief Write a distributed matrix in SLU_NR_loc format to a binary
+ * matrix file
+ *
+ * <pre>
+ * Collective on grid->comm. The rows of the processes must be in the
+ * order of the ranks, as produced by psread_binary_loc() or
+ * psreadMM_loc(). flags is a combination of SLU_BIN_SYM_PATTERN and
+ * SLU_BIN_SYM_VALUES recorded in the header.
+ * Returns 0 on success, 1 if the file cannot be written.
+ * </pre>
+ */
+int
+pswrite_binary_loc(char *filename, SuperMatrix *A, int flags,
+		   gridinfo_t *grid)
+{
+    NRformat_loc *Astore = (NRformat_loc *) A->Store;
+
+    return superlu_bin_write_loc(filename, SLU_S, flags, A->nrow, A->ncol,
+				 Astore->m_loc, Astore->fst_row,
+				 Astore->rowptr, Astore->colind,
+				 Astore->nzval, grid->comm);
+}
@@ -29,9 +29,9 @@ void validateInput_psgssvx3d(superlu_dist_options_t *options, SuperMatrix *A,
     int Fact = options->Fact;
     if (Fact < 0 || Fact > FACTORED)
         *info = -1;
-    else if (options->RowPerm < 0 || options->RowPerm > MY_PERMR)
+    else if (options->RowPerm < 0 || options->RowPerm > LargeDiag_AUCTION)
         *info = -1;
-    else if (options->ColPerm < 0 || options->ColPerm > MY_PERMC)
+    else if (options->ColPerm < 0 || options->ColPerm > ND_AT_PLUS_A)
         *info = -1;
     else if (options->IterRefine < 0 || options->IterRefine > SLU_EXTRA)
         *info = -1;
@@ -159,6 +159,47 @@ void sscaleFromScratch(
 #endif
 }
 
+/* Ruiz scaling with neighbor communication only (see psgsequ_ruiz);
+   with SamePattern, the previous R and C are the starting point. */
+void sscaleRuiz(
+    fact_t Fact, SuperMatrix *A, sScalePermstruct_t *ScalePermstruct,
+    gridinfo_t *grid, int *rowequ, int *colequ, int *iinfo)
+{
+    NRformat_loc *Astore = (NRformat_loc *)A->Store;
+    yes_no_t warm = (Fact == SamePattern && ScalePermstruct->DiagScale == BOTH);
+#if (PRNTlevel >= 1)
+    int steps;
+
+    steps = psgsequ_ruiz(A, ScalePermstruct->R, ScalePermstruct->C, warm,
+                         get_equil_ruiz(), get_equil_tol(), iinfo, grid);
+#else
+    psgsequ_ruiz(A, ScalePermstruct->R, ScalePermstruct->C, warm,
+                 get_equil_ruiz(), get_equil_tol(), iinfo, grid);
+#endif
+
+    if (*iinfo > 0) {
+#if (PRNTlevel >= 1)
+        fprintf(stderr, "The %d-th %s of A is exactly zero\n", *iinfo <= A->nrow ? *iinfo : *iinfo - (int)A->nrow, *iinfo <= A->nrow ? "row" : "column");
+#endif
+    } else if (*iinfo < 0) {
+        return;
+    }
+
+    /* R = C = 1 if A has an empty row or column. */
+    sscaleBoth(Astore->m_loc, Astore->fst_row, Astore->rowptr, Astore->colind,
+              (float *)Astore->nzval, ScalePermstruct->R, ScalePermstruct->C);
+    ScalePermstruct->DiagScale = BOTH;
+    *rowequ = 1;
+    *colequ = 1;
+
+#if (PRNTlevel >= 1)
+    if (grid->iam == 0) {
+        printf(".. Ruiz equilibration steps %d\n", steps);
+        fflush(stdout);
+    }
+#endif
+}
+
 void sscaleMatrixDiagonally(fact_t Fact, sScalePermstruct_t *ScalePermstruct,
                            SuperMatrix *A, SuperLUStat_t *stat, gridinfo_t *grid,
                             int *rowequ, int *colequ, int *iinfo)
@@ -173,6 +214,8 @@ void sscaleMatrixDiagonally(fact_t Fact, sScalePermstruct_t *ScalePermstruct,
 
     if (Fact == SamePattern_SameRowPerm) {
         sscalePrecomputed(A, ScalePermstruct);
+    } else if (get_equil_ruiz() > 0) {
+        sscaleRuiz(Fact, A, ScalePermstruct, grid, rowequ, colequ, iinfo);
     } else {
         sscaleFromScratch(A, ScalePermstruct, grid, rowequ, colequ, iinfo);
     }
@@ -405,11 +448,11 @@ void sperform_LargeDiag_MC64(
     }
 
     // int iinfo;
-    sfindRowPerm_MC64(grid, job, m, n,
-    nnz,
-    colptr,
-    rowind,
-     a_GA, Equil, perm_r, R1, C1, iinfo);
+    if (options->RowPerm == LargeDiag_AUCTION)
+        *iinfo = psldperm_dist(job, A, grid, perm_r, R1, C1);
+    else
+        sfindRowPerm_MC64(grid, job, m, n, nnz, colptr, rowind,
+                          a_GA, Equil, perm_r, R1, C1, iinfo);
 
     if (*iinfo && job == 5) {
         SUPERLU_FREE(R1);
@@ -504,7 +547,8 @@ void sperform_row_permutation(
             {
                 applyRowPerm(colptr, rowind, perm_r, n);
             }
-            else if (options->RowPerm == LargeDiag_MC64)
+            else if (options->RowPerm == LargeDiag_MC64 ||
+                     options->RowPerm == LargeDiag_AUCTION)
             {
 
                 sperform_LargeDiag_MC64(
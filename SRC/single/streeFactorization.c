@@ -461,6 +461,7 @@ int_t ssparseTreeFactor_ASYNC(
         {
             int_t k = perm_c_supno[k0];   // direct computation no perm_c_supno
             int_t offset = k0 % numLA;
+            double tk = SuperLU_timer_();
 
 	    sWaitL(k, msgss[offset]->msgcnt, msgss[offset]->msgcntU,
 		   comReqss[offset]->send_req, comReqss[offset]->recv_req,
@@ -705,6 +706,9 @@ int_t ssparseTreeFactor_ASYNC(
                 }
 
             }
+
+            /* cost of the step of k, see SUPERLU_LBS_PROFILE */
+            if (SCT->tSupernode) SCT->tSupernode[k] += SuperLU_timer_() - tk;
         }/*for main loop (int_t k0 = 0; k0 < gNodeCount[tree]; ++k0)*/
 
     }